@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <chrono>
+#include <stdexcept>
 #include <vector>
 
 #include <stdlib.h>
@@ -63,6 +64,15 @@ void Lil_UCB::load_arms(std::vector<arm_ptr_t> & arms) {
 // TODO: Check (with Bernoulli simulators) that we didn't get a regression.
 
 double Lil_UCB::pull_bandit_arms(size_t max_pulls, bool show_status) {
+	if (num_threads > 1) {
+		return pull_bandit_arms_batched(max_pulls, show_status);
+	} else {
+		return pull_bandit_arms_serial(max_pulls, show_status);
+	}
+}
+
+double Lil_UCB::pull_bandit_arms_serial(size_t max_pulls,
+	bool show_status) {
 
 	// Parameter also set according to spec for Heuristic, p. 5.
 	double lambda = 1 + 10/double(arm_queue.size());
@@ -103,6 +113,123 @@ double Lil_UCB::pull_bandit_arms(size_t max_pulls, bool show_status) {
 				1.0));
 }
 
+// The batched version works in rounds. First it picks num_threads pulls,
+// one at a time: each goes to whichever arm has the best evaluation when
+// the pulls already picked this round are counted as in flight. Arms taken
+// out of the queue stay in the batch (possibly receiving more than one
+// pull), so an arm is never handed to two threads at once. Then the arms
+// are simulated in parallel, and finally the results are applied and the
+// arms put back into the queue.
+
+// The stopping rule is only ever checked against completed pulls, so it
+// stays as valid as in the serial version; the in-flight counts only affect
+// which arms are chosen. The result also doesn't depend on the thread
+// schedule, only on the number of threads.
+
+double Lil_UCB::pull_bandit_arms_batched(size_t max_pulls,
+	bool show_status) {
+
+	double lambda = 1 + 10/double(arm_queue.size());
+
+	size_t recordholder_pulled = 1, other_pulled = 0;
+	size_t num_arms = arm_queue.size(), pulls_done = 0;
+
+	if (num_arms == 0) {
+		return 1;
+	}
+
+	std::vector<queue_entry> batch;
+	std::vector<size_t> in_flight;
+
+	while (pulls_done < max_pulls) {
+		if (show_status) {
+			std::cerr << pulls_done << "   " << max_pulls << "   \r"
+				<< std::flush;
+		}
+
+		size_t batch_pulls = std::min(num_threads, max_pulls - pulls_done);
+		size_t i, best_in_batch;
+
+		batch.clear();
+		in_flight.clear();
+
+		for (size_t pull = 0; pull < batch_pulls; ++pull) {
+			best_in_batch = batch.size();
+			for (i = 0; i < batch.size(); ++i) {
+				if (best_in_batch == batch.size() ||
+					batch[best_in_batch] < batch[i]) {
+					best_in_batch = i;
+				}
+			}
+
+			if (best_in_batch == batch.size() || (!arm_queue.empty() &&
+					batch[best_in_batch] < arm_queue.top())) {
+
+				best_in_batch = batch.size();
+				batch.push_back(arm_queue.top());
+				in_flight.push_back(0);
+				arm_queue.pop();
+			}
+
+			++in_flight[best_in_batch];
+			batch[best_in_batch].MAB_eval = get_eval(
+					batch[best_in_batch].arm_ref, num_arms,
+					in_flight[best_in_batch]);
+		}
+
+		// Exceptions can't leave the parallel region, so keep the
+		// first and rethrow it after.
+		bool failed = false;
+		std::string error_message;
+
+		#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+		for (size_t j = 0; j < batch.size(); ++j) {
+			try {
+				for (size_t k = 0; k < in_flight[j]; ++k) {
+					batch[j].arm_ref->simulate(true);
+				}
+			} catch (std::exception & e) {
+				#pragma omp critical
+				{
+					if (!failed) {
+						error_message = e.what();
+					}
+					failed = true;
+				}
+			}
+		}
+
+		if (failed) {
+			throw std::runtime_error("Lil_UCB: " + error_message);
+		}
+
+		pulls_done += batch_pulls;
+		total_num_pulls += batch_pulls;
+
+		// Put the arms back with their real evaluations, and check
+		// for the termination criterion. Only arms that were pulled
+		// could have reached it.
+		recordholder_pulled = 0;
+
+		for (queue_entry & entry: batch) {
+			entry.MAB_eval = get_eval(entry.arm_ref, num_arms);
+			arm_queue.push(entry);
+
+			recordholder_pulled = std::max(recordholder_pulled,
+					entry.arm_ref->get_simulation_count());
+		}
+
+		other_pulled = total_num_pulls - recordholder_pulled;
+
+		if (recordholder_pulled >= 1 + lambda * other_pulled) {
+			return 1;
+		}
+	}
+
+	return (std::min(recordholder_pulled / (1 + lambda * other_pulled),
+				1.0));
+}
+
 template<typename T> double to_seconds(const T & duration) {
 	return std::chrono::duration<double>(duration).count();
 }
@@ -2,6 +2,7 @@
 
 #include "simulator/simulator.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <queue>
@@ -44,6 +45,9 @@ class Lil_UCB {
 		// Used for timed pulls.
 		double pulls_per_second;
 
+		// Number of arms simulated at once. See set_num_threads.
+		size_t num_threads;
+
 		// First define some shim functions used to pretend that a simulator always
 		// is maximizing (higher score is better).
 
@@ -59,8 +63,18 @@ class Lil_UCB {
 			double sigma_sq) const;
 
 		double get_eval(arm_ptr_t & arm, size_t num_arms) {
-			return (get_adjusted_mean(arm) + C(arm->get_simulation_count(),
-						num_arms, arm->variance_proxy()));
+			return (get_eval(arm, num_arms, 0));
+		}
+
+		// The evaluation of an arm that has in_flight pulls underway.
+		// They count towards the number of plays (shrinking the
+		// exploration bonus) but not towards the mean, since we don't
+		// know their results yet. This keeps the batch from being
+		// spent on the same arm over and over.
+		double get_eval(arm_ptr_t & arm, size_t num_arms,
+			size_t in_flight) {
+			return (get_adjusted_mean(arm) + C(arm->get_simulation_count()
+						+ in_flight, num_arms, arm->variance_proxy()));
 		}
 
 		queue_entry create_queue_entry(arm_ptr_t arm,
@@ -72,6 +86,11 @@ class Lil_UCB {
 			return (out);
 		}
 
+		double pull_bandit_arms_serial(size_t max_pulls,
+			bool show_status);
+		double pull_bandit_arms_batched(size_t max_pulls,
+			bool show_status);
+
 	public:
 		// This parameter determines how sure we want to be
 		// that the identified best arm is actually best. The
@@ -81,13 +100,30 @@ class Lil_UCB {
 			delta = delta_in;
 		}
 
+		// If the number of threads is more than one, every round
+		// picks that many pulls at once, simulates them in parallel,
+		// and then applies the results. Every arm is only simulated by
+		// one thread at a time, but different arms are simulated
+		// concurrently, so the arms must not share mutable state (such
+		// as an entropy source or a ballot generator with a cache).
+		// philox_rng::split can give each arm its own entropy stream.
+		void set_num_threads(size_t num_threads_in) {
+			num_threads = std::max((size_t)1, num_threads_in);
+		}
+
+		size_t get_num_threads() const {
+			return num_threads;
+		}
+
 		Lil_UCB(double delta_in) {
 			pulls_per_second = 1;
+			num_threads = 1;
 			set_accuracy(delta_in);
 		}
 
 		Lil_UCB() {
 			pulls_per_second = 1;
+			num_threads = 1;
 			set_accuracy(0.01); // Default
 		}
 
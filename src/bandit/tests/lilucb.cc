@@ -0,0 +1,57 @@
+// Check that the batched (multithreaded) lil'UCB finds the best arm, and that
+// its result only depends on the number of threads.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bandit/lilucb.h"
+#include "simulator/stubs/bernoulli.h"
+
+// Ten Bernoulli arms, with the best (p = 0.9) in the middle. Every arm has
+// its own seeded rng so they can be simulated concurrently.
+std::vector<arm_ptr_t> get_test_arms() {
+	std::vector<arm_ptr_t> arms;
+
+	for (size_t i = 0; i < 10; ++i) {
+		double p = 0.3 + 0.02 * i;
+		if (i == 5) {
+			p = 0.9;
+		}
+		arms.push_back(std::make_shared<bernoulli_stub>(p, i + 1));
+	}
+
+	return arms;
+}
+
+TEST(LilUCB, BatchedFindsBestArm) {
+	std::vector<arm_ptr_t> arms = get_test_arms();
+
+	Lil_UCB bandit;
+	bandit.set_num_threads(4);
+	bandit.load_arms(arms);
+
+	EXPECT_EQ(bandit.pull_bandit_arms(100000, false), 1);
+	EXPECT_EQ(bandit.get_best_arm_so_far(), arms[5]);
+}
+
+TEST(LilUCB, BatchedIsDeterministic) {
+	std::vector<arm_ptr_t> first_arms = get_test_arms(),
+		second_arms = get_test_arms();
+
+	Lil_UCB first, second;
+	first.set_num_threads(3);
+	second.set_num_threads(3);
+	first.load_arms(first_arms);
+	second.load_arms(second_arms);
+
+	first.pull_bandit_arms(500, false);
+	second.pull_bandit_arms(500, false);
+
+	EXPECT_EQ(first.get_total_num_pulls(), second.get_total_num_pulls());
+
+	for (size_t i = 0; i < first_arms.size(); ++i) {
+		EXPECT_EQ(first_arms[i]->get_simulation_count(),
+			second_arms[i]->get_simulation_count());
+	}
+}
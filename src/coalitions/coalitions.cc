@@ -1,202 +1,338 @@
 #include "coalitions.h"
 #include "tools/tools.h"
 
-#include <iterator>
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <stdint.h>
 
 // TODO: Update comments and combine DAC and DSC functions to make HDSC.
-// The DAC function really needs some OPTIMIZATION!
 
-std::vector<coalition_data> get_solid_coalitions(
-	const election_t & elections,
-	const std::vector<bool> & hopefuls, int numcands) {
+// A hash table from coalitions to their support, using open addressing
+// with linear probing. Every ballot adds to at least as many coalitions as
+// it has ranks, so this is where most of the time goes; keeping the keys
+// in flat arrays avoids allocating a node per coalition.
+
+class coalition_counter {
+	private:
+		std::vector<coalition_mask> coalitions;
+		std::vector<double> support;
+		std::vector<bool> occupied;
+		size_t num_coalitions;
+		std::hash<coalition_mask> hasher;
+
+		// The table size is always a power of two.
+		size_t find_slot(const coalition_mask & coalition) const {
+			size_t slot = hasher(coalition) & (coalitions.size() - 1);
+
+			while (occupied[slot] && coalitions[slot] != coalition) {
+				slot = (slot + 1) & (coalitions.size() - 1);
+			}
+
+			return slot;
+		}
+
+		void grow() {
+			coalition_counter larger(2 * coalitions.size());
+
+			for (size_t slot = 0; slot < coalitions.size(); ++slot) {
+				if (occupied[slot]) {
+					larger.add(coalitions[slot], support[slot]);
+				}
+			}
+
+			*this = std::move(larger);
+		}
+
+	public:
+		void add(const coalition_mask & coalition, double weight) {
+			size_t slot = find_slot(coalition);
+
+			if (!occupied[slot]) {
+				// Keep the load factor below one half.
+				if (2 * (num_coalitions + 1) > coalitions.size()) {
+					grow();
+					slot = find_slot(coalition);
+				}
+
+				occupied[slot] = true;
+				coalitions[slot] = coalition;
+				support[slot] = 0;
+				++num_coalitions;
+			}
+
+			support[slot] += weight;
+		}
+
+		std::vector<coalition_mask_data> get_sorted_coalitions() const;
+
+		coalition_counter(size_t table_size) : coalitions(table_size),
+			support(table_size), occupied(table_size, false) {
+
+			num_coalitions = 0;
+		}
+
+		coalition_counter() : coalition_counter(64) {}
+};
+
+// Returns true if the members of a, in ascending order, come before the
+// members of b lexicographically.
+static bool lexicographically_less(const coalition_mask & a,
+	const coalition_mask & b) {
 
-	// Go through the ballot set, incrementing the coalition counts.
+	coalition_mask difference = a ^ b;
 
-	std::map<std::set<size_t>, double> coalition_count;
-	std::set<size_t> current_coalition, all_candidates;
+	if (difference.none()) {
+		return false;
+	}
+
+	size_t first_difference = 0;
+	while (!difference.test(first_difference)) {
+		++first_difference;
+	}
+
+	// The coalition that has the first differing member comes first,
+	// unless the other has no members left after it, in which case the
+	// other is a prefix of it.
+	if (a.test(first_difference)) {
+		return (b >> first_difference).any();
+	} else {
+		return (a >> first_difference).none();
+	}
+}
+
+std::vector<coalition_mask_data>
+coalition_counter::get_sorted_coalitions() const {
+
+	std::vector<coalition_mask_data> sorted;
+	sorted.reserve(num_coalitions);
+
+	for (size_t slot = 0; slot < coalitions.size(); ++slot) {
+		if (occupied[slot]) {
+			sorted.push_back(coalition_mask_data(support[slot],
+					coalitions[slot]));
+		}
+	}
+
+	std::sort(sorted.begin(), sorted.end(),
+		[](const coalition_mask_data & a, const coalition_mask_data & b) {
+		if (a.support != b.support) {
+			return (a.support > b.support);
+		}
+		return lexicographically_less(a.coalition, b.coalition);
+	});
+
+	return sorted;
+}
+
+static coalition_mask get_hopeful_mask(const std::vector<bool> & hopefuls,
+	int numcands) {
+
+	if (numcands > (int)MAX_COALITION_CANDIDATES) {
+		throw std::out_of_range("Coalitions: too many candidates");
+	}
+
+	coalition_mask all_hopefuls;
 
 	for (int i = 0; i < numcands; ++i) {
 		if (hopefuls[i]) {
-			all_candidates.insert(i);
+			all_hopefuls.set(i);
 		}
 	}
 
-	for (election_t::const_iterator ballot = elections.begin();
-		ballot != elections.end(); ++ballot) {
+	return all_hopefuls;
+}
 
-		current_coalition.clear();
+// Get the level sets of a ballot: the hopefuls the voter ranked equal,
+// from the top down. Levels with no hopefuls are skipped.
 
-		ordering::const_iterator opos = ballot->contents.begin();
+static void get_level_sets(const ballot_group & ballot,
+	const std::vector<bool> & hopefuls,
+	std::vector<std::vector<size_t> > & level_sets) {
 
-		while (opos != ballot->contents.end()) {
-			// The invariant is that we start at something that is
-			// strictly lower ranked than every candidate closer to
-			// pos->contents.begin().
+	level_sets.clear();
+	bool new_level = true;
 
-			// Skip past any eliminated candidates.
-			if (!hopefuls[opos->get_candidate_num()]) {
-				++opos;
-			}
+	for (ordering::const_iterator pos = ballot.contents.begin();
+		pos != ballot.contents.end(); ++pos) {
 
-			double current_score = opos->get_score();
+		if (pos != ballot.contents.begin() &&
+			pos->get_score() != std::prev(pos)->get_score()) {
+			new_level = true;
+		}
 
-			for (; opos != ballot->contents.end() &&
-				opos->get_score() == current_score; ++opos) {
-				if (hopefuls[opos->get_candidate_num()]) {
-					current_coalition.insert(opos->get_candidate_num());
-				}
+		if (!hopefuls[pos->get_candidate_num()]) {
+			continue;
+		}
+
+		if (new_level) {
+			level_sets.push_back(std::vector<size_t>());
+			new_level = false;
+		}
+
+		level_sets.back().push_back(pos->get_candidate_num());
+	}
+}
+
+std::vector<coalition_mask_data> get_solid_coalition_masks(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands) {
+
+	coalition_mask all_hopefuls = get_hopeful_mask(hopefuls, numcands);
+
+	// Go through the ballot set, incrementing the coalition counts. Each
+	// level set adds to the coalition of every hopeful ranked at or above
+	// it.
+
+	coalition_counter coalition_count;
+	std::vector<std::vector<size_t> > level_sets;
+
+	for (const ballot_group & ballot: election) {
+		coalition_mask current_coalition;
+
+		get_level_sets(ballot, hopefuls, level_sets);
+
+		for (const std::vector<size_t> & level_set: level_sets) {
+			for (size_t candidate: level_set) {
+				current_coalition.set(candidate);
 			}
 
-			coalition_count[current_coalition] += ballot->get_weight();
+			coalition_count.add(current_coalition, ballot.get_weight());
 		}
 
 		// If the ballot is truncated, add the coalition of all candidates
 		// also.
 
-		if (current_coalition.size() != (size_t)numcands) {
-			coalition_count[all_candidates] += ballot->get_weight();
+		if (current_coalition != all_hopefuls) {
+			coalition_count.add(all_hopefuls, ballot.get_weight());
 		}
 	}
 
-	// Convert the coalition counts into an array form that we can sort by
-	// support. The actual sorting happens inside get_candidate_score.
-
-	std::vector<coalition_data> coalitions;
-	for (std::map<std::set<size_t>, double>::const_iterator
-		pos = coalition_count.begin(); pos != coalition_count.end();
-		++pos) {
-		coalitions.push_back(coalition_data(pos->second, pos->first));
-	}
-
-	std::sort(coalitions.begin(), coalitions.end(),
-		std::greater<coalition_data>());
-
-	return coalitions;
+	return coalition_count.get_sorted_coalitions();
 }
 
-// Descending Acquiescing Coalitions helper. This can probably be
-// optimized further (later).
+// Descending Acquiescing Coalitions helper.
 
 // The general idea is that for each ballot we create a list of level
 // sets: candidates ranked equal by that voter. Then for each level
 // set, we add one to every coalition consisting of every candidate in
-// higher-ranked level sets, in addition to a subset of the/ current
-// level set, recursively.
-
-// Recursive helper for adding every subset of the current level set.
-void add_acquiescing_coalition(
-	double ballot_weight,
-	const std::vector<int> & current_level_set,
-	size_t position, size_t level_set_size,
-	size_t included_elements, std::set<size_t> & current_coalition,
-	std::map<std::set<size_t>, double> & coalition_count) {
-
-
-	// We've gone through the whole level set, get ready
-	// to increment the coalition count.
-	if (position == level_set_size) {
-		// But only if we added at least one element from the
-		// current level set.
-		if (included_elements > 0) {
-			coalition_count[current_coalition] += ballot_weight;
-		}
-		return;
-	}
+// higher-ranked level sets, in addition to a nonempty subset of the
+// current level set.
 
-	// Pick the current level set member, recurse, then remove it
-	// and recurse again.
-	current_coalition.insert(current_level_set[position]);
-	add_acquiescing_coalition(ballot_weight, current_level_set,
-		position+1, level_set_size, included_elements+1,
-		current_coalition, coalition_count);
-	current_coalition.erase(current_level_set[position]);
-	add_acquiescing_coalition(ballot_weight, current_level_set,
-		position+1, level_set_size, included_elements,
-		current_coalition, coalition_count);
-}
+// The subsets are visited in Gray code order, so that each differs from the
+// last by one member and we only need to flip one bit to get the next.
 
-std::vector<coalition_data> get_acquiescing_coalitions(
-	const election_t & elections,
-	const std::vector<bool> & hopefuls, int numcands) {
+static void add_acquiescing_coalitions(double ballot_weight,
+	const std::vector<size_t> & level_set,
+	const coalition_mask & higher_ranked,
+	coalition_counter & coalition_count) {
 
-	std::map<std::set<size_t>, double> coalition_count;
+	if (level_set.size() >= 64) {
+		throw std::out_of_range("Coalitions: too many candidates ranked "
+			"equal to enumerate acquiescing coalitions");
+	}
 
-	std::set<size_t> all_candidates;
+	coalition_mask current_coalition = higher_ranked;
+	uint64_t num_subsets = (uint64_t)1 << level_set.size();
 
-	for (int i = 0; i < numcands; ++i) {
-		if (hopefuls[i]) {
-			all_candidates.insert(i);
-		}
+	for (uint64_t subset = 1; subset < num_subsets; ++subset) {
+		current_coalition.flip(level_set[__builtin_ctzll(subset)]);
+		coalition_count.add(current_coalition, ballot_weight);
 	}
+}
 
-	for (election_t::const_iterator ballot = elections.begin();
-		ballot != elections.end(); ++ballot) {
+std::vector<coalition_mask_data> get_acquiescing_coalition_masks(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands) {
 
-		// Create the level sets.
-		std::vector<std::vector<int> > level_sets;
-		std::vector<int> current_level_set;
-		std::set<size_t> remaining_candidates = all_candidates;
+	coalition_mask all_hopefuls = get_hopeful_mask(hopefuls, numcands);
 
-		ordering::const_iterator pos = ballot->contents.begin(),
-								 level_start = pos;
+	coalition_counter coalition_count;
+	std::vector<std::vector<size_t> > level_sets;
 
-		while (level_start != ballot->contents.end()) {
-			pos = level_start;
-			while (pos != ballot->contents.end() &&
-				pos->get_score() == level_start->get_score()) {
-				if (hopefuls[pos->get_candidate_num()]) {
-					current_level_set.push_back(pos->get_candidate_num());
-					remaining_candidates.erase(pos->get_candidate_num());
-				}
-				++pos;
-			}
-			// Now we're either at the end or the candidate
-			// no longer has the score that every candidate in
-			// the current level set has got. In either case, the
-			// current level set is done - get ready to start a new one.
-
-			// An empty set can happen if there were no hopefuls at this
-			// level. If so, ignore it.
-			if (!current_level_set.empty()) {
-				level_sets.push_back(current_level_set);
+	for (const ballot_group & ballot: election) {
+		get_level_sets(ballot, hopefuls, level_sets);
+
+		coalition_mask current_coalition;
+
+		for (const std::vector<size_t> & level_set: level_sets) {
+			for (size_t candidate: level_set) {
+				current_coalition.set(candidate);
 			}
-			current_level_set.clear();
-			level_start = pos;
 		}
 
 		// Insert the remaining candidates set as the final level set
 		// if it's nonempty. This handles truncation.
-		if (!remaining_candidates.empty()) {
-			level_sets.push_back(std::vector<int>(remaining_candidates.begin(),
-					remaining_candidates.end()));
+		coalition_mask remaining_candidates = all_hopefuls &
+			~current_coalition;
+
+		if (remaining_candidates.any()) {
+			level_sets.push_back(std::vector<size_t>());
+			for (int i = 0; i < numcands; ++i) {
+				if (remaining_candidates.test(i)) {
+					level_sets.back().push_back(i);
+				}
+			}
 		}
 
 		// For each level set: process that level set, then add the whole
 		// set into the current_coalition set, as every higher level set
 		// needs to be included in later acquiescing coalitions.
 
-		std::set<size_t> current_coalition;
+		current_coalition.reset();
 
-		for (const std::vector<int> & level_set: level_sets) {
-			add_acquiescing_coalition(ballot->get_weight(),
-				level_set, 0, level_set.size(), 0, current_coalition,
-				coalition_count);
-			std::copy(level_set.begin(), level_set.end(), std::inserter(
-					current_coalition, current_coalition.begin()));
+		for (const std::vector<size_t> & level_set: level_sets) {
+			add_acquiescing_coalitions(ballot.get_weight(), level_set,
+				current_coalition, coalition_count);
+
+			for (size_t candidate: level_set) {
+				current_coalition.set(candidate);
+			}
 		}
 	}
 
+	return coalition_count.get_sorted_coalitions();
+}
+
+static std::vector<coalition_data> masks_to_sets(
+	const std::vector<coalition_mask_data> & mask_coalitions,
+	int numcands) {
+
 	std::vector<coalition_data> coalitions;
-	for (std::map<std::set<size_t>, double>::const_iterator
-		pos = coalition_count.begin(); pos != coalition_count.end();
-		++pos) {
-		coalitions.push_back(coalition_data(pos->second, pos->first));
+	coalitions.reserve(mask_coalitions.size());
+
+	for (const coalition_mask_data & mask_coalition: mask_coalitions) {
+		std::set<size_t> members;
+		for (int i = 0; i < numcands; ++i) {
+			if (mask_coalition.coalition.test(i)) {
+				members.insert(members.end(), i);
+			}
+		}
+		coalitions.push_back(coalition_data(mask_coalition.support,
+				members));
 	}
 
 	return coalitions;
 }
 
+std::vector<coalition_data> get_solid_coalitions(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands) {
+
+	return masks_to_sets(get_solid_coalition_masks(election, hopefuls,
+				numcands), numcands);
+}
+
+std::vector<coalition_data> get_acquiescing_coalitions(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands) {
+
+	return masks_to_sets(get_acquiescing_coalition_masks(election,
+				hopefuls, numcands), numcands);
+}
+
 void print_coalitions(const std::vector<coalition_data> & coalitions) {
 
 	for (const coalition_data & cc: coalitions) {
@@ -211,4 +347,4 @@ void print_coalitions(const std::vector<coalition_data> & coalitions) {
 		}
 		std::cout << "}\n";
 	}
-}
\ No newline at end of file
+}
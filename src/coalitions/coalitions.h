@@ -6,16 +6,38 @@
 // also used for determining sets based on solid coalitions (such as the
 // mutual majority set).
 
-// Helper class. Coalition X is greater than Y if X's support is greater, or
-// if it's equal and X contains the priority candidate whereas Y does not.
-// The priority candidate mechanism is used for tiebreaks in Descending Solid
-// Coalitions. (Maybe it should be separated out.)
+// The coalitions are counted as bitmasks (bit x set if candidate x is in
+// the coalition) in a hash table, so there can be at most
+// MAX_COALITION_CANDIDATES candidates. Methods that only need to intersect
+// coalitions should use the mask versions; the coalition_data versions
+// give each coalition as a set, for callers that want one.
 
+#include <bitset>
 #include <set>
 #include <vector>
 
 #include "common/ballots.h"
 
+const size_t MAX_COALITION_CANDIDATES = 128;
+typedef std::bitset<MAX_COALITION_CANDIDATES> coalition_mask;
+
+class coalition_mask_data {
+	public:
+		coalition_mask coalition;
+		double support;
+
+		coalition_mask_data(double support_in,
+			const coalition_mask & coalition_in) {
+			coalition = coalition_in;
+			support = support_in;
+		}
+};
+
+// Helper class. Coalition X is greater than Y if X's support is greater, or
+// if it's equal and X contains the priority candidate whereas Y does not.
+// The priority candidate mechanism is used for tiebreaks in Descending Solid
+// Coalitions. (Maybe it should be separated out.)
+
 class coalition_data {
 	public:
 		std::set<size_t> coalition;
@@ -39,7 +61,18 @@ class coalition_data {
 		}
 };
 
-// Should we put this in a class instead?
+// Both the mask and set versions return the coalitions sorted by descending
+// support, with ties broken by the lexicographic order of the members.
+// They throw std::out_of_range if there are more than
+// MAX_COALITION_CANDIDATES candidates.
+
+std::vector<coalition_mask_data> get_solid_coalition_masks(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands);
+
+std::vector<coalition_mask_data> get_acquiescing_coalition_masks(
+	const election_t & election,
+	const std::vector<bool> & hopefuls, int numcands);
 
 std::vector<coalition_data> get_solid_coalitions(
 	const election_t & election,
@@ -49,4 +82,4 @@ std::vector<coalition_data> get_acquiescing_coalitions(
 	const election_t & election,
 	const std::vector<bool> & hopefuls, int numcands);
 
-void print_coalitions(const std::vector<coalition_data> & coalitions);
\ No newline at end of file
+void print_coalitions(const std::vector<coalition_data> & coalitions);
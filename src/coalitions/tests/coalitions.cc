@@ -0,0 +1,106 @@
+// Tests for solid and acquiescing coalition counting, and for the
+// descending coalitions methods built on them.
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "coalitions/coalitions.h"
+#include "singlewinner/desc_coalitions/dac.h"
+#include "singlewinner/desc_coalitions/dsc.h"
+
+// Make a ballot from candidates listed from first to last. Candidates in
+// the same inner vector are ranked equal.
+static ballot_group get_ballot(double weight,
+	const std::vector<std::vector<size_t> > & ranks) {
+
+	ballot_group ballot(weight);
+	int score = ranks.size();
+
+	for (const std::vector<size_t> & rank: ranks) {
+		for (size_t candidate: rank) {
+			ballot.contents.insert(candscore(candidate, score));
+		}
+		--score;
+	}
+
+	return ballot;
+}
+
+static std::map<std::set<size_t>, double> get_support(
+	const std::vector<coalition_data> & coalitions) {
+
+	std::map<std::set<size_t>, double> support;
+
+	for (const coalition_data & coalition: coalitions) {
+		support[coalition.coalition] = coalition.support;
+	}
+
+	return support;
+}
+
+TEST(Coalitions, SolidSkipsEliminatedCandidates) {
+	// Candidates 1 and 2 are eliminated and ranked equal to each other,
+	// and candidate 4 is left off the ballot.
+	election_t election = {get_ballot(3, {{0}, {1, 2}, {3}})};
+	std::vector<bool> hopefuls = {true, false, false, true, true};
+
+	std::map<std::set<size_t>, double> expected = {
+		{{0}, 3}, {{0, 3}, 3}, {{0, 3, 4}, 3}
+	};
+
+	EXPECT_EQ(get_support(get_solid_coalitions(election, hopefuls, 5)),
+		expected);
+}
+
+TEST(Coalitions, Acquiescing) {
+	election_t election = {get_ballot(1, {{0}, {1, 2}}),
+			get_ballot(2, {{1}})
+		};
+	std::vector<bool> hopefuls(3, true);
+
+	std::map<std::set<size_t>, double> expected = {
+		{{0}, 1}, {{0, 1}, 3}, {{0, 2}, 1}, {{0, 1, 2}, 3},
+		{{1}, 2}, {{1, 2}, 2}
+	};
+
+	std::vector<coalition_data> coalitions = get_acquiescing_coalitions(
+			election, hopefuls, 3);
+
+	EXPECT_EQ(get_support(coalitions), expected);
+
+	for (size_t i = 1; i < coalitions.size(); ++i) {
+		EXPECT_GE(coalitions[i-1].support, coalitions[i].support);
+	}
+}
+
+TEST(Coalitions, TooManyCandidates) {
+	size_t numcands = MAX_COALITION_CANDIDATES + 1;
+
+	EXPECT_THROW(get_solid_coalitions(election_t(),
+			std::vector<bool>(numcands, true), numcands), std::out_of_range);
+}
+
+// The test vector from dsc.h: A and C can both win depending on how ties
+// between coalitions of equal support are broken, and B can't.
+TEST(DescendingCoalitions, WoodallExample) {
+	election_t election = {get_ballot(16, {{0}, {1}, {2}}),
+			get_ballot(29, {{0}, {2}, {1}}),
+			get_ballot(20, {{1}, {0}, {2}}),
+			get_ballot(18, {{1}, {2}, {0}}),
+			get_ballot(17, {{2}, {0}, {1}}),
+			get_ballot(27, {{2}, {1}, {0}})
+		};
+
+	ordering expected = {candscore(0, 3), candscore(2, 3),
+			candscore(1, 2)
+		};
+
+	EXPECT_EQ(dsc().elect(election, 3), expected);
+
+	// With complete strict ballots, acquiescing and solid coalitions
+	// are the same.
+	EXPECT_EQ(dac().elect(election, 3), dsc().elect(election, 3));
+}
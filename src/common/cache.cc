@@ -1,4 +1,3 @@
-#include <unordered_map>
 #include <vector>
 #include <map>
 
@@ -8,16 +7,15 @@
 
 #include "cache.h"
 
-bool cache_map::has_outcome(const std::string & name) const {
-	return (outcomes.find(name) != outcomes.end());
+bool cache_map::has_outcome(method_id_t id) const {
+	return (is_current(id));
 }
 
 // Winner_only will also accept a full ordering, so if w_o is true, this
 // reduces to the above function. Otherwise, we check that a full ranking is
 // indeed available.
-bool cache_map::has_outcome(const std::string & name,
-	bool winner_only) const {
-	bool at_all = has_outcome(name);
+bool cache_map::has_outcome(method_id_t id, bool winner_only) const {
+	bool at_all = has_outcome(id);
 
 	if (winner_only) {
 		return (at_all);
@@ -26,7 +24,7 @@ bool cache_map::has_outcome(const std::string & name,
 		return (false);
 	}
 
-	return (!outcomes.find(name)->second.first.empty());
+	return (!outcomes[id].first.empty());
 }
 
 // Condorcet matrix caching.
@@ -58,7 +56,145 @@ cache_condmat cache_map::get_condorcet_cache(pairwise_type kind) const {
 }
 
 
+bool cache_map::get_key(const std::vector<bool> & hopefuls, uint64_t param,
+	cache_key & key) const {
+
+	if (hopefuls.size() > 64) {
+		return (false);
+	}
+
+	key.hopefuls_mask = 0;
+	for (size_t cand = 0; cand < hopefuls.size(); ++cand) {
+		if (hopefuls[cand]) {
+			key.hopefuls_mask |= (uint64_t)1 << cand;
+		}
+	}
+
+	key.param = param;
+	key.num_candidates = hopefuls.size();
+
+	return (true);
+}
+
+std::pair<ordering, bool> cache_map::get_outcome(method_id_t id,
+	const std::vector<bool> & hopefuls, bool winner_only) const {
+
+	cache_key key;
+	auto lookup = hopefuls_outcomes.end();
+
+	if (get_key(hopefuls, id, key)) {
+		lookup = hopefuls_outcomes.find(key);
+	}
+
+	if (lookup == hopefuls_outcomes.end()) {
+		return (std::pair<ordering, bool>(ordering(), false));
+	}
+
+	if (!lookup->second.first.empty()) {
+		return (std::pair<ordering, bool>(lookup->second.first, false));
+	}
+
+	if (winner_only && !lookup->second.second.empty()) {
+		return (std::pair<ordering, bool>(lookup->second.second, true));
+	}
+
+	return (std::pair<ordering, bool>(lookup->second.first, false));
+}
+
+void cache_map::set_outcome(method_id_t id,
+	const std::vector<bool> & hopefuls,
+	const std::pair<ordering, bool> & outcome_inf) {
+
+	cache_key key;
+
+	if (!get_key(hopefuls, id, key)) {
+		return;
+	}
+
+	if (outcome_inf.second) {
+		hopefuls_outcomes[key].second = outcome_inf.first;
+	} else {
+		hopefuls_outcomes[key].first = outcome_inf.first;
+	}
+}
+
+// The param packs the positional type and zero run advice together. The
+// advice is -1 for a full matrix, hence the +1.
+
+static uint64_t positional_param(positional_type kind,
+	int zero_run_advice) {
+	return ((uint64_t)kind << 32) | (uint32_t)(zero_run_advice + 1);
+}
+
+const std::vector<std::vector<double> > * cache_map::get_positional_matrix(
+	positional_type kind, int zero_run_advice,
+	const std::vector<bool> & hopefuls) const {
+
+	cache_key key;
+
+	if (!get_key(hopefuls, positional_param(kind, zero_run_advice), key)) {
+		return (NULL);
+	}
+
+	auto lookup = positional_matrices.find(key);
+
+	if (lookup == positional_matrices.end() && zero_run_advice > 0) {
+		key.param = positional_param(kind, -1);
+		lookup = positional_matrices.find(key);
+	}
+
+	if (lookup == positional_matrices.end()) {
+		return (NULL);
+	}
+
+	return (&lookup->second);
+}
+
+void cache_map::set_positional_matrix(positional_type kind,
+	int zero_run_advice, const std::vector<bool> & hopefuls,
+	const std::vector<std::vector<double> > & matrix) {
+
+	cache_key key;
+
+	if (get_key(hopefuls, positional_param(kind, zero_run_advice), key)) {
+		positional_matrices[key] = matrix;
+	}
+}
+
+const beatpath * cache_map::get_beatpath(pairwise_ident input_type,
+	const std::vector<bool> & hopefuls) const {
+
+	cache_key key;
+
+	if (!get_key(hopefuls, input_type, key)) {
+		return (NULL);
+	}
+
+	auto lookup = beatpaths.find(key);
+
+	if (lookup == beatpaths.end()) {
+		return (NULL);
+	}
+
+	return (&lookup->second);
+}
+
+void cache_map::set_beatpath(pairwise_ident input_type,
+	const std::vector<bool> & hopefuls, const beatpath & bpath) {
+
+	cache_key key;
+
+	if (get_key(hopefuls, input_type, key)) {
+		beatpaths.erase(key);
+		beatpaths.emplace(key, bpath);
+	}
+}
+
 void cache_map::clear() {
-	outcomes.clear();
+	// Invalidates every outcome without freeing anything.
+	++generation;
 	condorcet_cache.clear();
+	hopefuls_outcomes.clear();
+	positional_matrices.clear();
+	beatpaths.clear();
 }
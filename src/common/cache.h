@@ -1,31 +1,87 @@
 // Extended cache for methods testing. Currently we cache:
-// 	- outcomes
-// 	- pairwise matrices.
-// TODO: Generalize so we can store all sorts of stuff, e.g. positional
-// matrices, Range arrays, Plur counts with eliminated candidates, you name it.
+// 	- outcomes, both with every candidate hopeful and with some excluded
+// 	- pairwise matrices
+// 	- positional matrices per hopefuls set (and thus Plurality counts with
+// 		eliminated candidates, since those are the first column)
+// 	- beatpath matrices per hopefuls set.
+// TODO: Range arrays.
 //
 // The cache helps cut down on time when we want to find out the same result
 // many times, such as with determining the Smith set for numerous Smith,X
 // methods.
 
+// Nothing in the cache records what ballots it was computed from, so a
+// cache_map must only ever be used with the same ballots until it's cleared.
+// Methods that elect on ballots of their own making (e.g. the filters in
+// singlewinner/meta/filters) must not pass the caller's cache on to the
+// methods they elect with.
+
+// Everything that depends on which candidates are hopeful is keyed by the
+// hopefuls as a bitmask, so those caches only work with up to 64 candidates.
+// With more, the get functions always miss and the set functions do nothing,
+// which is slow but correct.
+
+// Outcomes are indexed by interned method ID (see method_id.h), so a lookup
+// is an array access. Each entry is stamped with the generation it was set
+// in, and clearing the cache just starts a new generation; that way, clearing
+// doesn't touch (or free) every entry, and the orderings keep their capacity
+// from round to round.
+
 #ifndef _VOTE_CACHE
 #define _VOTE_CACHE
 
-#include <unordered_map>
+#include <algorithm>
 #include <vector>
 #include <map>
 
 #include "tools/ballot_tools.h"
 #include "pairwise/matrix.h"
 #include "pairwise/cache_matrix.h"
+#include "pairwise/beatpath.h"
+#include "singlewinner/positional/types.h"
+#include "method_id.h"
+
+#include <unordered_map>
 
 // This is for the outcome. First is full, second is winner only.
 typedef std::pair<ordering, ordering> cache_orderings;
 
+// Key for the caches that depend on the hopefuls. What param means depends
+// on the cache: method ID for outcomes, type and zero run for positional
+// matrices, and the input's pairwise type for beatpaths.
+struct cache_key {
+	uint64_t hopefuls_mask;
+	uint64_t param;
+	size_t num_candidates;
+
+	bool operator==(const cache_key & other) const {
+		return hopefuls_mask == other.hopefuls_mask &&
+			param == other.param &&
+			num_candidates == other.num_candidates;
+	}
+};
+
+struct cache_key_hash {
+	size_t operator()(const cache_key & key) const {
+		// Multiply-xorshift mixing; good enough for a hash table.
+		uint64_t h = key.hopefuls_mask * 0x9E3779B97F4A7C15ULL;
+		h ^= (key.param + (h << 6) + (h >> 2)) * 0xBF58476D1CE4E5B9ULL;
+		h ^= key.num_candidates + (h >> 31);
+		return h;
+	}
+};
+
 class cache_map {
 
 	private:
-		std::unordered_map<std::string, cache_orderings> outcomes;
+		std::vector<cache_orderings> outcomes;
+		std::vector<uint64_t> outcome_generation;
+		uint64_t generation;
+
+		bool is_current(method_id_t id) const {
+			return (id < outcome_generation.size() &&
+					outcome_generation[id] == generation);
+		}
 
 		// This is a list so we can detect it if it's empty. We'll
 		// do something more proper later, possibly with links to names
@@ -33,21 +89,89 @@ class cache_map {
 
 		std::list<condmat> condorcet_cache;
 
+		std::unordered_map<cache_key, cache_orderings, cache_key_hash>
+		hopefuls_outcomes;
+		std::unordered_map<cache_key, std::vector<std::vector<double> >,
+			cache_key_hash> positional_matrices;
+		std::unordered_map<cache_key, beatpath, cache_key_hash>
+		beatpaths;
+
+		bool get_key(const std::vector<bool> & hopefuls, uint64_t param,
+			cache_key & key) const;
+
 	public:
+		cache_map() {
+			generation = 1;
+		}
+
 		// The set/get functions are inline because they get called
 		// *a lot*.
 
-		inline void set_outcome(const std::string & name, bool winner_only,
+		inline void set_outcome(method_id_t id, bool winner_only,
 			const ordering & outcome);
-		inline void set_outcome(const std::string & name,
+		inline void set_outcome(method_id_t id,
 			const std::pair<ordering, bool> & outcome_inf);
 
-		bool has_outcome(const std::string & name) const;
-		bool has_outcome(const std::string & name, bool winner_only) const;
+		bool has_outcome(method_id_t id) const;
+		bool has_outcome(method_id_t id, bool winner_only) const;
 
-		inline std::pair<ordering, bool> get_outcome(const std::string & name,
+		inline std::pair<ordering, bool> get_outcome(method_id_t id,
 			bool winner_only) const;
 
+		// By-name versions. These intern the name on every call, so
+		// they're slower; election_method uses the ID versions.
+
+		void set_outcome(const std::string & name, bool winner_only,
+			const ordering & outcome) {
+			set_outcome(method_id_registry::intern(name), winner_only,
+				outcome);
+		}
+		void set_outcome(const std::string & name,
+			const std::pair<ordering, bool> & outcome_inf) {
+			set_outcome(method_id_registry::intern(name), outcome_inf);
+		}
+
+		bool has_outcome(const std::string & name) const {
+			return (has_outcome(method_id_registry::intern(name)));
+		}
+		bool has_outcome(const std::string & name, bool winner_only) const {
+			return (has_outcome(method_id_registry::intern(name),
+						winner_only));
+		}
+
+		std::pair<ordering, bool> get_outcome(const std::string & name,
+			bool winner_only) const {
+			return (get_outcome(method_id_registry::intern(name),
+						winner_only));
+		}
+
+		// Outcomes with some candidates excluded. The get function
+		// behaves like the one above; set_outcome does nothing if
+		// there are too many candidates.
+		std::pair<ordering, bool> get_outcome(method_id_t id,
+			const std::vector<bool> & hopefuls, bool winner_only) const;
+		void set_outcome(method_id_t id, const std::vector<bool> & hopefuls,
+			const std::pair<ordering, bool> & outcome_inf);
+
+		// Positional matrices, as produced by positional_aggregator.
+		// Returns NULL if there's no matrix for these parameters. If
+		// we're asked for a truncated matrix (zero_run_advice > 0) and
+		// only have the full one, we return the full one, since the
+		// extra columns are given zero weight anyway.
+		const std::vector<std::vector<double> > * get_positional_matrix(
+			positional_type kind, int zero_run_advice,
+			const std::vector<bool> & hopefuls) const;
+		void set_positional_matrix(positional_type kind,
+			int zero_run_advice, const std::vector<bool> & hopefuls,
+			const std::vector<std::vector<double> > & matrix);
+
+		// Beatpath matrices for a pairwise matrix of the given type,
+		// as used by Schulze. Returns NULL if there's none.
+		const beatpath * get_beatpath(pairwise_ident input_type,
+			const std::vector<bool> & hopefuls) const;
+		void set_beatpath(pairwise_ident input_type,
+			const std::vector<bool> & hopefuls, const beatpath & bpath);
+
 		// Condorcet cache
 
 		bool set_condorcet_matrix(const condmat & input);
@@ -60,21 +184,36 @@ class cache_map {
 // Inline functions go here because otherwise the compiler can't find them in
 // time.
 
-inline void cache_map::set_outcome(const std::string & name,
-	bool winner_only,
+inline void cache_map::set_outcome(method_id_t id, bool winner_only,
 	const ordering & outcome) {
 
+	if (id >= outcomes.size()) {
+		// Make room for every method seen so far, not just this one,
+		// so we don't have to grow again for each new method.
+		size_t new_size = std::max((size_t)id + 1,
+				method_id_registry::size());
+		outcomes.resize(new_size);
+		outcome_generation.resize(new_size, 0);
+	}
+
+	// If the entry is left over from before the last clear, empty it.
+	if (!is_current(id)) {
+		outcomes[id].first.clear();
+		outcomes[id].second.clear();
+		outcome_generation[id] = generation;
+	}
+
 	if (winner_only) {
-		outcomes[name].second = outcome;
+		outcomes[id].second = outcome;
 	} else {
-		outcomes[name].first = outcome;
+		outcomes[id].first = outcome;
 	}
 }
 
-inline void cache_map::set_outcome(const std::string & name,
+inline void cache_map::set_outcome(method_id_t id,
 	const std::pair<ordering, bool> & outcome_inf) {
 
-	set_outcome(name, outcome_inf.second, outcome_inf.first);
+	set_outcome(id, outcome_inf.second, outcome_inf.first);
 }
 
 // If there's no cache, it'll return empty. Otherwise:
@@ -83,26 +222,24 @@ inline void cache_map::set_outcome(const std::string & name,
 //              otherwise a winner-only, otherwise nothing. (We might want
 //              to make it work the opposite way to uncover bugs with
 //              winner_only, but well.. not yet.)
-inline std::pair<ordering, bool> cache_map::get_outcome(
-	const std::string & name,
+inline std::pair<ordering, bool> cache_map::get_outcome(method_id_t id,
 	bool winner_only) const {
 
-	std::unordered_map<std::string, cache_orderings>::const_iterator lookup =
-		outcomes.find(name);
-
-	if (lookup == outcomes.end()) {
+	if (!is_current(id)) {
 		return (std::pair<ordering, bool>(ordering(), false));
 	}
 
-	if (!lookup->second.first.empty()) {
-		return (std::pair<ordering, bool>(lookup->second.first, false));
+	const cache_orderings & lookup = outcomes[id];
+
+	if (!lookup.first.empty()) {
+		return (std::pair<ordering, bool>(lookup.first, false));
 	}
 
-	if (winner_only && !lookup->second.second.empty()) {
-		return (std::pair<ordering, bool>(lookup->second.second, true));
+	if (winner_only && !lookup.second.empty()) {
+		return (std::pair<ordering, bool>(lookup.second, true));
 	}
 
-	return (std::pair<ordering, bool>(lookup->second.first, false));
+	return (std::pair<ordering, bool>(lookup.first, false));
 }
 
 #endif
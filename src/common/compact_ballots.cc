@@ -0,0 +1,161 @@
+#include "compact_ballots.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <numeric>
+
+void compact_election::clear() {
+	candidates.clear();
+	scores.clear();
+	weights.clear();
+	complete.clear();
+	rated.clear();
+
+	offsets.clear();
+	offsets.push_back(0);
+
+	ballot_open = false;
+}
+
+void compact_election::reserve(size_t num_ballots, size_t num_entries) {
+	candidates.reserve(num_entries);
+	scores.reserve(num_entries);
+	offsets.reserve(num_ballots+1);
+	weights.reserve(num_ballots);
+	complete.reserve(num_ballots);
+	rated.reserve(num_ballots);
+}
+
+void compact_election::begin_ballot(double weight, bool complete_in,
+	bool rated_in) {
+
+	if (ballot_open) {
+		throw std::logic_error("compact_election: tried to begin a "
+			"ballot without ending the previous one.");
+	}
+
+	if (weight <= 0) {
+		throw std::out_of_range("Ballot weight must be positive.");
+	}
+
+	weights.push_back(weight);
+	complete.push_back(complete_in);
+	rated.push_back(rated_in);
+	ballot_open = true;
+}
+
+void compact_election::add_ranking(size_t candidate, double score) {
+	if (!ballot_open) {
+		throw std::logic_error("compact_election: add_ranking "
+			"without begin_ballot.");
+	}
+
+	// Same constraints as candscore::set_score.
+	if (!isfinite(score)) {
+		throw std::invalid_argument("compact_election: Scores must "
+			"be finite.");
+	}
+
+	candidates.push_back(candidate);
+	scores.push_back(score);
+}
+
+// Put the entries of the ballot currently being constructed into the order
+// an ordering would have them in, and remove exact duplicates, just as the
+// flat_set would have done.
+void compact_election::sort_last_ballot() {
+	size_t begin = offsets.back(), end = candidates.size();
+
+	// Insertion sort: ballots are short, and the generators often
+	// produce entries that are already nearly sorted.
+	for (size_t i = begin + 1; i < end; ++i) {
+		uint32_t cand = candidates[i];
+		double score = scores[i];
+		size_t j = i;
+
+		while (j > begin && (scores[j-1] < score ||
+				(scores[j-1] == score && candidates[j-1] < cand))) {
+			candidates[j] = candidates[j-1];
+			scores[j] = scores[j-1];
+			--j;
+		}
+
+		candidates[j] = cand;
+		scores[j] = score;
+	}
+
+	size_t out = begin;
+	for (size_t i = begin; i < end; ++i) {
+		if (out != begin && candidates[out-1] == candidates[i] &&
+			scores[out-1] == scores[i]) {
+			continue;
+		}
+		candidates[out] = candidates[i];
+		scores[out] = scores[i];
+		++out;
+	}
+
+	candidates.resize(out);
+	scores.resize(out);
+}
+
+void compact_election::end_ballot() {
+	if (!ballot_open) {
+		throw std::logic_error("compact_election: end_ballot "
+			"without begin_ballot.");
+	}
+
+	sort_last_ballot();
+	offsets.push_back(candidates.size());
+	ballot_open = false;
+}
+
+void compact_election::add_ballot(const ballot_group & in) {
+	// The ordering is already sorted and deduplicated, so there's no
+	// need to go through end_ballot().
+	begin_ballot(in.get_weight(), in.complete, in.rated);
+
+	for (const candscore & cs: in.contents) {
+		candidates.push_back(cs.get_candidate_num());
+		scores.push_back(cs.get_score());
+	}
+
+	offsets.push_back(candidates.size());
+	ballot_open = false;
+}
+
+void compact_election::add_ballots(const election_t & in) {
+	for (const ballot_group & ballot: in) {
+		add_ballot(ballot);
+	}
+}
+
+double compact_election::get_num_voters() const {
+	return std::accumulate(weights.begin(), weights.end(), 0.0);
+}
+
+ballot_group compact_election::get_ballot(size_t ballot) const {
+	ballot_group out(weights[ballot]);
+	out.complete = complete[ballot];
+	out.rated = rated[ballot];
+
+	// The entries are already in order, so hint the insertion at the
+	// end to make it linear.
+	for (size_t entry = ballot_begin(ballot); entry < ballot_end(ballot);
+		++entry) {
+		out.contents.insert(out.contents.end(),
+			candscore(candidates[entry], scores[entry]));
+	}
+
+	return out;
+}
+
+election_t compact_election::to_election() const {
+	election_t out;
+
+	for (size_t ballot = 0; ballot < num_ballots(); ++ballot) {
+		out.push_back(get_ballot(ballot));
+	}
+
+	return out;
+}
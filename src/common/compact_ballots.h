@@ -0,0 +1,104 @@
+#pragma once
+
+// A packed election representation. election_t is a list of ballot groups,
+// each of which holds a flat_set with its own heap allocation, so building
+// and walking an election in a Monte Carlo loop spends most of its time in
+// the allocator and chasing pointers. compact_election instead stores every
+// ballot's (candidate, score) entries back to back in one buffer, with an
+// offsets array marking where each ballot begins and a weights array giving
+// each ballot's weight.
+
+// Entries within a ballot are kept in the same order an ordering would have
+// them: by descending score, then by descending candidate number. Thus
+// anything that walks an ordering from begin() to end() can walk the compact
+// entries from ballot_begin() to ballot_end() instead and get the same
+// result.
+
+// Clearing the election keeps the buffers' capacity, so reusing the same
+// compact_election from round to round doesn't allocate once it has grown
+// large enough.
+
+#include "ballots.h"
+
+#include <stdint.h>
+#include <vector>
+
+class compact_election {
+	private:
+		std::vector<uint32_t> candidates;
+		std::vector<double> scores;
+		// offsets[i] is the first entry of ballot i, and
+		// offsets[num_ballots()] is one past the last entry.
+		std::vector<size_t> offsets;
+		std::vector<double> weights;
+		std::vector<bool> complete, rated;
+
+		bool ballot_open;
+
+		void sort_last_ballot();
+
+	public:
+		compact_election() {
+			clear();
+		}
+
+		explicit compact_election(const election_t & in) {
+			clear();
+			add_ballots(in);
+		}
+
+		void clear();
+		void reserve(size_t num_ballots, size_t num_entries);
+
+		// Direct construction. Call begin_ballot(), then add_ranking()
+		// for every candidate the voter ranked or rated, in any order,
+		// and then end_ballot() to sort the entries into ordering order.
+		void begin_ballot(double weight, bool complete_in,
+			bool rated_in);
+		void add_ranking(size_t candidate, double score);
+		void end_ballot();
+
+		void add_ballot(const ballot_group & in);
+		void add_ballots(const election_t & in);
+
+		size_t num_ballots() const {
+			return weights.size();
+		}
+
+		bool empty() const {
+			return weights.empty();
+		}
+
+		// Entry index range for the given ballot.
+		size_t ballot_begin(size_t ballot) const {
+			return offsets[ballot];
+		}
+		size_t ballot_end(size_t ballot) const {
+			return offsets[ballot+1];
+		}
+		size_t ballot_length(size_t ballot) const {
+			return offsets[ballot+1] - offsets[ballot];
+		}
+
+		size_t get_candidate(size_t entry) const {
+			return candidates[entry];
+		}
+		double get_score(size_t entry) const {
+			return scores[entry];
+		}
+
+		double get_weight(size_t ballot) const {
+			return weights[ballot];
+		}
+		bool is_complete(size_t ballot) const {
+			return complete[ballot];
+		}
+		bool is_rated(size_t ballot) const {
+			return rated[ballot];
+		}
+
+		double get_num_voters() const;
+
+		ballot_group get_ballot(size_t ballot) const;
+		election_t to_election() const;
+};
@@ -0,0 +1,59 @@
+#include "method_id.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// The tables are function-level statics so they're constructed before first
+// use no matter which translation unit asks first.
+
+struct registry_tables {
+	std::mutex lock;
+	std::unordered_map<std::string, method_id_t> ids;
+	std::vector<std::string> names;
+};
+
+static registry_tables & get_tables() {
+	static registry_tables tables;
+	return tables;
+}
+
+method_id_t method_id_registry::intern(const std::string & method_name) {
+	registry_tables & tables = get_tables();
+	std::lock_guard<std::mutex> guard(tables.lock);
+
+	auto pos = tables.ids.find(method_name);
+	if (pos != tables.ids.end()) {
+		return pos->second;
+	}
+
+	if (tables.names.size() >= NO_METHOD_ID) {
+		throw std::overflow_error("method_id_registry: Ran out of "
+			"method IDs");
+	}
+
+	method_id_t new_id = tables.names.size();
+	tables.ids[method_name] = new_id;
+	tables.names.push_back(method_name);
+
+	return new_id;
+}
+
+std::string method_id_registry::get_name(method_id_t id) {
+	registry_tables & tables = get_tables();
+	std::lock_guard<std::mutex> guard(tables.lock);
+
+	if (id >= tables.names.size()) {
+		throw std::out_of_range("method_id_registry: Unknown method ID");
+	}
+
+	return tables.names[id];
+}
+
+size_t method_id_registry::size() {
+	registry_tables & tables = get_tables();
+	std::lock_guard<std::mutex> guard(tables.lock);
+
+	return tables.names.size();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Interned method IDs. Every distinct method name gets a small integer ID the
+// first time it's seen, and the ID stays the same for the rest of the run.
+// The cache uses these IDs to index its outcome table directly, so that a
+// lookup doesn't need to build a name string (which for composite methods like
+// "Smith,Benham-Plurality" means a lot of string merging) or hash it.
+
+// Since IDs are handed out densely from zero, the number of IDs is the number
+// of distinct method names used during the run, and an array indexed by ID
+// stays small.
+
+// The registry is shared by every thread, so interning takes a lock. That's
+// fine because each method object only interns its name once; see
+// election_method::get_method_id().
+
+#include <stdint.h>
+#include <limits>
+#include <string>
+
+typedef uint32_t method_id_t;
+
+// Marks a method whose ID hasn't been determined yet.
+const method_id_t NO_METHOD_ID = std::numeric_limits<method_id_t>::max();
+
+class method_id_registry {
+	public:
+		// Returns the ID of the given method name, assigning a new one
+		// if the name hasn't been seen before.
+		static method_id_t intern(const std::string & method_name);
+
+		// Returns the name that was interned to the given ID. Throws
+		// std::out_of_range if no name has that ID.
+		static std::string get_name(method_id_t id);
+
+		// The number of IDs handed out so far. Every ID is less than
+		// this.
+		static size_t size();
+};
@@ -0,0 +1,161 @@
+// Tests for the method-ID-indexed cache.
+
+#include <gtest/gtest.h>
+
+#include "common/cache.h"
+#include "common/tests/random_elections.h"
+#include "interpreter/rank_order.h"
+#include "singlewinner/elimination/elimination.h"
+#include "singlewinner/meta/benham.h"
+#include "singlewinner/meta/comma.h"
+#include "singlewinner/meta/filters/clamp.h"
+#include "singlewinner/meta/filters/normalize.h"
+#include "singlewinner/meta/slash.h"
+#include "singlewinner/pairwise/simple_methods.h"
+#include "singlewinner/positional/simple_methods.h"
+#include "singlewinner/sets/max_elements/smith.h"
+
+TEST(MethodID, InterningIsStable) {
+	method_id_t first = method_id_registry::intern("Test method A"),
+				second = method_id_registry::intern("Test method B");
+
+	EXPECT_NE(first, second);
+	EXPECT_EQ(method_id_registry::intern("Test method A"), first);
+	EXPECT_EQ(method_id_registry::get_name(second), "Test method B");
+	EXPECT_LT(second, method_id_registry::size());
+}
+
+TEST(MethodID, SameNameSameID) {
+	plurality first(PT_WHOLE), second(PT_WHOLE);
+	borda other(PT_WHOLE);
+
+	EXPECT_EQ(first.get_method_id(), second.get_method_id());
+	EXPECT_NE(first.get_method_id(), other.get_method_id());
+	EXPECT_EQ(method_id_registry::get_name(first.get_method_id()),
+		first.name());
+}
+
+// Changing the sweep point changes the name, so it must change the ID too.
+TEST(MethodID, SetterResetsID) {
+	sweep method(PT_WHOLE, 1);
+	method_id_t before = method.get_method_id();
+
+	method.set_sweep_point(2);
+	EXPECT_NE(method.get_method_id(), before);
+	EXPECT_EQ(method_id_registry::get_name(method.get_method_id()),
+		method.name());
+}
+
+TEST(CacheMap, ClearInvalidatesOutcomes) {
+	election_t election = rank_order_int().interpret_ballots(
+	{"3: A > B > C", "2: B > C > A"}, false).second;
+
+	plurality method(PT_WHOLE);
+	cache_map cache;
+
+	ordering outcome = method.elect(election, 3, &cache, false);
+
+	EXPECT_TRUE(cache.has_outcome(method.get_method_id(), false));
+	EXPECT_TRUE(cache.has_outcome(method.name()));
+	EXPECT_EQ(cache.get_outcome(method.get_method_id(), false).first,
+		outcome);
+
+	cache.clear();
+
+	EXPECT_FALSE(cache.has_outcome(method.get_method_id()));
+	EXPECT_TRUE(cache.get_outcome(method.get_method_id(),
+			true).first.empty());
+
+	// Setting a winner-only outcome after clearing shouldn't bring back
+	// the old full ordering.
+	ordering winner;
+	winner.insert(candscore(0, 1));
+	cache.set_outcome(method.get_method_id(), true, winner);
+
+	EXPECT_FALSE(cache.has_outcome(method.get_method_id(), false));
+	EXPECT_EQ(cache.get_outcome(method.get_method_id(), true).first,
+		winner);
+}
+
+// Many methods sharing a cache should give the same results as each method
+// on its own, even though the cache now also holds outcomes with excluded
+// candidates, positional matrices and beatpaths.
+TEST(CacheMap, SharedCacheMatchesUncached) {
+	auto smith = std::make_shared<smith_set>();
+	auto irv = std::make_shared<instant_runoff_voting>(PT_WHOLE, true);
+	auto plur = std::make_shared<plurality>(PT_WHOLE);
+	auto schulze_wv = std::make_shared<schulze>(CM_WV);
+
+	std::vector<std::shared_ptr<const election_method> > methods = {
+		smith, irv, plur, schulze_wv,
+		std::make_shared<borda>(PT_WHOLE),
+		std::make_shared<schulze>(CM_MARGINS),
+		std::make_shared<slash>(smith, irv),
+		std::make_shared<slash>(smith, plur),
+		std::make_shared<comma>(smith, irv),
+		std::make_shared<comma>(smith, schulze_wv),
+		std::make_shared<benham_meta>(irv)
+	};
+
+	size_t num_candidates = 5, num_voters = 15;
+	rng randomizer(1);
+
+	for (int trial = 0; trial < 50; ++trial) {
+		election_t election = get_random_election(num_candidates,
+				num_voters, 0, false, false, randomizer);
+
+		cache_map cache;
+
+		for (auto & method: methods) {
+			EXPECT_EQ(method->elect(election, num_candidates, &cache, false),
+				method->elect(election, num_candidates, NULL, false))
+					<< method->name();
+		}
+	}
+}
+
+// A filter elects with its inner method on ballots it has rewritten. Running
+// the filter and the unfiltered method on the same cache mustn't let either
+// see what the other counted.
+TEST(CacheMap, FiltersDontLeakIntoCache) {
+	std::vector<std::shared_ptr<const election_method> > raw_methods = {
+		std::make_shared<plurality>(PT_WHOLE),
+		std::make_shared<instant_runoff_voting>(PT_WHOLE, true),
+		std::make_shared<schulze>(CM_WV)
+	};
+
+	size_t num_candidates = 4, num_voters = 15;
+	rng randomizer(2);
+
+	for (int trial = 0; trial < 50; ++trial) {
+		election_t election = get_random_election(num_candidates,
+				num_voters, 0, false, false, randomizer);
+
+		for (auto & raw: raw_methods) {
+			std::vector<std::shared_ptr<const election_method> > filters = {
+				std::make_shared<clamp>(raw, 0, 1, 1),
+				std::make_shared<normalize>(raw, 2)
+			};
+
+			ordering raw_outcome = raw->elect(election, num_candidates,
+					NULL, false);
+
+			for (auto & filter: filters) {
+				ordering filter_outcome = filter->elect(election,
+						num_candidates, NULL, false);
+
+				cache_map filter_first, raw_first;
+
+				EXPECT_EQ(filter->elect(election, num_candidates,
+						&filter_first, false), filter_outcome);
+				EXPECT_EQ(raw->elect(election, num_candidates,
+						&filter_first, false), raw_outcome) << filter->name();
+
+				EXPECT_EQ(raw->elect(election, num_candidates,
+						&raw_first, false), raw_outcome);
+				EXPECT_EQ(filter->elect(election, num_candidates,
+						&raw_first, false), filter_outcome) << filter->name();
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+// Check that the packed election representation gives the same results as
+// the list-of-ballot-groups one.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/compact_ballots.h"
+#include "generator/spatial/gaussian.h"
+#include "interpreter/rank_order.h"
+#include "pairwise/matrix.h"
+#include "random/random.h"
+#include "singlewinner/positional/aggregator.h"
+#include "singlewinner/statistics.h"
+
+// Contains equal rank, truncation and a candidate ranked by nobody.
+const std::vector<std::string> test_ballots = {
+	"3: A > B > C > D",
+	"2: B = C > A",
+	"4: D > A = B",
+	"1: C",
+	"2: E > D > C > B > A"
+};
+
+election_t get_test_election() {
+	return rank_order_int().interpret_ballots(test_ballots,
+			false).second;
+}
+
+TEST(CompactElection, RoundTripPreservesBallots) {
+	election_t election = get_test_election();
+	compact_election compact(election);
+
+	EXPECT_EQ(compact.num_ballots(), election.size());
+	EXPECT_EQ(compact.get_num_voters(), 12);
+	EXPECT_EQ(compact.to_election(), election);
+}
+
+TEST(CompactElection, DirectConstructionSortsEntries) {
+	compact_election compact;
+
+	// Insert out of order, with a duplicate.
+	compact.begin_ballot(2, false, true);
+	compact.add_ranking(1, 0.5);
+	compact.add_ranking(0, 1);
+	compact.add_ranking(2, 0.5);
+	compact.add_ranking(0, 1);
+	compact.end_ballot();
+
+	ballot_group expected(2);
+	expected.rated = true;
+	expected.contents.insert(candscore(0, 1));
+	expected.contents.insert(candscore(1, 0.5));
+	expected.contents.insert(candscore(2, 0.5));
+
+	EXPECT_EQ(compact.ballot_length(0), 3);
+	EXPECT_EQ(compact.get_ballot(0), expected);
+}
+
+TEST(CompactElection, CondorcetMatrixMatches) {
+	election_t election = get_test_election();
+	size_t num_candidates = 5;
+
+	condmat reference(election, num_candidates, CM_PAIRWISE_OPP);
+	condmat compact(compact_election(election), num_candidates,
+		CM_PAIRWISE_OPP);
+
+	EXPECT_EQ(reference.get_num_voters(), compact.get_num_voters());
+
+	for (size_t i = 0; i < num_candidates; ++i) {
+		for (size_t j = 0; j < num_candidates; ++j) {
+			EXPECT_EQ(reference.get_magnitude(i, j),
+				compact.get_magnitude(i, j));
+		}
+	}
+}
+
+TEST(CompactElection, PositionalMatrixMatches) {
+	election_t election = get_test_election();
+	compact_election compact(election);
+	size_t num_candidates = 5;
+
+	positional_aggregator aggregator;
+
+	std::vector<bool> all_hopeful(num_candidates, true),
+		some_hopeful = {true, false, true, true, false};
+
+	for (const std::vector<bool> & hopefuls: {all_hopeful, some_hopeful}) {
+		int num_hopefuls = std::count(hopefuls.begin(), hopefuls.end(),
+				true);
+
+		for (positional_type kind: {PT_WHOLE, PT_FRACTIONAL}) {
+			EXPECT_EQ(aggregator.get_positional_matrix(election,
+					num_candidates, num_hopefuls, hopefuls, kind, -1),
+				aggregator.get_positional_matrix(compact,
+					num_candidates, num_hopefuls, hopefuls, kind, -1));
+		}
+	}
+}
+
+TEST(CompactElection, SpatialGeneratorMatches) {
+	gaussian_generator gen(false, false);
+	size_t num_voters = 50, num_candidates = 4;
+
+	rng list_rng(1), compact_rng(1);
+
+	election_t reference = gen.generate_ballots(num_voters,
+			num_candidates, list_rng);
+
+	compact_election compact;
+	gen.generate_ballots(num_voters, num_candidates, compact_rng,
+		compact);
+
+	EXPECT_EQ(compact.to_election(), reference);
+}
+
+// Counting the utilities skips the ballots, but must give the same
+// summaries as the ballots would. Use more voters than the pairwise
+// counter's block size, and an odd number of dimensions.
+TEST(CompactElection, SpatialUtilitiesMatch) {
+	gaussian_generator gen(false, false, 3, false);
+	size_t num_voters = 150, num_candidates = 5, i, j;
+
+	rng list_rng(2), utility_rng(2);
+
+	positions_election reference = gen.generate_election_result(
+			num_voters, num_candidates, false, list_rng);
+
+	std::vector<double> utilities;
+	gen.generate_utilities(num_voters, num_candidates, utility_rng,
+		utilities);
+
+	statistics_request request;
+	request.pairwise_matrix = true;
+	request.positional_matrices.insert(positional_matrix_key(PT_WHOLE,
+			SIZE_MAX));
+	request.positional_matrices.insert(positional_matrix_key(
+			PT_FRACTIONAL, 2));
+
+	election_statistics reference_stats(request, reference.ballots,
+		num_candidates), utility_stats(request, num_candidates);
+	utility_stats.add_utilities(utilities, num_voters);
+
+	EXPECT_EQ(reference_stats.get_num_voters(),
+		utility_stats.get_num_voters());
+
+	condmat reference_matrix = reference_stats.get_condmat(CM_PAIRWISE_OPP),
+			utility_matrix = utility_stats.get_condmat(CM_PAIRWISE_OPP);
+
+	for (i = 0; i < num_candidates; ++i) {
+		for (j = 0; j < num_candidates; ++j) {
+			EXPECT_EQ(reference_matrix.get_magnitude(i, j),
+				utility_matrix.get_magnitude(i, j));
+		}
+	}
+
+	for (const positional_matrix_key & key: request.positional_matrices) {
+		EXPECT_EQ(reference_stats.get_positional_matrix(key.first,
+				key.second), utility_stats.get_positional_matrix(
+				key.first, key.second));
+	}
+
+	std::vector<double> reference_sums(num_candidates, 0),
+		utility_sums(num_candidates, 0);
+	for (const ballot_group & g: reference.ballots) {
+		for (const candscore & cs: g.contents) {
+			reference_sums[cs.get_candidate_num()] += cs.get_score();
+		}
+	}
+
+	for (i = 0; i < num_voters; ++i) {
+		for (j = 0; j < num_candidates; ++j) {
+			utility_sums[j] += utilities[i * num_candidates + j];
+		}
+	}
+
+	for (i = 0; i < num_candidates; ++i) {
+		EXPECT_NEAR(reference_sums[i], utility_sums[i], 1e-9);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Seeded random elections for the unit tests, so that tests comparing two
+// ways of counting or electing can use the same kinds of ballots.
+
+#include "common/ballots.h"
+#include "random/random.h"
+
+// Every voter rates each candidate independently on [0, 1]. If score_steps
+// is zero, the ratings are continuous, so there are (almost surely) no equal
+// ranks. Otherwise they're multiples of 1/score_steps, which gives lots of
+// them. If truncate is true, each candidate is left off a ballot with
+// probability 1/4, and ballots that end up empty are dropped. If weighted is
+// true, the ballots have weights from 0.5 to 3 in steps of 0.5; otherwise
+// every weight is 1.
+
+inline election_t get_random_election(size_t num_candidates,
+	size_t num_voters, int score_steps, bool truncate, bool weighted,
+	rng & randomizer) {
+
+	election_t election;
+
+	for (size_t voter = 0; voter < num_voters; ++voter) {
+		ballot_group ballot(1);
+		if (weighted) {
+			ballot.set_weight(0.5 * (1 + randomizer.next_int(6)));
+		}
+
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			if (truncate && randomizer.next_int(4) == 0) {
+				continue;
+			}
+
+			if (score_steps == 0) {
+				ballot.contents.insert(candscore(cand,
+						randomizer.next_double()));
+			} else {
+				ballot.contents.insert(candscore(cand,
+						randomizer.next_int(score_steps + 1) /
+						(double)score_steps));
+			}
+		}
+
+		if (!ballot.contents.empty()) {
+			election.push_back(ballot);
+		}
+	}
+
+	return election;
+}
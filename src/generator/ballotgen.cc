@@ -1,4 +1,4 @@
-// A little snippet for indiv_ballot_generator.
+// A little snippet for the ballot generator base classes.
 
 #include "ballotgen.h"
 
@@ -18,3 +18,25 @@ election_t indiv_ballot_generator::generate_ballots_int(
 
 	return (toRet);
 }
+
+void pure_ballot_generator::generate_compact_ballots_int(
+	int num_voters, int numcands, bool do_truncate,
+	coordinate_gen & coord_source, compact_election & out) const {
+
+	out.add_ballots(generate_ballots_int(num_voters, numcands,
+			do_truncate, coord_source));
+}
+
+void indiv_ballot_generator::generate_compact_ballots_int(
+	int num_voters, int numcands, bool do_truncate,
+	coordinate_gen & coord_source, compact_election & out) const {
+
+	ballot_group to_add;
+	to_add.set_weight(1);
+
+	for (int counter = 0; counter < num_voters; ++counter) {
+		to_add.contents = generate_ordering(numcands, do_truncate,
+				coord_source);
+		out.add_ballot(to_add);
+	}
+}
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "singlewinner/method.h"
+#include "common/compact_ballots.h"
 #include "tools/ballot_tools.h"
 #include "random/random.h"
 
@@ -30,6 +31,15 @@ class pure_ballot_generator {
 			int numcands, bool do_truncate,
 			coordinate_gen & coord_source) const = 0;
 
+		// Appends the ballots to a packed election. By default this
+		// just converts the output of generate_ballots_int, but
+		// generators that can write the packed representation directly
+		// should override it.
+		virtual void generate_compact_ballots_int(int num_voters,
+			int numcands, bool do_truncate,
+			coordinate_gen & coord_source,
+			compact_election & out) const;
+
 	public:
 		// Inheriting classes will have to set defaults on these
 		// constructors, so that they don't leave the variables in
@@ -60,6 +70,18 @@ class pure_ballot_generator {
 						numcands, truncate, coord_source);
 		}
 
+		// Packed version. The output is never compressed, as the
+		// point is to avoid the sorting that compression requires.
+		// The election is cleared first but keeps its capacity, so
+		// reusing it between rounds avoids allocation.
+		void generate_ballots(int num_voters, int numcands,
+			coordinate_gen & coord_source,
+			compact_election & out) const {
+			out.clear();
+			generate_compact_ballots_int(num_voters, numcands,
+				truncate, coord_source, out);
+		}
+
 		ballot_group generate_ballot(int numcands,
 			coordinate_gen & coord_source) const {
 			return *generate_ballots(1, numcands,
@@ -82,6 +104,10 @@ class indiv_ballot_generator : public pure_ballot_generator {
 		election_t generate_ballots_int(int num_voters,
 			int numcands, bool do_truncate,
 			coordinate_gen & coord_source) const;
+		void generate_compact_ballots_int(int num_voters,
+			int numcands, bool do_truncate,
+			coordinate_gen & coord_source,
+			compact_election & out) const;
 
 	public:
 		indiv_ballot_generator() : pure_ballot_generator() {}
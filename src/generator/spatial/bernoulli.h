@@ -44,6 +44,10 @@ class bernoulli_generator : public spatial_generator {
 		void bias_generator(size_t num_dimensions,
 			coordinate_gen & coord_source);
 
+		std::shared_ptr<spatial_generator> clone() const {
+			return std::make_shared<bernoulli_generator>(*this);
+		}
+
 		std::string name() const {
 			return ("Bernoulli");
 		}
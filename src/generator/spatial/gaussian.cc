@@ -8,38 +8,55 @@
 #include <math.h>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
 
 // Not necessarily random, so "rnd" doesn't really fit. TODO rename?
 
-// TODO: This pulls two dimensions at a time even with a higher dimension
-// count, which makes quasirandom work badly with num dimensions != 2.
-// FIX by not ending query until we're done sampling the whole vector.
-// Also find some way to deal with odd dimensions. Use the inversion method
-// for the last coordinare?
 std::vector<double> gaussian_generator::rnd_vector(size_t size,
 	coordinate_gen & coord_source) const {
 
-	std::vector<double> toRet;
-	toRet.reserve(size);
+	std::vector<double> toRet(size);
+	rnd_vectors(1, size, coord_source, toRet.data());
 
-	for (size_t counter = 0; counter < size; counter += 2) {
-		std::pair<double, double> gaussian_sample;
-		if (!center.empty() && center.size() >= 2)
-			gaussian_sample = gdist.get_2D(center[0], center[1], dispersion[0],
-					coord_source);
-		else {
-			gaussian_sample = gdist.get_2D(dispersion[0], coord_source);
-		}
+	return (toRet);
+}
 
-		toRet.push_back(gaussian_sample.first);
-		toRet.push_back(gaussian_sample.second);
+void gaussian_generator::rnd_vectors(size_t count, size_t size,
+	coordinate_gen & coord_source, double * out) const {
+
+	// QMC draws two variates per query, so with an odd number of
+	// dimensions, we have to draw one more than we need for each
+	// vector and throw it away. (TODO: Find some better way of dealing
+	// with odd dimensions. Use the inversion method for the last
+	// coordinate?)
+	size_t drawn_size = size;
+	if (!coord_source.is_independent()) {
+		drawn_size += size % 2;
 	}
 
-	while (toRet.size() > size) {
-		toRet.pop_back();
+	if (drawn_size == size) {
+		gdist.fill_standard(out, count * size, coord_source);
+	} else {
+		std::vector<double> drawn(count * drawn_size);
+		gdist.fill_standard(drawn.data(), drawn.size(), coord_source);
+
+		for (size_t i = 0; i < count; ++i) {
+			std::copy(drawn.begin() + i * drawn_size,
+				drawn.begin() + i * drawn_size + size, out + i * size);
+		}
 	}
 
-	return (toRet);
+	double sigma = dispersion[0];
+
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t dim = 0; dim < size; ++dim) {
+			double mu = 0;
+			if (dim < center.size()) {
+				mu = center[dim];
+			}
+			out[i * size + dim] = mu + sigma * out[i * size + dim];
+		}
+	}
 }
 
 double gaussian_generator::get_mean_utility(
@@ -22,6 +22,8 @@ class gaussian_generator : public spatial_generator {
 	public:
 		std::vector<double> rnd_vector(size_t size,
 			coordinate_gen & coord_source) const;
+		void rnd_vectors(size_t count, size_t size,
+			coordinate_gen & coord_source, double * out) const;
 
 		//public:
 		gaussian_generator() : spatial_generator() {
@@ -59,5 +61,9 @@ class gaussian_generator : public spatial_generator {
 
 		double pdf(const std::vector<double> & point) const;
 
+		std::shared_ptr<spatial_generator> clone() const {
+			return std::make_shared<gaussian_generator>(*this);
+		}
+
 		std::string name() const;
 };
\ No newline at end of file
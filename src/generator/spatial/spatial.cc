@@ -3,6 +3,7 @@
 
 #include "spatial.h"
 #include <iostream>
+#include <algorithm>
 
 
 double spatial_generator::distance(const std::vector<double> & a,
@@ -28,31 +29,117 @@ std::vector<double> spatial_generator::max_dim_vector(
 	return (toRet);
 }
 
+void spatial_generator::rnd_vectors(size_t count, size_t size,
+	coordinate_gen & coord_source, double * out) const {
+
+	for (size_t i = 0; i < count; ++i) {
+		std::vector<double> vec = rnd_vector(size, coord_source);
+		std::copy(vec.begin(), vec.end(), out + i * size);
+	}
+}
+
+void spatial_generator::generate_position_blocks(size_t num_voters,
+	size_t numcands, coordinate_gen & coord_source,
+	std::vector<double> & cand_block,
+	std::vector<double> & voter_block) const {
+
+	cand_block.resize(numcands * num_dimensions);
+	voter_block.resize(num_voters * num_dimensions);
+
+	if (fixed && numcands == fixed_cand_positions.size()) {
+		for (size_t cand = 0; cand < numcands; ++cand) {
+			std::copy(fixed_cand_positions[cand].begin(),
+				fixed_cand_positions[cand].end(),
+				cand_block.begin() + cand * num_dimensions);
+		}
+	} else {
+		rnd_vectors(numcands, num_dimensions, coord_source,
+			cand_block.data());
+	}
+
+	rnd_vectors(num_voters, num_dimensions, coord_source,
+		voter_block.data());
+}
+
 positions_election spatial_generator::generate_positions(
 	size_t num_voters, size_t numcands,
 	coordinate_gen & coord_source) const {
 
 	positions_election pos_out;
+	std::vector<double> cand_block, voter_block;
 
-	size_t cand, voter;
+	generate_position_blocks(num_voters, numcands, coord_source,
+		cand_block, voter_block);
 
-	if (fixed && (size_t)numcands == fixed_cand_positions.size()) {
-		pos_out.candidates_pos = fixed_cand_positions;
-	} else {
-		for (cand = 0; cand < numcands; ++cand) {
-			pos_out.candidates_pos.push_back(
-				rnd_vector(num_dimensions, coord_source));
-		}
+	for (size_t cand = 0; cand < numcands; ++cand) {
+		pos_out.candidates_pos.push_back(std::vector<double>(
+				cand_block.begin() + cand * num_dimensions,
+				cand_block.begin() + (cand+1) * num_dimensions));
 	}
 
-	for (voter = 0; voter < num_voters; ++voter) {
-		pos_out.voters_pos.push_back(
-			rnd_vector(num_dimensions, coord_source));
+	for (size_t voter = 0; voter < num_voters; ++voter) {
+		pos_out.voters_pos.push_back(std::vector<double>(
+				voter_block.begin() + voter * num_dimensions,
+				voter_block.begin() + (voter+1) * num_dimensions));
 	}
 
 	return pos_out;
 }
 
+void spatial_generator::get_utilities(size_t num_voters, size_t numcands,
+	const std::vector<double> & cand_block,
+	const std::vector<double> & voter_block,
+	std::vector<double> & utilities) const {
+
+	size_t voter, cand, dim;
+
+	// Transpose the candidates so that the innermost loop runs over
+	// candidates with unit stride; that lets the compiler vectorize it.
+	// We still add up the dimensions in order, so the distances are
+	// exactly the same as distance() would give.
+	std::vector<double> cand_by_dim(num_dimensions * numcands);
+
+	for (cand = 0; cand < numcands; ++cand) {
+		for (dim = 0; dim < num_dimensions; ++dim) {
+			cand_by_dim[dim * numcands + cand] =
+				cand_block[cand * num_dimensions + dim];
+		}
+	}
+
+	utilities.resize(num_voters * numcands);
+
+	// Compatibility with Warren.
+	double spacing = sqrt(0.6 * num_dimensions);
+
+	for (voter = 0; voter < num_voters; ++voter) {
+		const double * voter_pos = voter_block.data() +
+			voter * num_dimensions;
+		double * utility = utilities.data() + voter * numcands;
+
+		std::fill(utility, utility + numcands, 0);
+
+		for (dim = 0; dim < num_dimensions; ++dim) {
+			const double * cand_pos = cand_by_dim.data() + dim * numcands;
+			for (cand = 0; cand < numcands; ++cand) {
+				double diff = voter_pos[dim] - cand_pos[cand];
+				utility[cand] += diff * diff;
+			}
+		}
+
+		// If warren_utility is true, use Warren's utility model,
+		// otherwise use JGA's.
+		if (warren_utility) {
+			for (cand = 0; cand < numcands; ++cand) {
+				utility[cand] = 1 / (spacing + sqrt(utility[cand]));
+			}
+		} else {
+			for (cand = 0; cand < numcands; ++cand) {
+				utility[cand] = -sqrt(utility[cand]);
+			}
+		}
+	}
+}
+
 positions_election spatial_generator::generate_election_result(
 	size_t num_voters, size_t numcands, bool do_truncate,
 	coordinate_gen & coord_source) const {
@@ -63,54 +150,38 @@ positions_election spatial_generator::generate_election_result(
 		throw std::invalid_argument("spatial generator: truncation not supported");
 	}
 
-	// First generate the positions.
-	positions_election pos_elect = generate_positions(
-			num_voters, numcands, coord_source);
+	// First generate the positions, then the utilities for every voter
+	// at once.
+	std::vector<double> cand_block, voter_block, utilities;
 
-	std::vector<double> distances_to_cand(numcands, 0);
+	generate_position_blocks(num_voters, numcands, coord_source,
+		cand_block, voter_block);
+	get_utilities(num_voters, numcands, cand_block, voter_block,
+		utilities);
 
-	ballot_group our_entry;
-	our_entry.set_weight(1);
-
-	double max_distance = 0;
+	positions_election pos_elect;
 
 	size_t counter, sec;
 
-	for (counter = 0; counter < num_voters; ++counter) {
-		our_entry.contents.clear();
-
-		// Dump distances to all the candidates and get the minimum
-		// distance (which may be needed for truncation).
-		double mindist = INFINITY;
-		for (sec = 0; sec < numcands; ++sec) {
-			distances_to_cand[sec] = distance(
-					pos_elect.voters_pos[counter],
-					pos_elect.candidates_pos[sec]);
+	for (counter = 0; counter < numcands; ++counter) {
+		pos_elect.candidates_pos.push_back(std::vector<double>(
+				cand_block.begin() + counter * num_dimensions,
+				cand_block.begin() + (counter+1) * num_dimensions));
+	}
 
-			mindist = std::min(mindist, distances_to_cand[sec]);
-			max_distance = std::max(max_distance, distances_to_cand[sec]);
-		}
+	ballot_group our_entry;
+	our_entry.set_weight(1);
 
-		// Compatibility with Warren.
-		double spacing = sqrt(0.6 * num_dimensions);
+	for (counter = 0; counter < num_voters; ++counter) {
+		pos_elect.voters_pos.push_back(std::vector<double>(
+				voter_block.begin() + counter * num_dimensions,
+				voter_block.begin() + (counter+1) * num_dimensions));
 
-		// For all candidates...
-		for (sec = 0; sec < (size_t)numcands; ++sec) {
-			// Get distance to candidate.
-			double our_dist = distances_to_cand[sec];
+		our_entry.contents.clear();
 
-			// If warren_utility is true, use Warren's utility
-			// model.
-			if (warren_utility) {
-				our_entry.contents.insert(candscore(sec, 1 /
-						(spacing + our_dist)));
-			}
-			// ... otherwise use JGA's.
-			else {
-				assert(our_dist <= max_distance);
-				our_entry.contents.insert(candscore(sec,
-						-our_dist));
-			}
+		for (sec = 0; sec < numcands; ++sec) {
+			our_entry.contents.insert(candscore(sec,
+					utilities[counter * numcands + sec]));
 		}
 
 		our_entry.complete = (our_entry.contents.size() ==
@@ -123,6 +194,55 @@ positions_election spatial_generator::generate_election_result(
 	return pos_elect;
 }
 
+void spatial_generator::generate_compact_ballots_int(int num_voters,
+	int numcands, bool do_truncate, coordinate_gen & coord_source,
+	compact_election & out) const {
+
+	if (do_truncate) {
+		throw std::invalid_argument("spatial generator: truncation not supported");
+	}
+
+	// This consumes the coordinate source in exactly the same way as
+	// generate_election_result, so the two produce the same ballots for
+	// the same seed.
+	std::vector<double> cand_block, voter_block, utilities;
+
+	generate_position_blocks(num_voters, numcands, coord_source,
+		cand_block, voter_block);
+	get_utilities(num_voters, numcands, cand_block, voter_block,
+		utilities);
+
+	out.reserve(out.num_ballots() + num_voters,
+		(out.num_ballots() + num_voters) * numcands);
+
+	for (int voter = 0; voter < num_voters; ++voter) {
+		out.begin_ballot(1, true, true);
+
+		for (int cand = 0; cand < numcands; ++cand) {
+			out.add_ranking(cand, utilities[voter * numcands + cand]);
+		}
+
+		out.end_ballot();
+	}
+}
+
+void spatial_generator::generate_utilities(size_t num_voters,
+	size_t numcands, coordinate_gen & coord_source,
+	std::vector<double> & utilities) const {
+
+	if (numcands == 0) {
+		throw std::invalid_argument("spatial generator: Must have at "
+			"least one candidate");
+	}
+
+	std::vector<double> cand_block, voter_block;
+
+	generate_position_blocks(num_voters, numcands, coord_source,
+		cand_block, voter_block);
+	get_utilities(num_voters, numcands, cand_block, voter_block,
+		utilities);
+}
+
 bool spatial_generator::set_params(size_t num_dimensions_in,
 	bool warren_util_in) {
 
@@ -22,6 +22,8 @@
 #include "../ballotgen.h"
 #include "stats/coordinate_gen.h"
 
+#include <memory>
+
 
 // TODO: Provide "get_minimum_value" and "get_maximum_value" functions.
 // Will have to do something about the Gaussian's infinite tail in that case.
@@ -55,6 +57,21 @@ class spatial_generator : public pure_ballot_generator {
 		double distance(const std::vector<double> & a,
 			const std::vector<double> & b) const;
 
+		// Generates the candidate and voter positions into flat blocks,
+		// num_dimensions doubles per point, consuming the coordinate
+		// source in the same order as generate_positions.
+		void generate_position_blocks(size_t num_voters, size_t numcands,
+			coordinate_gen & coord_source, std::vector<double> & cand_block,
+			std::vector<double> & voter_block) const;
+
+		// Calculates the utility of every candidate to every voter, with
+		// utilities[voter * numcands + cand] being the utility of cand to
+		// voter.
+		void get_utilities(size_t num_voters, size_t numcands,
+			const std::vector<double> & cand_block,
+			const std::vector<double> & voter_block,
+			std::vector<double> & utilities) const;
+
 		// If true, the candidate positions are fixed. This is used
 		// for drawing Yee diagrams (since they'd be fairly useless
 		// if the candidate positions were to drift around).
@@ -70,6 +87,12 @@ class spatial_generator : public pure_ballot_generator {
 			coordinate_gen & coord_source) const = 0;
 		virtual std::vector<double> max_dim_vector(size_t dimensions) const;
 
+		// Generates count vectors into out, one after another. The
+		// default calls rnd_vector for each; subclasses that can generate
+		// a whole block more quickly should override it.
+		virtual void rnd_vectors(size_t count, size_t size,
+			coordinate_gen & coord_source, double * out) const;
+
 		// Generates just the coordinates; the ballots iteself
 		// will be empty.
 		positions_election generate_positions(
@@ -85,6 +108,13 @@ class spatial_generator : public pure_ballot_generator {
 					coord_source).ballots;
 		}
 
+		// Writes the ballots straight into the packed election
+		// without going through ballot_groups.
+		void generate_compact_ballots_int(int num_voters,
+			int numcands, bool do_truncate,
+			coordinate_gen & coord_source,
+			compact_election & out) const;
+
 	public:
 		spatial_generator() : pure_ballot_generator() {
 			set_params(2, true); uses_center = false;
@@ -116,6 +146,16 @@ class spatial_generator : public pure_ballot_generator {
 			size_t num_voters, size_t numcands, bool do_truncate,
 			coordinate_gen & coord_source) const;
 
+		// Generates an election's utilities without making any ballots,
+		// with utilities[voter * numcands + cand] being the utility of
+		// cand to voter. This consumes the coordinate source in the same
+		// way as generate_election_result, so counting the utilities
+		// (see election_statistics::add_utilities) gives the same
+		// summaries as counting its ballots would.
+		void generate_utilities(size_t num_voters, size_t numcands,
+			coordinate_gen & coord_source,
+			std::vector<double> & utilities) const;
+
 		bool set_params(size_t num_dimensions_in, bool warren_util_in);
 
 		size_t get_num_dimensions() const {
@@ -177,6 +217,12 @@ class spatial_generator : public pure_ballot_generator {
 			return dispersion;
 		}
 
+		// Returns an independent copy of this generator, with the same
+		// center, dispersion and fixed candidate positions. Used to give
+		// each thread its own generator, since set_center() alters the
+		// generator it's called on.
+		virtual std::shared_ptr<spatial_generator> clone() const = 0;
+
 		// Should also return dimensions, etc.
 		virtual std::string name() const = 0;
 };
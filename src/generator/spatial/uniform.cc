@@ -18,3 +18,18 @@ std::vector<double> uniform_generator::rnd_vector(size_t size,
 
 	return coord;
 }
+
+void uniform_generator::rnd_vectors(size_t count, size_t size,
+	coordinate_gen & coord_source, double * out) const {
+
+	coord_source.get_coordinates(size, count, out);
+
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t dim = 0; dim < size; ++dim) {
+			double min = center[dim] - dispersion[dim],
+				   max = center[dim] + dispersion[dim];
+
+			out[i * size + dim] = (min + out[i * size + dim]) * (max-min);
+		}
+	}
+}
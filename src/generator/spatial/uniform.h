@@ -8,6 +8,8 @@ class uniform_generator : public spatial_generator {
 	protected:
 		std::vector<double> rnd_vector(size_t size,
 			coordinate_gen & coord_source) const;
+		void rnd_vectors(size_t count, size_t size,
+			coordinate_gen & coord_source, double * out) const;
 
 	public:
 		uniform_generator() : spatial_generator() {
@@ -35,6 +37,10 @@ class uniform_generator : public spatial_generator {
 			set_dispersion(0.5); set_center(0.5);
 		}
 
+		std::shared_ptr<spatial_generator> clone() const {
+			return std::make_shared<uniform_generator>(*this);
+		}
+
 		std::string name() const {
 			return ("Uniform spatial");
 		}
@@ -36,7 +36,7 @@
 
 // Stats
 #include "stats/coordinate_gen.h"
-#include "stats/quasirandom/r_sequence.h"
+#include "stats/quasirandom/sobol.h"
 
 // More later. POC for now. Perhaps also do something with the fact that C++
 // doesn't have garbage collection -- i.e. clean up after ourselves.
@@ -128,7 +128,7 @@ yee setup_yee(
 	int num_voters, int num_cands,
 	bool do_use_autopilot, std::string case_prefix, int picture_size,
 	double sigma, spatial_generator & gaussian, uniform_generator & uniform,
-	uint64_t rng_seed, bool quasi_monte_carlo) {
+	uint64_t rng_seed, bool quasi_monte_carlo, int num_threads) {
 
 	yee to_output;
 
@@ -143,7 +143,7 @@ yee setup_yee(
 
 	if (quasi_monte_carlo) {
 		to_output.set_coordinate_gen(PURPOSE_BALLOT_GENERATOR,
-			std::make_shared<r_sequence>(2));
+			std::make_shared<sobol_sequence>(2, rng_seed));
 	} else {
 		to_output.set_coordinate_gen(PURPOSE_BALLOT_GENERATOR,
 			rng_ptr);
@@ -151,6 +151,7 @@ yee setup_yee(
 
 	to_output.set_voter_pdf(&gaussian);
 	to_output.set_candidate_pdf(&uniform);
+	to_output.set_num_threads(num_threads);
 
 	to_output.add_methods(methods.begin(), methods.end());
 
@@ -473,10 +474,16 @@ void print_usage_info(std::string program_name) {
 		"pixel.\n\t\t\tDefault is 1000." << std::endl;
 	std::cout << "\t-yc [cands]\tPlace [cands] random candidates on the Yee"<<
 		" map.\n\t\t\tDefault is 4." << std::endl;
-	std::cout << "\t-yq\t\tUse Quasi-Monte Carlo. This generally gives more"<<
-		"\n\t\t\taccurate results, but requires autopilot to be"<<
-		"\n\t\t\tdisabled and may have side effects on methods"<<
-		"\n\t\t\tthat break ties randomly. Default is no.\n" << std::endl;
+	std::cout << "\t-yq\t\tUse Quasi-Monte Carlo (scrambled Sobol). This"<<
+		"\n\t\t\tgenerally gives more accurate results, but"<<
+		"\n\t\t\trequires autopilot to be disabled and may have"<<
+		"\n\t\t\tside effects on methods that break ties"<<
+		"\n\t\t\trandomly. Default is no." << std::endl;
+	std::cout << "\t-yt [threads]\tDraw each column with [threads] threads."<<
+		"\n\t\t\tThe picture then only depends on the seed, not"<<
+		"\n\t\t\ton the number of threads. With -yq, each pixel"<<
+		"\n\t\t\tgets its own scramble. Default is 0 (single"<<
+		"\n\t\t\tstream).\n" << std::endl;
 	std::cout << std::endl;
 	std::cout << "Barycentric characterization options:" << std::endl;
 	std::cout << "\t-c\t\tEnable voter method barycentric visualization." <<
@@ -490,6 +497,7 @@ int main(int argc, char * * argv) {
 	double yee_sigma = 0.3;
 	int yee_size = 240, yee_voters = 1000, yee_candidates = 4;
 	bool yee_autopilot = true, yee_quasi_mc = false;
+	int yee_threads = 0;
 	std::string yee_prefix = "default";
 
 	int breg_rounds = 20000, breg_min_cands = 3, breg_max_cands = 20,
@@ -542,6 +550,7 @@ int main(int argc, char * * argv) {
 		{"yv", required_argument, 0, 'l'},
 		{"yc", required_argument, 0, 'n'},
 		{"yq", no_argument, 0, 's'},
+		{"yt", required_argument, 0, 't'},
 		{0, 0, 0, 0}
 	};
 
@@ -651,6 +660,14 @@ int main(int argc, char * * argv) {
 						yee_quasi_mc = true;
 						yee_autopilot = false; // Autopilot interferes
 						break;
+					case 't': // -yt   threads
+						yee_threads = str_toi(ext);
+						if (yee_threads < 0) {
+							std::cerr << "Yee diagram: number of threads "
+								"can't be negative." << std::endl;
+							return -1;
+						}
+						break;
 					case 'p': // -ic [filename]
 						int_constraint_fn = ext;
 						constrain_ints = true;
@@ -856,6 +873,7 @@ int main(int argc, char * * argv) {
 			std::cout << "no" << std::endl;
 		}
 		std::cout << "\t\t- picture prefix: " << yee_prefix << std::endl;
+		std::cout << "\t\t- threads: " << yee_threads << std::endl;
 
 		if (methods.size() > 10) {
 			std::cout << "WARNING: You have selected more than 10 " <<
@@ -866,7 +884,7 @@ int main(int argc, char * * argv) {
 		yee_mode = setup_yee(methods, yee_voters, yee_candidates,
 				yee_autopilot, yee_prefix, yee_size, yee_sigma,
 				gaussian, uniform, randomizer.get_initial_seed(),
-				yee_quasi_mc);
+				yee_quasi_mc, yee_threads);
 
 		yee_mode.print_candidate_positions();
 
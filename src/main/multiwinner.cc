@@ -4,6 +4,7 @@
 #include "generator/spatial/all.h"
 
 #include "random/random.h"
+#include "tools/revolving_door.h"
 #include "tools/tools.h"
 
 #include "multiwinner/helper/errors.h"
@@ -17,14 +18,18 @@
 
 #include <unordered_map>
 
+#include <omp.h>
+
 // return the natural log of x!
 double lfac(size_t x) {
 	return lgamma(x+1);
 }
 
-VSE_limits get_proportionality_limits(
-	proportionality_measure & measure,
-	size_t num_candidates, size_t num_seats,
+// The measure is copied for each thread, since measures may use
+// internal scratch space when calculating errors.
+
+template<typename T> VSE_limits get_proportionality_limits(
+	const T & measure, size_t num_candidates, size_t num_seats,
 	rng & rnd, size_t max_iters) {
 
 	// Check if an exhaustive search would exceed our iteration budget.
@@ -32,35 +37,54 @@ VSE_limits get_proportionality_limits(
 	double log_combinations = lfac(num_candidates) - (
 			lfac(num_seats) + lfac(num_candidates-num_seats));
 
-	std::vector<size_t> candidates(num_candidates, 0);
-	std::vector<size_t> council(num_seats, 0);
-	std::iota(candidates.begin(), candidates.end(), 0);
-
 	VSE_limits limits(MINIMIZE); // higher error is worse
 
-	auto evaluate = // TODO, const measure
-		[&limits, &measure, &council](
-			std::vector<size_t>::const_iterator start,
-	std::vector<size_t>::const_iterator end) -> bool {
-
-		std::copy(start, end, council.begin());
+	if (log_combinations > log(max_iters)) {
+		T sample_measure(measure);
 
-		// TODO: measures: templating and iterators...
-		limits.update(measure.get_error(council));
+		std::vector<size_t> candidates(num_candidates, 0);
+		std::iota(candidates.begin(), candidates.end(), 0);
 
-		// keep going
-		return false;
-	};
-
-	if (log_combinations <= log(max_iters)) {
-		for_each_combination(candidates.begin(),
-			candidates.begin() + num_seats, candidates.end(),
-			evaluate);
-	} else {
 		for (size_t i = 0; i < max_iters; ++i) {
 			std::shuffle(candidates.begin(), candidates.end(), rnd);
-			evaluate(candidates.begin(), candidates.begin() + num_seats);
+			limits.update(sample_measure.get_error(council_t(
+						candidates.begin(), candidates.begin() + num_seats)));
+		}
+
+		return limits;
+	}
+
+	// Split the councils between the threads by rank, and merge what
+	// they found afterwards.
+
+	uint64_t num_councils = revolving_door::num_combinations(
+			num_candidates, num_seats);
+
+	#pragma omp parallel
+	{
+		T thread_measure(measure);
+		VSE_limits thread_limits(MINIMIZE);
+
+		uint64_t num_threads = omp_get_num_threads(),
+				 thread = omp_get_thread_num(),
+				 first = num_councils * thread / num_threads,
+				 last = num_councils * (thread + 1) / num_threads;
+
+		if (first < last) {
+			council_t council = revolving_door::unrank(first,
+					num_candidates, num_seats);
+			size_t removed, added;
+
+			thread_limits.update(thread_measure.get_error(council));
+
+			for (uint64_t rank = first + 1; rank < last; ++rank) {
+				revolving_door::next(council, num_candidates, removed, added);
+				thread_limits.update(thread_measure.get_error(council));
+			}
 		}
+
+		#pragma omp critical
+		limits.merge(thread_limits);
 	}
 
 	return limits;
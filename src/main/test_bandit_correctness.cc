@@ -12,6 +12,12 @@ int main(int argc, const char ** argv) {
 	int how_many = 500, i;
 	bool maximize = true;
 
+	// Optional argument: number of threads to pull arms with.
+	size_t num_threads = 1;
+	if (argc > 1) {
+		num_threads = atoi(argv[1]);
+	}
+
 	std::vector<std::shared_ptr<simulator> > bernoullis;
 	double maxmean = 0, minmean = 1;
 
@@ -28,6 +34,7 @@ int main(int argc, const char ** argv) {
 	double seconds_per_round = 0.5;
 
 	Lil_UCB bandit_tester;
+	bandit_tester.set_num_threads(num_threads);
 	bandit_tester.load_arms(bernoullis);
 
 	double progress;
@@ -58,6 +58,7 @@
 #include "bandit/lilucb.h"
 
 #include "tests/strategy/strategies.h"
+#include "tests/batch_runner.h"
 #include "tests/provider.h"
 
 #include "singlewinner/get_methods.h"
@@ -96,26 +97,30 @@ void test_with_bandits(
 
 	test_provider tests;
 
+	// Use lower values to more quickly identify the best method.
+	// Use higher values to get more accurate strategy
+	// susceptibility values (i.e. succumbs to strategy 10% of
+	// the time).
+	int tries_to_get_strat = 512; // was 4096
+
+	// Every method is tested on the same elections, so that ballot
+	// generation and honest outcomes are shared between them.
+	auto batch = std::make_shared<batch_test_runner>(ballotgen,
+			numvoters, numcands, numcands, randomizer, to_test,
+			tries_to_get_strat);
+
+	// We're testing the rate of failure of "strategy immunity" criteria,
+	// i.e. the presence of opportunities for manipulation.
+	batch->set_name("Strategy");
+
+	// Add some strategies
+	for (auto test: tests.get_tests_by_category("Strategy")) {
+		batch->add_test(test);
+	}
+
 	for (i = 0; i < to_test.size(); ++i) {
-		// Use lower values to more quickly identify the best method.
-		// Use higher values to get more accurate strategy
-		// susceptibility values (i.e. succumbs to strategy 10% of
-		// the time).
-		int tries_to_get_strat = 512; // was 4096
-
-		auto sim = std::make_shared<test_runner>(ballotgen,
-				numvoters, numcands, numcands, randomizer, to_test[i],
-				tries_to_get_strat);
-		sims.push_back(sim);
-
-		// We're testing the rate of failure of "strategy immunity" criteria,
-		// i.e. the presence of opportunities for manipulation.
-		sim->set_name("Strategy");
-
-		// Add some strategies
-		for (auto test: tests.get_tests_by_category("Strategy")) {
-			sim->add_test(test);
-		}
+		sims.push_back(std::make_shared<batch_test_arm>(batch, i,
+				randomizer));
 	}
 
 	Lil_UCB lil_ucb;
@@ -3,6 +3,8 @@
 #include <memory>
 #include <vector>
 
+#include <omp.h>
+
 #include "tests/quick_dirty/monotonicity.h"
 #include "simulator/all.h"
 
@@ -14,6 +16,7 @@
 #include "singlewinner/meta/all.h"
 #include "singlewinner/pairwise/simple_methods.h"
 #include "singlewinner/sets/all.h"
+#include "random/philox.h"
 #include "random/random.h"
 
 #include "generator/all.h"
@@ -41,6 +44,11 @@ void test_with_bandits(
 		std::make_shared<gaussian_generator>(false, false, dimensions, false);
 	const_gen->set_dispersion(1);
 
+	// Give every arm its own stream, so that an arm's results only
+	// depend on the seed and how often it's been pulled, not on the
+	// order the arms were pulled in.
+	philox_rng arm_streams(randomizer->get_initial_seed());
+
 	for (i = 0; i < to_test.size(); ++i) {
 		/*auto sim = std::make_shared<vse_sim>(randomizer, to_test[i],
 				numcands, numvoters, dimensions);
@@ -48,7 +56,8 @@ void test_with_bandits(
 		sim->set_scale_factor(1/E_opt_random);
 		sim->set_dispersion(sigma);*/
 
-		auto sim = std::make_shared<utility_freq_sim>(randomizer,
+		auto sim = std::make_shared<utility_freq_sim>(
+				std::make_shared<philox_rng>(arm_streams.split(i)),
 				to_test[i], const_gen, numcands, numvoters);
 
 		sims.push_back(sim);
@@ -57,6 +66,10 @@ void test_with_bandits(
 	Lil_UCB lil_ucb;
 	lil_ucb.load_arms(sims);
 
+	// Each arm has its own entropy stream and only reads the shared
+	// generator, so the arms can be simulated in parallel.
+	lil_ucb.set_num_threads(omp_get_max_threads());
+
 	// The stuff below needs a cleanup! TODO
 	// It's better now.
 
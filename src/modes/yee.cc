@@ -7,7 +7,10 @@
 #include "images/color/color.h"
 #include "output/png_writer.h"
 #include "singlewinner/pairwise/simple_methods.h"
+#include "random/random.h"
+#include "stats/quasirandom/sobol.h"
 
+#include <algorithm>
 #include <fstream>
 
 // The methods here are a bit out of order because this used to be in
@@ -37,18 +40,16 @@
 // should diminish salt-and-pepper noise. BLUESKY: Render using PNG
 // interpolation order to maximize effect.
 
-long long yee::check_pixel(int x, int y, int xsize_in, int ysize_in,
+long long yee::check_pixel(int x, int y,
 	const std::vector<std::shared_ptr<const election_method> > & methods,
-	spatial_generator & ballotgen,
-	std::vector<std::vector<std::vector<std::vector<bool > > > > &
-	am_ac_winners,
+	spatial_generator & ballotgen, size_t num_cands,
+	std::vector<std::vector<bool> > & pixel_winners,
 	int min_num_voters_in, int max_num_voters_in,
 	bool use_autopilot_in, double autopilot_factor_in,
 	int autopilot_history_in, cache_map * cache,
 	coordinate_gen & ballot_coord_source) const {
 
-	size_t num_cands = am_ac_winners[0].size(),
-		   num_methods = am_ac_winners.size();
+	size_t num_methods = methods.size();
 
 	std::vector<election_t> autopilot_am(num_methods);
 	std::vector<int> num_identical(num_methods, 0);
@@ -81,14 +82,37 @@ long long yee::check_pixel(int x, int y, int xsize_in, int ysize_in,
 
 	double def_autopilot_factor = 1.01;
 
+	// If every method only needs summaries of the ballots, we can count
+	// them straight from the voters' utilities and skip the ballots.
+	statistics_request required_statistics;
+	bool use_statistics = num_methods > 0;
+
+	for (method = 0; method < num_methods && use_statistics; ++method) {
+		statistics_request method_request =
+			methods[method]->get_required_statistics();
+		use_statistics = !method_request.empty();
+		required_statistics.add(method_request);
+	}
+
+	std::vector<double> utilities;
+
 	while ((int)round(cur_num_voters) <= max_num_voters_in &&
 		cleared < num_methods) {
 
 		// Sample the voter distribution at our pixel.
 		// Note: generate_ballots is quite expensive. Consider the value
 		// of using autopilot...
-		ballots = ballotgen.generate_ballots(round(cur_num_voters),
-				num_cands, ballot_coord_source);
+		election_statistics statistics(required_statistics, num_cands);
+
+		if (use_statistics) {
+			size_t num_voters = round(cur_num_voters);
+			ballotgen.generate_utilities(num_voters, num_cands,
+				ballot_coord_source, utilities);
+			statistics.add_utilities(utilities, num_voters);
+		} else {
+			ballots = ballotgen.generate_ballots(round(cur_num_voters),
+					num_cands, ballot_coord_source);
+		}
 
 		cache->clear();
 
@@ -100,8 +124,13 @@ long long yee::check_pixel(int x, int y, int xsize_in, int ysize_in,
 				continue;
 			}
 
-			out = methods[method]->elect(ballots, num_cands, cache,
-					true);
+			if (use_statistics) {
+				out = methods[method]->elect_from_statistics(statistics,
+						true).first;
+			} else {
+				out = methods[method]->elect(ballots, num_cands, cache,
+						true);
+			}
 
 			rank_out = ordering_tools().scrub_scores(out);
 
@@ -138,7 +167,9 @@ long long yee::check_pixel(int x, int y, int xsize_in, int ysize_in,
 					autopilot_factor_in);
 	}
 
-	// Now simply paint the appropriate pixels depending on who won.
+	// Now simply record who won.
+
+	pixel_winners.assign(num_methods, std::vector<bool>(num_cands, false));
 
 	for (method = 0; method < num_methods; ++method) {
 
@@ -153,13 +184,143 @@ long long yee::check_pixel(int x, int y, int xsize_in, int ysize_in,
 		for (ordering::const_iterator opos = meta.begin(); opos !=
 			meta.end() && opos->get_score() ==
 			meta.begin()->get_score(); ++opos)
-			am_ac_winners[method][opos->get_candidate_num()][x][y]
-				= true;
+			pixel_winners[method][opos->get_candidate_num()] = true;
 	}
 
 	return (bottom_line);
 }
 
+void yee::paint_pixel(int x, int y,
+	const std::vector<std::vector<bool> > & pixel_winners) {
+
+	for (size_t method = 0; method < pixel_winners.size(); ++method) {
+		for (size_t cand = 0; cand < pixel_winners[method].size(); ++cand) {
+			if (pixel_winners[method][cand]) {
+				winners_all_m_all_cand[method][cand][x][y] = true;
+			}
+		}
+	}
+}
+
+uint64_t yee::get_pixel_seed(uint64_t base_seed, int x, int y) const {
+	uint64_t pixel_data[3] = {base_seed, (uint64_t)x, (uint64_t)y};
+
+	uint64_t seed = SpookyHash::Hash64(pixel_data, sizeof(pixel_data), 0);
+
+	// A seed of RNG_ENTROPY would make the rng draw its seed from the
+	// entropy source, and then the picture would no longer be
+	// reproducible.
+	if (seed == RNG_ENTROPY) {
+		seed = 1;
+	}
+
+	return seed;
+}
+
+bool yee::has_pixel_streams() const {
+	const coordinate_gen & ballot_source =
+		*coordinate_sources.find(PURPOSE_BALLOT_GENERATOR)->second;
+	const sobol_sequence * sobol_source =
+		dynamic_cast<const sobol_sequence *>(&ballot_source);
+
+	bool can_split = ballot_source.is_independent() ||
+		(sobol_source != NULL && sobol_source->is_scrambled());
+
+	return (can_split && ballot_source.get_initial_seed() != RNG_ENTROPY);
+}
+
+// Draws a column with per-pixel streams, using num_threads threads. Each
+// thread has its own copy of the voter generator and its own cache, and the
+// column is split into tiles of rows that are handed out dynamically, since
+// pixels near the boundaries between candidates' regions take much longer
+// for the autopilot to settle than those well inside a region. The winners
+// are collected per pixel and painted afterwards, because concurrent writes
+// to the same vector<bool> are not safe.
+
+// Returns -1 on error, like check_pixel.
+
+long long yee::check_column_by_pixel(int x) {
+	const int tile_height = 4;
+	int num_tiles = (y_size + tile_height - 1) / tile_height;
+
+	const coordinate_gen & ballot_source =
+		*coordinate_sources[PURPOSE_BALLOT_GENERATOR];
+	uint64_t base_seed = ballot_source.get_initial_seed();
+
+	// With scrambled Sobol, every pixel gets its own scramble; otherwise
+	// every pixel gets its own pseudorandom stream.
+	const sobol_sequence * sobol_source =
+		dynamic_cast<const sobol_sequence *>(&ballot_source);
+
+	std::vector<std::vector<std::vector<bool> > > column_winners(y_size);
+	std::vector<long long> contribs(y_size, 0);
+
+	bool failed = false;
+	std::string error_message;
+
+	#pragma omp parallel num_threads(num_threads)
+	{
+		std::shared_ptr<spatial_generator> thread_pdf = voter_pdf->clone();
+		cache_map thread_cache;
+
+		#pragma omp for schedule(dynamic)
+		for (int tile = 0; tile < num_tiles; ++tile) {
+			int tile_end = std::min(y_size, (tile+1) * tile_height);
+
+			for (int y = tile * tile_height; y < tile_end; ++y) {
+				std::unique_ptr<coordinate_gen> pixel_source;
+				uint64_t pixel_seed = get_pixel_seed(base_seed, x, y);
+
+				if (sobol_source != NULL) {
+					pixel_source.reset(new sobol_sequence(
+							sobol_source->get_dimension(), pixel_seed));
+				} else {
+					pixel_source.reset(new rng(pixel_seed));
+				}
+
+				// Exceptions can't cross the parallel region's
+				// boundary, so keep the first one and rethrow it
+				// after we're done.
+				try {
+					contribs[y] = check_pixel(x, y, e_methods,
+							*thread_pdf, num_candidates,
+							column_winners[y], min_num_voters,
+							max_num_voters, use_autopilot,
+							autopilot_factor, autopilot_history_len,
+							&thread_cache, *pixel_source);
+				} catch (std::exception & e) {
+					#pragma omp critical
+					{
+						if (!failed) {
+							error_message = e.what();
+						}
+						failed = true;
+					}
+				}
+			}
+		}
+	}
+
+	if (failed) {
+		throw std::runtime_error("Yee diagram: " + error_message);
+	}
+
+	long long grand_sum = 0;
+
+	for (int y = 0; y < y_size; ++y) {
+		if (contribs[y] == -1) {
+			std::cerr << "Yee: error at x = " << x << ", y = " << y
+				<< std::endl;
+			return (-1);
+		}
+
+		paint_pixel(x, y, column_winners[y]);
+		grand_sum += contribs[y];
+	}
+
+	return (grand_sum);
+}
+
 void yee::draw_pictures(std::string prefix,
 	std::string method_name, uint64_t seed,
 	const std::vector<std::vector<std::vector<bool > > > &
@@ -344,6 +505,7 @@ yee::yee() {
 	manual_cand_positions = false;
 
 	voter_pdf = NULL; candidate_pdf = NULL;
+	num_threads = 0;
 
 	// TODO later, allow for custom canvas sizes to zoom in on
 	// interesting features of a Yee diagram.
@@ -421,6 +583,15 @@ bool yee::set_params(int num_voters, int num_cands, bool do_use_autopilot,
 				picture_size, picture_size, sigma_in));
 }
 
+void yee::set_num_threads(int num_threads_in) {
+	if (num_threads_in < 0) {
+		throw std::invalid_argument("Yee diagram: Number of threads "
+			"can't be negative");
+	}
+
+	num_threads = num_threads_in;
+}
+
 void yee::set_voter_pdf(spatial_generator * input_gen) {
 	inited = false;
 	voter_pdf = input_gen;
@@ -556,6 +727,16 @@ bool yee::init(coordinate_gen & candidate_coord_source) {
 			"deviation!");
 	}
 
+	// Per-pixel streams are only reproducible if the source they're
+	// seeded from is a pseudorandom generator or a scrambled Sobol
+	// sequence with a known seed, and without them, we can't draw with
+	// more than one thread.
+	if (num_threads > 0 && !has_pixel_streams()) {
+		throw std::invalid_argument("Yee diagram: Multithreading "
+			"requires a seeded pseudorandom or scrambled Sobol "
+			"ballot generator source");
+	}
+
 	inited = true;
 
 	// Each round, we draw a new row. However, if we want to have
@@ -602,23 +783,35 @@ std::string yee::do_round(bool give_brief_status) {
 			+ ": drawing x = " + itos(row_number);
 
 		long long grand_sum = 0;
+		std::vector<std::vector<bool> > pixel_winners;
 
-		for (int y = 0; y < y_size; ++y) {
-			long long contrib = check_pixel(row_number, y, x_size, y_size,
-					e_methods, *voter_pdf,
-					winners_all_m_all_cand,
-					min_num_voters, max_num_voters,
-					use_autopilot, autopilot_factor,
-					autopilot_history_len, &cmap,
-					*coordinate_sources[PURPOSE_BALLOT_GENERATOR]);
+		if (num_threads > 0) {
+			grand_sum = check_column_by_pixel(row_number);
 
-			if (contrib == -1) {
+			if (grand_sum == -1) {
 				std::cerr << "Yee: error at round " << cur_round
-					<< ", x = " << row_number << ", y = " << y << std::endl;
+					<< std::endl;
 				return ("");
 			}
+		} else {
+			for (int y = 0; y < y_size; ++y) {
+				long long contrib = check_pixel(row_number, y,
+						e_methods, *voter_pdf, num_candidates,
+						pixel_winners, min_num_voters, max_num_voters,
+						use_autopilot, autopilot_factor,
+						autopilot_history_len, &cmap,
+						*coordinate_sources[PURPOSE_BALLOT_GENERATOR]);
+
+				if (contrib == -1) {
+					std::cerr << "Yee: error at round " << cur_round
+						<< ", x = " << row_number << ", y = " << y
+						<< std::endl;
+					return ("");
+				}
 
-			grand_sum += contrib;
+				paint_pixel(row_number, y, pixel_winners);
+				grand_sum += contrib;
+			}
 		}
 
 		output += ", " + lltos(grand_sum) + " voters in all.";
@@ -66,18 +66,34 @@ class yee : public mode {
 		std::vector<std::vector<double> > get_candidate_colors(int numcands,
 			bool debug) const;
 
-		// Test a given pixel and update winners arrays. See the .cc
-		// for more information.
-		long long check_pixel(int x, int y, int xsize, int ysize,
+		// Test a given pixel and write who won into pixel_winners,
+		// indexed by method and then candidate. See the .cc for more
+		// information.
+		long long check_pixel(int x, int y,
 			const std::vector<std::shared_ptr<const election_method> > & methods,
-			spatial_generator & ballotgen,
-			std::vector<std::vector<std::vector<std::vector<bool > > > > &
-			am_ac_winners, int min_num_voters_in,
+			spatial_generator & ballotgen, size_t num_cands,
+			std::vector<std::vector<bool> > & pixel_winners,
+			int min_num_voters_in,
 			int max_num_voters_in, bool do_use_autopilot,
 			double autopilot_factor_in,
 			int autopilot_history_in, cache_map * cache,
 			coordinate_gen & ballot_coord_source) const;
 
+		// Transfer the output of check_pixel to the winners arrays.
+		void paint_pixel(int x, int y,
+			const std::vector<std::vector<bool> > & pixel_winners);
+
+		// Multithreaded rendering. Each pixel gets its own random
+		// number stream, seeded by hashing the ballot generator
+		// source's seed together with the pixel's coordinates, so the
+		// picture doesn't depend on the number of threads or the order
+		// in which the pixels are drawn. This requires a source that
+		// can be split (see has_pixel_streams).
+		int num_threads;
+		bool has_pixel_streams() const;
+		uint64_t get_pixel_seed(uint64_t base_seed, int x, int y) const;
+		long long check_column_by_pixel(int x);
+
 		// Given complete winners arrays, draw the different pictures
 		// that visualize those arrays. The method name and RNG seed
 		// are added to the picture as text metadata for archiving etc.
@@ -132,6 +148,23 @@ class yee : public mode {
 		template<typename T> void add_methods(T start_iter, T end_iter);
 		void clear_methods();
 
+		// If num_threads_in is zero (the default), pixels are drawn
+		// one at a time from the shared ballot generator coordinate
+		// source, as they always have been. Otherwise, each column is
+		// drawn by num_threads_in threads, and the output only depends
+		// on the seed of the ballot generator source, which must then
+		// be a pseudorandom generator or a scrambled Sobol sequence
+		// with a fixed seed. (In the latter case, every pixel gets its
+		// own scramble.) So one thread draws the same picture as any
+		// other number of threads, but not the same as zero threads.
+		// The election methods must be safe to call from several
+		// threads at once.
+		void set_num_threads(int num_threads_in);
+
+		int get_num_threads() const {
+			return num_threads;
+		}
+
 		// Will reinit if already inited.
 		bool init();
 
@@ -9,6 +9,30 @@ class birational_eval : public scored_method {
 		double K;
 		bool relative;
 
+		double get_rating(size_t candidate,
+			const scored_ballot & this_ballot) const;
+
+	protected:
+		// The objective factors into (sum of ratings) times (sum of
+		// 1/(K + rating)) over the council.
+		size_t get_num_council_sums() const {
+			return 2;
+		}
+
+		double get_sum_term(size_t sum_idx, size_t candidate,
+			const scored_ballot & this_ballot) {
+			if (sum_idx == 0) {
+				return get_rating(candidate, this_ballot);
+			} else {
+				return 1 / (K + get_rating(candidate, this_ballot));
+			}
+		}
+
+		double evaluate_from_sums(const double * sums, size_t,
+			size_t ballot_idx) {
+			return sums[0] * sums[1] * scored_ballots[ballot_idx].weight;
+		}
+
 	public:
 		std::string name() const {
 
@@ -75,25 +99,10 @@ inline double birational_eval::evaluate(combo::it & start, combo::it & end,
 	double total = 0, atw, ats;
 
 	for (auto pos = start; pos != end; ++pos) {
-		size_t w = *pos;
+		atw = get_rating(*pos, this_ballot);
 
 		for (auto sec_pos = start; sec_pos != end; ++sec_pos) {
-			size_t s = *sec_pos;
-
-			if (relative) {
-				atw = this_ballot.get_norm_score(w);
-				ats = this_ballot.get_norm_score(s);
-			} else {
-				atw = this_ballot.scores[w];
-				ats = this_ballot.scores[s];
-			}
-
-			if (!isfinite(atw)) {
-				atw = 0;
-			}
-			if (!isfinite(ats)) {
-				ats = 0;
-			}
+			ats = get_rating(*sec_pos, this_ballot);
 
 			total += atw / (K + ats);
 		}
@@ -102,4 +111,22 @@ inline double birational_eval::evaluate(combo::it & start, combo::it & end,
 	return total * this_ballot.weight;
 }
 
+inline double birational_eval::get_rating(size_t candidate,
+	const scored_ballot & this_ballot) const {
+
+	double rating;
+
+	if (relative) {
+		rating = this_ballot.get_norm_score(candidate);
+	} else {
+		rating = this_ballot.scores[candidate];
+	}
+
+	if (!isfinite(rating)) {
+		return 0;
+	}
+
+	return rating;
+}
+
 typedef exhaustive_method_runner<birational_eval> birational;
@@ -18,11 +18,25 @@ class harmonic_voting_eval : public scored_method {
 		double evaluate(combo::it & start, combo::it & end,
 			const scored_ballot & this_ballot);
 
+		// Returns the quality of the first num_ratings entries of
+		// elected_ratings, sorting them in the process.
+		double evaluate_ratings(size_t num_ratings, double weight);
+
 		double delta;
 
 		std::vector<double> elected_ratings;
 
 	public:
+		// Harmonic quality only gets better if a rating increases, so
+		// we can bound it by supposing that the remaining seats go to
+		// the voter's favorite remaining candidates.
+		bool has_bound() {
+			return prepare_rating_bounds();
+		}
+
+		double get_bound(combo::it start, combo::it end,
+			size_t first_available, size_t council_size);
+
 		std::string name() const {
 			if (delta == 0) {
 				return "Cardinal: Harmonic (Chamberlin-Courant)";
@@ -77,20 +91,27 @@ inline double harmonic_voting_eval::evaluate(combo::it & start,
 
 	elected_ratings.resize(council_size);
 
-	double quality = 0;
 	size_t idx = 0;
 
 	for (auto pos = start; pos != end; ++pos) {
 		elected_ratings[idx++] = this_ballot.get_norm_score(*pos);
 	}
 
-	std::sort(elected_ratings.begin(), elected_ratings.begin()+idx,
+	return evaluate_ratings(idx, this_ballot.weight);
+}
+
+inline double harmonic_voting_eval::evaluate_ratings(size_t num_ratings,
+	double weight) {
+
+	double quality = 0;
+
+	std::sort(elected_ratings.begin(), elected_ratings.begin()+num_ratings,
 		std::greater<double>());
 
 	// Note that this will work as a "no opinion" marker; if the voter
 	// hasn't rated anybody, then we don't return below-minimum, we
 	// return zero.
-	if (elected_ratings.empty()) {
+	if (num_ratings == 0) {
 		return 0;
 	}
 
@@ -99,18 +120,46 @@ inline double harmonic_voting_eval::evaluate(combo::it & start,
 	// of the file for how this makes sense.)
 
 	if (delta == 0) {
-		return this_ballot.weight * elected_ratings[0];
+		return weight * elected_ratings[0];
 	}
 
 	// Otherwise, do full Harmonic.
 
-	for (size_t i = 0; i < council_size; ++i) {
+	for (size_t i = 0; i < num_ratings; ++i) {
 		quality += elected_ratings[i] / (i + delta);
 	}
 
-	return this_ballot.weight * quality;
+	return weight * quality;
+}
+
+inline double harmonic_voting_eval::get_bound(combo::it start,
+	combo::it end, size_t first_available, size_t council_size) {
+
+	elected_ratings.resize(council_size);
+	double bound = 0;
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		size_t idx = 0;
+
+		for (auto pos = start; pos != end; ++pos) {
+			elected_ratings[idx++] =
+				scored_ballots[ballot].get_norm_score(*pos);
+		}
+
+		const double * best_remaining = get_best_remaining_ratings(
+				ballot, first_available, council_size);
+
+		for (size_t i = 0; idx < council_size; ++i) {
+			elected_ratings[idx++] = best_remaining[i];
+		}
+
+		bound += evaluate_ratings(council_size,
+				scored_ballots[ballot].weight);
+	}
+
+	return bound;
 }
 
-typedef exhaustive_method_runner<harmonic_voting_eval> harmonic_voting;
+typedef branch_bound_runner<harmonic_voting_eval> harmonic_voting;
 typedef sequential_method_runner<harmonic_voting_eval>
 sequential_harmonic_voting;
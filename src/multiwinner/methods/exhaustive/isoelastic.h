@@ -8,8 +8,32 @@ class isoelastic_eval : public scored_method {
 		double evaluate(combo::it & start, combo::it & end,
 			const scored_ballot & this_ballot);
 
+		double evaluate_from_rating_sum(double total_rating,
+			double weight) const;
+
 		double r;
 
+	protected:
+		size_t get_num_council_sums() const {
+			return 1;
+		}
+
+		// Since x^(r-1)/(r-1) is increasing for every r.
+		bool improves_with_rating_sum() const {
+			return true;
+		}
+
+		double get_sum_term(size_t, size_t candidate,
+			const scored_ballot & this_ballot) {
+			return this_ballot.get_norm_score(candidate);
+		}
+
+		double evaluate_from_sums(const double * sums, size_t,
+			size_t ballot_idx) {
+			return evaluate_from_rating_sum(sums[0],
+					scored_ballots[ballot_idx].weight);
+		}
+
 	public:
 		std::string name() const {
 			return "Cardinal: Isoelastic (r = " + dtos(r) + ")";
@@ -58,6 +82,12 @@ inline double isoelastic_eval::evaluate(combo::it & start, combo::it & end,
 		total_rating += this_ballot.get_norm_score(*pos);
 	}
 
+	return evaluate_from_rating_sum(total_rating, this_ballot.weight);
+}
+
+inline double isoelastic_eval::evaluate_from_rating_sum(
+	double total_rating, double weight) const {
+
 	double r_adj = r;
 
 	if (r == 1) {
@@ -66,7 +96,7 @@ inline double isoelastic_eval::evaluate(combo::it & start, combo::it & end,
 		r_adj = 1 + 1e-15;
 	}
 
-	return this_ballot.weight * pow(total_rating, r_adj-1)/(r_adj-1);
+	return weight * pow(total_rating, r_adj-1)/(r_adj-1);
 }
 
-typedef exhaustive_method_runner<isoelastic_eval> isoelastic;
+typedef branch_bound_runner<isoelastic_eval> isoelastic;
@@ -8,9 +8,42 @@ class log_penalty_eval : public scored_method {
 		double evaluate(combo::it & start, combo::it & end,
 			const scored_ballot & this_ballot);
 
+		double evaluate_from_denominator(double inner_denominator,
+			size_t num_seats, double score_total, double weight) const;
+
 		double K;
 
+		// The sum of each voter's (unnormalized) scores.
+		std::vector<double> score_totals;
+		bool nonnegative_totals;
+
+	protected:
+		size_t get_num_council_sums() const {
+			return 1;
+		}
+
+		// The log term decreases as the sum of ratings increases, so
+		// the penalty does too, unless some voter's scores sum to
+		// something negative.
+		bool improves_with_rating_sum() const {
+			return nonnegative_totals;
+		}
+
+		double get_sum_term(size_t, size_t candidate,
+			const scored_ballot & this_ballot) {
+			return this_ballot.get_norm_score(candidate);
+		}
+
+		double evaluate_from_sums(const double * sums, size_t council_size,
+			size_t ballot_idx) {
+			return evaluate_from_denominator(sums[0], council_size,
+					score_totals[ballot_idx], scored_ballots[ballot_idx].weight);
+		}
+
 	public:
+		void process_ballots(const election_t & ballots,
+			size_t num_candidates);
+
 		std::string name() const {
 			if (K == 0) {
 				return "Cardinal: LPV0+";
@@ -25,6 +58,7 @@ class log_penalty_eval : public scored_method {
 
 		log_penalty_eval() {
 			K = 0;
+			nonnegative_totals = false;
 		}
 
 		log_penalty_eval(double K_in) {
@@ -33,6 +67,7 @@ class log_penalty_eval : public scored_method {
 			}
 
 			K = K_in;
+			nonnegative_totals = false;
 		}
 };
 
@@ -68,24 +103,51 @@ inline double log_penalty_eval::evaluate(combo::it & start,
 		inner_denominator += this_ballot.get_norm_score(*pos);
 	}
 
+	double score_total = 0;
+
+	for (auto score_pos = this_ballot.scores.begin();
+		score_pos != this_ballot.scores.end(); ++score_pos) {
+		score_total += *score_pos;
+	}
+
+	return evaluate_from_denominator(inner_denominator, end - start,
+			score_total, this_ballot.weight);
+}
+
+inline double log_penalty_eval::evaluate_from_denominator(
+	double inner_denominator, size_t num_seats, double score_total,
+	double weight) const {
+
 	if (inner_denominator == 0 && K == 0) {
 		// This will return an infinity. Return a very large value as
 		// a HACK.
-		return this_ballot.weight * 1e15;
+		return weight * 1e15;
 	}
 
-	// Otherwise calculate the product.
+	// Otherwise calculate the product. The log term is the same for
+	// every candidate, so we can sum the scores first.
 
-	double voter_contribution = 0;
-	size_t num_seats = end - start;
 	double log_denom = log((K +  num_seats) / (K + inner_denominator));
 
-	for (auto score_pos = this_ballot.scores.begin();
-		score_pos != this_ballot.scores.end(); ++score_pos) {
-		voter_contribution += *score_pos * log_denom;
-	}
+	return weight * score_total * log_denom;
+}
+
+inline void log_penalty_eval::process_ballots(const election_t & ballots,
+	size_t num_candidates) {
+
+	scored_method::process_ballots(ballots, num_candidates);
 
-	return this_ballot.weight * voter_contribution;
+	score_totals.clear();
+	nonnegative_totals = true;
+
+	for (const scored_ballot & ballot: scored_ballots) {
+		double score_total = 0;
+		for (double score: ballot.scores) {
+			score_total += score;
+		}
+		score_totals.push_back(score_total);
+		nonnegative_totals &= score_total >= 0;
+	}
 }
 
-typedef exhaustive_method_runner<log_penalty_eval> log_penalty;
+typedef branch_bound_runner<log_penalty_eval> log_penalty;
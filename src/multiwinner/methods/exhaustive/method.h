@@ -5,11 +5,15 @@
 #include <list>
 #include <numeric>
 #include <stdexcept>
+#include <algorithm>
+
+#include <omp.h>
 
 #include <math.h>
 #include <assert.h>
 
 #include "lib/combinations/combinations.h"
+#include "tools/revolving_door.h"
 
 #include "multiwinner/methods/methods.h"
 #include "optima.h"
@@ -43,20 +47,65 @@ class exhaustive_method {
 		// a score or penalty for that particular assignment.
 		virtual double evaluate(combo::it & start, combo::it & end) = 0;
 
+	public:
+
+		virtual ~exhaustive_method() {}
+
 		// What is the direction of optimization - greater is better or
 		// less is better?
 		virtual bool maximize() const = 0;
 
-	public:
+		// The runner goes through the councils in revolving door order,
+		// where each council differs from the one before by a single
+		// candidate. Methods that can use this to update the objective
+		// more quickly than by evaluating from scratch should override
+		// these. evaluate_first is called at the start of each run of
+		// councils, and evaluate_next for the rest of the run.
+		virtual double evaluate_first(combo::it start, combo::it end) {
+			return evaluate(start, end);
+		}
 
-		virtual ~exhaustive_method() {}
+		virtual double evaluate_next(combo::it start, combo::it end,
+			size_t /*removed*/, size_t /*added*/) {
+			return evaluate(start, end);
+		}
 
-		bool operator()(combo::it start, combo::it end) {
+		// If the incremental objective values or the bounds below may
+		// differ from what evaluate() would give due to rounding, this
+		// should return an upper bound on the absolute difference.
+		virtual double rounding_tolerance() const {
+			return 0;
+		}
+
+		// Methods that can bound the objective of partial councils
+		// should return true from has_bound and implement get_bound.
+		// The latter returns an optimistic bound (upper if maximizing,
+		// lower otherwise) on the objective of every council of
+		// council_size candidates made up of the candidates in
+		// [start, end) and candidates numbered first_available or
+		// higher.
+		virtual bool has_bound() {
+			return false;
+		}
+
+		virtual double get_bound(combo::it /*start*/, combo::it /*end*/,
+			size_t /*first_available*/, size_t /*council_size*/) {
+			return NAN;
+		}
+
+		// Evaluates the council, updates the optimum, and returns the
+		// objective value.
+		double evaluate_and_update(combo::it start, combo::it end) {
 			double objective_value = evaluate(start, end);
 
 			current_optimum.update(objective_value,
 				start, end);
 
+			return objective_value;
+		}
+
+		bool operator()(combo::it start, combo::it end) {
+			evaluate_and_update(start, end);
 			return false; // Keep going.
 		}
 
@@ -101,26 +150,179 @@ template<class T> class exhaustive_method_runner : public
 		}
 };
 
+// The parallel runner splits the councils into runs and keeps, for each
+// run, the best council it's seen. Incremental evaluation may be off by a
+// little, so when two councils are too close to tell apart, we evaluate
+// both exactly and keep the better one, or the lexicographically first if
+// they tie. Afterwards we evaluate each run's council exactly to pick the
+// winner.
+
+class council_shortlist {
+	private:
+		bool maximize;
+		double tolerance;
+		std::vector<size_t> council;
+		double council_value, council_exact_value;
+		bool has_exact_value;
+
+		bool is_better(double value, double than) const {
+			if (maximize) {
+				return value > than;
+			} else {
+				return value < than;
+			}
+		}
+
+	public:
+		// exact_value(council) gives the exact objective value.
+		template<typename F> void update(double value,
+			const std::vector<size_t> & council_in, F exact_value) {
+
+			// NaN means inadmissible, as for exhaustive_optima.
+			if (isnan(value)) {
+				return;
+			}
+
+			// Both values may be off by the tolerance. Check for
+			// equality separately, since the values may be infinite.
+			double slack = 2 * std::max(tolerance,
+					1e-9 * fabs(council_value));
+			bool near_tie = !council.empty() && (value == council_value ||
+					fabs(value - council_value) <= slack);
+
+			if (!council.empty() && !near_tie &&
+				is_better(council_value, value)) {
+				return;
+			}
+
+			if (near_tie) {
+				if (!has_exact_value) {
+					council_exact_value = exact_value(council);
+					has_exact_value = true;
+				}
+
+				double exact = exact_value(council_in);
+
+				if (!is_better(exact, council_exact_value) &&
+					(exact != council_exact_value ||
+						!(council_in < council))) {
+					return;
+				}
+
+				council_exact_value = exact;
+			} else {
+				has_exact_value = false;
+			}
+
+			council = council_in;
+			council_value = value;
+		}
+
+		// Returns an empty vector if every council was inadmissible.
+		const std::vector<size_t> & get_council() const {
+			return council;
+		}
+
+		council_shortlist(bool maximize_in, double tolerance_in) {
+			maximize = maximize_in;
+			tolerance = tolerance_in;
+			council_value = 0;
+			council_exact_value = 0;
+			has_exact_value = false;
+		}
+};
+
 template<class T> council_t
 exhaustive_method_runner<T>::get_council(
 	size_t council_size, size_t num_candidates,
 	const election_t & ballots) const {
 
-	std::vector<size_t> v(num_candidates);
-	std::iota(v.begin(), v.end(), 0);
-
-	// This is a bit hacky, but necessary due to how
-	// for_each_combination works. We clone our derived
-	// class, pass it as a function, and then this clone
-	// carries out all the calculations and returns it
-	// through operator(). The constructor initializes
-	// any auxiliary structures we might need, like score
-	// arrays.
+	// This is a bit hacky. We clone our derived class and then it
+	// carries out all the calculations. The constructor initializes
+	// any auxiliary structures we might need, like score arrays.
+	// Each thread then gets its own copy, since evaluation may
+	// modify the evaluator.
 	T evaluator(params_set);
 	evaluator.process_ballots(ballots, num_candidates);
 
-	exhaustive_optima optimum = for_each_combination(v.begin(),
-			v.begin() + council_size, v.end(), evaluator);
+	const exhaustive_method & method = evaluator;
+
+	// Split the councils, in revolving door order, into runs that the
+	// threads can handle independently. The runs are short enough that
+	// the incremental evaluation doesn't drift much, and that the threads
+	// get work of about the same size.
+
+	const uint64_t MAX_RUN_LENGTH = 4096;
+
+	uint64_t num_councils = revolving_door::num_combinations(
+			num_candidates, council_size),
+		num_runs = std::max((uint64_t)4 * omp_get_max_threads(),
+			(num_councils + MAX_RUN_LENGTH - 1) / MAX_RUN_LENGTH);
+	num_runs = std::min(num_runs, num_councils);
+
+	uint64_t run_length = 0;
+	if (num_runs > 0) {
+		run_length = (num_councils + num_runs - 1) / num_runs;
+	}
+
+	std::vector<council_shortlist> shortlists(num_runs,
+		council_shortlist(method.maximize(),
+			method.rounding_tolerance()));
+
+	#pragma omp parallel
+	{
+		T run_evaluator(evaluator), exact_evaluator(evaluator);
+		size_t removed, added;
+
+		// The exact evaluator also tracks its own optimum, but
+		// nothing looks at it.
+		auto exact_value = [&exact_evaluator](
+			const std::vector<size_t> & council) {
+			return exact_evaluator.evaluate_and_update(council.begin(),
+					council.end());
+		};
+
+		#pragma omp for schedule(dynamic)
+		for (uint64_t run = 0; run < num_runs; ++run) {
+			uint64_t first = run * run_length,
+					 last = std::min(first + run_length, num_councils);
+
+			if (first >= last) {
+				continue;
+			}
+
+			std::vector<size_t> council = revolving_door::unrank(first,
+					num_candidates, council_size);
+
+			shortlists[run].update(run_evaluator.evaluate_first(
+					council.begin(), council.end()), council, exact_value);
+
+			for (uint64_t rank = first + 1; rank < last; ++rank) {
+				revolving_door::next(council, num_candidates, removed, added);
+				shortlists[run].update(run_evaluator.evaluate_next(
+						council.begin(), council.end(), removed, added), council,
+					exact_value);
+			}
+		}
+	}
+
+	// Now evaluate each run's council exactly, in lexicographic order.
+	// This gives the same result as going through every council in that
+	// order, which is what we used to do.
+
+	std::vector<std::vector<size_t> > candidate_optima;
+	for (const council_shortlist & shortlist: shortlists) {
+		if (!shortlist.get_council().empty()) {
+			candidate_optima.push_back(shortlist.get_council());
+		}
+	}
+	std::sort(candidate_optima.begin(), candidate_optima.end());
+
+	for (const std::vector<size_t> & council: candidate_optima) {
+		evaluator(council.begin(), council.end());
+	}
+
+	exhaustive_optima optimum(evaluator);
 
 	council_t out;
 
@@ -133,6 +335,165 @@ exhaustive_method_runner<T>::get_council(
 	return out;
 }
 
+// This runner finds the same council as exhaustive_method_runner, but
+// uses branch and bound to skip parts of the search space that can't
+// contain an optimum. It goes through the councils in lexicographic
+// order, and never prunes councils that might tie the best found so far,
+// so ties are broken the same way. If the method doesn't support bounds,
+// we fall back to the exhaustive runner.
+
+template<class T> class branch_bound_runner : public
+	multiwinner_method {
+	private:
+		T params_set;
+
+		void search(T & evaluator, std::vector<size_t> & council,
+			size_t depth, size_t first_available, size_t num_candidates,
+			double & incumbent) const;
+
+		bool is_worse(const exhaustive_method & method, double value,
+			double reference) const;
+
+	public:
+		council_t get_council(size_t council_size,
+			size_t num_candidates, const election_t & ballots) const;
+
+		std::string name() const {
+			return params_set.name();
+		}
+
+		void set_parameters(const T reference) {
+			params_set = reference;
+		}
+
+		branch_bound_runner() {}
+		branch_bound_runner(const T reference) {
+			set_parameters(reference);
+		}
+};
+
+// Is the value worse than the reference by more than rounding error?
+// NaN references (nothing found yet) are never beaten.
+
+template<class T> bool branch_bound_runner<T>::is_worse(
+	const exhaustive_method & method, double value,
+	double reference) const {
+
+	if (isnan(reference)) {
+		return false;
+	}
+
+	double slack = std::max(method.rounding_tolerance(),
+			1e-9 * fabs(reference));
+
+	if (method.maximize()) {
+		return value < reference - slack;
+	} else {
+		return value > reference + slack;
+	}
+}
+
+template<class T> void branch_bound_runner<T>::search(T & evaluator,
+	std::vector<size_t> & council, size_t depth, size_t first_available,
+	size_t num_candidates, double & incumbent) const {
+
+	exhaustive_method & method = evaluator;
+
+	if (depth == council.size()) {
+		double value = method.evaluate_and_update(council.begin(),
+				council.end());
+
+		if (!isnan(value) && (isnan(incumbent) ||
+				is_worse(method, incumbent, value))) {
+			incumbent = value;
+		}
+		return;
+	}
+
+	size_t seats_left = council.size() - depth;
+
+	for (size_t cand = first_available;
+		cand + seats_left <= num_candidates; ++cand) {
+
+		council[depth] = cand;
+
+		double bound = method.get_bound(council.begin(),
+				council.begin() + depth + 1, cand + 1, council.size());
+
+		if (!is_worse(method, bound, incumbent)) {
+			search(evaluator, council, depth + 1, cand + 1,
+				num_candidates, incumbent);
+		}
+	}
+}
+
+template<class T> council_t
+branch_bound_runner<T>::get_council(
+	size_t council_size, size_t num_candidates,
+	const election_t & ballots) const {
+
+	T evaluator(params_set);
+	evaluator.process_ballots(ballots, num_candidates);
+
+	exhaustive_method & method = evaluator;
+
+	if (!method.has_bound() || council_size > num_candidates) {
+		return exhaustive_method_runner<T>(params_set).get_council(
+				council_size, num_candidates, ballots);
+	}
+
+	// Get a good council to start with by adding candidates greedily.
+	// The greater the starting value, the more we can prune.
+
+	T greedy_evaluator(evaluator);
+	exhaustive_method & greedy = greedy_evaluator;
+	std::vector<size_t> council;
+	std::vector<bool> elected(num_candidates, false);
+	double incumbent = NAN;
+
+	for (size_t seat = 0; seat < council_size; ++seat) {
+		size_t best_cand = 0;
+		bool found = false;
+		incumbent = NAN;
+		council.push_back(0);
+
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			if (elected[cand]) {
+				continue;
+			}
+
+			*council.rbegin() = cand;
+			double value = greedy.evaluate_and_update(council.begin(),
+					council.end());
+
+			if (!found || is_worse(greedy, incumbent, value)) {
+				incumbent = value;
+				best_cand = cand;
+				found = !isnan(value);
+			}
+		}
+
+		*council.rbegin() = best_cand;
+		elected[best_cand] = true;
+	}
+
+	// Then do the search. The exhaustive_optima we get out only includes
+	// the optimal councils in the direction we're optimizing in.
+
+	council.resize(council_size);
+	search(evaluator, council, 0, 0, num_candidates, incumbent);
+
+	exhaustive_optima optimum(evaluator);
+
+	council_t out;
+
+	for (size_t i: optimum.get_optimal_solution()) {
+		out.push_back(i);
+	}
+
+	return out;
+}
+
 // Duplication HACK
 
 template<class T> class sequential_method_runner : public
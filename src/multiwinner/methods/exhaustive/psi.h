@@ -18,8 +18,32 @@ class psi_voting_eval : public scored_method {
 		double evaluate(combo::it & start, combo::it & end,
 			const scored_ballot & this_ballot);
 
+		double evaluate_from_rating_sum(double norm_rating_sum,
+			double weight) const;
+
 		double delta;
 
+	protected:
+		size_t get_num_council_sums() const {
+			return 1;
+		}
+
+		// Since digamma is increasing.
+		bool improves_with_rating_sum() const {
+			return true;
+		}
+
+		double get_sum_term(size_t, size_t candidate,
+			const scored_ballot & this_ballot) {
+			return this_ballot.get_norm_score(candidate);
+		}
+
+		double evaluate_from_sums(const double * sums, size_t,
+			size_t ballot_idx) {
+			return evaluate_from_rating_sum(sums[0],
+					scored_ballots[ballot_idx].weight);
+		}
+
 	public:
 		std::string name() const {
 			if (delta == 0.5) {
@@ -64,6 +88,12 @@ inline double psi_voting_eval::evaluate(combo::it & start, combo::it & end,
 		norm_rating_sum += this_ballot.get_norm_score(*pos);
 	}
 
+	return evaluate_from_rating_sum(norm_rating_sum, this_ballot.weight);
+}
+
+inline double psi_voting_eval::evaluate_from_rating_sum(
+	double norm_rating_sum, double weight) const {
+
 	// digamma(0) = +/- infinity. HACK to deal with this without having
 	// to bring in infinities.
 	// Since we're given normalized scores, these can't ever be below
@@ -71,11 +101,11 @@ inline double psi_voting_eval::evaluate(combo::it & start, combo::it & end,
 	// the positive side, i.e. x -> 0+; and intuitively, it makes sense
 	// that not being represented (all scores 0) is bad, not good.
 	if (delta + norm_rating_sum == 0) {
-		return -1e9 * this_ballot.weight;
+		return -1e9 * weight;
 	}
 
-	return digamma(delta + norm_rating_sum) * this_ballot.weight;
+	return digamma(delta + norm_rating_sum) * weight;
 }
 
-typedef exhaustive_method_runner<psi_voting_eval> psi_voting;
+typedef branch_bound_runner<psi_voting_eval> psi_voting;
 typedef sequential_method_runner<psi_voting_eval> sequential_psi_voting;
\ No newline at end of file
@@ -1,9 +1,14 @@
 #include "scored_method.h"
 
 #include <vector>
+#include <algorithm>
 
 void scored_method::process_ballots(const
-	election_t & ballots, size_t num_candidates) {
+	election_t & ballots, size_t num_candidates_in) {
+
+	num_candidates = num_candidates_in;
+	sums_prepared = false;
+	bounds_prepared = false;
 
 	// This is used to calculate birational and LPV results quickly, as
 	// those methods have terms like "voter X's rating of candidate Y".
@@ -47,4 +52,236 @@ void scored_method::process_ballots(const
 		}
 		++ballot_idx;
 	}
-}
\ No newline at end of file
+}
+
+void scored_method::prepare_sums() {
+	num_sums = get_num_council_sums();
+	use_sums = num_sums > 0;
+	sums_prepared = true;
+
+	if (!use_sums) {
+		return;
+	}
+
+	sum_terms.resize(scored_ballots.size() * num_candidates * num_sums);
+	council_sums.resize(scored_ballots.size() * num_sums);
+	nonzero_terms.resize(scored_ballots.size() * num_sums);
+
+	size_t idx = 0;
+
+	for (const scored_ballot & ballot: scored_ballots) {
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			for (size_t i = 0; i < num_sums; ++i) {
+				sum_terms[idx] = get_sum_term(i, cand, ballot);
+
+				// Infinities and NaNs don't survive being added and
+				// then subtracted again, so fall back to evaluating
+				// every council from scratch.
+				if (!isfinite(sum_terms[idx])) {
+					use_sums = false;
+					return;
+				}
+				++idx;
+			}
+		}
+	}
+}
+
+double scored_method::evaluate_council_sums(size_t council_size) {
+	double sum = 0;
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		double * sums = council_sums.data() + ballot * num_sums;
+
+		for (size_t i = 0; i < num_sums; ++i) {
+			if (nonzero_terms[ballot * num_sums + i] == 0) {
+				sums[i] = 0;
+			}
+		}
+
+		sum += evaluate_from_sums(sums, council_size, ballot);
+	}
+
+	return sum;
+}
+
+double scored_method::evaluate_first(combo::it start, combo::it end) {
+	if (!sums_prepared) {
+		prepare_sums();
+	}
+
+	if (!use_sums) {
+		return evaluate(start, end);
+	}
+
+	std::fill(council_sums.begin(), council_sums.end(), 0);
+	std::fill(nonzero_terms.begin(), nonzero_terms.end(), 0);
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		for (auto pos = start; pos != end; ++pos) {
+			const double * terms = sum_terms.data() +
+				(ballot * num_candidates + *pos) * num_sums;
+
+			for (size_t i = 0; i < num_sums; ++i) {
+				council_sums[ballot * num_sums + i] += terms[i];
+				nonzero_terms[ballot * num_sums + i] += (terms[i] != 0);
+			}
+		}
+	}
+
+	return evaluate_council_sums(end - start);
+}
+
+double scored_method::evaluate_next(combo::it start, combo::it end,
+	size_t removed, size_t added) {
+
+	if (!sums_prepared || !use_sums) {
+		return evaluate_first(start, end);
+	}
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		const double * removed_terms = sum_terms.data() +
+			(ballot * num_candidates + removed) * num_sums,
+			* added_terms = sum_terms.data() +
+				(ballot * num_candidates + added) * num_sums;
+
+		for (size_t i = 0; i < num_sums; ++i) {
+			size_t idx = ballot * num_sums + i;
+
+			council_sums[idx] += added_terms[i] - removed_terms[i];
+			nonzero_terms[idx] += (added_terms[i] != 0);
+			nonzero_terms[idx] -= (removed_terms[i] != 0);
+		}
+	}
+
+	return evaluate_council_sums(end - start);
+}
+
+double scored_method::rounding_tolerance() const {
+	// The runner restarts the incremental evaluation every few thousand
+	// councils, so the sums shouldn't be off by more than a few thousand
+	// ulps. This is much more than that, per voter.
+	double total_weight = 0;
+
+	for (const scored_ballot & ballot: scored_ballots) {
+		total_weight += ballot.weight;
+	}
+
+	return 1e-8 * total_weight;
+}
+
+bool scored_method::prepare_rating_bounds() {
+	if (bounds_prepared) {
+		return bounds_valid;
+	}
+
+	bounds_prepared = true;
+	bounds_valid = true;
+	table_seats = 0;
+
+	for (const scored_ballot & ballot: scored_ballots) {
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			if (!isfinite(ballot.get_norm_score(cand))) {
+				bounds_valid = false;
+			}
+		}
+	}
+
+	return bounds_valid;
+}
+
+void scored_method::build_remaining_table(size_t seats) {
+	table_seats = seats;
+	best_remaining_ratings.resize(scored_ballots.size() *
+		(num_candidates + 1) * seats);
+
+	// Go from the last candidate to the first, inserting each rating
+	// into the sorted list we got from the candidates after it.
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		double * table = best_remaining_ratings.data() +
+			ballot * (num_candidates + 1) * seats;
+
+		std::fill(table + num_candidates * seats,
+			table + (num_candidates + 1) * seats, 0);
+
+		for (size_t cand = num_candidates; cand > 0; --cand) {
+			const double * after = table + cand * seats;
+			double * here = table + (cand-1) * seats;
+			double rating = scored_ballots[ballot].get_norm_score(cand-1);
+
+			size_t i = 0;
+			for (; i < seats && after[i] >= rating; ++i) {
+				here[i] = after[i];
+			}
+			if (i < seats) {
+				here[i] = rating;
+			}
+			for (++i; i < seats; ++i) {
+				here[i] = after[i-1];
+			}
+		}
+	}
+}
+
+const double * scored_method::get_best_remaining_ratings(
+	size_t ballot_idx, size_t first_available, size_t council_size) {
+
+	if (council_size > table_seats) {
+		build_remaining_table(council_size);
+	}
+
+	return best_remaining_ratings.data() + (ballot_idx *
+			(num_candidates + 1) + first_available) * table_seats;
+}
+
+bool scored_method::has_bound() {
+	return improves_with_rating_sum() && prepare_rating_bounds();
+}
+
+double scored_method::get_bound(combo::it start, combo::it end,
+	size_t first_available, size_t council_size) {
+
+	size_t seats_left = council_size - (end - start), i;
+	double bound = 0;
+
+	for (size_t ballot = 0; ballot < scored_ballots.size(); ++ballot) {
+		double rating_sum = 0;
+
+		for (auto pos = start; pos != end; ++pos) {
+			rating_sum += scored_ballots[ballot].get_norm_score(*pos);
+		}
+
+		// Some methods have special cases for voters who rate every
+		// council member zero, which may break monotonicity. So if the
+		// voter might end up like that, check that case too.
+		double zero_sum = 0, at_zero = 0;
+		bool may_be_zero = rating_sum == 0;
+
+		if (may_be_zero) {
+			at_zero = evaluate_from_sums(&zero_sum, council_size, ballot);
+		}
+
+		const double * best_remaining = get_best_remaining_ratings(
+				ballot, first_available, council_size);
+
+		for (i = 0; i < seats_left; ++i) {
+			rating_sum += best_remaining[i];
+		}
+
+		double ballot_bound = evaluate_from_sums(&rating_sum, council_size,
+				ballot);
+
+		if (may_be_zero) {
+			if (maximize()) {
+				ballot_bound = std::max(ballot_bound, at_zero);
+			} else {
+				ballot_bound = std::min(ballot_bound, at_zero);
+			}
+		}
+
+		bound += ballot_bound;
+	}
+
+	return bound;
+}
@@ -36,13 +36,96 @@ class scored_method : public exhaustive_method {
 			return sum;
 		}
 
+		// Incremental evaluation state. sum_terms[(ballot * num_candidates
+		// + candidate) * num_sums + i] is what candidate contributes to
+		// the ith council sum for that ballot, and council_sums and
+		// nonzero_terms give the current council's sums and how many
+		// of the terms in each are nonzero, per ballot.
+		size_t num_candidates, num_sums;
+		bool sums_prepared, use_sums;
+		std::vector<double> sum_terms, council_sums;
+		std::vector<size_t> nonzero_terms;
+
+		void prepare_sums();
+		double evaluate_council_sums(size_t council_size);
+
+		// Branch and bound state. The table holds, for every voter and
+		// candidate c, the voter's greatest table_seats normalized
+		// ratings of candidates numbered c or higher, in descending
+		// order.
+		bool bounds_prepared, bounds_valid;
+		size_t table_seats;
+		std::vector<double> best_remaining_ratings;
+
+		void build_remaining_table(size_t seats);
+
 	protected:
 		std::vector<scored_ballot> scored_ballots;
 
 		virtual double evaluate(combo::it & start, combo::it & end,
 			const scored_ballot & this_ballot) = 0;
 
+		// Most of these methods only depend on the council through
+		// sums, over the council members, of some function of the
+		// voter's rating of each. Such methods should say how many sums
+		// they need, what each candidate contributes, and what the
+		// ballot's objective is given the sums. Then the runner can
+		// update the objective in constant time per voter when one
+		// council member is replaced by another.
+
+		// A sum with only zero terms is passed as exactly zero, so
+		// special cases for unrepresented voters still work.
+		virtual size_t get_num_council_sums() const {
+			return 0;
+		}
+
+		virtual double get_sum_term(size_t /*sum_idx*/,
+			size_t /*candidate*/, const scored_ballot & /*this_ballot*/) {
+			return 0;
+		}
+
+		virtual double evaluate_from_sums(const double * /*sums*/,
+			size_t /*council_size*/, size_t /*ballot_idx*/) {
+			return 0;
+		}
+
+		// Methods that have one council sum, of normalized ratings, and
+		// whose objective gets better as that sum increases, can be
+		// bounded by supposing the remaining seats go to the voter's
+		// favorite remaining candidates. They should return true here.
+		virtual bool improves_with_rating_sum() const {
+			return false;
+		}
+
+		// Returns false if some ratings can't be normalized.
+		bool prepare_rating_bounds();
+
+		// Returns the voter's council_size greatest ratings of
+		// candidates numbered first_available or higher, greatest first.
+		// If there are fewer such candidates, the rest are zero.
+		const double * get_best_remaining_ratings(size_t ballot_idx,
+			size_t first_available, size_t council_size);
+
 	public:
 		void process_ballots(const election_t & ballots,
-			size_t num_candidates);
+			size_t num_candidates_in);
+
+		bool has_bound();
+		double get_bound(combo::it start, combo::it end,
+			size_t first_available, size_t council_size);
+
+		double evaluate_first(combo::it start, combo::it end);
+		double evaluate_next(combo::it start, combo::it end,
+			size_t removed, size_t added);
+		double rounding_tolerance() const;
+
+		scored_method() {
+			num_candidates = 0;
+			num_sums = 0;
+			sums_prepared = false;
+			use_sums = false;
+			bounds_prepared = false;
+			bounds_valid = false;
+			table_seats = 0;
+		}
 };
\ No newline at end of file
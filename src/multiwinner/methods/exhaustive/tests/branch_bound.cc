@@ -0,0 +1,93 @@
+// Check that the branch and bound runner finds the same councils as
+// exhaustive search, and that the bounds it uses are actually bounds.
+
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "multiwinner/methods/exhaustive/all.h"
+
+template<typename T> static void check_against_exhaustive(
+	const T & reference, size_t num_candidates, int steps) {
+
+	// Quantized ratings (steps > 0) give lots of ties between councils.
+	rng randomizer(1);
+
+	for (int trial = 0; trial < 3; ++trial) {
+		election_t election = get_random_election(num_candidates, 20,
+				steps, false, true, randomizer);
+
+		for (size_t council_size = 1; council_size < num_candidates;
+			++council_size) {
+
+			EXPECT_EQ(branch_bound_runner<T>(reference).get_council(
+					council_size, num_candidates, election),
+				exhaustive_method_runner<T>(reference).get_council(
+					council_size, num_candidates, election));
+		}
+	}
+}
+
+template <typename T>
+class BranchBoundTest : public ::testing::Test {};
+
+using BoundedMethods = ::testing::Types<harmonic_voting_eval,
+	  isoelastic_eval, log_penalty_eval, psi_voting_eval>;
+
+TYPED_TEST_SUITE(BranchBoundTest, BoundedMethods);
+
+TYPED_TEST(BranchBoundTest, MatchesExhaustiveSearch) {
+	check_against_exhaustive(TypeParam(), 9, 4);
+	check_against_exhaustive(TypeParam(), 9, 0);
+}
+
+TYPED_TEST(BranchBoundTest, BoundsAreAdmissible) {
+	size_t num_candidates = 7, council_size = 4;
+	rng randomizer(1);
+	election_t election = get_random_election(num_candidates, 15, 0,
+			false, true, randomizer);
+
+	TypeParam method;
+	method.process_ballots(election, num_candidates);
+
+	ASSERT_TRUE(method.has_bound());
+
+	std::vector<size_t> v(num_candidates);
+	std::iota(v.begin(), v.end(), 0);
+
+	// For every council, check the bound of every prefix, i.e. the
+	// partial councils the branch and bound passes through.
+	for_each_combination(v.begin(), v.begin() + council_size, v.end(),
+	[&](combo::it start, combo::it end) -> bool {
+		TypeParam exact(method);
+		double value = exact.evaluate_and_update(start, end);
+
+		for (auto prefix_end = start + 1; prefix_end != end;
+			++prefix_end) {
+
+			double bound = method.get_bound(start, prefix_end,
+					*(prefix_end-1) + 1, council_size);
+			double slack = 1e-9 * std::max(1.0, fabs(value));
+
+			if (method.maximize()) {
+				EXPECT_GE(bound, value - slack);
+			} else {
+				EXPECT_LE(bound, value + slack);
+			}
+		}
+		return false;
+	});
+}
+
+// The Chamberlin-Courant and D'Hondt limits have special cases, so check
+// them separately.
+TEST(BranchBound, SpecialCases) {
+	check_against_exhaustive(harmonic_voting_eval(0), 8, 0);
+	check_against_exhaustive(harmonic_voting_eval(1), 8, 4);
+	check_against_exhaustive(psi_voting_eval(0), 8, 0);
+	check_against_exhaustive(psi_voting_eval(0), 8, 4);
+	check_against_exhaustive(log_penalty_eval(1), 8, 4);
+	check_against_exhaustive(isoelastic_eval(-0.5), 8, 4);
+}
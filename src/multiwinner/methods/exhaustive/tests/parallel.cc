@@ -0,0 +1,121 @@
+// Check that the parallel, incremental exhaustive runner gives the same
+// councils as going through every council in lexicographic order and
+// evaluating each from scratch.
+
+#include <vector>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "multiwinner/methods/exhaustive/all.h"
+#include "tools/revolving_door.h"
+
+TEST(RevolvingDoor, VisitsEveryCombinationOnce) {
+	size_t n = 9;
+
+	for (size_t k = 0; k <= n; ++k) {
+		uint64_t num_councils = revolving_door::num_combinations(n, k);
+		std::vector<size_t> council = revolving_door::unrank(0, n, k);
+		std::set<std::vector<size_t> > seen;
+		size_t removed, added;
+
+		for (uint64_t rank = 0; rank < num_councils; ++rank) {
+			EXPECT_EQ(council, revolving_door::unrank(rank, n, k));
+			EXPECT_EQ(revolving_door::rank(council), rank);
+			EXPECT_TRUE(std::is_sorted(council.begin(), council.end()));
+			seen.insert(council);
+
+			if (rank + 1 == num_councils) {
+				continue;
+			}
+
+			std::set<size_t> expected(council.begin(), council.end());
+			revolving_door::next(council, n, removed, added);
+
+			ASSERT_EQ(expected.count(removed), 1);
+			ASSERT_EQ(expected.count(added), 0);
+			expected.erase(removed);
+			expected.insert(added);
+
+			EXPECT_EQ(std::set<size_t>(council.begin(), council.end()),
+				expected);
+		}
+
+		EXPECT_EQ(seen.size(), num_councils);
+	}
+}
+
+template <typename T>
+class ParallelExhaustiveTest : public ::testing::Test {};
+
+using ScoredMethods = ::testing::Types<birational_eval,
+	  harmonic_voting_eval, isoelastic_eval, log_penalty_eval,
+	  psi_voting_eval>;
+
+TYPED_TEST_SUITE(ParallelExhaustiveTest, ScoredMethods);
+
+TYPED_TEST(ParallelExhaustiveTest, MatchesLexicographicSearch) {
+	size_t num_candidates = 9;
+
+	// Ratings in steps of a quarter give lots of exact ties between
+	// councils.
+	rng randomizer(0);
+
+	for (int trial = 0; trial < 4; ++trial) {
+		election_t election = get_random_election(num_candidates, 25, 4,
+				false, true, randomizer);
+
+		for (size_t council_size = 1; council_size < num_candidates;
+			++council_size) {
+
+			std::vector<size_t> v(num_candidates);
+			std::iota(v.begin(), v.end(), 0);
+
+			TypeParam evaluator;
+			evaluator.process_ballots(election, num_candidates);
+
+			exhaustive_optima optimum = for_each_combination(v.begin(),
+					v.begin() + council_size, v.end(), evaluator);
+
+			council_t expected = optimum.get_optimal_solution();
+
+			EXPECT_EQ(exhaustive_method_runner<TypeParam>().get_council(
+					council_size, num_candidates, election), expected);
+		}
+	}
+}
+
+TYPED_TEST(ParallelExhaustiveTest, IncrementalAgreesWithExact) {
+	size_t num_candidates = 8, council_size = 3;
+	rng randomizer(1);
+	election_t election = get_random_election(num_candidates, 30, 4,
+			false, true, randomizer);
+
+	TypeParam incremental;
+	incremental.process_ballots(election, num_candidates);
+
+	std::vector<size_t> council = revolving_door::unrank(0,
+			num_candidates, council_size);
+	size_t removed, added;
+
+	double value = incremental.evaluate_first(council.begin(),
+			council.end());
+	uint64_t num_councils = revolving_door::num_combinations(
+			num_candidates, council_size);
+
+	for (uint64_t rank = 0; rank < num_councils; ++rank) {
+		if (rank > 0) {
+			revolving_door::next(council, num_candidates, removed, added);
+			value = incremental.evaluate_next(council.begin(),
+					council.end(), removed, added);
+		}
+
+		TypeParam exact;
+		exact.process_ballots(election, num_candidates);
+		exact(council.begin(), council.end());
+
+		EXPECT_NEAR(value, exhaustive_optima(exact).get_optimum(),
+			1e-9 * std::max(1.0, fabs(value)));
+	}
+}
@@ -1,11 +1,24 @@
 
 #include "meek_stv.h"
 
+meek_flat_ballots::meek_flat_ballots(const election_t & ballots) {
+	for (const ballot_group & ballot: ballots) {
+		start.push_back(candidates.size());
+		weights.push_back(ballot.get_weight());
+
+		for (const candscore & cs: ballot.contents) {
+			candidates.push_back(cs.get_candidate_num());
+		}
+	}
+
+	start.push_back(candidates.size());
+}
+
 // This does the Meek "progressive reweighting" on a single ballot, adding the
 // proportion of the ballot that goes to each candidate. It breaks when a
 // weight is 1, because then subsequent weights are zero and there's no point.
-void MeekSTV::absorb_ballot_meek(const ballot_group & ballot,
-	const std::vector<double> & weighting,
+void MeekSTV::absorb_ballot_meek(const meek_flat_ballots & ballots,
+	size_t ballot_idx, const std::vector<double> & weighting,
 	std::vector<double> & candidate_tally, double & excess) const {
 
 	// At any step, a candidate receives weight q * (candidate weight).
@@ -14,26 +27,24 @@ void MeekSTV::absorb_ballot_meek(const ballot_group & ballot,
 	// sense. Perhaps if A > B = C > D, then B gets q/2 * w_B and C
 	// gets q/2 * w_C and the next Q is 1 - (sum of these)?
 
-	double q = 1;
+	double q = 1, weight = ballots.weights[ballot_idx];
+	const size_t * cand = ballots.candidates.data();
 
-	for (ordering::const_iterator pos = ballot.contents.begin(); pos !=
-		ballot.contents.end() && q != 0; ++pos) {
-		double this_wt = q * weighting[pos->get_candidate_num()];
+	for (size_t pos = ballots.start[ballot_idx];
+		pos < ballots.start[ballot_idx+1] && q != 0; ++pos) {
+		double this_wt = q * weighting[cand[pos]];
 
-		candidate_tally[pos->get_candidate_num()] += this_wt *
-			ballot.get_weight();
-
-		//q *= (1 - weighting[pos->get_candidate_num()]);
+		candidate_tally[cand[pos]] += this_wt * weight;
 
 		q -= this_wt;
 		assert(q >= 0 && q <= 1);
 	}
 
-	excess += q;
+	excess += q * weight;
 }
 
-void MeekSTV::absorb_ballot_warren(const ballot_group & ballot,
-	const std::vector<double> & weighting,
+void MeekSTV::absorb_ballot_warren(const meek_flat_ballots & ballots,
+	size_t ballot_idx, const std::vector<double> & weighting,
 	std::vector<double> & candidate_tally, double & excess) const {
 
 	// The proportion of the vote apportioned to first preference is
@@ -45,27 +56,45 @@ void MeekSTV::absorb_ballot_warren(const ballot_group & ballot,
 	// preference.
 	// 	If adding the third preference (...) as above.
 
-	double cumulative = 0;
+	double cumulative = 0, weight = ballots.weights[ballot_idx];
+	const size_t * cand = ballots.candidates.data();
 
-	for (ordering::const_iterator pos = ballot.contents.begin(); pos !=
-		ballot.contents.end(); ++pos) {
+	for (size_t pos = ballots.start[ballot_idx];
+		pos < ballots.start[ballot_idx+1]; ++pos) {
 
-		double cur_wt = weighting[pos->get_candidate_num()];
+		double cur_wt = weighting[cand[pos]];
 
 		if (cumulative + cur_wt > 1) {
-			candidate_tally[pos->get_candidate_num()] += (1 -
-					cumulative);
+			candidate_tally[cand[pos]] += (1 - cumulative) * weight;
 			// Excess is always zero?
 			return;
 		}
 
-		candidate_tally[pos->get_candidate_num()] += cur_wt;
+		candidate_tally[cand[pos]] += cur_wt * weight;
 
 		cumulative += cur_wt;
 	}
 
 	if (cumulative < 1) {
-		excess += (1 - cumulative);
+		excess += (1 - cumulative) * weight;
+	}
+}
+
+void MeekSTV::count_ballots(const meek_flat_ballots & ballots,
+	const std::vector<size_t> & ballots_to_count,
+	const std::vector<double> & weighting,
+	std::vector<double> & candidate_tally, double & excess) const {
+
+	if (warren) {
+		for (size_t ballot_idx: ballots_to_count) {
+			absorb_ballot_warren(ballots, ballot_idx, weighting,
+				candidate_tally, excess);
+		}
+	} else {
+		for (size_t ballot_idx: ballots_to_count) {
+			absorb_ballot_meek(ballots, ballot_idx, weighting,
+				candidate_tally, excess);
+		}
 	}
 }
 
@@ -141,10 +170,8 @@ council_t MeekSTV::get_council(size_t council_size,
 
 	double unweighted_sum = 0; // Sum of initial (non-STV) weights.
 
-	election_t::const_iterator pos;
-
-	for (pos = ballots.begin(); pos != ballots.end(); ++pos) {
-		unweighted_sum += pos->get_weight();
+	for (const ballot_group & ballot: ballots) {
+		unweighted_sum += ballot.get_weight();
 	}
 
 	// "First difference" approximation. TODO: Fix later, and make changeable
@@ -153,22 +180,65 @@ council_t MeekSTV::get_council(size_t council_size,
 			num_candidates, NULL, false);
 	ordering::const_iterator opos, vpos;
 
+	// Both Meek and Warren give everything that's left of a ballot to the
+	// first hopeful candidate on it (whose weight is 1), and nothing to
+	// anyone after that. So a ballot that reaches a hopeful without
+	// passing through an elected candidate gives the same result no
+	// matter what the elected candidates' weights are. We count those
+	// ballots once per round; the rest have to be recounted every time
+	// the weights change.
+	meek_flat_ballots flat_ballots(ballots);
+	std::vector<size_t> changing_ballots, fixed_ballots;
+	std::vector<double> fixed_tally(num_candidates);
+	double fixed_excess;
+
+	// Keep factors from the last two iterations, for extrapolation, and
+	// the plain iteration's keep factors in case extrapolating doesn't
+	// help.
+	std::vector<double> last_weight(num_candidates),
+		second_last_weight(num_candidates), plain_weight(num_candidates);
+
 	while (num_elected < (size_t)council_size) {
 
-		// Reset the vote count and excess
-		fill(cand_tally.begin(), cand_tally.end(), 0);
-		excess = 0;
+		changing_ballots.clear();
+		fixed_ballots.clear();
 
-		// Count the votes.
-		for (pos = ballots.begin(); pos != ballots.end(); ++pos) {
-			if (warren)
-				absorb_ballot_warren(*pos, candidate_weight,
-					cand_tally, excess);
-			else
-				absorb_ballot_meek(*pos, candidate_weight,
-					cand_tally, excess);
+		for (size_t ballot_idx = 0; ballot_idx < flat_ballots.size();
+			++ballot_idx) {
+
+			bool changing = false;
+
+			for (size_t bpos = flat_ballots.start[ballot_idx];
+				bpos < flat_ballots.start[ballot_idx+1]; ++bpos) {
+
+				size_t cand = flat_ballots.candidates[bpos];
+				if (elected[cand]) {
+					changing = true;
+					break;
+				}
+				if (!eliminated[cand]) {
+					break;
+				}
+			}
+
+			if (changing) {
+				changing_ballots.push_back(ballot_idx);
+			} else {
+				fixed_ballots.push_back(ballot_idx);
+			}
 		}
 
+		fill(fixed_tally.begin(), fixed_tally.end(), 0);
+		fixed_excess = 0;
+		count_ballots(flat_ballots, fixed_ballots, candidate_weight,
+			fixed_tally, fixed_excess);
+
+		// Count the votes.
+		cand_tally = fixed_tally;
+		excess = fixed_excess;
+		count_ballots(flat_ballots, changing_ballots, candidate_weight,
+			cand_tally, excess);
+
 		// Get quota.
 		double quota = (unweighted_sum - excess) / (double)
 			(council_size + 1);
@@ -178,10 +248,17 @@ council_t MeekSTV::get_council(size_t council_size,
 		// record, and thus the entire convergence loop is skipped.
 		double error = absolute_quota_error(cand_tally, council, quota);
 
+		size_t iterations = 0;
+		bool extrapolating = true, extrapolated_last = false;
+		double error_before_extrapolation = 0;
+
 		while (error > epsilon) {
 			for (council_t::const_iterator cpos = council.begin();
 				cpos != council.end(); ++cpos) {
 
+				second_last_weight[*cpos] = last_weight[*cpos];
+				last_weight[*cpos] = candidate_weight[*cpos];
+
 				candidate_weight[*cpos] = (candidate_weight[*cpos] * quota) /
 					cand_tally[*cpos];
 
@@ -190,28 +267,73 @@ council_t MeekSTV::get_council(size_t council_size,
 						std::max(0.0, candidate_weight[*cpos]));
 			}
 
-			// Recount
-			excess = 0;
-			fill(cand_tally.begin(), cand_tally.end(), 0);
-
-			for (pos = ballots.begin(); pos != ballots.end();
-				++pos) {
-				if (warren)
-					absorb_ballot_warren(*pos,
-						candidate_weight,
-						cand_tally, excess);
-				else
-					absorb_ballot_meek(*pos,
-						candidate_weight,
-						cand_tally, excess);
+			// The keep factors usually converge linearly, so every third
+			// iteration, use Aitken's delta-squared method to jump
+			// closer to the limit. We only do so when the last steps
+			// look like geometric convergence. If extrapolating ever
+			// makes the error larger than it was before the step, we go
+			// back to the plain iteration's keep factors and stop
+			// extrapolating for this round.
+			if (extrapolating && ++iterations % 3 == 0) {
+				error_before_extrapolation = error;
+				extrapolated_last = true;
+
+				for (size_t cand: council) {
+					plain_weight[cand] = candidate_weight[cand];
+
+					double first_diff = last_weight[cand] -
+						second_last_weight[cand],
+						second_diff = candidate_weight[cand] - last_weight[cand];
+
+					if (first_diff == 0) {
+						continue;
+					}
+
+					double ratio = second_diff / first_diff;
+
+					if (ratio <= 0 || ratio >= 0.95) {
+						continue;
+					}
+
+					double extrapolated = candidate_weight[cand] +
+						second_diff * ratio / (1 - ratio);
+
+					if (extrapolated >= 0 && extrapolated <= 1) {
+						candidate_weight[cand] = extrapolated;
+					}
+				}
 			}
 
+			// Recount
+			cand_tally = fixed_tally;
+			excess = fixed_excess;
+			count_ballots(flat_ballots, changing_ballots, candidate_weight,
+				cand_tally, excess);
+
 			// Recalc quota and error.
 			quota = (unweighted_sum - excess) / (double)
 				(council_size +1);
 
 			error = absolute_quota_error(cand_tally, council,
 					quota);
+
+			if (extrapolated_last && error > error_before_extrapolation) {
+				extrapolating = false;
+
+				for (size_t cand: council) {
+					candidate_weight[cand] = plain_weight[cand];
+				}
+
+				cand_tally = fixed_tally;
+				excess = fixed_excess;
+				count_ballots(flat_ballots, changing_ballots,
+					candidate_weight, cand_tally, excess);
+
+				quota = (unweighted_sum - excess) / (double)
+					(council_size + 1);
+				error = absolute_quota_error(cand_tally, council, quota);
+			}
+			extrapolated_last = false;
 		}
 
 		// Now check for candidates to elect.
@@ -7,7 +7,6 @@
 #include <list>
 
 // TODO: Rational numbers. Nobody's done it before, so WTH not?
-// Also TODO, test, because I'm getting really bad performance here.
 // Maybe add BTR-STV and STV-ME to this?
 
 // Perhaps change its name from Meek STV to "Computerized STV" or similar, since
@@ -16,12 +15,33 @@
 // This is sufficiently different from ordinary STV that it merits its own
 // class.
 
+// The ballots, converted once into flat arrays of candidate numbers so
+// that the counting loops don't have to walk orderings. Ballot i ranks
+// candidates[start[i]] to candidates[start[i+1]-1], in that order.
+
+class meek_flat_ballots {
+	public:
+		std::vector<size_t> candidates;
+		std::vector<size_t> start;
+		std::vector<double> weights;
+
+		size_t size() const {
+			return weights.size();
+		}
+
+		meek_flat_ballots(const election_t & ballots);
+};
+
 class MeekSTV : public multiwinner_method {
 	private:
-		void absorb_ballot_meek(const ballot_group & ballot,
-			const std::vector<double> & weighting,
+		void absorb_ballot_meek(const meek_flat_ballots & ballots,
+			size_t ballot_idx, const std::vector<double> & weighting,
+			std::vector<double> & candidate_tally, double & excess) const;
+		void absorb_ballot_warren(const meek_flat_ballots & ballots,
+			size_t ballot_idx, const std::vector<double> & weighting,
 			std::vector<double> & candidate_tally, double & excess) const;
-		void absorb_ballot_warren(const ballot_group & ballot,
+		void count_ballots(const meek_flat_ballots & ballots,
+			const std::vector<size_t> & ballots_to_count,
 			const std::vector<double> & weighting,
 			std::vector<double> & candidate_tally, double & excess) const;
 		double absolute_quota_error(const std::vector<double> & cand_tally,
@@ -21,6 +21,7 @@
 
 #include "common.h"
 
+#include <algorithm>
 #include <numeric>
 #include <vector>
 #include <list>
@@ -446,6 +447,271 @@ void SchulzeCommon::Analyzing_the_Input() {
 
 /*******************************************************************************/
 
+// Allocate the working arrays used by VoteMana and the procedures it calls.
+// Every SchulzeCommon object has its own, so that the vote managements can
+// be calculated in parallel with one object per thread.
+
+void SchulzeCommon::allocate_vote_management() {
+	int i1;
+
+	i1=N2;
+
+	if (M+1>N2) {
+		i1=M+1;
+	}
+
+	Length4      =i1;
+	Length6      =i1;
+	Length7      =i1;
+	LengthArc    =i1;
+	LengthArc7   =i1;
+	LengthArc8   =i1;
+	LengthIndiff7=i1;
+	LengthIndiff8=i1;
+
+	Kombi    =(int                 *)calloc(C+2,sizeof(int));
+	Vote3    =(unsigned char       *)calloc(N2*M+1,sizeof(unsigned char));
+	Value3   =(int                 *)calloc(N2+1,sizeof(int));
+	Vote4    =(unsigned char       *)calloc(Length4*M+1,
+			sizeof(unsigned char));
+	Value4   =(long double         *)calloc(Length4+1,
+			sizeof(long double));
+	Indif4   =(int                 *)calloc(Length4+1,
+			sizeof(int));
+	cool4    =(bool                *)calloc(Length4+1,
+			sizeof(bool));
+	Kombi4   =(int                 *)calloc(M+1,sizeof(int));
+	Vote5    =(unsigned char       *)calloc(i1*M+1,sizeof(unsigned char));
+	Value5   =(int                 *)calloc(i1+1,sizeof(int));
+	Test     =(unsigned char       *)calloc(M+1,sizeof(unsigned char));
+	Test3    =(int                 *)calloc(N2+1,sizeof(int));
+	Indiff   =(struct IndiffElement*)calloc(Length6+1,
+			sizeof(struct IndiffElement));
+	Arcs     =(struct ArcElement   *)calloc(LengthArc+1,
+			sizeof(struct ArcElement));
+	Arcs7    =(struct ArcElement   *)calloc(LengthArc7+1,
+			sizeof(struct ArcElement));
+	Arcs8    =(struct ArcElement   *)calloc(LengthArc8+1,
+			sizeof(struct ArcElement));
+	Votes    =(struct VotesElement *)calloc(M+1,sizeof(struct VotesElement));
+	Votes1   =(int                 *)calloc(M+1,sizeof(int));
+	completed=(bool                *)calloc(M+1,sizeof(bool));
+	Vote7    =(bool                *)calloc(Length7*M+1,
+			sizeof(bool));
+	Value7   =(long double         *)calloc(Length7+1,
+			sizeof(long double));
+	Vote8    =(bool                *)calloc(Length7*M+1,
+			sizeof(bool));
+	Value8   =(long double         *)calloc(Length7+1,
+			sizeof(long double));
+	Indiff7  =(struct IndiffElement*)calloc(LengthIndiff7+1,
+			sizeof(struct IndiffElement));
+	Indiff8  =(struct IndiffElement*)calloc(LengthIndiff8+1,
+			sizeof(struct IndiffElement));
+}
+
+/*******************************************************************************/
+
+void SchulzeCommon::free_vote_management() {
+	free(Kombi);
+	free(Vote3);
+	free(Value3);
+	free(Vote4);
+	free(Value4);
+	free(Indif4);
+	free(cool4);
+	free(Kombi4);
+	free(Vote5);
+	free(Value5);
+	free(Test);
+	free(Test3);
+	free(Indiff);
+	free(Arcs);
+	free(Arcs7);
+	free(Arcs8);
+	free(Votes);
+	free(Votes1);
+	free(completed);
+	free(Vote7);
+	free(Value7);
+	free(Vote8);
+	free(Value8);
+	free(Indiff7);
+	free(Indiff8);
+}
+
+/*******************************************************************************/
+
+// Augment the flow already present in FlowArcs[0...NArcs-1] until it's a maximum
+// flow from Source to Drain, or until it exceeds Target-eps2, and return the
+// new total flow. EKarp and EKarpSimple use this for every digraph. Each
+// scan over the arcs finds a blocking flow (Dinic's algorithm), and the
+// adjacency lists are kept between calls so that we don't have to
+// reallocate them every time.
+
+long double SchulzeCommon::augment_to_max_flow(struct ArcElement *FlowArcs,
+	int NArcs, int NVertices, int Source, int Drain,
+	long double Flow, long double Target) {
+
+	int i1,i2,i3,i4=0;
+	long double PossFlow;
+	bool forward;
+
+	if (Flow>Target-eps2) {
+		return Flow;
+	}
+
+	// Every arc can be used forwards from its start if it has capacity
+	// left, and backwards from its end if it carries flow, so it's
+	// adjacent to both.
+
+	FlowFirstArc.assign(NVertices+1,0);
+
+	for (i1=0; i1<NArcs; i1++) {
+		++FlowFirstArc[FlowArcs[i1].start+1];
+		++FlowFirstArc[FlowArcs[i1].end+1];
+	}
+
+	std::partial_sum(FlowFirstArc.begin(),FlowFirstArc.end(),
+		FlowFirstArc.begin());
+
+	FlowAdjacent.resize(2*NArcs);
+	FlowCurrentArc.assign(FlowFirstArc.begin(),FlowFirstArc.end()-1);
+
+	for (i1=0; i1<NArcs; i1++) {
+		FlowAdjacent[FlowCurrentArc[FlowArcs[i1].start]++]=i1;
+		FlowAdjacent[FlowCurrentArc[FlowArcs[i1].end]++]=i1;
+	}
+
+	while (Flow<=Target-eps2) {
+		// Find the distance of every vertex from the source in the
+		// residual digraph.
+
+		FlowLevel.assign(NVertices,-1);
+		FlowQueue.resize(NVertices);
+
+		FlowLevel[Source]=0;
+		FlowQueue[0]=Source;
+		i2=1;
+
+		for (i1=0; i1<i2 && FlowLevel[Drain]==-1; i1++) {
+			i3=FlowQueue[i1];
+
+			for (i4=FlowFirstArc[i3]; i4<FlowFirstArc[i3+1]; i4++) {
+				ArcElement & arc=FlowArcs[FlowAdjacent[i4]];
+
+				if ((arc.start==i3) && (FlowLevel[arc.end]==-1)
+					&& (arc.Value<arc.Cap)) {
+					FlowLevel[arc.end]=FlowLevel[i3]+1;
+					FlowQueue[i2++]=arc.end;
+				}
+
+				if ((arc.end==i3) && (FlowLevel[arc.start]==-1)
+					&& (arc.Value>0.0)) {
+					FlowLevel[arc.start]=FlowLevel[i3]+1;
+					FlowQueue[i2++]=arc.start;
+				}
+			}
+		}
+
+		if (FlowLevel[Drain]==-1) {
+			return Flow;
+		}
+
+		// Then augment along shortest paths until there are none left.
+		// FlowPath holds the arcs of the current path, and FlowQueue is
+		// reused for the vertices on it.
+
+		FlowCurrentArc.assign(FlowFirstArc.begin(),FlowFirstArc.end()-1);
+		FlowPath.clear();
+		FlowQueue[0]=Source;
+
+		while (FlowLevel[Source]!=-1) {
+			i3=FlowQueue[FlowPath.size()];
+
+			if (i3==Drain) {
+				PossFlow=N+0.0;
+
+				for (i1=0; i1<(int)FlowPath.size(); i1++) {
+					ArcElement & arc=FlowArcs[FlowPath[i1]];
+
+					if (arc.start==FlowQueue[i1]) {
+						PossFlow=std::min(PossFlow,arc.Cap-arc.Value);
+					} else {
+						PossFlow=std::min(PossFlow,arc.Value);
+					}
+				}
+
+				for (i1=0; i1<(int)FlowPath.size(); i1++) {
+					ArcElement & arc=FlowArcs[FlowPath[i1]];
+
+					if (arc.start==FlowQueue[i1]) {
+						arc.Value=arc.Value+PossFlow;
+
+						if (arc.Value>arc.Cap-eps1) {
+							arc.Value=arc.Cap;
+						}
+					} else {
+						arc.Value=arc.Value-PossFlow;
+
+						if (arc.Value<eps1) {
+							arc.Value=0.0;
+						}
+					}
+				}
+
+				Flow=Flow+PossFlow;
+
+				if (Flow>Target-eps2) {
+					return Flow;
+				}
+
+				FlowPath.clear();
+				continue;
+			}
+
+			// Find the next arc that leads one step closer to the
+			// drain and has residual capacity.
+
+			for (; FlowCurrentArc[i3]<FlowFirstArc[i3+1];
+				++FlowCurrentArc[i3]) {
+				ArcElement & arc=FlowArcs[FlowAdjacent[FlowCurrentArc[i3]]];
+				forward=(arc.start==i3);
+
+				if (forward) {
+					i4=arc.end;
+				} else {
+					i4=arc.start;
+				}
+
+				if ((FlowLevel[i4]==FlowLevel[i3]+1)
+					&& ((forward && (arc.Value<arc.Cap))
+						|| (!forward && (arc.Value>0.0)))) {
+					break;
+				}
+			}
+
+			if (FlowCurrentArc[i3]<FlowFirstArc[i3+1]) {
+				FlowPath.push_back(FlowAdjacent[FlowCurrentArc[i3]]);
+				FlowQueue[FlowPath.size()]=i4;
+			} else {
+				// Dead end: don't visit this vertex again during
+				// this phase, and retreat.
+				FlowLevel[i3]=-1;
+
+				if (!FlowPath.empty()) {
+					FlowPath.pop_back();
+					++FlowCurrentArc[FlowQueue[FlowPath.size()]];
+				}
+			}
+		}
+	}
+
+	return Flow;
+}
+
+/*******************************************************************************/
+
 void SchulzeCommon::PropCompletionSimple() {
 	int i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11;
 	bool j1,j2,j3,j4;
@@ -778,10 +1044,9 @@ void SchulzeCommon::EKarp() {
 
 	int i1,i2,i3,i4,i47,i48,i5,i57,i58,i6,i7,i8,i9;
 	int NArcs7,NArcs8,NVertices7,NVertices8,Source7,Source8,Drain7,Drain8,
-		first,
-		gross;
-	bool j1,j2,j3,j4,j5;
-	long double Flow,PossFlow,d1,d2,d3;
+		first;
+	bool j1,j2,j3;
+	long double Flow,d1,d2,d3;
 	long double LowerBounce7,UpperBounce7,UpperBounce7a,
 		 LowerBounce8,UpperBounce8,UpperBounce8a;
 
@@ -1014,20 +1279,7 @@ void SchulzeCommon::EKarp() {
 		}
 
 		NVertices7=N7-i57+2+M;
-		if (NVertices7>LengthVertex7) {
-			free(Vertices7);
-			LengthVertex7=NVertices7;
-			Vertices7=(struct VertexElement*)calloc(LengthVertex7+1,
-					sizeof(struct VertexElement));
-		}
-
 		NVertices8=N8-i58+2+M;
-		if (NVertices8>LengthVertex8) {
-			free(Vertices8);
-			LengthVertex8=NVertices8;
-			Vertices8=(struct VertexElement*)calloc(LengthVertex8+1,
-					sizeof(struct VertexElement));
-		}
 
 		Source7=N7-i57;
 		Drain7 =N7+M+1-i57;
@@ -1215,148 +1467,8 @@ void SchulzeCommon::EKarp() {
 				i9++;
 			}
 
-			j1=true;
-			gross=NArcs7+1;
-
-			if (Flow<=UpperBounce7a-eps2)
-				while (j1==true) {
-					for (i1=0; i1<NVertices7; i1++) {
-						Vertices7[i1].marked=gross;
-					}
-
-					Vertices7[Source7].marked=0;
-
-					for (i1=0; i1<NArcs7; i1++) {
-						Arcs7[i1].upper=i1-1;
-						Arcs7[i1].lower=i1+1;
-					}
-
-					Arcs7[0].upper=NArcs7-1;
-					Arcs7[NArcs7-1].lower=0;
-
-					i1=NArcs7-1;
-
-					j4=true;
-
-					i5=0;
-					j5=true;
-
-					while ((Vertices7[Drain7].marked==gross) && (j5==true)) {
-						i6=Arcs7[i1].start;
-						i7=Arcs7[i1].end;
-
-						if (Vertices7[i6].marked==i5) {
-							if ((Vertices7[i7].marked==gross)
-								&& (Arcs7[i1].Value<Arcs7[i1].Cap)) {
-								Vertices7[i7].marked   =i5+1;
-								Vertices7[i7].upper    =i1;
-								Vertices7[i7].direction=true;
-
-								j4=false;
-							}
-
-							Arcs7[Arcs7[i1].upper].lower=Arcs7[i1].lower;
-							Arcs7[Arcs7[i1].lower].upper=Arcs7[i1].upper;
-						}
-
-						else {
-							if (Vertices7[i7].marked==i5) {
-								if ((Vertices7[i6].marked==gross) && (Arcs7[i1].Value>0.0)) {
-									Vertices7[i6].marked   =i5+1;
-									Vertices7[i6].upper    =i1;
-									Vertices7[i6].direction=false;
-
-									j4=false;
-								}
-
-								Arcs7[Arcs7[i1].upper].lower=Arcs7[i1].lower;
-								Arcs7[Arcs7[i1].lower].upper=Arcs7[i1].upper;
-							}
-						}
-
-						if (i1<Arcs7[i1].upper) {
-							i5++;
-
-							if (j4==true) {
-								j5=false;
-							}
-
-							j4=true;
-						}
-
-						i1=Arcs7[i1].upper;
-					}
-
-					if (Vertices7[Drain7].marked<gross) {
-						i1=Drain7;
-
-						PossFlow=N+0.0;
-
-						while (i1!=Source7) {
-							i2=Vertices7[i1].upper;
-
-							if (Vertices7[i1].direction==true) {
-								if (Arcs7[i2].Cap-Arcs7[i2].Value<PossFlow)
-
-								{
-									PossFlow=Arcs7[i2].Cap-Arcs7[i2].Value;
-								}
-
-								i1=Arcs7[i2].start;
-							}
-
-							else {
-								if (Arcs7[i2].Value<PossFlow)
-
-								{
-									PossFlow=Arcs7[i2].Value;
-								}
-
-								i1=Arcs7[i2].end;
-							}
-						}
-
-						i1=Drain7;
-
-						while (i1!=Source7) {
-							i2=Vertices7[i1].upper;
-
-							if (Vertices7[i1].direction==true) {
-								Arcs7[i2].Value=Arcs7[i2].Value+PossFlow;
-
-								if (Arcs7[i2].Value>Arcs7[i2].Cap-eps1)
-
-								{
-									Arcs7[i2].Value=Arcs7[i2].Cap;
-								}
-
-								i1=Arcs7[i2].start;
-							}
-
-							else {
-								Arcs7[i2].Value=Arcs7[i2].Value-PossFlow;
-
-								if (Arcs7[i2].Value<eps1)
-
-								{
-									Arcs7[i2].Value=0.0;
-								}
-
-								i1=Arcs7[i2].end;
-							}
-						}
-
-						Flow=Flow+PossFlow;
-					}
-
-					else {
-						j1=false;
-					}
-
-					if (Flow>UpperBounce7a-eps2) {
-						j1=false;
-					}
-				}
+			Flow=augment_to_max_flow(Arcs7,NArcs7,NVertices7,Source7,Drain7,
+				Flow,UpperBounce7a);
 
 			LowerBounce7=N+0.0;
 
@@ -1556,148 +1668,8 @@ void SchulzeCommon::EKarp() {
 			i9++;
 		}
 
-		j1=true;
-		gross=NArcs8+1;
-
-		if (Flow<=UpperBounce8a-eps2)
-			while (j1==true) {
-				for (i1=0; i1<NVertices8; i1++) {
-					Vertices8[i1].marked=gross;
-				}
-
-				Vertices8[Source8].marked=0;
-
-				for (i1=0; i1<NArcs8; i1++) {
-					Arcs8[i1].upper=i1-1;
-					Arcs8[i1].lower=i1+1;
-				}
-
-				Arcs8[0].upper=NArcs8-1;
-				Arcs8[NArcs8-1].lower=0;
-
-				i1=NArcs8-1;
-
-				j4=true;
-
-				i5=0;
-				j5=true;
-
-				while ((Vertices8[Drain8].marked==gross) && (j5==true)) {
-					i6=Arcs8[i1].start;
-					i7=Arcs8[i1].end;
-
-					if (Vertices8[i6].marked==i5) {
-						if ((Vertices8[i7].marked==gross)
-							&& (Arcs8[i1].Value<Arcs8[i1].Cap)) {
-							Vertices8[i7].marked   =i5+1;
-							Vertices8[i7].upper    =i1;
-							Vertices8[i7].direction=true;
-
-							j4=false;
-						}
-
-						Arcs8[Arcs8[i1].upper].lower=Arcs8[i1].lower;
-						Arcs8[Arcs8[i1].lower].upper=Arcs8[i1].upper;
-					}
-
-					else {
-						if (Vertices8[i7].marked==i5) {
-							if ((Vertices8[i6].marked==gross) && (Arcs8[i1].Value>0.0)) {
-								Vertices8[i6].marked   =i5+1;
-								Vertices8[i6].upper    =i1;
-								Vertices8[i6].direction=false;
-
-								j4=false;
-							}
-
-							Arcs8[Arcs8[i1].upper].lower=Arcs8[i1].lower;
-							Arcs8[Arcs8[i1].lower].upper=Arcs8[i1].upper;
-						}
-					}
-
-					if (i1<Arcs8[i1].upper) {
-						i5++;
-
-						if (j4==true) {
-							j5=false;
-						}
-
-						j4=true;
-					}
-
-					i1=Arcs8[i1].upper;
-				}
-
-				if (Vertices8[Drain8].marked<gross) {
-					i1=Drain8;
-
-					PossFlow=N+0.0;
-
-					while (i1!=Source8) {
-						i2=Vertices8[i1].upper;
-
-						if (Vertices8[i1].direction==true) {
-							if (Arcs8[i2].Cap-Arcs8[i2].Value<PossFlow)
-
-							{
-								PossFlow=Arcs8[i2].Cap-Arcs8[i2].Value;
-							}
-
-							i1=Arcs8[i2].start;
-						}
-
-						else {
-							if (Arcs8[i2].Value<PossFlow)
-
-							{
-								PossFlow=Arcs8[i2].Value;
-							}
-
-							i1=Arcs8[i2].end;
-						}
-					}
-
-					i1=Drain8;
-
-					while (i1!=Source8) {
-						i2=Vertices8[i1].upper;
-
-						if (Vertices8[i1].direction==true) {
-							Arcs8[i2].Value=Arcs8[i2].Value+PossFlow;
-
-							if (Arcs8[i2].Value>Arcs8[i2].Cap-eps1)
-
-							{
-								Arcs8[i2].Value=Arcs8[i2].Cap;
-							}
-
-							i1=Arcs8[i2].start;
-						}
-
-						else {
-							Arcs8[i2].Value=Arcs8[i2].Value-PossFlow;
-
-							if (Arcs8[i2].Value<eps1)
-
-							{
-								Arcs8[i2].Value=0.0;
-							}
-
-							i1=Arcs8[i2].end;
-						}
-					}
-
-					Flow=Flow+PossFlow;
-				}
-
-				else {
-					j1=false;
-				}
-
-				if (Flow>UpperBounce8a-eps2) {
-					j1=false;
-				}
-			}
+		Flow=augment_to_max_flow(Arcs8,NArcs8,NVertices8,Source8,Drain8,
+			Flow,UpperBounce8a);
 
 		LowerBounce8=N+0.0;
 		for (i1=0; i1<M; i1++)
@@ -1865,149 +1837,8 @@ void SchulzeCommon::EKarp() {
 					i9++;
 				}
 
-				j1=true;
-				gross=NArcs7+1;
-
-				if (Flow<=UpperBounce7a-eps2)
-					while (j1==true) {
-						for (i1=0; i1<NVertices7; i1++) {
-							Vertices7[i1].marked=gross;
-						}
-
-						Vertices7[Source7].marked=0;
-
-						for (i1=0; i1<NArcs7; i1++) {
-							Arcs7[i1].upper=i1-1;
-							Arcs7[i1].lower=i1+1;
-						}
-
-						Arcs7[0].upper=NArcs7-1;
-						Arcs7[NArcs7-1].lower=0;
-
-						i1=NArcs7-1;
-
-						j4=true;
-
-						i5=0;
-						j5=true;
-
-						while ((Vertices7[Drain7].marked==gross) && (j5==true)) {
-							i6=Arcs7[i1].start;
-							i7=Arcs7[i1].end;
-
-							if (Vertices7[i6].marked==i5) {
-								if ((Vertices7[i7].marked==gross)
-									&& (Arcs7[i1].Value<Arcs7[i1].Cap)) {
-									Vertices7[i7].marked   =i5+1;
-									Vertices7[i7].upper    =i1;
-									Vertices7[i7].direction=true;
-
-									j4=false;
-								}
-
-								Arcs7[Arcs7[i1].upper].lower=Arcs7[i1].lower;
-								Arcs7[Arcs7[i1].lower].upper=Arcs7[i1].upper;
-							}
-
-							else {
-								if (Vertices7[i7].marked==i5) {
-									if ((Vertices7[i6].marked==gross)
-										&& (Arcs7[i1].Value>0.0)) {
-										Vertices7[i6].marked   =i5+1;
-										Vertices7[i6].upper    =i1;
-										Vertices7[i6].direction=false;
-
-										j4=false;
-									}
-
-									Arcs7[Arcs7[i1].upper].lower=Arcs7[i1].lower;
-									Arcs7[Arcs7[i1].lower].upper=Arcs7[i1].upper;
-								}
-							}
-
-							if (i1<Arcs7[i1].upper) {
-								i5++;
-
-								if (j4==true) {
-									j5=false;
-								}
-
-								j4=true;
-							}
-
-							i1=Arcs7[i1].upper;
-						}
-
-						if (Vertices7[Drain7].marked<gross) {
-							i1=Drain7;
-
-							PossFlow=N+0.0;
-
-							while (i1!=Source7) {
-								i2=Vertices7[i1].upper;
-
-								if (Vertices7[i1].direction==true) {
-									if (Arcs7[i2].Cap-Arcs7[i2].Value<PossFlow)
-
-									{
-										PossFlow=Arcs7[i2].Cap-Arcs7[i2].Value;
-									}
-
-									i1=Arcs7[i2].start;
-								}
-
-								else {
-									if (Arcs7[i2].Value<PossFlow)
-
-									{
-										PossFlow=Arcs7[i2].Value;
-									}
-
-									i1=Arcs7[i2].end;
-								}
-							}
-
-							i1=Drain7;
-
-							while (i1!=Source7) {
-								i2=Vertices7[i1].upper;
-
-								if (Vertices7[i1].direction==true) {
-									Arcs7[i2].Value=Arcs7[i2].Value+PossFlow;
-
-									if (Arcs7[i2].Value>Arcs7[i2].Cap-eps1)
-
-									{
-										Arcs7[i2].Value=Arcs7[i2].Cap;
-									}
-
-									i1=Arcs7[i2].start;
-								}
-
-								else {
-									Arcs7[i2].Value=Arcs7[i2].Value-PossFlow;
-
-									if (Arcs7[i2].Value<eps1)
-
-									{
-										Arcs7[i2].Value=0.0;
-									}
-
-									i1=Arcs7[i2].end;
-								}
-							}
-
-							Flow=Flow+PossFlow;
-						}
-
-						else {
-							j1=false;
-						}
-
-						if (Flow>UpperBounce7a-eps2) {
-							j1=false;
-						}
-					}
+				Flow=augment_to_max_flow(Arcs7,NArcs7,NVertices7,Source7,Drain7,
+					Flow,UpperBounce7a);
 
 				LowerBounce7=N+0.0;
 
@@ -2180,149 +2011,8 @@ void SchulzeCommon::EKarp() {
 					i9++;
 				}
 
-				j1=true;
-				gross=NArcs8+1;
-
-				if (Flow<=UpperBounce8a-eps2)
-					while (j1==true) {
-						for (i1=0; i1<NVertices8; i1++) {
-							Vertices8[i1].marked=gross;
-						}
-
-						Vertices8[Source8].marked=0;
-
-						for (i1=0; i1<NArcs8; i1++) {
-							Arcs8[i1].upper=i1-1;
-							Arcs8[i1].lower=i1+1;
-						}
-
-						Arcs8[0].upper=NArcs8-1;
-						Arcs8[NArcs8-1].lower=0;
-
-						i1=NArcs8-1;
-
-						j4=true;
-
-						i5=0;
-						j5=true;
-
-						while ((Vertices8[Drain8].marked==gross) && (j5==true)) {
-							i6=Arcs8[i1].start;
-							i7=Arcs8[i1].end;
-
-							if (Vertices8[i6].marked==i5) {
-								if ((Vertices8[i7].marked==gross)
-									&& (Arcs8[i1].Value<Arcs8[i1].Cap)) {
-									Vertices8[i7].marked   =i5+1;
-									Vertices8[i7].upper    =i1;
-									Vertices8[i7].direction=true;
-
-									j4=false;
-								}
-
-								Arcs8[Arcs8[i1].upper].lower=Arcs8[i1].lower;
-								Arcs8[Arcs8[i1].lower].upper=Arcs8[i1].upper;
-							}
-
-							else {
-								if (Vertices8[i7].marked==i5) {
-									if ((Vertices8[i6].marked==gross)
-										&& (Arcs8[i1].Value>0.0)) {
-										Vertices8[i6].marked   =i5+1;
-										Vertices8[i6].upper    =i1;
-										Vertices8[i6].direction=false;
-
-										j4=false;
-									}
-
-									Arcs8[Arcs8[i1].upper].lower=Arcs8[i1].lower;
-									Arcs8[Arcs8[i1].lower].upper=Arcs8[i1].upper;
-								}
-							}
-
-							if (i1<Arcs8[i1].upper) {
-								i5++;
-
-								if (j4==true) {
-									j5=false;
-								}
-
-								j4=true;
-							}
-
-							i1=Arcs8[i1].upper;
-						}
-
-						if (Vertices8[Drain8].marked<gross) {
-							i1=Drain8;
-
-							PossFlow=N+0.0;
-
-							while (i1!=Source8) {
-								i2=Vertices8[i1].upper;
-
-								if (Vertices8[i1].direction==true) {
-									if (Arcs8[i2].Cap-Arcs8[i2].Value<PossFlow)
-
-									{
-										PossFlow=Arcs8[i2].Cap-Arcs8[i2].Value;
-									}
-
-									i1=Arcs8[i2].start;
-								}
-
-								else {
-									if (Arcs8[i2].Value<PossFlow)
-
-									{
-										PossFlow=Arcs8[i2].Value;
-									}
-
-									i1=Arcs8[i2].end;
-								}
-							}
-
-							i1=Drain8;
-
-							while (i1!=Source8) {
-								i2=Vertices8[i1].upper;
-
-								if (Vertices8[i1].direction==true) {
-									Arcs8[i2].Value=Arcs8[i2].Value+PossFlow;
-
-									if (Arcs8[i2].Value>Arcs8[i2].Cap-eps1)
-
-									{
-										Arcs8[i2].Value=Arcs8[i2].Cap;
-									}
-
-									i1=Arcs8[i2].start;
-								}
-
-								else {
-									Arcs8[i2].Value=Arcs8[i2].Value-PossFlow;
-
-									if (Arcs8[i2].Value<eps1)
-
-									{
-										Arcs8[i2].Value=0.0;
-									}
-
-									i1=Arcs8[i2].end;
-								}
-							}
-
-							Flow=Flow+PossFlow;
-						}
-
-						else {
-							j1=false;
-						}
-
-						if (Flow>UpperBounce8a-eps2) {
-							j1=false;
-						}
-					}
+				Flow=augment_to_max_flow(Arcs8,NArcs8,NVertices8,Source8,Drain8,
+					Flow,UpperBounce8a);
 
 				LowerBounce8=N+0.0;
 				for (i1=0; i1<M; i1++)
@@ -2351,9 +2041,9 @@ void SchulzeCommon::EKarp() {
 
 void SchulzeCommon::EKarpSimple() {
 	int i1,i2,i3,i4,i5,i6,i7,i8,i9;
-	int NArcs,NVertices,Source,Drain,first,gross;
-	bool j1,j2,j4,j5;
-	long double Flow,PossFlow,MaxPossFlow,MaxPossFlow2,d1,d2,d3;
+	int NArcs,NVertices,Source,Drain,first;
+	bool j2;
+	long double Flow,MaxPossFlow,MaxPossFlow2,d1,d2,d3;
 
 	NArcs=M;
 	Flow=0.0;
@@ -2411,12 +2101,6 @@ void SchulzeCommon::EKarpSimple() {
 		}
 
 		NVertices=N4-i5+2+M;
-		if (NVertices>LengthVertex) {
-			free(Vertices);
-			LengthVertex=NVertices;
-			Vertices=(struct VertexElement*)calloc(LengthVertex+1,
-					sizeof(struct VertexElement));
-		}
 
 		Source=N4-i5;
 		Drain =N4+M+1-i5;
@@ -2593,149 +2277,8 @@ void SchulzeCommon::EKarpSimple() {
 			i9++;
 		}
 
-		j1=true;
-		gross=NArcs+1;
-
-		if (Flow<=MaxPossFlow-eps2)
-			while (j1==true) {
-				for (i1=0; i1<NVertices; i1++) {
-					Vertices[i1].marked=gross;
-				}
-
-				Vertices[Source].marked=0;
-
-				for (i1=0; i1<NArcs; i1++) {
-					Arcs[i1].upper=i1-1;
-					Arcs[i1].lower=i1+1;
-				}
-
-				Arcs[0].upper=NArcs-1;
-				Arcs[NArcs-1].lower=0;
-
-				i1=NArcs-1;
-
-				j4=true;
-
-				i5=0;
-				j5=true;
-
-				while ((Vertices[Drain].marked==gross) && (j5==true)) {
-					i6=Arcs[i1].start;
-					i7=Arcs[i1].end;
-
-					if (Vertices[i6].marked==i5) {
-						if ((Vertices[i7].marked==gross)
-							&& (Arcs[i1].Value<Arcs[i1].Cap)) {
-							Vertices[i7].marked   =i5+1;
-							Vertices[i7].upper    =i1;
-							Vertices[i7].direction=true;
-
-							j4=false;
-						}
-
-						Arcs[Arcs[i1].upper].lower=Arcs[i1].lower;
-						Arcs[Arcs[i1].lower].upper=Arcs[i1].upper;
-					}
-
-					else {
-						if (Vertices[i7].marked==i5) {
-							if ((Vertices[i6].marked==gross) && (Arcs[i1].Value>0.0)) {
-								Vertices[i6].marked   =i5+1;
-								Vertices[i6].upper    =i1;
-								Vertices[i6].direction=false;
-
-								j4=false;
-							}
-
-							Arcs[Arcs[i1].upper].lower=Arcs[i1].lower;
-							Arcs[Arcs[i1].lower].upper=Arcs[i1].upper;
-						}
-					}
-
-					if (i1<Arcs[i1].upper) {
-						i5++;
-
-						if (j4==true) {
-							j5=false;
-						}
-
-						j4=true;
-					}
-
-
-					i1=Arcs[i1].upper;
-				}
-
-				if (Vertices[Drain].marked<gross) {
-					i1=Drain;
-
-					PossFlow=N+0.0;
-
-					while (i1!=Source) {
-						i2=Vertices[i1].upper;
-
-						if (Vertices[i1].direction==true) {
-							if (Arcs[i2].Cap-Arcs[i2].Value<PossFlow)
-
-							{
-								PossFlow=Arcs[i2].Cap-Arcs[i2].Value;
-							}
-
-							i1=Arcs[i2].start;
-						}
-
-						else {
-							if (Arcs[i2].Value<PossFlow)
-
-							{
-								PossFlow=Arcs[i2].Value;
-							}
-
-							i1=Arcs[i2].end;
-						}
-					}
-
-					i1=Drain;
-
-					while (i1!=Source) {
-						i2=Vertices[i1].upper;
-
-						if (Vertices[i1].direction==true) {
-							Arcs[i2].Value=Arcs[i2].Value+PossFlow;
-
-							if (Arcs[i2].Value>Arcs[i2].Cap-eps1)
-
-							{
-								Arcs[i2].Value=Arcs[i2].Cap;
-							}
-
-							i1=Arcs[i2].start;
-						}
-
-						else {
-							Arcs[i2].Value=Arcs[i2].Value-PossFlow;
-
-							if (Arcs[i2].Value<eps1)
-
-							{
-								Arcs[i2].Value=0.0;
-							}
-
-							i1=Arcs[i2].end;
-						}
-					}
-
-					Flow=Flow+PossFlow;
-				}
-
-				else {
-					j1=false;
-				}
-
-				if (Flow>MaxPossFlow-eps2) {
-					j1=false;
-				}
-			}
+		Flow=augment_to_max_flow(Arcs,NArcs,NVertices,Source,Drain,
+			Flow,MaxPossFlow);
 
 		if (Flow>MaxPossFlow-eps2) {
 			SimplexNoetig=false;
@@ -3028,147 +2571,73 @@ void SchulzeCommon::PropCompletion() {
 void SchulzeCommon::VoteMana() {
 	int i1,i2,i3,i4,i5,i6,i7,i8;
 	unsigned char i9;
-	bool j1,j2;
+	bool j2;
 
-	i1=Vote2[Kombi[g2]];
-	i8=0;
-	j2=false;
-
-	for (i2=0; i2<g2; i2++) {
-		if (Vote2[Kombi[i2]]<i1) {
-			Vote3[i2]=1;
-			Vote4[i2]=1;
-			j2=true;
-		} else {
-			if (Vote2[Kombi[i2]]>i1) {
-				Vote3[i2]=3;
-				Vote4[i2]=3;
-			} else {
-				Vote3[i2]=2;
-				Vote4[i2]=2;
-				i8++;
-			}
-		}
-	}
+	/* Sort the ballots into types by how they rank each of the other        */
+	/* candidates of Kombi relative to Kombi[g2]: 1 if the other candidate is */
+	/* preferred, 2 if equally ranked, 3 if ranked below. The types are     */
+	/* numbered in the order in which they first appear.                      */
 
-	for (i2=g2+1; i2<=M; i2++) {
-		if (Vote2[Kombi[i2]]<i1) {
-			Vote3[i2-1]=1;
-			Vote4[i2-1]=1;
-			j2=true;
-		} else {
-			if (Vote2[Kombi[i2]]>i1) {
-				Vote3[i2-1]=3;
-				Vote4[i2-1]=3;
-			} else {
-				Vote3[i2-1]=2;
-				Vote4[i2-1]=2;
-				i8++;
-			}
-		}
-	}
+	// Look the types up in a hash table instead of comparing each ballot
+	// to every type seen so far.
 
-	Value3[0]=Value2[0];
-	Indif4[0]=i8;
-	cool4 [0]=j2;
+	BallotTypes.clear();
+	BallotType.resize(M);
 
 	N3=0;
 
-	for (i1=1; i1<N2; i1++) {
-		i2=0;
-
+	for (i1=0; i1<N2; i1++) {
 		i4=C*i1;
+		i6=Vote2[i4+Kombi[g2]];
 
-		j1=false;
-
-		while ((i2<=N3) && (j1==false)) {
-			i5=M*i2;
-
-			j1=true;
-
-			i6=Vote2[i4+Kombi[g2]];
+		i3=0;
+		i8=0;
+		j2=false;
 
-			for (i3=0; (j1==true) && (i3<g2); i3++) {
-				i7=Vote2[i4+Kombi[i3]];
-				i9=Vote3[i5+i3];
-
-				if (((i7>i6) && (i9!=3))
-					|| ((i7<i6) && (i9!=1))
-					|| ((i7==i6) && (i9!=2))) {
-					j1=false;
-				}
+		for (i2=0; i2<=M; i2++) {
+			if (i2==g2) {
+				continue;
 			}
 
-			if (j1==true)
-				for (i3=g2+1; (j1==true) && (i3<=M); i3++) {
-					i7=Vote2[i4+Kombi[i3]];
-					i9=Vote3[i5+i3-1];
-
-					if (((i7>i6) && (i9!=3))
-						|| ((i7<i6) && (i9!=1))
-						|| ((i7==i6) && (i9!=2))) {
-						j1=false;
-					}
-				}
+			i7=Vote2[i4+Kombi[i2]];
 
-			if (j1==false) {
-				i2++;
+			if (i7<i6) {
+				i9=1;
+				j2=true;
 			} else {
-				Value3[i2]=Value3[i2]+Value2[i1];
+				if (i7>i6) {
+					i9=3;
+				} else {
+					i9=2;
+					i8++;
+				}
 			}
+
+			BallotType[i3]=i9;
+			i3++;
 		}
 
-		if (j1==false) {
-			N3++;
+		auto type=BallotTypes.insert(std::make_pair(BallotType,N3));
 
-			i5=M*N3;
-			i6=Vote2[i4+Kombi[g2]];
+		if (type.second==false) {
+			Value3[type.first->second]+=Value2[i1];
+			continue;
+		}
 
-			i8=0;
-			j2=false;
+		i5=M*N3;
 
-			for (i2=0; i2<g2; i2++) {
-				if (Vote2[i4+Kombi[i2]]<i6) {
-					Vote3[i5+i2]=1;
-					Vote4[i5+i2]=1;
-					j2=true;
-				} else {
-					if (Vote2[i4+Kombi[i2]]>i6) {
-						Vote3[i5+i2]=3;
-						Vote4[i5+i2]=3;
-					} else {
-						Vote3[i5+i2]=2;
-						Vote4[i5+i2]=2;
-						i8++;
-					}
-				}
-			}
+		for (i2=0; i2<M; i2++) {
+			Vote3[i5+i2]=BallotType[i2];
+			Vote4[i5+i2]=BallotType[i2];
+		}
 
-			for (i2=g2+1; i2<=M; i2++) {
-				if (Vote2[i4+Kombi[i2]]<i6) {
-					Vote3[i5+i2-1]=1;
-					Vote4[i5+i2-1]=1;
-					j2=true;
-				} else {
-					if (Vote2[i4+Kombi[i2]]>i6) {
-						Vote3[i5+i2-1]=3;
-						Vote4[i5+i2-1]=3;
-					} else {
-						Vote3[i5+i2-1]=2;
-						Vote4[i5+i2-1]=2;
-						i8++;
-					}
-				}
-			}
+		Value3[N3]=Value2[i1];
+		Indif4[N3]=i8;
+		cool4 [N3]=j2;
 
-			Value3[N3]=Value2[i1];
-			Indif4[N3]=i8;
-			cool4 [N3]=j2;
-		}
+		N3++;
 	}
 
-	N3++;
-
 	N4=N3;
 
 	for (i1=0; i1<N4; i1++) {
@@ -14,6 +14,8 @@
 #include <time.h>
 #include <limits.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "multiwinner/methods/methods.h" // council_t
@@ -31,14 +33,6 @@ struct ArcElement {
 	int end;
 	long double Value;
 	long double Cap;
-	int upper;
-	int lower;
-};
-
-struct VertexElement {
-	int  marked;
-	int  upper;
-	bool direction;
 };
 
 struct IndiffElement {
@@ -118,16 +112,22 @@ class SchulzeCommon {
 
 		struct IndiffElement *Indiff,*Indiff7,*Indiff8;
 		struct ArcElement    *Arcs,*Arcs7,*Arcs8;
-		struct VertexElement *Vertices,*Vertices7,*Vertices8;
 		struct VotesElement  *Votes;
 
-		int         g1,g2,g3,m1,Length4,Length6,Length7,LengthArc,LengthVertex;
+		int         g1,g2,g3,m1,Length4,Length6,Length7,LengthArc;
 		long double Output1;
 
 		int SimplexNichtNoetig;
 
-		int LengthIndiff7,LengthIndiff8,LengthArc7,LengthArc8,LengthVertex7,
-			LengthVertex8;
+		int LengthIndiff7,LengthIndiff8,LengthArc7,LengthArc8;
+
+		// Ballot types seen so far by VoteMana.
+		std::string BallotType;
+		std::unordered_map<std::string,int> BallotTypes;
+
+		// Reusable buffers for augment_to_max_flow.
+		std::vector<int> FlowFirstArc,FlowAdjacent,FlowCurrentArc,FlowLevel,
+			FlowQueue,FlowPath;
 
 		bool *completed;
 		int tobecompleted;
@@ -144,6 +144,12 @@ class SchulzeCommon {
 		void Print2();
 		void Reading_the_Input();
 		void Analyzing_the_Input();
+		void allocate_vote_management();
+		void free_vote_management();
+		long double augment_to_max_flow(struct ArcElement *FlowArcs,
+			int NArcs, int NVertices, int Source, int Drain,
+			long double Flow, long double Target);
+
 		void PropCompletionSimple();
 		void EKarp();
 		void EKarpSimple();
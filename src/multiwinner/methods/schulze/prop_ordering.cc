@@ -46,70 +46,9 @@ size_t SchulzePOCalc::Filling_the_next_place() {
 
 	M++;
 
-	i1=N2;
+	allocate_vote_management();
 
-	if (M+1>N2) {
-		i1=M+1;
-	}
-
-	Length4      =i1;
-	Length6      =i1;
-	Length7      =i1;
-	LengthArc    =i1;
-	LengthArc7   =i1;
-	LengthArc8   =i1;
-	LengthVertex =i1;
-	LengthVertex7=i1;
-	LengthVertex8=i1;
-	LengthIndiff7=i1;
-	LengthIndiff8=i1;
-
-	Kombi    =(int                 *)calloc(C+2,sizeof(int));
 	Matrix2  =(long double         *)calloc(C*C+1,sizeof(long double));
-	Vote3    =(unsigned char       *)calloc(N2*M+1,sizeof(unsigned char));
-	Value3   =(int                 *)calloc(N2+1,sizeof(int));
-	Vote4    =(unsigned char       *)calloc(Length4*M+1,
-			sizeof(unsigned char));
-	Value4   =(long double         *)calloc(Length4+1,
-			sizeof(long double));
-	Indif4   =(int                 *)calloc(Length4+1,
-			sizeof(int));
-	cool4    =(bool                *)calloc(Length4+1,
-			sizeof(bool));
-	Kombi4   =(int                 *)calloc(M+1,sizeof(int));
-	Vote5    =(unsigned char       *)calloc(i1*M+1,sizeof(unsigned char));
-	Value5   =(int                 *)calloc(i1+1,sizeof(int));
-	Test     =(unsigned char       *)calloc(M+1,sizeof(unsigned char));
-	Test3    =(int                 *)calloc(N2+1,sizeof(int));
-	Indiff   =(struct IndiffElement*)calloc(Length6+1,
-			sizeof(struct IndiffElement));
-	Arcs     =(struct ArcElement   *)calloc(LengthArc+1,
-			sizeof(struct ArcElement));
-	Arcs7    =(struct ArcElement   *)calloc(LengthArc7+1,
-			sizeof(struct ArcElement));
-	Arcs8    =(struct ArcElement   *)calloc(LengthArc8+1,
-			sizeof(struct ArcElement));
-	Vertices =(struct VertexElement*)calloc(LengthVertex+1,
-			sizeof(struct VertexElement));
-	Vertices7=(struct VertexElement*)calloc(LengthVertex7+1,
-			sizeof(struct VertexElement));
-	Vertices8=(struct VertexElement*)calloc(LengthVertex8+1,
-			sizeof(struct VertexElement));
-	Votes    =(struct VotesElement *)calloc(M+1,sizeof(struct VotesElement));
-	Votes1   =(int                 *)calloc(M+1,sizeof(int));
-	completed=(bool                *)calloc(M+1,sizeof(bool));
-	Vote7    =(bool                *)calloc(Length7*M+1,
-			sizeof(bool));
-	Value7   =(long double         *)calloc(Length7+1,
-			sizeof(long double));
-	Vote8    =(bool                *)calloc(Length7*M+1,
-			sizeof(bool));
-	Value8   =(long double         *)calloc(Length7+1,
-			sizeof(long double));
-	Indiff7  =(struct IndiffElement*)calloc(LengthIndiff7+1,
-			sizeof(struct IndiffElement));
-	Indiff8  =(struct IndiffElement*)calloc(LengthIndiff8+1,
-			sizeof(struct IndiffElement));
 
 	marked   =(bool*)calloc(M+2,sizeof(bool));
 	p        =(long double*)calloc(C*C+1,sizeof(long double));
@@ -247,34 +186,7 @@ size_t SchulzePOCalc::Filling_the_next_place() {
 
 	free(Matrix2);
 
-	free(Kombi);
-	free(Vote3);
-	free(Value3);
-	free(Vote4);
-	free(Value4);
-	free(Indif4);
-	free(cool4);
-	free(Kombi4);
-	free(Vote5);
-	free(Value5);
-	free(Test);
-	free(Test3);
-	free(Indiff);
-	free(Arcs);
-	free(Arcs7);
-	free(Arcs8);
-	free(Vertices);
-	free(Vertices7);
-	free(Vertices8);
-	free(Votes);
-	free(Votes1);
-	free(completed);
-	free(Vote7);
-	free(Value7);
-	free(Vote8);
-	free(Value8);
-	free(Indiff7);
-	free(Indiff8);
+	free_vote_management();
 
 	free(marked);
 	free(p);
@@ -57,167 +57,68 @@ void SchulzeSTVCalc::Elimination() {
 void SchulzeSTVCalc::Calculation_of_the_Strengths_of_the_Vote_Managements() {
 	int i1,i2,i3,i4;
 	bool j1;
+	std::vector<int> KombiG(M+1);
 
-	i1=N2;
-
-	if (M+1>N2) {
-		i1=M+1;
-	}
-
-	Length4      =i1;
-	Length6      =i1;
-	Length7      =i1;
-	LengthArc    =i1;
-	LengthArc7   =i1;
-	LengthArc8   =i1;
-	LengthVertex =i1;
-	LengthVertex7=i1;
-	LengthVertex8=i1;
-	LengthIndiff7=i1;
-	LengthIndiff8=i1;
-
-	Kombi    =(int                 *)calloc(C+2,sizeof(int));
 	Matrix1  =(int                 *)calloc(Comb2*(M+1)+1,
 			sizeof(int));
 	Matrix2  =(long double         *)calloc(Comb2*(M+1)+1,
 			sizeof(long double));
-	Vote3    =(unsigned char       *)calloc(N2*M+1,sizeof(unsigned char));
-	Value3   =(int                 *)calloc(N2+1,sizeof(int));
-	Vote4    =(unsigned char       *)calloc(Length4*M+1,
-			sizeof(unsigned char));
-	Value4   =(long double         *)calloc(Length4+1,
-			sizeof(long double));
-	Indif4   =(int                 *)calloc(Length4+1,
-			sizeof(int));
-	cool4    =(bool                *)calloc(Length4+1,
-			sizeof(bool));
-	Kombi4   =(int                 *)calloc(M+1,sizeof(int));
-	Vote5    =(unsigned char       *)calloc(i1*M+1,sizeof(unsigned char));
-	Value5   =(int                 *)calloc(i1+1,sizeof(int));
-	Test     =(unsigned char       *)calloc(M+1,sizeof(unsigned char));
-	Test3    =(int                 *)calloc(N2+1,sizeof(int));
-	Indiff   =(struct IndiffElement*)calloc(Length6+1,
-			sizeof(struct IndiffElement));
-	Arcs     =(struct ArcElement   *)calloc(LengthArc+1,
-			sizeof(struct ArcElement));
-	Arcs7    =(struct ArcElement   *)calloc(LengthArc7+1,
-			sizeof(struct ArcElement));
-	Arcs8    =(struct ArcElement   *)calloc(LengthArc8+1,
-			sizeof(struct ArcElement));
-	Vertices =(struct VertexElement*)calloc(LengthVertex+1,
-			sizeof(struct VertexElement));
-	Vertices7=(struct VertexElement*)calloc(LengthVertex7+1,
-			sizeof(struct VertexElement));
-	Vertices8=(struct VertexElement*)calloc(LengthVertex8+1,
-			sizeof(struct VertexElement));
-	Votes    =(struct VotesElement *)calloc(M+1,sizeof(struct VotesElement));
-	Votes1   =(int                 *)calloc(M+1,sizeof(int));
-	completed=(bool                *)calloc(M+1,sizeof(bool));
-	Vote7    =(bool                *)calloc(Length7*M+1,
-			sizeof(bool));
-	Value7   =(long double         *)calloc(Length7+1,
-			sizeof(long double));
-	Vote8    =(bool                *)calloc(Length7*M+1,
-			sizeof(bool));
-	Value8   =(long double         *)calloc(Length7+1,
-			sizeof(long double));
-	Indiff7  =(struct IndiffElement*)calloc(LengthIndiff7+1,
-			sizeof(struct IndiffElement));
-	Indiff8  =(struct IndiffElement*)calloc(LengthIndiff8+1,
-			sizeof(struct IndiffElement));
 
-	/*datafile=fopen("output.txt","w+");
-	fclose(datafile);*/
+	// First list every combination of M+1 candidates in Matrix1, then
+	// calculate the strengths of the vote managements for each of them.
+	// The combinations are independent of each other, so the latter is
+	// done in parallel, with each thread using its own copy of the
+	// working arrays.
 
 	i4=0;
 
 	for (i1=0; i1<=M; i1++) {
-		Kombi[i1]=i1;
-	}
-
-	/*datafile=fopen("output.txt","a+");
-
-	fprintf(datafile,"%d ",i4+1);*/
-
-	for (i1=0; i1<=M; i1++) {
-		g1=Kombi[i1];
-		Matrix1[(M+1)*i4+i1]=g1;
-		//Print1();
+		KombiG[i1]=i1;
 	}
 
-//fclose(datafile);
-
-	g3=i4;
-	Elimination();
-
-	i4++;
-
 	j1=true;
 
 	while (j1==true) {
+		for (i1=0; i1<=M; i1++) {
+			Matrix1[(M+1)*i4+i1]=KombiG[i1];
+		}
+
+		i4++;
+
 		j1=false;
 
 		for (i1=M; (j1==false) && (i1>=0); i1--)
-			if (Kombi[i1]!=C-M+i1-1) {
+			if (KombiG[i1]!=C-M+i1-1) {
 				j1=true;
 
-				Kombi[i1]++;
+				KombiG[i1]++;
 
 				i3=1;
 				for (i2=i1+1; i2<=M; i2++) {
-					Kombi[i2]=Kombi[i1]+i3;
+					KombiG[i2]=KombiG[i1]+i3;
 					i3++;
 				}
 			}
+	}
 
-		if (j1==true) {
-			//datafile=fopen("output.txt","a+");
-
-			//fprintf(datafile,"%d ",i4+1);
+	#pragma omp parallel private(i1,i4)
+	{
+		SchulzeSTVCalc worker(*this);
+		worker.allocate_vote_management();
 
+		#pragma omp for schedule(dynamic)
+		for (i4=0; i4<Comb2; i4++) {
 			for (i1=0; i1<=M; i1++) {
-				g1=Kombi[i1];
-				Matrix1[(M+1)*i4+i1]=g1;
-				//Print1();
+				worker.Kombi[i1]=Matrix1[(M+1)*i4+i1];
 			}
 
-			//fclose(datafile);
-
-			g3=i4;
-			Elimination();
-
-			i4++;
+			worker.g1=worker.Kombi[M];
+			worker.g3=i4;
+			worker.Elimination();
 		}
-	}
 
-	free(Kombi);
-	free(Vote3);
-	free(Value3);
-	free(Vote4);
-	free(Value4);
-	free(Indif4);
-	free(cool4);
-	free(Kombi4);
-	free(Vote5);
-	free(Value5);
-	free(Test);
-	free(Test3);
-	free(Indiff);
-	free(Arcs);
-	free(Arcs7);
-	free(Arcs8);
-	free(Vertices);
-	free(Vertices7);
-	free(Vertices8);
-	free(Votes);
-	free(Votes1);
-	free(completed);
-	free(Vote7);
-	free(Value7);
-	free(Vote8);
-	free(Value8);
-	free(Indiff7);
-	free(Indiff8);
+		worker.free_vote_management();
+	}
 }
 
 /*******************************************************************************/
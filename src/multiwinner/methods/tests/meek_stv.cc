@@ -0,0 +1,94 @@
+// Meek and Warren STV tests
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multiwinner/methods/meek_stv.h"
+#include "interpreter/rank_order.h"
+
+// Helper function
+static std::vector<std::string> get_sorted_winners(
+	const multiwinner_method & method, size_t num_seats,
+	const std::vector<std::string> & ballots) {
+
+	rank_order_int interpreter;
+
+	names_and_election interpreted_election =
+		interpreter.interpret_ballots(ballots, false);
+
+	council_t outcome = method.get_council(num_seats,
+			interpreted_election.first.size(), interpreted_election.second);
+
+	std::vector<std::string> winners;
+
+	for (auto i: outcome) {
+		winners.push_back(interpreted_election.first[i]);
+	}
+
+	std::sort(winners.begin(), winners.end());
+
+	return winners;
+}
+
+// A 60-40 split into two factions should give each faction a seat, with
+// the second seat going to the smaller faction's favorite, not to the
+// larger faction's second choice.
+TEST(MeekSTV, FactionsGetProportionalSeats) {
+	std::vector<std::string> desired_outcome = {"A", "C"};
+
+	std::vector<std::string> election = {
+		"60: A > B > C > D",
+		"40: C > D > A > B"
+	};
+
+	EXPECT_EQ(get_sorted_winners(MeekSTV(false), 2, election),
+		desired_outcome);
+	EXPECT_EQ(get_sorted_winners(MeekSTV(true), 2, election),
+		desired_outcome);
+}
+
+// B has fewer first preferences than D, and only gets elected through
+// A's surplus, which needs A's keep factor to converge.
+TEST(MeekSTV, SurplusTransfers) {
+	std::vector<std::string> desired_outcome = {"A", "B", "C"};
+
+	std::vector<std::string> election = {
+		"50: A > B",
+		"14: B > C",
+		"20: C",
+		"16: D"
+	};
+
+	EXPECT_EQ(get_sorted_winners(MeekSTV(false), 3, election),
+		desired_outcome);
+	EXPECT_EQ(get_sorted_winners(MeekSTV(true), 3, election),
+		desired_outcome);
+}
+
+// Weighted ballots should count the same as that many single ballots.
+TEST(MeekSTV, WeightsMatchRepeatedBallots) {
+	std::vector<std::string> weighted = {
+		"3: A > B > C > D",
+		"2: B > A > D > C",
+		"2: C > D > B",
+		"1: D > C > A > B",
+		"2: B > C"
+	};
+
+	std::vector<std::string> repeated;
+
+	for (const std::string & ballot: weighted) {
+		int weight = ballot[0] - '0';
+		for (int i = 0; i < weight; ++i) {
+			repeated.push_back("1" + ballot.substr(1));
+		}
+	}
+
+	for (bool warren: {false, true}) {
+		for (size_t seats = 1; seats <= 3; ++seats) {
+			EXPECT_EQ(get_sorted_winners(MeekSTV(warren), seats, weighted),
+				get_sorted_winners(MeekSTV(warren), seats, repeated));
+		}
+	}
+}
@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/tests/random_elections.h"
 #include "multiwinner/methods/schulze/shuntsstv.h"
 #include "interpreter/rank_order.h"
 
@@ -329,6 +330,36 @@ TEST(SchulzeSTV, OverflowWith100Cands50Seats) {
 		std::invalid_argument);
 }
 
+// Vote management finds its strengths through max flows and proportional
+// completion, and there's more than one way to implement those. Whichever
+// way we use, the outcomes must stay the same, so these are the councils
+// that the original implementation elected on some seeded elections, with
+// and without equal rankings and truncation.
+TEST(SchulzeSTV, KeepsOutcomesOnRandomElections) {
+	std::vector<council_t> expected = {
+		{3}, {2}, {0, 3}, {1, 4, 5, 6}, {3}, {1, 2, 3, 4, 5}, {1, 2},
+		{0, 2, 3, 4}, {1, 4}, {2, 4, 5}, {0, 2, 3, 4}, {4}, {0}, {4, 5},
+		{0, 3}, {2, 3}, {1}, {0, 3}, {1, 2, 3, 4, 5, 6}, {2, 3, 4}, {3, 4},
+		{0, 3, 4, 5}, {0}, {2}, {4}, {2, 3, 4}, {0, 1, 3}, {1, 4},
+		{0, 1, 2, 4, 5}, {1, 2, 3}, {2}, {2, 4, 5}, {2}, {2}, {2, 4}, {5},
+		{0, 1, 3, 4, 5}, {1, 2, 3, 4, 5}, {0, 1, 2, 3}, {0, 1, 4, 5, 6}
+	};
+
+	rng randomizer(1);
+	SchulzeSTV SSTV;
+
+	for (size_t trial = 0; trial < expected.size(); ++trial) {
+		size_t num_candidates = 4 + randomizer.next_int(4),
+			num_seats = 1 + randomizer.next_int(num_candidates - 1);
+
+		election_t election = get_random_election(num_candidates, 30,
+				trial % 2 == 1 ? 4 : 0, true, false, randomizer);
+
+		EXPECT_EQ(SSTV.get_council(num_seats, num_candidates, election),
+			expected[trial]) << "trial " << trial;
+	}
+}
+
 // TODO: Test unreasonable candidate and seat numbers - should
 // return an exception. (See the "over" statements in the code,
 // these are binomial numbers, don't accept any that would overflow.
@@ -0,0 +1,161 @@
+#include "counter.h"
+
+#include <stdexcept>
+#include <math.h>
+
+// Eight doubles is the AVX-512 vector width; it's also two AVX2 vectors, so
+// padding to it suits both.
+const size_t COUNTER_LANES = 8;
+
+const size_t pairwise_counter::BLOCK_SIZE;
+
+pairwise_counter::pairwise_counter(size_t num_candidates_in) {
+	if (num_candidates_in == 0) {
+		throw std::invalid_argument("pairwise_counter: Must have at "
+			"least one candidate");
+	}
+
+	num_candidates = num_candidates_in;
+	stride = ((num_candidates + COUNTER_LANES - 1) / COUNTER_LANES) *
+		COUNTER_LANES;
+
+	counts.resize(num_candidates * stride, 0);
+	rank_block.resize(BLOCK_SIZE * stride, -INFINITY);
+	weight_block.resize(BLOCK_SIZE, 0);
+
+	clear();
+}
+
+void pairwise_counter::clear() {
+	std::fill(counts.begin(), counts.end(), 0);
+	num_voters = 0;
+	ballots_in_block = 0;
+}
+
+void pairwise_counter::add_ranks(const double * ranks, double weight) {
+	num_voters += weight;
+
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		double * row = &counts[cand * stride];
+		double cand_rank = ranks[cand];
+
+		#pragma omp simd
+		for (size_t against = 0; against < num_candidates; ++against) {
+			row[against] += (cand_rank < ranks[against]) ? weight : 0;
+		}
+	}
+}
+
+void pairwise_counter::add_rank_block(const double * ranks,
+	const double * weights, size_t num_ballots) {
+
+	for (size_t ballot = 0; ballot < num_ballots; ++ballot) {
+		num_voters += weights[ballot];
+	}
+
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		double * row = &counts[cand * stride];
+
+		for (size_t ballot = 0; ballot < num_ballots; ++ballot) {
+			const double * ballot_ranks = ranks + ballot * stride;
+			double cand_rank = ballot_ranks[cand], weight = weights[ballot];
+
+			// Going all the way to the stride is what lets the
+			// compiler skip the remainder loop. The padding ranks are
+			// -INFINITY, so nothing is ever added to the padding.
+			#pragma omp simd
+			for (size_t against = 0; against < stride; ++against) {
+				row[against] += (cand_rank < ballot_ranks[against]) ?
+					weight : 0;
+			}
+		}
+	}
+}
+
+double * pairwise_counter::next_rank_vector() {
+	if (ballots_in_block == BLOCK_SIZE) {
+		flush();
+	}
+
+	return &rank_block[ballots_in_block * stride];
+}
+
+// Equal-scored candidates get the same rank, and every unranked candidate
+// gets num_candidates, which is worse than any ranked candidate. This matches
+// how condmat has always completed truncated ballots.
+
+void pairwise_counter::set_ranks(const ballot_group & ballot,
+	double * ranks) const {
+
+	std::fill(ranks, ranks + num_candidates, num_candidates);
+
+	size_t rank = 0;
+	bool first = true;
+	double last_score = 0;
+
+	for (const candscore & cs: ballot.contents) {
+		if (cs.get_candidate_num() >= num_candidates) {
+			throw std::out_of_range("pairwise_counter: Voter ranked a "
+				"candidate greater than number of candidates.");
+		}
+
+		if (!first && cs.get_score() != last_score) {
+			++rank;
+		}
+
+		ranks[cs.get_candidate_num()] = rank;
+		last_score = cs.get_score();
+		first = false;
+	}
+}
+
+void pairwise_counter::set_ranks(const compact_election & election,
+	size_t ballot, double * ranks) const {
+
+	std::fill(ranks, ranks + num_candidates, num_candidates);
+
+	size_t begin = election.ballot_begin(ballot),
+		   end = election.ballot_end(ballot), rank = 0;
+
+	for (size_t entry = begin; entry < end; ++entry) {
+		size_t candidate = election.get_candidate(entry);
+
+		if (candidate >= num_candidates) {
+			throw std::out_of_range("pairwise_counter: Voter ranked a "
+				"candidate greater than number of candidates.");
+		}
+
+		if (entry != begin && election.get_score(entry) !=
+			election.get_score(entry-1)) {
+			++rank;
+		}
+
+		ranks[candidate] = rank;
+	}
+}
+
+void pairwise_counter::add_ballot(const ballot_group & ballot) {
+	double * ranks = next_rank_vector();
+	set_ranks(ballot, ranks);
+	weight_block[ballots_in_block++] = ballot.get_weight();
+}
+
+void pairwise_counter::add_ballots(const election_t & election) {
+	for (const ballot_group & ballot: election) {
+		add_ballot(ballot);
+	}
+}
+
+void pairwise_counter::add_ballots(const compact_election & election) {
+	for (size_t ballot = 0; ballot < election.num_ballots(); ++ballot) {
+		double * ranks = next_rank_vector();
+		set_ranks(election, ballot, ranks);
+		weight_block[ballots_in_block++] = election.get_weight(ballot);
+	}
+}
+
+void pairwise_counter::flush() {
+	add_rank_block(rank_block.data(), weight_block.data(),
+		ballots_in_block);
+	ballots_in_block = 0;
+}
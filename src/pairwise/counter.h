@@ -0,0 +1,88 @@
+#pragma once
+
+// A dedicated pairwise counting engine. Every ballot is first turned into a
+// dense rank vector (the position of each candidate, with every unranked
+// candidate sharing the position just below the last ranked one), and then a
+// ballot updates a whole row of the pairwise matrix at once: candidate A's row
+// gets the ballot's weight added to every column B where A's rank is better
+// than B's.
+
+// The matrix is a flat row-major buffer whose rows are padded to a multiple
+// of the SIMD width, and the padding entries of the rank vectors are set so
+// that they never count. This lets the compiler turn the inner loop into
+// branch-free compare-and-accumulate vector instructions (AVX2 or AVX-512
+// with -march=native) with no scalar remainder loop.
+
+// The batch interface counts a block of ballots row by row so that each row
+// of the matrix stays in registers or L1 while the block's rank vectors
+// stream past it.
+
+// Ranks are stored as doubles so that the comparison masks have the same
+// width as the accumulators.
+
+#include "common/ballots.h"
+#include "common/compact_ballots.h"
+
+#include <vector>
+
+class pairwise_counter {
+	private:
+		size_t num_candidates, stride;
+		double num_voters;
+
+		// counts[a * stride + b] is the number of voters preferring
+		// a to b.
+		std::vector<double> counts;
+
+		// Rank vectors waiting to be counted, and their weights.
+		std::vector<double> rank_block, weight_block;
+		size_t ballots_in_block;
+
+		double * next_rank_vector();
+		void set_ranks(const ballot_group & ballot, double * ranks) const;
+		void set_ranks(const compact_election & election,
+			size_t ballot, double * ranks) const;
+
+	public:
+		// Number of ballots counted at once by the batch interface.
+		static const size_t BLOCK_SIZE = 64;
+
+		pairwise_counter(size_t num_candidates_in);
+
+		void clear();
+
+		// Counts a single rank vector of num_candidates entries. Lower
+		// ranks are better; equal ranks express no preference.
+		void add_ranks(const double * ranks, double weight);
+
+		// Counts num_ballots rank vectors. The rank vectors are laid
+		// out one after another, each get_stride() entries long; the
+		// entries past num_candidates must be -INFINITY.
+		void add_rank_block(const double * ranks, const double * weights,
+			size_t num_ballots);
+
+		// These queue up rank vectors and count them in blocks. Call
+		// flush() before reading off the result.
+		void add_ballot(const ballot_group & ballot);
+		void add_ballots(const election_t & election);
+		void add_ballots(const compact_election & election);
+		void flush();
+
+		size_t get_num_candidates() const {
+			return num_candidates;
+		}
+
+		size_t get_stride() const {
+			return stride;
+		}
+
+		double get_num_voters() const {
+			return num_voters;
+		}
+
+		// Number of voters preferring candidate to against. Requires
+		// that the queue has been flushed.
+		double get_count(size_t candidate, size_t against) const {
+			return counts[candidate * stride + against];
+		}
+};
@@ -57,6 +57,17 @@ condmat::condmat(const election_t & scores, size_t num_candidates,
 	count_ballots(scores, num_candidates);
 }
 
+condmat::condmat(const compact_election & scores, size_t num_candidates,
+	pairwise_type kind) : abstract_condmat(kind) {
+
+	if (num_candidates == 0) {
+		throw std::invalid_argument("condmat: Must have at least "
+			"one candidate");
+	}
+
+	count_ballots(scores, num_candidates);
+}
+
 condmat::condmat(size_t num_candidates_in, double num_voters_in,
 	pairwise_type type_in) : abstract_condmat(type_in) {
 
@@ -71,6 +82,17 @@ condmat::condmat(size_t num_candidates_in, double num_voters_in,
 	num_voters = num_voters_in;
 }
 
+condmat::condmat(pairwise_counter & counter,
+	pairwise_type type_in) : abstract_condmat(type_in) {
+
+	if (counter.get_num_candidates() == 0) {
+		throw std::invalid_argument("condmat: Must have at least "
+			"one candidate");
+	}
+
+	set_from_counter(counter);
+}
+
 condmat::condmat(const condmat & in,
 	pairwise_type type_in) : abstract_condmat(
 			type_in) {
@@ -78,157 +100,42 @@ condmat::condmat(const condmat & in,
 	num_voters = in.num_voters;
 }
 
-// count ballots go here. Then test.
+// Both count_ballots variants go through the pairwise counting engine (see
+// counter.h) and then copy its result into the matrix.
 
-// Perhaps bool clear.
-void condmat::count_ballots(const election_t & scores,
-	size_t num_candidates) {
+void condmat::set_from_counter(pairwise_counter & counter) {
+	counter.flush();
 
-	// For each ballot
-	//	 For each pair of candidates
-	//		If the candidates have different score,
-	//			add the appropriate weight to the matrix at
-	//			the appropriate position.
-
-	// We handle incomplete ballots by storing a v<bool> of num_candidates.
-	// Every candidate met gets marked as true in it, and then we simply
-	// add weight points to all trues above all falses afterwards. We do
-	// nothing if we've seen all the candidates (i.e. ballot is complete).
-
-	if (contents.size() != num_candidates)
-		contents = std::vector<std::vector<double> > (num_candidates,
-				std::vector<double> (num_candidates, 0));
-
-	std::vector<bool> seen(num_candidates);
-
-	bool debug = false;
-	num_voters = 0;
-
-	for (election_t::const_iterator ballot = scores.begin();
-		ballot != scores.end(); ++ballot) {
-
-		fill(seen.begin(), seen.end(), false);
-		size_t seen_candidates = 0;
-
-		ordering::const_iterator cand, against;
-
-		num_voters += ballot->get_weight();
-
-		for (ordering::const_iterator cand = ballot->contents.begin();
-			cand != ballot->contents.end(); ++cand) {
-
-			// Check that the data is valid.
-			if (cand->get_candidate_num() >= num_candidates) {
-				throw std::out_of_range("condmat::count_ballots: "
-					"Voter ranked a candidate greater then number of candidates.");
-			}
-
-			// Okay, it's valid, so mark it off...
-			if (!seen[cand->get_candidate_num()]) {
-				seen[cand->get_candidate_num()] = true;
-				++seen_candidates;
-			}
-
-			// ... and count all lower candidates against it.
-			against = cand;
-
-			while (++against != ballot->contents.end()) {
-				// If it has the same score as the other
-				// candidate, there's no need to deal with it,
-				// so skip.
-				if (against->get_score() == cand->get_score()) {
-					continue;
-				}
-
-				if (against->get_candidate_num() >= num_candidates) {
-					throw std::out_of_range("condmat::count_ballots: "
-						"Voter ranked a candidate greater then number of candidates.");
-				}
-
-				// Okay, it's legitimate and there's a
-				// strict preference. Add it.
-				double last = get_internal(cand->
-						get_candidate_num(),
-						against->get_candidate_num(),
-						true);
-
-				if (debug) {
-					std::cout << "Adding "<< ballot->get_weight() <<
-						" to " 	<< (char)('A' + cand->
-							get_candidate_num())
-						<< " vs " << (char)('A' +
-							against->
-							get_candidate_num())
-						<< " -- was " << last
-						<< " is now ";
-				}
-
-				set_internal(cand->get_candidate_num(),
-					against->get_candidate_num(),
-					last + ballot->get_weight());
-
-				if (debug) {
-					std::cout << get_internal(cand->
-							get_candidate_num(),
-							against->
-							get_candidate_num(),
-							true);
-					std::cout << std::endl;
-				}
-			}
-		}
-
-		// If this was an incomplete ballot, complete it by ranking
-		// all those listed above all those not.
-		if (seen_candidates != num_candidates) {
-
-			for (size_t counter = 0; counter < seen.size();
-				++counter) {
-				// If it's not a ranked candidate, skip
-				if (!seen[counter]) {
-					continue;
-				}
-
-				for (size_t sec = 0; sec < seen.size(); ++sec) {
-					// If it's a ranked candidate, skip
-					if (seen[sec]) {
-						continue;
-					}
-
-					if (debug)
-						std::cout << "Unranked vs ranked: "<<
-							"adding " << ballot->
-							get_weight() << " to " <<
-							(char)('A'+ counter) <<
-							" vs " <<
-							(char)('A' + sec)
-							<< std::endl;
-
-					// The ranked candidate beats the
-					// unranked one - update scores.
-
-					set_internal(counter, sec,
-						get_internal(counter,
-							sec, true) +
-						ballot->get_weight());
-				}
-			}
-		}
+	size_t num_candidates = counter.get_num_candidates();
+	zeroize(num_candidates);
 
-		if (debug) {
-			std::cout << std::endl;
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		for (size_t against = 0; against < num_candidates; ++against) {
+			contents[cand][against] = counter.get_count(cand, against);
 		}
 	}
 
-	if (debug) {
-		std::cout << "After count-ballots:" << std::endl;
-		for (size_t y = 0; y < num_candidates; ++y) {
-			for (size_t x = 0; x < num_candidates; ++x) {
-				std::cout << get_internal(y, x, true) << "    ";
-			}
-			std::cout << std::endl;
-		}
-	}
+	num_voters = counter.get_num_voters();
+}
+
+// We handle incomplete ballots by ranking every candidate that isn't listed
+// equal-last, below every candidate that is. Candidates with the same score
+// are considered equally ranked, so no preference is recorded between them.
+
+void condmat::count_ballots(const election_t & scores,
+	size_t num_candidates) {
+
+	pairwise_counter counter(num_candidates);
+	counter.add_ballots(scores);
+	set_from_counter(counter);
+}
+
+void condmat::count_ballots(const compact_election & scores,
+	size_t num_candidates) {
+
+	pairwise_counter counter(num_candidates);
+	counter.add_ballots(scores);
+	set_from_counter(counter);
 }
 
 void condmat::zeroize() {
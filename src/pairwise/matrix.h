@@ -1,10 +1,12 @@
 #pragma once
 
 #include "common/ballots.h"
+#include "common/compact_ballots.h"
 #include "tools/tools.h"
 
 #include "types.h"
 #include "abstract_matrix.h"
+#include "counter.h"
 
 #include <iterator>
 #include <iostream>
@@ -50,6 +52,8 @@ class condmat : public abstract_condmat {
 	private:
 		std::vector<std::vector<double> > contents;
 
+		void set_from_counter(pairwise_counter & counter);
+
 	protected:
 		double get_internal(size_t candidate, size_t against, bool raw) const;
 		bool set_internal(size_t candidate, size_t against, double value);
@@ -58,15 +62,23 @@ class condmat : public abstract_condmat {
 		condmat(pairwise_type type_in);
 		condmat(const election_t & scores, size_t num_candidates,
 			pairwise_type kind);
+		condmat(const compact_election & scores, size_t num_candidates,
+			pairwise_type kind);
 		// Should we permit condmat(input, kind)? Does that break
 		// or enhance encapsulation?
 		// Do it for now, then judge later.
 		condmat(const condmat & in, pairwise_type type_in);
 		condmat(size_t num_candidates_in, double num_voters_in,
 			pairwise_type type_in);
+		// Takes the result of a counting engine that the caller has
+		// fed directly, e.g. with rank vectors.
+		condmat(pairwise_counter & counter, pairwise_type type_in);
 
 		void count_ballots(const election_t & scores,
 			size_t num_candidates);
+		// Same as above, but for the packed representation.
+		void count_ballots(const compact_election & scores,
+			size_t num_candidates);
 
 		// Perhaps "expand candidates by one, contract by one" here?
 		// Clear, etc...
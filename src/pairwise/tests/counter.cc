@@ -0,0 +1,93 @@
+// Pairwise counting engine tests.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "interpreter/rank_order.h"
+#include "pairwise/counter.h"
+#include "pairwise/matrix.h"
+
+// Count the matrix the slow and obvious way: for every pair of candidates,
+// look up where each is on the ballot.
+static std::vector<std::vector<double> > naive_count(
+	const election_t & election, size_t num_candidates) {
+
+	std::vector<std::vector<double> > out(num_candidates,
+		std::vector<double>(num_candidates, 0));
+
+	for (const ballot_group & ballot: election) {
+		std::vector<bool> ranked(num_candidates, false);
+		std::vector<double> score(num_candidates, 0);
+
+		for (const candscore & cs: ballot.contents) {
+			ranked[cs.get_candidate_num()] = true;
+			score[cs.get_candidate_num()] = cs.get_score();
+		}
+
+		for (size_t a = 0; a < num_candidates; ++a) {
+			for (size_t b = 0; b < num_candidates; ++b) {
+				if (ranked[a] && (!ranked[b] || score[a] > score[b])) {
+					out[a][b] += ballot.get_weight();
+				}
+			}
+		}
+	}
+
+	return out;
+}
+
+TEST(PairwiseCounter, MatchesNaiveCount) {
+	std::vector<std::string> ballots = {
+		"3: A > B > C > D",
+		"2: B = C > A",
+		"4: D > A = B",
+		"1: C",
+		"2: E > D > C > B > A"
+	};
+
+	election_t election = rank_order_int().interpret_ballots(
+			ballots, false).second;
+	size_t num_candidates = 5;
+
+	std::vector<std::vector<double> > expected = naive_count(
+			election, num_candidates);
+
+	pairwise_counter counter(num_candidates);
+	counter.add_ballots(election);
+	counter.flush();
+
+	EXPECT_EQ(counter.get_num_voters(), 12);
+
+	for (size_t a = 0; a < num_candidates; ++a) {
+		for (size_t b = 0; b < num_candidates; ++b) {
+			EXPECT_EQ(counter.get_count(a, b), expected[a][b]);
+		}
+	}
+}
+
+// Check more ballots than fit in a block, and more candidates than fit in a
+// single SIMD row.
+TEST(PairwiseCounter, BatchedRandomElectionMatchesNaiveCount) {
+	size_t num_candidates = 11, num_voters = 300;
+	rng randomizer(1);
+
+	// Score ties and truncation both happen now and then.
+	election_t election = get_random_election(num_candidates, num_voters,
+			5, true, true, randomizer);
+
+	std::vector<std::vector<double> > expected = naive_count(
+			election, num_candidates);
+
+	condmat matrix(election, num_candidates, CM_PAIRWISE_OPP);
+	condmat compact_matrix(compact_election(election), num_candidates,
+		CM_PAIRWISE_OPP);
+
+	for (size_t a = 0; a < num_candidates; ++a) {
+		for (size_t b = 0; b < num_candidates; ++b) {
+			EXPECT_EQ(matrix.get_magnitude(a, b), expected[a][b]);
+			EXPECT_EQ(compact_matrix.get_magnitude(a, b), expected[a][b]);
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#include "philox.h"
+
+#include <random>
+#include <stdexcept>
+
+// Multipliers and Weyl sequence constants for the key schedule, as given
+// in the paper.
+const uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57,
+			   PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+const int PHILOX_ROUNDS = 10;
+
+void philox_rng::get_block(const uint32_t counter_in[4],
+	const uint32_t key_in[2], uint32_t out[4]) {
+
+	uint32_t c[4] = {counter_in[0], counter_in[1], counter_in[2],
+			counter_in[3]
+		};
+	uint32_t k[2] = {key_in[0], key_in[1]};
+
+	for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+		if (round > 0) {
+			k[0] += PHILOX_W0;
+			k[1] += PHILOX_W1;
+		}
+
+		uint64_t product0 = (uint64_t)PHILOX_M0 * c[0],
+				 product1 = (uint64_t)PHILOX_M1 * c[2];
+
+		uint32_t hi0 = product0 >> 32, lo0 = product0,
+				 hi1 = product1 >> 32, lo1 = product1;
+
+		c[0] = hi1 ^ c[1] ^ k[0];
+		c[1] = lo1;
+		c[2] = hi0 ^ c[3] ^ k[1];
+		c[3] = lo0;
+	}
+
+	for (int i = 0; i < 4; ++i) {
+		out[i] = c[i];
+	}
+}
+
+philox_rng::philox_rng(uint64_t key_in, uint64_t stream_in) {
+	if (key_in == RNG_ENTROPY) {
+		// See rng::s_rand for why we try more than once.
+		std::random_device rd;
+		for (int i = 0; i < 10 && key_in == 0; ++i) {
+			uint64_t a = rd(), b = rd();
+			key_in = (a << 32ULL) + b;
+		}
+
+		if (key_in == 0) {
+			throw std::runtime_error(
+				"philox_rng: std::random_device always returns 0");
+		}
+	}
+
+	key = key_in;
+	stream = stream_in;
+	position = 0;
+	has_cached_block = false;
+	cached_block_num = 0;
+}
+
+// To get the new stream, we encrypt the (old stream, ID) pair with a key
+// that's different from the one used for outputs. Since the block function
+// is a bijection for each key, different pairs can only collide when we
+// throw away half of the output.
+
+philox_rng philox_rng::split(uint64_t stream_id) const {
+	uint32_t counter[4] = {(uint32_t)stream_id, (uint32_t)(stream_id >> 32),
+			(uint32_t)stream, (uint32_t)(stream >> 32)
+		};
+	uint64_t split_key = key ^ 0x5851F42D4C957F2DULL;
+	uint32_t key_words[2] = {(uint32_t)split_key,
+			(uint32_t)(split_key >> 32)
+		}, out[4];
+
+	get_block(counter, key_words, out);
+
+	return philox_rng(key, out[0] + ((uint64_t)out[1] << 32));
+}
+
+uint64_t philox_rng::next_long() {
+	uint64_t block_num = position >> 1;
+
+	if (!has_cached_block || block_num != cached_block_num) {
+		uint32_t counter[4] = {(uint32_t)block_num,
+				(uint32_t)(block_num >> 32), (uint32_t)stream,
+				(uint32_t)(stream >> 32)
+			};
+		uint32_t key_words[2] = {(uint32_t)key, (uint32_t)(key >> 32)},
+				 out[4];
+
+		get_block(counter, key_words, out);
+
+		cached_block[0] = out[0] + ((uint64_t)out[1] << 32);
+		cached_block[1] = out[2] + ((uint64_t)out[3] << 32);
+		cached_block_num = block_num;
+		has_cached_block = true;
+	}
+
+	return cached_block[position++ & 1];
+}
+
+// These are the same as for rng: reject the values that would give modulo
+// bias.
+
+uint64_t philox_rng::next_long(uint64_t modulus) {
+	if (modulus == 0) {
+		return (0);
+	}
+
+	const uint64_t maxVal = ~((uint64_t)0);
+	uint64_t remainder = maxVal % modulus;
+
+	if (remainder == 0) {
+		return (next_long() % modulus);
+	}
+
+	uint64_t randval;
+
+	do {
+		randval = next_long();
+	} while (randval < remainder);
+
+	return ((randval - remainder)%modulus);
+}
+
+uint32_t philox_rng::next_int(uint32_t modulus) {
+	if (modulus == 0) {
+		return (0);
+	}
+
+	const uint32_t maxVal = ~((uint32_t)0);
+	uint32_t remainder = maxVal % modulus;
+
+	if (remainder == 0) {
+		return (next_int() % modulus);
+	}
+
+	uint32_t randval;
+	do {
+		randval = next_int();
+	} while (randval < remainder);
+
+	return ((randval - remainder)%modulus);
+}
+
+std::vector<double> philox_rng::get_coordinate(size_t dimension) {
+	std::vector<double> out(dimension);
+	get_coordinates(dimension, 1, out.data());
+
+	return out;
+}
+
+void philox_rng::get_coordinates(size_t dimension, size_t count,
+	double * out) {
+
+	for (size_t i = 0; i < dimension * count; ++i) {
+		out[i] = next_double();
+	}
+}
@@ -0,0 +1,95 @@
+// Counter-based random number generator: Philox4x32-10, from
+// SALMON, John K., et al. Parallel random numbers: as easy as 1, 2, 3.
+// In: Proceedings of the 2011 International Conference for High Performance
+// Computing, Networking, Storage and Analysis. 2011. p. 1-12.
+
+// The nth output is a pure function of the key (seed), the stream number and
+// n, so we can jump ahead in constant time, and split off independent streams
+// for each thread, pixel, bandit arm or whatever. If every unit of work gets
+// its own stream, the results don't depend on the number of threads or the
+// order in which the work is scheduled.
+
+// Like rng, there's no () constructor so that the seed has to be set
+// explicitly; and like rng, a key of RNG_ENTROPY draws the key from the
+// entropy source.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "random.h"
+#include "stats/coordinate_gen.h"
+
+class philox_rng : public coordinate_gen {
+	private:
+		uint64_t key, stream;
+
+		// Number of 64-bit outputs produced so far. Each block gives
+		// two.
+		uint64_t position;
+
+		uint64_t cached_block_num;
+		uint64_t cached_block[2];
+		bool has_cached_block;
+
+	public:
+		// Encrypts the counter with the given key, i.e. runs the ten
+		// Philox rounds. Exposed for testing against known answers.
+		static void get_block(const uint32_t counter_in[4],
+			const uint32_t key_in[2], uint32_t out[4]);
+
+		philox_rng(uint64_t key_in, uint64_t stream_in);
+		philox_rng(uint64_t key_in) : philox_rng(key_in, 0) {}
+
+		// Returns a generator with the same key and a stream derived
+		// from this one's and the given ID. The new stream starts at
+		// the beginning, whatever this generator's position. Different
+		// IDs (or streams) give different streams, except with
+		// negligible probability, so splits can be nested.
+		philox_rng split(uint64_t stream_id) const;
+
+		// Skips n outputs, as if next_long() had been called n times.
+		void jump(uint64_t n) {
+			position += n;
+		}
+
+		uint64_t get_position() const {
+			return position;
+		}
+
+		uint64_t get_stream() const {
+			return stream;
+		}
+
+		bool is_independent() const {
+			return true;
+		}
+
+		void start_query() {}
+		void end_query() {}
+
+		uint64_t get_initial_seed() const {
+			return key;
+		}
+
+		using coordinate_gen::next_long;
+		using coordinate_gen::next_int;
+		using coordinate_gen::next_double;
+
+		uint64_t next_long();
+		uint64_t next_long(uint64_t modulus);
+
+		uint32_t next_int() {
+			return next_long();
+		}
+		uint32_t next_int(uint32_t modulus);
+
+		// Uses the top 53 bits, so this is in [0, 1).
+		double next_double() {
+			return (next_long() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		std::vector<double> get_coordinate(size_t dimension);
+		void get_coordinates(size_t dimension, size_t count, double * out);
+};
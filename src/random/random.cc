@@ -167,6 +167,12 @@ std::vector<double> rng::get_coordinate(size_t dimension) {
 	return out;
 }
 
+void rng::get_coordinates(size_t dimension, size_t count, double * out) {
+	for (size_t i = 0; i < dimension * count; ++i) {
+		out[i] = next_double();
+	}
+}
+
 /*main() {
 
 	long double accumulated = 0;
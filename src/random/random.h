@@ -69,4 +69,5 @@ class rng : public coordinate_gen {
 		uint32_t next_int(uint32_t modulus);
 
 		std::vector<double> get_coordinate(size_t dimension);
+		void get_coordinates(size_t dimension, size_t count, double * out);
 };
\ No newline at end of file
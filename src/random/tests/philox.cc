@@ -0,0 +1,75 @@
+// Tests for the counter-based RNG.
+
+#include <gtest/gtest.h>
+
+#include "random/philox.h"
+
+#include <vector>
+
+// Known answers from the Random123 distribution (kat_vectors).
+TEST(Philox, KnownAnswers) {
+	uint32_t zero_counter[4] = {0, 0, 0, 0}, zero_key[2] = {0, 0},
+			 ones_counter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+			 ones_key[2] = {0xffffffff, 0xffffffff},
+			 pi_counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+			 pi_key[2] = {0xa4093822, 0x299f31d0}, out[4];
+
+	philox_rng::get_block(zero_counter, zero_key, out);
+	EXPECT_EQ(out[0], 0x6627e8d5U);
+	EXPECT_EQ(out[1], 0xe169c58dU);
+	EXPECT_EQ(out[2], 0xbc57ac4cU);
+	EXPECT_EQ(out[3], 0x9b00dbd8U);
+
+	philox_rng::get_block(ones_counter, ones_key, out);
+	EXPECT_EQ(out[0], 0x408f276dU);
+	EXPECT_EQ(out[1], 0x41c83b0eU);
+	EXPECT_EQ(out[2], 0xa20bc7c6U);
+	EXPECT_EQ(out[3], 0x6d5451fdU);
+
+	philox_rng::get_block(pi_counter, pi_key, out);
+	EXPECT_EQ(out[0], 0xd16cfe09U);
+	EXPECT_EQ(out[1], 0x94fdccebU);
+	EXPECT_EQ(out[2], 0x5001e420U);
+	EXPECT_EQ(out[3], 0x24126ea1U);
+}
+
+TEST(Philox, JumpMatchesDrawing) {
+	for (uint64_t skip = 0; skip < 5; ++skip) {
+		philox_rng drawn(1234, 5), jumped(1234, 5);
+
+		for (uint64_t i = 0; i < skip; ++i) {
+			drawn.next_long();
+		}
+		jumped.jump(skip);
+
+		for (int i = 0; i < 4; ++i) {
+			EXPECT_EQ(drawn.next_long(), jumped.next_long());
+		}
+	}
+}
+
+TEST(Philox, SplitIsDeterministicAndDistinct) {
+	philox_rng parent(99), used_parent(99);
+
+	// Splitting doesn't depend on how far along the parent is.
+	used_parent.jump(1000);
+
+	std::vector<uint64_t> first_outputs;
+
+	for (uint64_t id = 0; id < 100; ++id) {
+		philox_rng child = parent.split(id), other = used_parent.split(id);
+		uint64_t first = child.next_long();
+
+		EXPECT_EQ(first, other.next_long());
+		EXPECT_NE(child.get_stream(), parent.get_stream());
+
+		for (uint64_t earlier: first_outputs) {
+			EXPECT_NE(first, earlier);
+		}
+		first_outputs.push_back(first);
+	}
+
+	// Nested splits shouldn't collide with their parents' siblings.
+	EXPECT_NE(parent.split(1).split(0).get_stream(),
+		parent.split(0).get_stream());
+}
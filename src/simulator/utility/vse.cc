@@ -13,20 +13,45 @@ double vse_sim::do_simulation() {
 	// E[chosen] = mean over candidates coming in first.
 	// E[random] = mean over the whole vector.
 
-	election_t election = ballot_gen.generate_ballots(numvoters,
-			numcands, *entropy_source);
-
 	std::vector<double> candidate_scores(numcands, 0);
+	ordering outcome;
+
+	// Methods that only need summaries of the ballots don't need the
+	// ballots themselves, so count the voters' utilities directly
+	// instead. The generator draws the same election either way.
+	if (!required_statistics.empty()) {
+		ballot_gen.generate_utilities(numvoters, numcands,
+			*entropy_source, utilities);
+
+		for (size_t voter = 0; voter < numvoters; ++voter) {
+			for (size_t cand = 0; cand < numcands; ++cand) {
+				candidate_scores[cand] += utilities[voter * numcands +
+						cand];
+			}
+		}
 
-	for (const ballot_group & g: election) {
-		for (const candscore & cs: g.contents) {
-			assert(cs.get_candidate_num() < numcands);
-			candidate_scores[cs.get_candidate_num()] +=
-				g.get_weight() * cs.get_score() / (double)numvoters;
+		for (double & score: candidate_scores) {
+			score /= (double)numvoters;
 		}
-	}
 
-	ordering outcome = method->elect(election, numcands, true);
+		election_statistics statistics(required_statistics, numcands);
+		statistics.add_utilities(utilities, numvoters);
+
+		outcome = method->elect_from_statistics(statistics, true).first;
+	} else {
+		election_t election = ballot_gen.generate_ballots(numvoters,
+				numcands, *entropy_source);
+
+		for (const ballot_group & g: election) {
+			for (const candscore & cs: g.contents) {
+				assert(cs.get_candidate_num() < numcands);
+				candidate_scores[cs.get_candidate_num()] +=
+					g.get_weight() * cs.get_score() / (double)numvoters;
+			}
+		}
+
+		outcome = method->elect(election, numcands, true);
+	}
 
 	std::vector<size_t> winners = ordering_tools::get_winners(outcome);
 
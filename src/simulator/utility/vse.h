@@ -74,6 +74,13 @@ class vse_sim : public simulator {
 
 		std::shared_ptr<election_method> method;
 		gaussian_generator ballot_gen;
+
+		// If the method only needs summaries of the ballots (see
+		// singlewinner/statistics.h), this says which, and we count
+		// them straight from the voters' utilities instead of making
+		// ballots.
+		statistics_request required_statistics;
+		std::vector<double> utilities;
 		double E_opt_rand;
 		double sigma;
 
@@ -107,6 +114,7 @@ class vse_sim : public simulator {
 			numcands = numcands_in;
 			numvoters = numvoters_in;
 			method = method_in;
+			required_statistics = method->get_required_statistics();
 			E_opt_rand = -1;
 
 			set_dispersion(ballot_gen.get_dispersion()[0]);
@@ -67,6 +67,7 @@ class cond_brute_rpn : public election_method {
 			id = funct_code_in;
 			cfunct.set_id(id);
 			cfunct.set_asymptote_generous(generosity);
+			reset_method_id();
 		}
 
 		// The default is to not be generous to asymptotes.
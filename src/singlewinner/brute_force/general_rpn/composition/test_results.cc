@@ -119,6 +119,9 @@ bool test_results::passes_tests(
 	// First determine the location of the first test result for each
 	// algorithm.
 
+	// This is a local so that multiple threads may check tests at once.
+	size_t results_start_position[NUM_REL_ELECTION_TYPES];
+
 	for (int type = 0; type < NUM_REL_ELECTION_TYPES; ++type) {
 		results_start_position[type] = get_linear_idx(method_indices[type],
 				0, (test_election)type);
@@ -170,6 +173,8 @@ bool test_results::passes_tests(
 
 	bool fail = false;
 
+	size_t results_start_position[NUM_REL_ELECTION_TYPES];
+
 	for (int type = 0; type < NUM_REL_ELECTION_TYPES; ++type) {
 		results_start_position[type] = get_linear_idx(method_indices[type],
 				0, (test_election)type);
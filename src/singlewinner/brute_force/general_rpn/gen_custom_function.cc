@@ -1,4 +1,5 @@
 #include "gen_custom_function.h"
+#include <iterator>
 #include <limits>
 
 size_t gen_custom_function::get_num_referential_atoms(
@@ -68,11 +69,11 @@ atom_bundle gen_custom_function::get_atom_bundle(
 	return (out);
 }
 
-// Point of CPU use. Allocating the vectors takes time.
-// TODO: Consider optimization.
+// Splits the algorithm number into atom encodings, without allocating.
+// Returns the number of atoms.
 
-std::vector<atom_bundle> gen_custom_function::decode_algorithm(
-	algo_t algorithm_encoding, size_t numcands) const {
+size_t gen_custom_function::get_atom_encodings(algo_t algorithm_encoding,
+	size_t numcands, algo_t * atom_encodings) const {
 
 	// The decoding is a little more complex than you'd expect, because we
 	// have to allow for the first digit having value 0. To do so, we let
@@ -81,14 +82,14 @@ std::vector<atom_bundle> gen_custom_function::decode_algorithm(
 	// most significant digit first style.
 
 	if (algorithm_encoding == 0) {
-		return (std::vector<atom_bundle>());
+		return (0);
 	}
 
 	// First count how many digits we have.
 
 	size_t radix = get_num_referential_atoms(numcands) + TOTAL_NUM_CONST_ATOMS;
 
-	int digits = 0;
+	size_t digits = 0;
 	algo_t greatest_power = 1, divisor;
 
 	while (algorithm_encoding >= greatest_power * (radix + 1)) {
@@ -96,27 +97,108 @@ std::vector<atom_bundle> gen_custom_function::decode_algorithm(
 		greatest_power *= radix;
 	}
 
-	std::vector<atom_bundle> out;
-	out.reserve(digits); // or is it digits+1? TODO: Check later
+	if (digits >= GCF_MAX_ALGORITHM_LENGTH) {
+		throw std::logic_error("gen_custom_function: algorithm has "
+			"too many atoms!");
+	}
 
 	// Then get the first digit...
 	algo_t digit = algorithm_encoding / greatest_power;
 	algorithm_encoding -= digit * greatest_power;
 	greatest_power /= radix;
 
-	out.push_back(get_atom_bundle(digit-1, numcands));
+	size_t num_atoms = 0;
+	atom_encodings[num_atoms++] = digit-1;
 
 	// and subsequent digits.
 	for (divisor = greatest_power; divisor > 0; divisor /= radix) {
 		digit = algorithm_encoding / divisor;
 		algorithm_encoding -= digit * divisor;
 
-		out.push_back(get_atom_bundle(digit, numcands));
+		atom_encodings[num_atoms++] = digit;
+	}
+
+	return (num_atoms);
+}
+
+std::vector<atom_bundle> gen_custom_function::decode_algorithm(
+	algo_t algorithm_encoding, size_t numcands) const {
+
+	algo_t atom_encodings[GCF_MAX_ALGORITHM_LENGTH];
+	size_t num_atoms = get_atom_encodings(algorithm_encoding, numcands,
+			atom_encodings);
+
+	std::vector<atom_bundle> out;
+	out.reserve(num_atoms);
+
+	for (size_t i = 0; i < num_atoms; ++i) {
+		out.push_back(get_atom_bundle(atom_encodings[i], numcands));
 	}
 
 	return (out);
 }
 
+// Compiles the algorithm into instructions, keeping track of the stack depth
+// as we go. Returns false if the algorithm would run out of stack or leave
+// something other than one value on it, as evaluating such an algorithm
+// would always give NaN.
+
+bool gen_custom_function::compile_algorithm(algo_t algorithm_encoding,
+	std::vector<gcf_instruction> & program) const {
+
+	algo_t atom_encodings[GCF_MAX_ALGORITHM_LENGTH];
+	size_t num_atoms = get_atom_encodings(algorithm_encoding,
+			number_candidates, atom_encodings);
+
+	algo_t num_direct_refs = factorial(number_candidates),
+		   num_refs = get_num_referential_atoms(number_candidates);
+
+	size_t depth = 0;
+	program.clear();
+
+	for (size_t i = 0; i < num_atoms; ++i) {
+		gcf_instruction instruction;
+		instruction.depth = depth;
+		instruction.operand = 0;
+
+		if (atom_encodings[i] < num_direct_refs) {
+			instruction.opcode = GCF_OP_DIRECT_REF;
+			instruction.operand = atom_encodings[i];
+			++depth;
+		} else if (atom_encodings[i] < num_refs) {
+			instruction.opcode = GCF_OP_LINEAR_REF;
+			instruction.operand = atom_encodings[i] - num_direct_refs;
+			++depth;
+		} else {
+			instruction.opcode = atom_encodings[i] - num_refs;
+
+			if (instruction.opcode <= VAL_TWO) {
+				++depth;
+			} else if (instruction.opcode <= UNARY_FUNC_MINKOWSKIQ) {
+				if (depth < 1) {
+					return (false);
+				}
+			} else if (instruction.opcode <= BINARY_FUNC_MAX) {
+				if (depth < 2) {
+					return (false);
+				}
+				--depth;
+			} else if (instruction.opcode == ALL_FUNC_PLUS) {
+				if (depth < 2) {
+					return (false);
+				}
+				depth = 1;
+			} else {
+				throw std::runtime_error("RPN token not matched anywhere!");
+			}
+		}
+
+		program.push_back(instruction);
+	}
+
+	// Don't permit more than one value to remain on the stack.
+	return (depth == 1);
+}
 
 matrix_indices gen_custom_function::get_positional_matrix_indices(
 	size_t numcands) const {
@@ -217,6 +299,38 @@ matrix_indices gen_custom_function::get_pairwise_matrix_indices(
 	return (pair_indices);
 }
 
+// Flatten the positional and pairwise indices so that the evaluator can get
+// at a linear combination by its atom encoding alone.
+
+void gen_custom_function::set_linear_combinations(size_t numcands) {
+	size_t num_direct_refs = factorial(numcands),
+		   num_linear = get_num_referential_atoms(numcands) - num_direct_refs;
+
+	linear_indices.clear();
+	linear_offsets.clear();
+
+	for (size_t i = 0; i < num_linear; ++i) {
+		linear_offsets.push_back(linear_indices.size());
+
+		atom_bundle reference = get_atom_bundle(num_direct_refs + i,
+				numcands);
+
+		const std::vector<int> * indices;
+		if (reference.is_positional_reference) {
+			indices = &positional_matrix_indices[reference.cand][
+						reference.place];
+		} else {
+			indices = &pairwise_matrix_indices[reference.incumbent][
+						reference.challenger];
+		}
+
+		std::copy(indices->begin(), indices->end(),
+			std::back_inserter(linear_indices));
+	}
+
+	linear_offsets.push_back(linear_indices.size());
+}
+
 double gen_custom_function::linear_combination(const std::vector<int> &
 	indices,
 	const std::vector<double> & weights) const {
@@ -274,73 +388,18 @@ double gen_custom_function::evaluate_ref(const atom_bundle & cur_alias,
 // A lot of the code is copied from custom_funct since the functions are the
 // same.
 
-double gen_custom_function::evaluate(std::vector<double> & stack,
-	const atom_bundle & cur_raw_atom,
-	const std::vector<double> & input_values, size_t numcands) const {
-
-	bool generous_to_asymptotes = true;
-
-	// First check for references to ballot data or linear combinations of
-	// such.
-
-	if (cur_raw_atom.is_reference) {
-		return evaluate_ref(cur_raw_atom, input_values, numcands);
-	}
-
-	// Check for functions and constants. Return the appropriate
-	// value if cur_atom is a function or constant.
-
-	gen_custom_funct_atom cur_atom = cur_raw_atom.function;
-
-	// Constants:
-
-	switch (cur_atom) {
-		case VAL_IN_ALL:
-			return std::accumulate(input_values.begin(),
-					input_values.end(), 0.0);
-
-		case VAL_ZERO: return (0);
-		case VAL_ONE: return (1);
-		case VAL_TWO: return (2);
-		default: break;
-	}
-
-	// Unary and multi-value functions require at least one value on the stack.
-	if (stack.empty()) {
-		return (std::numeric_limits<double>::quiet_NaN());
-		//throw runtime_error("stack error");
-	}
-
-	// All-stack functions that empty the whole stack must have at least one
-	// value on the stack, and so go here or below.
-
-	// Functions where applying the function once is a nop will go down by
-	// binary functions. E.g. ALL_FUNC_PLUS is a vector addition operation,
-	// and doing plus with just one element is a no operation.
-
-	// ---
-
-	// Then we have functions with a specified number of parameters, unary
-	// ones first:
+static inline double apply_unary(uint16_t opcode, double right_arg,
+	double blancmange_order) {
 
-	double right_arg = *(stack.rbegin());
-	if (isnan(right_arg)) {
-		return (right_arg);    // NaNs propagate automatically
-	}
-	stack.pop_back();
-
-	switch (cur_atom) {
+	switch (opcode) {
 		case UNARY_FUNC_INFRMAP: return (1/(1 + exp(-right_arg)));
 		case UNARY_FUNC_INFRMAPINV: return (log(-right_arg/(right_arg-1)));
 		case UNARY_FUNC_SQUARE: return (right_arg*right_arg);
 		case UNARY_FUNC_SQRT: return (sqrt(right_arg));
 		case UNARY_FUNC_LOG:
+			// intend limit towards 0 so that 0 log 0 = 0, e.g
 			if (right_arg == 0) {
-				if (generous_to_asymptotes) {
-					// intend limit towards 0 so that 0 log 0 = 0, e.g
-					return (-1e9);
-				}
-				return (-INFINITY);
+				return (-1e9);
 			}
 			return (log(right_arg));
 		case UNARY_FUNC_EXP: return (exp(right_arg));
@@ -348,96 +407,290 @@ double gen_custom_function::evaluate(std::vector<double> & stack,
 		case UNARY_FUNC_BLANCMANGE: return (blancmange(blancmange_order,
 						right_arg));
 		case UNARY_FUNC_MINKOWSKIQ: return (minkowski_q(right_arg));
-		default: break;
+		default:
+			throw std::runtime_error("RPN token not matched anywhere!");
 	}
+}
 
-	// Binary functions require at least two values on the stack.
-	if (stack.empty()) {
-		return (std::numeric_limits<double>::quiet_NaN());
-		//throw runtime_error("stack error");
-	}
+// NOTE: The stack has most recently pushed arguments to the right.
+// This means that if we want, say "fpA fpC -" to resolve to
+// "fpA - fpC", as is intuitive, and as dc does it, we need to do
+// middle_arg - right_arg, not the other way around.
 
-	double middle_arg = *(stack.rbegin());
-	if (isnan(middle_arg)) {
-		return (middle_arg);    // NaN propagate automatically
+static inline double protected_divide(double middle_arg, double right_arg) {
+	if (!isfinite(middle_arg) && isfinite(right_arg) && right_arg != 0) {
+		return (middle_arg);
 	}
-	stack.pop_back();
-
-	// See above for why ALL_FUNC_PLUS is here.
-
-	// Sums up every element on the stack.
-	if (cur_atom == ALL_FUNC_PLUS) {
-		double sum_stack = std::accumulate(stack.begin(), stack.end(), 0.0);
-		stack.clear();
-		return (sum_stack + middle_arg + right_arg);
+	// lim x->inf 3/x = 0
+	if (isfinite(middle_arg) && !isfinite(right_arg)) {
+		return (0);
+	}
+	// Perhaps we should let x/inf = 0? And inf/x = inf,
+	// except when x = 0, in which case it's undefined.
+	// inf/inf is also similarly undefined.
+	if (!isfinite(middle_arg) && !isfinite(right_arg)) {
+		return (std::numeric_limits<double>::quiet_NaN());
+	}
+	if (right_arg == 0) {
+		return (middle_arg/(right_arg+1e-9));
 	}
+	return (middle_arg/right_arg);
+}
 
-	// NOTE: The stack has most recently pushed arguments to the right.
-	// This means that if we want, say "fpA fpC -" to resolve to
-	// "fpA - fpC", as is intuitive, and as dc does it, we need to do
-	// middle_arg - right_arg, not the other way around.
+static inline double apply_binary(uint16_t opcode, double middle_arg,
+	double right_arg) {
 
-	switch (cur_atom) {
+	switch (opcode) {
 		case BINARY_FUNC_PLUS: return (middle_arg + right_arg);
 		case BINARY_FUNC_MINUS: return (middle_arg - right_arg);
 		case BINARY_FUNC_MUL: return (middle_arg * right_arg);
-		case BINARY_FUNC_DIVIDE:
-			if (!isfinite(middle_arg) && isfinite(right_arg) && right_arg != 0) {
-				return (middle_arg);
-			}
-			// lim x->inf 3/x = 0
-			if (isfinite(middle_arg) && !isfinite(right_arg)) {
-				return (0);
-			}
-			// Perhaps we should let x/inf = 0? And inf/x = inf,
-			// except when x = 0, in which case it's undefined.
-			// inf/inf is also similarly undefined.
-			if (!isfinite(middle_arg) && !isfinite(right_arg)) {
-				return (std::numeric_limits<double>::quiet_NaN());
-			}
-			if (right_arg == 0) {
-				if (generous_to_asymptotes) {
-					return (middle_arg/(right_arg+1e-9));
-				}
-				//return(std::numeric_limits<double>::quiet_NaN());
-				return (INFINITY); // could also be -infty
-			}
-			return (middle_arg/right_arg);
+		case BINARY_FUNC_DIVIDE: return (protected_divide(middle_arg,
+						right_arg));
 		case BINARY_FUNC_MAX: return (std::max(middle_arg, right_arg));
 		case BINARY_FUNC_MIN: return (std::min(middle_arg, right_arg));
-		default: break;
+		default:
+			throw std::runtime_error("RPN token not matched anywhere!");
 	}
-
-	// Error, should never happen. This happens if the atom is not caught
-	// anywhere, which means I forgot to implement the code after adding
-	// one.
-	throw std::runtime_error("RPN token not matched anywhere!");
 }
 
+// The program has been checked by compile_algorithm, so every instruction
+// finds the values it needs at the depth it was compiled with. The result of
+// an instruction goes into the lowest stack slot it reads from, or on top if
+// it's a reference or constant.
+
+// Once a NaN turns up, the result is NaN no matter what comes later. Rather
+// than stop right away, we just remember that we saw one.
+
 double gen_custom_function::evaluate(
-	const std::vector<atom_bundle> & algorithm,
-	const std::vector<double> & input_values, size_t numcands) const {
+	const std::vector<gcf_instruction> & program,
+	const std::vector<double> & input_values) const {
+
+	double stack[GCF_MAX_ALGORITHM_LENGTH];
+	bool saw_nan = false;
+
+	for (const gcf_instruction & instruction: program) {
+		size_t slot = instruction.depth;
+		double result = 0;
+
+		switch (instruction.opcode) {
+			case GCF_OP_DIRECT_REF:
+				result = input_values[instruction.operand];
+				break;
+			case GCF_OP_LINEAR_REF:
+				for (size_t i = linear_offsets[instruction.operand];
+					i < linear_offsets[instruction.operand+1]; ++i) {
+					result += input_values[linear_indices[i]];
+				}
+				break;
+			case VAL_IN_ALL:
+				result = std::accumulate(input_values.begin(),
+						input_values.end(), 0.0);
+				break;
+			case VAL_ZERO: result = 0; break;
+			case VAL_ONE: result = 1; break;
+			case VAL_TWO: result = 2; break;
+			case ALL_FUNC_PLUS:
+				// Sums up every element on the stack.
+				for (slot = 0; slot < instruction.depth; ++slot) {
+					result += stack[slot];
+				}
+				slot = 0;
+				break;
+			default:
+				if (instruction.opcode <= UNARY_FUNC_MINKOWSKIQ) {
+					slot = instruction.depth-1;
+					result = apply_unary(instruction.opcode, stack[slot],
+							blancmange_order);
+				} else {
+					slot = instruction.depth-2;
+					result = apply_binary(instruction.opcode, stack[slot],
+							stack[slot+1]);
+				}
+				break;
+		}
 
-	algorithm_stack.clear();
+		stack[slot] = result;
+		saw_nan |= isnan(result);
+	}
 
-	for (const atom_bundle & atom: algorithm) {
-		double output = evaluate(algorithm_stack, atom, input_values,
-				numcands);
+	if (saw_nan || program.empty()) {
+		return (std::numeric_limits<double>::quiet_NaN());
+	}
+
+	return (stack[0]);
+}
+
+gcf_batch_input::gcf_batch_input(const std::vector<std::vector<double> > &
+	input_vectors) {
+
+	num_vectors = input_vectors.size();
+	input_size = 0;
+	if (num_vectors > 0) {
+		input_size = input_vectors[0].size();
+	}
+
+	// Pad the last block with zero vectors.
+	values.resize(num_blocks() * input_size * GCF_LANES, 0);
+	totals.resize(num_blocks() * GCF_LANES, 0);
 
-		if (isnan(output)) {
-			return (output);
+	for (size_t i = 0; i < num_vectors; ++i) {
+		if (input_vectors[i].size() != input_size) {
+			throw std::invalid_argument("gcf_batch_input: input vectors "
+				"must all have the same size");
 		}
 
-		algorithm_stack.push_back(output);
+		size_t block = i / GCF_LANES, lane = i % GCF_LANES;
+
+		for (size_t index = 0; index < input_size; ++index) {
+			values[(block * input_size + index) * GCF_LANES + lane] =
+				input_vectors[i][index];
+		}
+
+		totals[i] = std::accumulate(input_vectors[i].begin(),
+				input_vectors[i].end(), 0.0);
 	}
+}
 
-	// Don't permit more than one value to remain on the stack.
-	if (algorithm_stack.size() != 1) {
-		return (std::numeric_limits<double>::quiet_NaN());
+// Evaluates the program on a block of GCF_LANES input vectors. This is the
+// same as evaluate() above, except that each stack slot holds a value per
+// lane, so that every instruction is a loop the compiler can vectorize.
+
+void gen_custom_function::evaluate_lanes(
+	const std::vector<gcf_instruction> & program,
+	const double * block, const double * totals, double * results) const {
+
+	double stack[GCF_MAX_ALGORITHM_LENGTH][GCF_LANES];
+	bool saw_nan[GCF_LANES];
+	size_t lane;
+
+	std::fill(saw_nan, saw_nan + GCF_LANES, false);
+
+	for (const gcf_instruction & instruction: program) {
+		size_t slot = instruction.depth;
+		double * out = stack[slot];
+
+		switch (instruction.opcode) {
+			case GCF_OP_DIRECT_REF:
+				std::copy(block + instruction.operand * GCF_LANES,
+					block + (instruction.operand+1) * GCF_LANES, out);
+				break;
+			case GCF_OP_LINEAR_REF:
+				std::fill(out, out + GCF_LANES, 0);
+				for (size_t i = linear_offsets[instruction.operand];
+					i < linear_offsets[instruction.operand+1]; ++i) {
+					const double * values = block +
+						linear_indices[i] * GCF_LANES;
+					#pragma omp simd
+					for (lane = 0; lane < GCF_LANES; ++lane) {
+						out[lane] += values[lane];
+					}
+				}
+				break;
+			case VAL_IN_ALL:
+				std::copy(totals, totals + GCF_LANES, out);
+				break;
+			case VAL_ZERO: std::fill(out, out + GCF_LANES, 0); break;
+			case VAL_ONE: std::fill(out, out + GCF_LANES, 1); break;
+			case VAL_TWO: std::fill(out, out + GCF_LANES, 2); break;
+			case ALL_FUNC_PLUS: {
+				// Sum in the same order as evaluate() so that the
+				// results are the same to the last bit.
+				double sum[GCF_LANES];
+				std::fill(sum, sum + GCF_LANES, 0);
+				for (slot = 0; slot < instruction.depth; ++slot) {
+					#pragma omp simd
+					for (lane = 0; lane < GCF_LANES; ++lane) {
+						sum[lane] += stack[slot][lane];
+					}
+				}
+				out = stack[0];
+				std::copy(sum, sum + GCF_LANES, out);
+				break;
+			}
+			case BINARY_FUNC_PLUS:
+				out = stack[slot-2];
+				#pragma omp simd
+				for (lane = 0; lane < GCF_LANES; ++lane) {
+					out[lane] += stack[slot-1][lane];
+				}
+				break;
+			case BINARY_FUNC_MINUS:
+				out = stack[slot-2];
+				#pragma omp simd
+				for (lane = 0; lane < GCF_LANES; ++lane) {
+					out[lane] -= stack[slot-1][lane];
+				}
+				break;
+			case BINARY_FUNC_MUL:
+				out = stack[slot-2];
+				#pragma omp simd
+				for (lane = 0; lane < GCF_LANES; ++lane) {
+					out[lane] *= stack[slot-1][lane];
+				}
+				break;
+			case UNARY_FUNC_NEG:
+				out = stack[slot-1];
+				#pragma omp simd
+				for (lane = 0; lane < GCF_LANES; ++lane) {
+					out[lane] = -out[lane];
+				}
+				break;
+			case UNARY_FUNC_SQUARE:
+				out = stack[slot-1];
+				#pragma omp simd
+				for (lane = 0; lane < GCF_LANES; ++lane) {
+					out[lane] *= out[lane];
+				}
+				break;
+			default:
+				if (instruction.opcode <= UNARY_FUNC_MINKOWSKIQ) {
+					out = stack[slot-1];
+					for (lane = 0; lane < GCF_LANES; ++lane) {
+						out[lane] = apply_unary(instruction.opcode,
+								out[lane], blancmange_order);
+					}
+				} else {
+					out = stack[slot-2];
+					for (lane = 0; lane < GCF_LANES; ++lane) {
+						out[lane] = apply_binary(instruction.opcode,
+								out[lane], stack[slot-1][lane]);
+					}
+				}
+				break;
+		}
+
+		for (lane = 0; lane < GCF_LANES; ++lane) {
+			saw_nan[lane] |= isnan(out[lane]);
+		}
 	}
 
-	// Otherwise, return the one value.
-	return (*algorithm_stack.begin());
+	for (lane = 0; lane < GCF_LANES; ++lane) {
+		if (saw_nan[lane] || program.empty()) {
+			results[lane] = std::numeric_limits<double>::quiet_NaN();
+		} else {
+			results[lane] = stack[0][lane];
+		}
+	}
+}
+
+void gen_custom_function::evaluate_batch(const gcf_batch_input &
+	input_values, std::vector<double> & results) const {
+
+	// Room for the padding lanes of the last block.
+	results.resize(input_values.num_blocks() * GCF_LANES);
+
+	if (!current_algorithm_valid) {
+		std::fill(results.begin(), results.end(),
+			std::numeric_limits<double>::quiet_NaN());
+	} else {
+		for (size_t block = 0; block < input_values.num_blocks(); ++block) {
+			evaluate_lanes(current_algorithm, input_values.get_block(block),
+				input_values.get_totals(block),
+				results.data() + block * GCF_LANES);
+		}
+	}
+
+	results.resize(input_values.size());
 }
 
 std::string gen_custom_function::get_atom_name(
@@ -493,7 +746,8 @@ std::string gen_custom_function::to_string() const {
 
 	std::string out = "";
 
-	for (const atom_bundle & atom: current_algorithm) {
+	for (const atom_bundle & atom: decode_algorithm(current_algorithm_num,
+			number_candidates)) {
 		if (!is_first) {
 			out = out + " ";
 		}
@@ -509,11 +763,8 @@ std::string gen_custom_function::to_string() const {
 // the evaluator. Note that it returns true if such an algorithm has been
 // force set in the past and the call tries to set the same algorithm.
 
-// XXX: This is a point of optimization. The initial evaluation takes
-// a considerable amount of time when sifting for interesting algorithms.
-// We could perhaps make the decoder keep track of the arity of the
-// functions it encounters and return false if the stack will be empty
-// too soon or have more than one value on it once the evaluation is done.
+// Most algorithm numbers are rejected by the stack depth check when
+// compiling, so we only need to evaluate the ones that pass it.
 bool gen_custom_function::set_algorithm(algo_t algorithm_encoding) {
 
 	// If it's the same one that we already have, do nothing.
@@ -521,22 +772,20 @@ bool gen_custom_function::set_algorithm(algo_t algorithm_encoding) {
 		return true;
 	}
 
-	std::vector<atom_bundle> proposed_algorithm = decode_algorithm(
-			algorithm_encoding, number_candidates);
+	if (!compile_algorithm(algorithm_encoding, proposed_algorithm)) {
+		return (false);
+	}
 
 	// Now test this with a standard array (all zeroes) to see if we get a
 	// NaN.
 
-	std::vector<double> fake_input(factorial(number_candidates), 0);
-	double result = evaluate(proposed_algorithm, fake_input,
-			number_candidates);
-
-	if (isnan(result)) {
+	if (isnan(evaluate(proposed_algorithm, zero_input))) {
 		return (false);
 	}
 
-	current_algorithm = proposed_algorithm;
+	std::swap(current_algorithm, proposed_algorithm);
 	current_algorithm_num = algorithm_encoding;
+	current_algorithm_valid = true;
 	return (true);
 }
 
@@ -545,8 +794,8 @@ void gen_custom_function::force_set_algorithm(algo_t algorithm_encoding) {
 		return;
 	}
 
-	current_algorithm = decode_algorithm(algorithm_encoding,
-			number_candidates);
+	current_algorithm_valid = compile_algorithm(algorithm_encoding,
+			current_algorithm);
 	current_algorithm_num = algorithm_encoding;
 }
 
@@ -32,14 +32,25 @@
 // evaluation logic inside each atom. But again, eh. I'll do it if it's
 // necessary.
 
+// Since the sifter and compositor evaluate billions of algorithms, the
+// algorithm isn't interpreted atom by atom. Instead, setting an algorithm
+// compiles it into fixed-width instructions (see gcf_instruction below),
+// checking the stack depth as it goes, so that algorithms that would
+// underflow the stack or leave more than one value on it are rejected
+// without evaluating anything. Evaluation then runs the instructions on a
+// fixed-size stack with no allocation, and evaluate_batch() runs them on
+// several input vectors at once, one per SIMD lane.
+
 #include <math.h>
 #include <assert.h>
+#include <stdint.h>
 
 #include <string>
 #include <vector>
 #include <numeric>
 #include <algorithm>
 #include <stdexcept>
+#include <limits>
 
 #include "../rpn/chaotic_functions.h"
 #include "tools/tools.h"
@@ -95,7 +106,67 @@ struct atom_bundle {
 	gen_custom_funct_atom function;
 };
 
+// A compiled atom. The opcode is either a gen_custom_funct_atom or one of the
+// reference opcodes below. Since the stack depth before every instruction is
+// known at compile time, each instruction carries it, so the evaluator needs
+// no stack pointer and never checks for underflow.
+
+const uint16_t GCF_OP_DIRECT_REF = TOTAL_NUM_CONST_ATOMS;	// input[operand]
+const uint16_t GCF_OP_LINEAR_REF = TOTAL_NUM_CONST_ATOMS + 1; // positional
+															// or pairwise
+
+struct gcf_instruction {
+	uint16_t opcode;
+	uint16_t depth;
+	// The input index for direct references, the linear combination
+	// index for positional and pairwise references.
+	uint32_t operand;
+};
+
+// The longest algorithm that fits in an algo_t has fewer atoms than this,
+// since the radix is always greater than 16.
+const size_t GCF_MAX_ALGORITHM_LENGTH = 17;
+
+// The number of input vectors evaluate_batch handles at once. Eight
+// doubles fill an AVX-512 register.
+const size_t GCF_LANES = 8;
+
 typedef std::vector<std::vector<std::vector<int> > > matrix_indices;
+
+// Input vectors laid out for evaluate_batch: in blocks of GCF_LANES
+// vectors, with each block storing every input value lane by lane so that
+// loading a reference for all the lanes is a contiguous read. The sifter
+// evaluates millions of algorithms on the same test vectors, so this is
+// worth setting up once.
+
+class gcf_batch_input {
+	private:
+		size_t num_vectors, input_size;
+		// values[(block * input_size + index) * GCF_LANES + lane]
+		std::vector<double> values;
+		// The sum of each vector's values, for VAL_IN_ALL.
+		std::vector<double> totals;
+
+	public:
+		gcf_batch_input(const std::vector<std::vector<double> > &
+			input_vectors);
+
+		size_t size() const {
+			return num_vectors;
+		}
+
+		size_t num_blocks() const {
+			return (num_vectors + GCF_LANES - 1) / GCF_LANES;
+		}
+
+		const double * get_block(size_t block) const {
+			return &values[block * input_size * GCF_LANES];
+		}
+
+		const double * get_totals(size_t block) const {
+			return &totals[block * GCF_LANES];
+		}
+};
 typedef unsigned long long algo_t;
 
 class gen_custom_function {
@@ -103,26 +174,41 @@ class gen_custom_function {
 		matrix_indices positional_matrix_indices;
 		matrix_indices pairwise_matrix_indices;
 
-		std::vector<atom_bundle> current_algorithm;
+		// The positional and pairwise linear combinations, flattened in
+		// atom encoding order: combination k sums the inputs given by
+		// linear_indices[linear_offsets[k]...linear_offsets[k+1]-1].
+		std::vector<uint32_t> linear_indices;
+		std::vector<size_t> linear_offsets;
+
+		std::vector<gcf_instruction> current_algorithm,
+			proposed_algorithm;
 		algo_t current_algorithm_num; // For caching purposes
-		mutable std::vector<double> algorithm_stack;
+		bool current_algorithm_valid;
 
 		size_t number_candidates;
+		std::vector<double> zero_input;
 
 		const double blancmange_order = 0.67;
 
 		size_t get_num_referential_atoms(size_t numcands) const;
 
 		atom_bundle get_atom_bundle(algo_t atom_encoding, size_t numcands) const;
+		size_t get_atom_encodings(algo_t algorithm_encoding,
+			size_t numcands, algo_t * atom_encodings) const;
 		std::vector<atom_bundle> decode_algorithm(algo_t
 			algorithm_encoding, size_t numcands) const;
 
+		bool compile_algorithm(algo_t algorithm_encoding,
+			std::vector<gcf_instruction> & program) const;
+
 		bool does_a_beat_b(int a, int b, const std::vector<int> &
 			ballot_permutation) const;
 
 		matrix_indices get_positional_matrix_indices(size_t numcands) const;
 		matrix_indices get_pairwise_matrix_indices(size_t numcands) const;
 
+		void set_linear_combinations(size_t numcands);
+
 		double linear_combination(const std::vector<int> & indices,
 			const std::vector<double> & weights) const;
 
@@ -130,20 +216,35 @@ class gen_custom_function {
 			const std::vector<double> & input_values,
 			size_t numcands) const;
 
-		double evaluate(std::vector<double> & stack,
-			const atom_bundle & cur_atom,
-			const std::vector<double> & input_values, size_t numcands) const;
+		double evaluate(const std::vector<gcf_instruction> & program,
+			const std::vector<double> & input_values) const;
 
-		double evaluate(const std::vector<atom_bundle> & algorithm,
-			const std::vector<double> & input_values, size_t numcands) const;
+		void evaluate_lanes(const std::vector<gcf_instruction> & program,
+			const double * block, const double * totals,
+			double * results) const;
 
 		std::string get_atom_name(const atom_bundle & cur_atom,
 			size_t numcands) const;
 
 	public:
+		// Returns NaN if the algorithm is invalid or if the evaluation
+		// produces a NaN anywhere along the way.
 		double evaluate(const std::vector<double> & input_values) const {
-			return evaluate(current_algorithm, input_values,
-					number_candidates);
+			if (!current_algorithm_valid) {
+				return (std::numeric_limits<double>::quiet_NaN());
+			}
+			return evaluate(current_algorithm, input_values);
+		}
+
+		// Evaluates the algorithm on every input vector. The results
+		// are the same as calling evaluate() on each in turn.
+		void evaluate_batch(const gcf_batch_input & input_values,
+			std::vector<double> & results) const;
+
+		void evaluate_batch(
+			const std::vector<std::vector<double> > & input_values,
+			std::vector<double> & results) const {
+			evaluate_batch(gcf_batch_input(input_values), results);
 		}
 
 		std::string to_string() const;
@@ -156,6 +257,12 @@ class gen_custom_function {
 					number_candidates);
 			pairwise_matrix_indices = get_pairwise_matrix_indices(
 					number_candidates);
+			set_linear_combinations(number_candidates);
+			zero_input.assign(factorial(number_candidates), 0);
+
+			// The references have changed, so recompile.
+			current_algorithm_valid = compile_algorithm(
+					current_algorithm_num, current_algorithm);
 		}
 
 		size_t get_num_candidates() const {
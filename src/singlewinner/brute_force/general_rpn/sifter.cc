@@ -9,14 +9,45 @@
 // of the results, i.e. which test returned max score, which returned next to
 // max and so on, to the orders we've already seen).
 
+// There are three ways to run it:
+
+// qe_sifter [file containing past output]
+//		Goes through every algorithm number in order on a single thread,
+//		printing each new algorithm, and resuming from the highest
+//		algorithm number in the past output.
+
+// qe_sifter sift [numcands] [run directory] [first] [last] [threads]
+//		Splits the algorithm numbers from first (inclusive) to last
+//		(exclusive) into shards of SHARD_SIZE numbers, aligned to
+//		multiples of SHARD_SIZE, and sifts the shards in parallel. Each
+//		shard keeps its own table of the first algorithm seen for each
+//		result hash and writes it, sorted by hash, as a run file in the
+//		run directory. Shards whose run files already exist are skipped,
+//		so a crashed or stopped sift is resumed by running the same
+//		command again. Several processes (or machines sharing the
+//		directory) can work on disjoint ranges at once.
+
+// qe_sifter merge [run files...]
+//		Does a k-way merge of the run files, keeping the lowest
+//		algorithm number for each result hash, and prints these
+//		representatives in algorithm number order, like the first mode
+//		would have.
+
 #include <map>
+#include <queue>
 #include <unordered_map>		// Test performance? Needs hash
 #include "gen_custom_function.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <fstream>
 
 #include "spookyhash/SpookyV2.h"
+#include "tools/tools.h"
+
+#include <memory>
+#include <omp.h>
 #include "hack/msvc_random.h"
 
 // Will clean up and put into class later.
@@ -60,7 +91,7 @@ std::vector<std::vector<double> > get_identity_vectors(int numcands,
 
 std::vector<double> evaluate_algorithm(gen_custom_function & gcf,
 	//algo_t algorithm_number,
-	const std::vector<std::vector<double> > & test_vectors) {
+	const gcf_batch_input & test_vectors) {
 
 	// If it's not a well-formed algorithm, then abort immediately.
 	/*if (!gcf.set_algorithm(algorithm_number)) {
@@ -69,9 +100,7 @@ std::vector<double> evaluate_algorithm(gen_custom_function & gcf,
 
 	// Otherwise, evaluate on all the test vectors.
 	std::vector<double> output;
-	for (const std::vector<double> & test_vector : test_vectors) {
-		output.push_back(gcf.evaluate(test_vector));
-	}
+	gcf.evaluate_batch(test_vectors, output);
 
 	return output;
 }
@@ -158,11 +187,29 @@ hash_result get_ordinal_hash_test_result(const std::vector<double> &
 // of the other - and then compare the ordinal test results for both
 // (adjusting epsilon as necessary).
 
+// The cardinal tests are random vectors; the ordinal tests are random vectors
+// plus the (scaled) identity vectors. drand48 is never seeded, so every
+// process gets the same tests as long as they're drawn in the same order;
+// this is what lets shards sifted by different processes be merged.
+
+void get_sifter_test_vectors(int numcands,
+	std::vector<std::vector<double> > & cardinal_tests,
+	std::vector<std::vector<double> > & ordinal_tests) {
+
+	cardinal_tests = get_test_vectors(8, numcands);
+	ordinal_tests = get_test_vectors(48, numcands);
+
+	std::vector<std::vector<double> > basis = get_identity_vectors(numcands,
+			true);
+
+	std::copy(basis.begin(), basis.end(), std::back_inserter(ordinal_tests));
+}
+
 std::string algo_str(int numcands, algo_t algorithm) {
 	return gen_custom_function(numcands, algorithm).to_string();
 }
 
-int main(int argc, const char ** argv)  {
+int resume_sift(int argc, const char ** argv) {
 	SpookyHash hasher;
 	hasher.Init(0, 0);
 
@@ -170,12 +217,6 @@ int main(int argc, const char ** argv)  {
 
 	// Open some files to get back up to speed
 
-	if (argc < 2) {
-		std::cerr << "Usage: " << argv[0] << " [file containing past output]"
-			<< std::endl;
-		return (-1);
-	}
-
 	std::string filename = argv[1];
 	std::ifstream past_file(filename);
 
@@ -192,16 +233,12 @@ int main(int argc, const char ** argv)  {
 
 	gen_custom_function x(numcands);
 
-	std::vector<std::vector<double> > cardinal_tests = get_test_vectors(8,
-			numcands);
+	std::vector<std::vector<double> > cardinal_tests, ordinal_tests;
+	get_sifter_test_vectors(numcands, cardinal_tests, ordinal_tests);
 
-	std::vector<std::vector<double> > ordinal_tests = get_test_vectors(48,
-			numcands);
-
-	std::vector<std::vector<double> > basis = get_identity_vectors(numcands,
-			true);
-
-	std::copy(basis.begin(), basis.end(), std::back_inserter(ordinal_tests));
+	// Lay the test vectors out for batch evaluation once and for all.
+	gcf_batch_input cardinal_batch(cardinal_tests),
+					ordinal_batch(ordinal_tests);
 
 	std::map<std::vector<double>, algo_t> cardinal_seen_before;
 	std::unordered_map<std::pair<uint64_t, uint64_t>, algo_t>
@@ -225,7 +262,7 @@ int main(int argc, const char ** argv)  {
 
 		std::pair<uint64_t, uint64_t> ordinal_results_hash =
 			get_ordinal_hash_test_result(
-				evaluate_algorithm(x, ordinal_tests), hasher);
+				evaluate_algorithm(x, ordinal_batch), hasher);
 
 		ordinal_seen_before[ordinal_results_hash] = algorithm;
 
@@ -246,7 +283,7 @@ int main(int argc, const char ** argv)  {
 		}
 
 		std::vector<double> cardinal_results = evaluate_algorithm(x,
-				cardinal_tests);
+				cardinal_batch);
 
 		if (cardinal_seen_before.find(cardinal_results) !=
 			cardinal_seen_before.end()) {
@@ -256,7 +293,7 @@ int main(int argc, const char ** argv)  {
 
 		std::pair<uint64_t, uint64_t> ordinal_results_hash =
 			get_ordinal_hash_test_result(
-				evaluate_algorithm(x, ordinal_tests), hasher);
+				evaluate_algorithm(x, ordinal_batch), hasher);
 
 		if (ordinal_seen_before.find(ordinal_results_hash) !=
 			ordinal_seen_before.end()) {
@@ -266,4 +303,349 @@ int main(int argc, const char ** argv)  {
 		std::cout << i << "\t" << x.to_string() << std::endl;
 		ordinal_seen_before[ordinal_results_hash] = i;
 	}
-}
\ No newline at end of file
+}
+
+// The sharded sifter splits the algorithm numbers into shards that can be
+// sifted independently, each into its own run file. SHARD_SIZE is the
+// number of algorithms per shard. It's large enough that the per-shard
+// overhead (writing the run file) doesn't matter, and small enough that not
+// much work is lost if we crash.
+const algo_t SHARD_SIZE = 1 << 22;
+
+// Run files start with this, then the number of candidates and the number
+// of records, then the records themselves, sorted by hash.
+const char RUN_MAGIC[8] = {'Q', 'E', 'S', 'I', 'F', 'T', '0', '1'};
+
+struct sift_record {
+	hash_result hash;
+	algo_t algorithm;
+
+	bool operator<(const sift_record & other) const {
+		if (hash != other.hash) {
+			return hash < other.hash;
+		}
+		return algorithm < other.algorithm;
+	}
+};
+
+std::string get_run_filename(const std::string & run_dir, int numcands,
+	algo_t first, algo_t last) {
+
+	return run_dir + "/" + itos(numcands) + "_" + std::to_string(first) +
+		"_" + std::to_string(last) + ".run";
+}
+
+bool file_exists(const std::string & filename) {
+	std::ifstream test(filename);
+	return (bool)test;
+}
+
+// Writes to a temporary file and then renames it, so that a run file either
+// exists in full or not at all.
+
+void write_run(const std::string & filename, int numcands,
+	const std::vector<sift_record> & records) {
+
+	std::string temp_filename = filename + ".tmp";
+	std::ofstream out(temp_filename, std::ios::binary);
+
+	uint64_t header[2] = {(uint64_t)numcands, records.size()};
+
+	out.write(RUN_MAGIC, sizeof(RUN_MAGIC));
+	out.write((const char *)header, sizeof(header));
+	out.write((const char *)records.data(),
+		records.size() * sizeof(sift_record));
+	out.close();
+
+	if (!out) {
+		throw std::runtime_error("Could not write " + temp_filename);
+	}
+
+	if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+		throw std::runtime_error("Could not rename " + temp_filename);
+	}
+}
+
+// Sifts algorithm numbers from first to last, returning the first algorithm
+// for each ordinal result hash, sorted by hash. The old cardinal check
+// never rejected anything (nothing was ever added to its table), so it's
+// left out here.
+
+std::vector<sift_record> sift_shard(int numcands, algo_t first,
+	algo_t last, const gcf_batch_input & ordinal_batch) {
+
+	gen_custom_function gcf(numcands);
+	SpookyHash hasher;
+	std::unordered_map<hash_result, algo_t> seen_before;
+
+	for (algo_t algorithm = first; algorithm < last; ++algorithm) {
+		if (!gcf.set_algorithm(algorithm)) {
+			continue;
+		}
+
+		hash_result ordinal_results_hash = get_ordinal_hash_test_result(
+				evaluate_algorithm(gcf, ordinal_batch), hasher);
+
+		// Since we go in increasing order, the first algorithm stays.
+		seen_before.insert(std::pair<hash_result, algo_t>(
+				ordinal_results_hash, algorithm));
+	}
+
+	std::vector<sift_record> records;
+	records.reserve(seen_before.size());
+
+	for (const auto & entry: seen_before) {
+		sift_record record;
+		record.hash = entry.first;
+		record.algorithm = entry.second;
+		records.push_back(record);
+	}
+
+	std::sort(records.begin(), records.end());
+
+	return records;
+}
+
+int sharded_sift(int argc, const char ** argv) {
+	if (argc < 6) {
+		std::cerr << "Usage: " << argv[0] << " sift [numcands] "
+			<< "[run directory] [first] [last] [threads]" << std::endl;
+		return (-1);
+	}
+
+	int numcands = atoi(argv[2]);
+	std::string run_dir = argv[3];
+	algo_t first = strtoull(argv[4], NULL, 10),
+		   last = strtoull(argv[5], NULL, 10);
+	int num_threads = 0;
+
+	if (argc > 6) {
+		num_threads = atoi(argv[6]);
+	}
+
+	if (numcands < 1 || first >= last || num_threads < 0) {
+		std::cerr << "Invalid parameters." << std::endl;
+		return (-1);
+	}
+
+	if (num_threads > 0) {
+		omp_set_num_threads(num_threads);
+	}
+
+	std::vector<std::vector<double> > cardinal_tests, ordinal_tests;
+	get_sifter_test_vectors(numcands, cardinal_tests, ordinal_tests);
+
+	gcf_batch_input ordinal_batch(ordinal_tests);
+
+	// Set up the shards, skipping those that are already done.
+
+	std::vector<std::pair<algo_t, algo_t> > shards;
+	size_t num_done = 0;
+
+	for (algo_t shard_first = first; shard_first < last;) {
+		algo_t shard_last = std::min(last,
+				(shard_first / SHARD_SIZE + 1) * SHARD_SIZE);
+
+		if (file_exists(get_run_filename(run_dir, numcands,
+					shard_first, shard_last))) {
+			++num_done;
+		} else {
+			shards.push_back(std::pair<algo_t, algo_t>(shard_first,
+					shard_last));
+		}
+
+		shard_first = shard_last;
+	}
+
+	std::cerr << "Skipping " << num_done << " finished shards, sifting "
+		<< shards.size() << "." << std::endl;
+
+	bool failed = false;
+	std::string failure;
+
+	#pragma omp parallel for schedule(dynamic)
+	for (size_t i = 0; i < shards.size(); ++i) {
+		try {
+			std::vector<sift_record> records = sift_shard(numcands,
+					shards[i].first, shards[i].second, ordinal_batch);
+
+			write_run(get_run_filename(run_dir, numcands, shards[i].first,
+					shards[i].second), numcands, records);
+
+			#pragma omp critical
+			{
+				std::cerr << "Shard " << shards[i].first << " - "
+					<< shards[i].second << ": " << records.size()
+					<< " distinct." << std::endl;
+			}
+		} catch (std::exception & e) {
+			#pragma omp critical
+			{
+				if (!failed) {
+					failure = e.what();
+				}
+				failed = true;
+			}
+		}
+	}
+
+	if (failed) {
+		std::cerr << "Error: " << failure << std::endl;
+		return (-1);
+	}
+
+	return (0);
+}
+
+// The run files are then merged into the final list. A run_reader reads
+// one run file a record at a time, so that the merge doesn't need to hold
+// every run in memory.
+
+class run_reader {
+	private:
+		std::ifstream source;
+		uint64_t records_left;
+		sift_record current;
+		bool has_current;
+
+	public:
+		int numcands;
+
+		run_reader(const std::string & filename) :
+			source(filename, std::ios::binary) {
+
+			char magic[sizeof(RUN_MAGIC)];
+			uint64_t header[2];
+
+			source.read(magic, sizeof(magic));
+			source.read((char *)header, sizeof(header));
+
+			if (!source || memcmp(magic, RUN_MAGIC, sizeof(magic)) != 0) {
+				throw std::runtime_error(filename + " is not a run file");
+			}
+
+			numcands = header[0];
+			records_left = header[1];
+			next();
+		}
+
+		bool done() const {
+			return !has_current;
+		}
+
+		const sift_record & get() const {
+			return current;
+		}
+
+		void next() {
+			has_current = records_left > 0;
+
+			if (!has_current) {
+				return;
+			}
+
+			source.read((char *)&current, sizeof(current));
+			if (!source) {
+				throw std::runtime_error("Run file is truncated");
+			}
+			--records_left;
+		}
+};
+
+int merge_runs(int argc, const char ** argv) {
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] << " merge [run files...]"
+			<< std::endl;
+		return (-1);
+	}
+
+	std::vector<std::unique_ptr<run_reader> > runs;
+	int numcands = -1;
+
+	for (int i = 2; i < argc; ++i) {
+		runs.push_back(std::unique_ptr<run_reader>(new run_reader(argv[i])));
+
+		if (numcands != -1 && runs.back()->numcands != numcands) {
+			std::cerr << "Run files have different numbers of candidates!"
+				<< std::endl;
+			return (-1);
+		}
+		numcands = runs.back()->numcands;
+	}
+
+	// The queue holds the current record of every run that isn't done,
+	// smallest first.
+
+	typedef std::pair<sift_record, size_t> queue_entry;
+	auto greater = [](const queue_entry & a, const queue_entry & b) {
+		return b.first < a.first;
+	};
+	std::priority_queue<queue_entry, std::vector<queue_entry>,
+		decltype(greater)> queue(greater);
+
+	for (size_t i = 0; i < runs.size(); ++i) {
+		if (!runs[i]->done()) {
+			queue.push(queue_entry(runs[i]->get(), i));
+		}
+	}
+
+	// Records are sorted by hash, then by algorithm, so the first record
+	// with a given hash has the lowest algorithm number.
+
+	std::vector<algo_t> representatives;
+	bool has_last_hash = false;
+	hash_result last_hash;
+
+	while (!queue.empty()) {
+		queue_entry entry = queue.top();
+		queue.pop();
+
+		if (!has_last_hash || entry.first.hash != last_hash) {
+			representatives.push_back(entry.first.algorithm);
+			last_hash = entry.first.hash;
+			has_last_hash = true;
+		}
+
+		runs[entry.second]->next();
+		if (!runs[entry.second]->done()) {
+			queue.push(queue_entry(runs[entry.second]->get(),
+					entry.second));
+		}
+	}
+
+	std::sort(representatives.begin(), representatives.end());
+
+	gen_custom_function gcf(numcands);
+
+	for (algo_t algorithm: representatives) {
+		gcf.force_set_algorithm(algorithm);
+		std::cout << algorithm << "\t" << gcf.to_string() << "\n";
+	}
+
+	std::cout << std::flush;
+
+	return (0);
+}
+
+
+int main(int argc, const char ** argv)  {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " [file containing past output]"
+			<< std::endl;
+		std::cerr << "       " << argv[0] << " sift [numcands] "
+			<< "[run directory] [first] [last] [threads]" << std::endl;
+		std::cerr << "       " << argv[0] << " merge [run files...]"
+			<< std::endl;
+		return (-1);
+	}
+
+	if (strcmp(argv[1], "sift") == 0) {
+		return sharded_sift(argc, argv);
+	}
+
+	if (strcmp(argv[1], "merge") == 0) {
+		return merge_runs(argc, argv);
+	}
+
+	return resume_sift(argc, argv);
+}
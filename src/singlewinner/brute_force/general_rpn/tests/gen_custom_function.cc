@@ -0,0 +1,106 @@
+// Tests for the compiled gen_custom_function evaluator.
+
+#include <gtest/gtest.h>
+
+#include "random/random.h"
+#include "singlewinner/brute_force/general_rpn/gen_custom_function.h"
+
+// Encodes a list of atoms the way gen_custom_function decodes them: most
+// significant digit first, with the first digit offset by one.
+static algo_t encode_algorithm(const std::vector<algo_t> & atoms,
+	size_t numcands) {
+
+	algo_t radix = factorial(numcands) + numcands * numcands +
+		numcands * (numcands-1) + TOTAL_NUM_CONST_ATOMS;
+
+	algo_t encoding = atoms[0] + 1;
+	for (size_t i = 1; i < atoms.size(); ++i) {
+		encoding = encoding * radix + atoms[i];
+	}
+
+	return encoding;
+}
+
+// Three candidates: ABC ACB BAC BCA CAB CBA are the direct references, then
+// nine positional and six pairwise references come before the functions.
+static const algo_t A_OVER_B = 15, A_OVER_C = 16, FIRST_FUNCTION = 21;
+
+TEST(GenCustomFunction, EvaluatesKnownAlgorithm) {
+	gen_custom_function gcf(3);
+
+	algo_t minmax = encode_algorithm({A_OVER_B, A_OVER_C,
+			FIRST_FUNCTION + BINARY_FUNC_MIN}, 3);
+
+	ASSERT_TRUE(gcf.set_algorithm(minmax));
+	EXPECT_EQ(gcf.to_string(), "A>B A>C MIN");
+
+	// A>B is ABC + ACB + CAB = 7, A>C is ABC + ACB + BAC = 6.
+	std::vector<double> input = {1, 2, 3, 4, 4, 5};
+	EXPECT_EQ(gcf.evaluate(input), 6);
+
+	algo_t sum_all = encode_algorithm({0, 1, 2,
+			FIRST_FUNCTION + ALL_FUNC_PLUS}, 3);
+	ASSERT_TRUE(gcf.set_algorithm(sum_all));
+	EXPECT_EQ(gcf.evaluate(input), 6);
+}
+
+TEST(GenCustomFunction, RejectsBadStackDepth) {
+	gen_custom_function gcf(3);
+
+	// Not enough values for the function.
+	EXPECT_FALSE(gcf.set_algorithm(encode_algorithm({
+		FIRST_FUNCTION + BINARY_FUNC_PLUS}, 3)));
+	EXPECT_FALSE(gcf.set_algorithm(encode_algorithm({0,
+			FIRST_FUNCTION + BINARY_FUNC_MINUS}, 3)));
+	// Too many values left over.
+	EXPECT_FALSE(gcf.set_algorithm(encode_algorithm({0, 1}, 3)));
+	// Valid structure, but NaN on all-zero input.
+	EXPECT_FALSE(gcf.set_algorithm(encode_algorithm({
+		FIRST_FUNCTION + VAL_ONE, FIRST_FUNCTION + UNARY_FUNC_NEG,
+		FIRST_FUNCTION + UNARY_FUNC_SQRT}, 3)));
+
+	// Force-setting an invalid algorithm makes evaluation return NaN.
+	gcf.force_set_algorithm(encode_algorithm({0, 1}, 3));
+	EXPECT_TRUE(isnan(gcf.evaluate(std::vector<double>(6, 1))));
+}
+
+// Running many input vectors at once must give exactly the same results as
+// one at a time, including where the result is NaN.
+TEST(GenCustomFunction, BatchMatchesScalar) {
+	gen_custom_function gcf(3);
+	rng randomizer(1);
+
+	// 19 vectors: two full blocks and a partial one.
+	std::vector<std::vector<double> > inputs(19, std::vector<double>(6));
+	for (std::vector<double> & input: inputs) {
+		for (double & value: input) {
+			value = randomizer.next_int(5) - 1;
+		}
+	}
+
+	std::vector<double> batch_results;
+	size_t num_valid = 0;
+
+	for (algo_t algorithm = 0; algorithm < 200000; ++algorithm) {
+		if (!gcf.set_algorithm(algorithm)) {
+			continue;
+		}
+		++num_valid;
+
+		gcf.evaluate_batch(inputs, batch_results);
+		ASSERT_EQ(batch_results.size(), inputs.size());
+
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			double scalar_result = gcf.evaluate(inputs[i]);
+
+			if (isnan(scalar_result)) {
+				EXPECT_TRUE(isnan(batch_results[i])) << gcf.to_string();
+			} else {
+				EXPECT_EQ(batch_results[i], scalar_result)
+						<< gcf.to_string();
+			}
+		}
+	}
+
+	EXPECT_GT(num_valid, 1000);
+}
@@ -0,0 +1,152 @@
+// Tests for the verifier's backtracking search.
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "random/random.h"
+#include "singlewinner/brute_force/general_rpn/verifier/backtracker.h"
+#include "tools/tools.h"
+
+static const size_t NUMCANDS = 3, NUM_ALGORITHMS = 4, NUM_TESTS = 2;
+
+// A group whose A, B, A' and B' scenarios are the three-candidate scenarios
+// with the given numbers.
+static test_generator_group get_group(int before_A, int before_B,
+	int after_A, int after_B, bool no_harm, bool no_help) {
+
+	test_instance_generator generator{test_generator(1)};
+	generator.before_A = copeland_scenario(before_A, NUMCANDS);
+	generator.before_B = copeland_scenario(before_B, NUMCANDS);
+	generator.after_A = copeland_scenario(after_A, NUMCANDS);
+	generator.after_B = copeland_scenario(after_B, NUMCANDS);
+	generator.cand_B_idx_before = 1;
+	generator.cand_B_idx_after = 1;
+	generator.no_harm = no_harm;
+	generator.no_help = no_help;
+
+	test_generator_group group;
+	group.insert(generator);
+	return group;
+}
+
+// The number of ways of assigning an algorithm to each scenario that pass
+// every group's tests, by trying every assignment.
+static size_t brute_force_passing_methods(
+	const test_generator_groups & groups,
+	const std::vector<test_results> & all_results) {
+
+	std::vector<copeland_scenario> scenarios;
+	for (const test_generator_group & group: groups.groups) {
+		for (int type = 0; type < NUM_REL_ELECTION_TYPES; ++type) {
+			copeland_scenario scenario = group.get_scenario(
+					(test_election)type);
+			if (std::find(scenarios.begin(), scenarios.end(), scenario) ==
+				scenarios.end()) {
+				scenarios.push_back(scenario);
+			}
+		}
+	}
+
+	size_t num_assignments = 1, passing = 0;
+	for (size_t i = 0; i < scenarios.size(); ++i) {
+		num_assignments *= NUM_ALGORITHMS;
+	}
+
+	for (size_t assignment = 0; assignment < num_assignments; ++assignment) {
+		bool passes = true;
+
+		for (size_t i = 0; i < groups.groups.size() && passes; ++i) {
+			const test_generator_group & group = groups.groups[i];
+			std::vector<int> method_indices;
+
+			for (int type = 0; type < NUM_REL_ELECTION_TYPES; ++type) {
+				size_t scenario_idx = std::find(scenarios.begin(),
+						scenarios.end(), group.get_scenario(
+							(test_election)type)) - scenarios.begin();
+
+				size_t algorithm = assignment;
+				for (size_t j = 0; j < scenario_idx; ++j) {
+					algorithm /= NUM_ALGORITHMS;
+				}
+				method_indices.push_back(algorithm % NUM_ALGORITHMS);
+			}
+
+			passes = all_results[i].passes_tests(method_indices,
+					group.get_no_harm(), group.get_no_help());
+		}
+
+		if (passes) {
+			++passing;
+		}
+	}
+
+	return passing;
+}
+
+// Run the verifier's steps on a few groups with made-up results: find the
+// group order, sample the algorithms, and then search with the order found.
+// Every step must leave the backtracker ready for the next, and the search
+// must find exactly the methods that pass every group's tests.
+TEST(Verifier, SearchFindsEveryPassingMethod) {
+	test_generator_groups groups;
+	groups.groups.push_back(get_group(0, 1, 2, 3, true, false));
+	groups.groups.push_back(get_group(2, 3, 0, 1, false, true));
+	groups.groups.push_back(get_group(0, 2, 1, 3, true, true));
+	groups.groups.push_back(get_group(1, 3, 1, 0, true, false));
+
+	rng randomizer(1);
+	std::vector<test_results> all_results;
+
+	for (size_t i = 0; i < groups.groups.size(); ++i) {
+		test_results results(NUM_TESTS, NUM_ALGORITHMS);
+		results.allocate_space(testing::TempDir() + "verifier_test_" +
+			itos(i) + ".dat");
+
+		for (size_t algorithm = 0; algorithm < NUM_ALGORITHMS; ++algorithm) {
+			for (size_t test = 0; test < NUM_TESTS; ++test) {
+				for (int type = 0; type < NUM_REL_ELECTION_TYPES; ++type) {
+					results.set_result(algorithm, test, (test_election)type,
+						randomizer.next_int(3));
+				}
+			}
+		}
+
+		all_results.push_back(results);
+	}
+
+	size_t expected = brute_force_passing_methods(groups, all_results);
+	ASSERT_GT(expected, 0);
+
+	std::vector<std::vector<algo_t> > algorithms(NUMCANDS+1);
+	for (size_t algorithm = 0; algorithm < NUM_ALGORITHMS; ++algorithm) {
+		algorithms[NUMCANDS].push_back(algorithm);
+	}
+
+	backtracker tester(NUMCANDS, NUMCANDS);
+	tester.show_reports = false;
+	tester.set_algorithms(algorithms);
+
+	double time_limit = 0.05;
+	std::list<size_t> group_order = get_group_order(time_limit, groups,
+			all_results, tester, false);
+
+	std::vector<size_t> sorted_order(group_order.begin(),
+		group_order.end());
+	std::sort(sorted_order.begin(), sorted_order.end());
+	EXPECT_EQ(sorted_order, std::vector<size_t>({0, 1, 2, 3}));
+
+	get_function_sample(time_limit, tester, algorithms);
+
+	for (size_t num_threads: {1, 4}) {
+		tester.num_threads = num_threads;
+		tester.set_algorithms(algorithms);
+		tester.set_tests_and_results(group_order, groups, all_results);
+		tester.try_algorithms();
+
+		EXPECT_EQ(tester.get_num_passing_methods(), expected)
+				<< num_threads << " threads";
+	}
+}
@@ -0,0 +1,797 @@
+#include "backtracker.h"
+
+#include "tools/tools.h"
+
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+#include <omp.h>
+
+double backtracker::get_progress(const search_state & state) const {
+	// This is basically a least significant digit first radix conversion.
+	// While MSD is easier to write, it would also cause overflows.
+	// idx is indexed backwards to avoid problems with going below zero
+	// on an unsigned counter.
+
+	// Fortunately for us, algorithm_used is indexed so that [0] changes
+	// least often, [1] changes a bit more often, and so on, so we can
+	// simply go in reverse order, skipping any -1 values.
+
+	double progress = 0;
+
+	for (size_t r_idx = 1; r_idx <= state.algorithm_used.size(); ++r_idx) {
+		size_t idx = state.algorithm_used.size() - r_idx;
+
+		if (state.algorithm_used[idx] == -1) {
+			continue;
+		}
+
+		progress += state.algorithm_used[idx];
+		progress /= (double)(*prospective_algorithms)[
+		 numcands_per_scenario_idx[idx]].size();
+	}
+
+	return progress;
+}
+
+// The fraction of the search space that consists of every way of
+// completing the current (partial) assignment.
+double backtracker::get_weight(const search_state & state) const {
+	double weight = 1;
+
+	for (size_t idx = 0; idx < state.algorithm_used.size(); ++idx) {
+		if (state.algorithm_used[idx] != -1) {
+			weight /= (double)(*prospective_algorithms)[
+			 numcands_per_scenario_idx[idx]].size();
+		}
+	}
+
+	return weight;
+}
+
+// Must be called from inside the verifier_shared critical section.
+void backtracker::print_progress(const search_state & state) const {
+
+	// Other running tasks' progress isn't known until they finish, so
+	// this is an underestimate.
+	double progress = completed_progress + std::max(0.0,
+			get_progress(state) - state.start_progress -
+			state.spawned_weight);
+
+	double seconds_run = secs_elapsed(start_time, last_shown_time);
+	double eta_seconds = (1-progress)/progress * seconds_run;
+
+	std::cerr << "Iteration counts." << std::endl;
+	for (size_t i = 0; i < iteration_count.size(); ++i) {
+		std::cerr << "idx " << i << "\t" << iteration_count[i] +
+			state.iteration_count[i] << std::endl;
+	}
+
+	std::cerr << "Progress: " << progress << "    ";
+	std::cerr << "ETA: " << format_time(eta_seconds) << ".";
+	std::cerr << "    \r" << std::flush;
+}
+
+// We want to assign an algorithm to each scenario, which then determines
+// what voting method we have constructed out of the algorithms. Because
+// indexing by scenario takes too long time when we're calling the
+// try_algorithms function billions of times, instead the program uses a
+// bit of an in-between move. It assigns each (group_idx, election_setting)
+// pair to an index into an array. What that index is depends on what
+// scenario corresponds to that particular group and that particular
+// election setting. Then the try_algorithms function can simply check if
+// some algorithm has already been set at algorithm_used[
+// algorithm_used_idx_for_test[test_group_idx][current_election_setting]]
+// without having to do a costly map lookup.
+void backtracker::init_algorithms_used() {
+
+	algorithm_used_idx_for_scenario.clear();
+
+	algorithm_used_idx_for_test = std::vector<std::vector<int> >(
+			tests_and_results.size(), std::vector<int>(NUM_REL_ELECTION_TYPES,
+				0));
+
+	max_num_algorithms = std::vector<std::vector<int> >(
+			tests_and_results.size(), std::vector<int>(NUM_REL_ELECTION_TYPES,
+				0));
+
+	// Map scenarios to indices and (test_group, current_election) pairs
+	// to the same indices through their scenarios.
+	size_t num_distinct_scenarios = 0, test_group_idx;
+	int current_election_setting;
+
+	numcands_per_scenario_idx = std::vector<size_t>();
+
+	for (test_group_idx = 0; test_group_idx < tests_and_results.size();
+		++test_group_idx) {
+
+		for (current_election_setting = 0; current_election_setting <
+			NUM_REL_ELECTION_TYPES; ++current_election_setting) {
+
+			copeland_scenario current_scenario = tests_and_results[
+			test_group_idx].test_group.get_scenario(
+					(test_election)current_election_setting);
+
+			if (algorithm_used_idx_for_scenario.find(current_scenario) ==
+				algorithm_used_idx_for_scenario.end()) {
+				algorithm_used_idx_for_scenario[current_scenario] =
+					num_distinct_scenarios;
+
+				numcands_per_scenario_idx.push_back(
+					current_scenario.get_numcands());
+
+				num_distinct_scenarios++;
+			}
+
+			algorithm_used_idx_for_test[test_group_idx]
+			[current_election_setting] =
+				algorithm_used_idx_for_scenario[current_scenario];
+
+			// Set the denominator for the progress indicator.
+			// This could be done once and for all outside of the loop.
+			// TODO: Do that.
+			max_num_algorithms[test_group_idx][(int)current_election_setting] =
+				(*prospective_algorithms)[
+				 current_scenario.get_numcands()].size();
+		}
+	}
+}
+
+// Print the method we've constructed so far. Must be called from inside
+// the verifier_shared critical section.
+void backtracker::print_method(const search_state & state,
+	size_t test_group_idx) {
+
+	bool do_printout = false;
+
+	if (test_group_idx == num_groups) {
+		do_printout = true;
+
+		std::cout << "Reached the end." << std::endl;
+	}
+
+	if (test_group_idx >= std::max((size_t)7, greatest_idx_reached) &&
+		show_partially_complying_methods) {
+
+		std::cout << "Found another best-so-far at idx " << test_group_idx <<
+			std::endl;
+		std::cout << "Printing it to get partial method information." << std::endl;
+
+		do_printout = true;
+		greatest_idx_reached = test_group_idx;
+	}
+
+	if (!do_printout) {
+		return;
+	}
+
+	for (const auto & kv : algorithm_used_idx_for_scenario) {
+		size_t numcands = kv.first.get_numcands();
+
+		int algo_idx = state.algorithm_used[kv.second];
+		algo_t algorithm = (*prospective_algorithms)[numcands][algo_idx];
+		evaluators[numcands].set_algorithm(algorithm);
+		std::cout << "\t" << kv.first.to_string() << ": "
+			<< algorithm << "\t" << evaluators[numcands].to_string()
+			<< "\n";
+	}
+	std::cout << "Summary: ";
+	for (const auto & kv : algorithm_used_idx_for_scenario) {
+		size_t numcands = kv.first.get_numcands();
+
+		int algo_idx = state.algorithm_used[kv.second];
+		algo_t algorithm = (*prospective_algorithms)[numcands][algo_idx];
+		evaluators[numcands].set_algorithm(algorithm);
+
+		std::cout << evaluators[numcands].to_string() << " ## ";
+	}
+
+	std::cout << std::endl;
+
+	std::cout << "Iteration counts." << std::endl;
+	for (size_t i = 0; i < iteration_count.size(); ++i) {
+		std::cout << "idx " << i << "\t" << iteration_count[i] +
+			state.iteration_count[i] << std::endl;
+	}
+}
+
+bool backtracker::is_out_of_time() {
+	int out;
+
+	#pragma omp atomic read
+	out = out_of_time;
+
+	if (out) {
+		return true;
+	}
+
+	if (time_limit > 0 && secs_elapsed(start_time, get_now()) >= time_limit) {
+		#pragma omp atomic write
+		out_of_time = 1;
+
+		return true;
+	}
+
+	return false;
+}
+
+// Search a subtree, then add its counts and progress to the totals.
+
+void backtracker::run_task(search_state state, size_t test_group_idx,
+	test_election current_election_setting) {
+
+	// Exceptions can't cross the task boundary, so keep the first one
+	// and rethrow it after we're done.
+	try {
+		try_algorithms(state, test_group_idx, current_election_setting);
+	} catch (std::exception & e) {
+		#pragma omp critical(verifier_shared)
+		{
+			if (!failed) {
+				error_message = e.what();
+			}
+			failed = true;
+		}
+	}
+
+	#pragma omp critical(verifier_shared)
+	{
+		for (size_t i = 0; i < iteration_count.size(); ++i) {
+			iteration_count[i] += state.iteration_count[i];
+		}
+
+		for (size_t i = 0; i < state.failures_per_test.size(); ++i) {
+			failures_per_test[i] += state.failures_per_test[i];
+		}
+
+		// The parts of the subtree that were handed off to other
+		// tasks are counted by those tasks.
+		if (state.aborted) {
+			completed_progress += std::max(0.0, state.progress_at_exit -
+					state.start_progress - state.spawned_weight);
+		} else {
+			completed_progress += state.weight - state.spawned_weight;
+		}
+	}
+}
+
+void backtracker::try_algorithms(search_state & state,
+	size_t test_group_idx, test_election current_election_setting) {
+
+	if (test_group_idx == num_groups) {
+		++state.iteration_count[test_group_idx];
+
+		if (!show_reports) {
+			return;
+		}
+	}
+
+	if (show_reports && (test_group_idx == num_groups ||
+			(test_group_idx >= 7 && show_partially_complying_methods))) {
+
+		#pragma omp critical(verifier_shared)
+		print_method(state, test_group_idx);
+	}
+
+	if (test_group_idx == num_groups) {
+		return;
+	}
+
+	// First check if we've set an algorithm for the current test group.
+	// If not, go through every possible algorithm.
+
+	int current_scenario_idx = algorithm_used_idx_for_test[test_group_idx]
+		[(int)current_election_setting];
+
+	size_t i, numcands = numcands_per_scenario_idx[current_scenario_idx];
+
+	if (state.algorithm_used[current_scenario_idx] == -1) {
+		// Go through every possible algorithm. For each, recurse back with
+		// the current position the same so we'll fall through next time.
+
+		// Near the top of the search tree, make each subtree a task of
+		// its own instead, so that idle threads can pick them up.
+		bool spawn = current_scenario_idx < (int)task_depth;
+
+		for (i = 0; i < (*prospective_algorithms)[numcands].size(); ++i) {
+			state.algorithm_used[current_scenario_idx] = i;
+
+			if (!spawn) {
+				try_algorithms(state, test_group_idx,
+					current_election_setting);
+				continue;
+			}
+
+			// There's no point in starting new tasks if we're out of
+			// time.
+			if (is_out_of_time()) {
+				state.aborted = true;
+				state.progress_at_exit = get_progress(state);
+				break;
+			}
+
+			search_state child = state;
+			child.iteration_count.assign(child.iteration_count.size(), 0);
+			child.failures_per_test.assign(
+				child.failures_per_test.size(), 0);
+			child.start_progress = get_progress(child);
+			child.weight = get_weight(child);
+			child.spawned_weight = 0;
+
+			state.spawned_weight += child.weight;
+
+			#pragma omp task firstprivate(child, test_group_idx, \
+				current_election_setting)
+			run_task(child, test_group_idx, current_election_setting);
+		}
+
+		// Since we've looped through to ourselves, there's no need
+		// to do anything but reset the scenario to undecided and return.
+		state.algorithm_used[current_scenario_idx] = -1;
+		return;
+	}
+
+	// If we got here, the algorithm to use for the current scenario has
+	// already been defined. So set the algorithm_per_setting array to
+	// this particular algorithm, as the testing function need is in that
+	// particular format.
+
+	// Increment the relevant iteration count.
+	if (current_election_setting == TYPE_A) {
+		++state.iteration_count[test_group_idx];
+	}
+
+	// Note that we need a different algorithm_per_setting array for each
+	// test_group_idx. Otherwise recursions further in might scribble on
+	// an algorithm_per_setting that a recursion further out needs to
+	// preserve.
+
+	state.algorithm_per_setting[test_group_idx][(int)current_election_setting] =
+		state.algorithm_used[current_scenario_idx];
+
+	// Show a progress report if the global counter is high enough and enough
+	// time has elapsed. (1s hard-coded.)
+	if (state.global_counter++ >= counter_threshold) {
+
+		// Time limit check
+		if (state.aborted || is_out_of_time()) {
+
+			// Record how far we managed to get before forced to exit,
+			// if we haven't already recorded it.
+			if (!state.aborted) {
+				state.aborted = true;
+				state.progress_at_exit = get_progress(state);
+			}
+			return;
+		}
+
+		state.global_counter = 0;
+		if (show_reports) {
+			#pragma omp critical(verifier_shared)
+			{
+				if (secs_elapsed(last_shown_time,get_now()) > 1) {
+					last_shown_time = get_now();
+					print_progress(state);
+				}
+			}
+		}
+	}
+
+	// If we're at the last election setting, run a test, because we have
+	// algorithms for every selection setting (A, B, A', B').
+	if (current_election_setting == TYPE_B_PRIME) {
+		bool pass;
+
+		// If we've been told to record just which tests fail the result,
+		// do so.
+		if (record_failures_for_group_idx == (int)test_group_idx) {
+			pass = tests_and_results[test_group_idx].group_results.
+				passes_tests(state.algorithm_per_setting[test_group_idx],
+					state.failures_per_test, must_pass_first_k,
+					tests_and_results[test_group_idx].test_group.get_no_harm(),
+					tests_and_results[test_group_idx].test_group.get_no_help());
+		} else {
+			pass = tests_and_results[test_group_idx].group_results.
+				passes_tests(state.algorithm_per_setting[test_group_idx],
+					tests_and_results[test_group_idx].test_group.get_no_harm(),
+					tests_and_results[test_group_idx].test_group.get_no_help());
+		}
+
+		// Abort early if no pass.
+		if (!pass) {
+			return;
+		}
+	}
+
+	// Recurse either to the next group or to the next election setting.
+	if (current_election_setting == TYPE_B_PRIME) {
+		try_algorithms(state, test_group_idx+1, TYPE_A);
+	} else {
+		try_algorithms(state, test_group_idx, (test_election)
+			((int)current_election_setting+1));
+	}
+
+	// Make debugging easier by cleaning up after ourselves.
+	state.algorithm_per_setting[test_group_idx][(int)current_election_setting] =
+		-1;
+}
+
+double backtracker::try_algorithms() {
+	if (!prospective_algorithms || prospective_algorithms->empty()) {
+		throw new std::runtime_error("No algorithms to check!");
+	}
+
+	search_state root;
+	root.algorithm_used = std::vector<int>(numcands_per_scenario_idx.size(),
+			-1);
+	root.algorithm_per_setting = std::vector<std::vector<int> >(
+			tests_and_results.size(),
+			std::vector<int>(NUM_REL_ELECTION_TYPES, -1));
+	root.iteration_count = std::vector<size_t>(iteration_count.size(), 0);
+	root.failures_per_test = std::vector<size_t>(
+			failures_per_test.size(), 0);
+	root.global_counter = 0;
+	root.start_progress = 0;
+	root.weight = 1;
+	root.spawned_weight = 0;
+	root.aborted = false;
+	root.progress_at_exit = 0;
+
+	start_time = get_now();
+	completed_progress = 0;
+	out_of_time = 0;
+	failed = false;
+
+	int threads = num_threads;
+	if (threads == 0) {
+		threads = omp_get_max_threads();
+	}
+
+	// One thread starts the search; the tasks it spawns are then shared
+	// among the rest.
+	#pragma omp parallel num_threads(threads)
+	{
+		#pragma omp single
+		run_task(root, 0, TYPE_A);
+	}
+
+	if (failed) {
+		throw std::runtime_error("Verifier: " + error_message);
+	}
+
+	if (show_reports) {
+		std::cout << "Final iteration counts." << std::endl;
+		for (size_t i = 0; i < iteration_count.size(); ++i) {
+			std::cout << "idx " << i << "\t" << iteration_count[i] << std::endl;
+		}
+	}
+
+	// If we didn't run out of time, we must have gone through the whole
+	// search space before exceeding our time budget, so set progress
+	// accordingly. If we finish just in time, set progress to 1, but if
+	// we finish before time is up, extrapolate linearly. E.g. finishing
+	// in half the allotted time gives a progress number of 2.
+	if (!out_of_time) {
+		return std::max(1.0, time_limit/secs_elapsed(start_time, get_now()));
+	}
+
+	// Otherwise, the progress is the sum of what every task managed to
+	// get done.
+	return completed_progress;
+}
+
+void backtracker::set_tests_and_results(
+	const std::list<size_t> & order,
+	const test_generator_groups & all_groups,
+	const std::vector<test_results> & all_results) {
+
+	tests_and_results.clear();
+
+	for (size_t idx: order) {
+		tests_and_results.push_back(
+			test_and_result(all_groups.groups[idx], all_results[idx]));
+	}
+
+	max_num_algorithms = std::vector<std::vector<int> >(
+			tests_and_results.size(),
+			std::vector<int>(NUM_REL_ELECTION_TYPES, -1));
+
+	iteration_count =
+		std::vector<size_t>(tests_and_results.size()+1, 0);
+
+	// Init_algorithms_used also initializes the size counts that we
+	// need for progress reports. These counts depend on the algorithms
+	// having been set, so we can only call init_algorithms if both
+	// tests_and_results and prospective_algorithms have been set.
+
+	if (prospective_algorithms && !prospective_algorithms->empty()) {
+		init_algorithms_used();
+	}
+
+	num_groups = tests_and_results.size();
+}
+
+void backtracker::set_algorithms(
+	const std::vector<std::vector<algo_t> > & algos_in) {
+
+	prospective_algorithms = std::make_shared<
+		const std::vector<std::vector<algo_t> > >(algos_in);
+
+	// See above.
+	if (!tests_and_results.empty()) {
+		init_algorithms_used();
+	}
+}
+
+/////////////////////////////////////////////////////////////////
+
+// "Greater" sorts descending by score and ascending by group index,
+// which is how the tiebreaking should work for aesthetic reasons.
+class group_score_pair {
+	public:
+		double score;
+		size_t group_idx;
+		bool beginning;
+
+		bool operator>(const group_score_pair & other) const {
+			if (score != other.score) {
+				return score < other.score;
+			}
+			return group_idx >= other.group_idx;
+		}
+
+		group_score_pair(double score_in, size_t idx_in, bool beginning_in) {
+			group_idx = idx_in;
+			score = score_in;
+			beginning = beginning_in;
+		}
+};
+
+// Local search subroutine for getting how much progress we can attain
+// in a given time.
+
+double get_progress(double time_limit, backtracker & tester) {
+
+	bool old_show_reports = tester.show_reports;
+	double old_time_limit = tester.time_limit;
+
+	tester.show_reports = false;
+	tester.time_limit = time_limit;
+	double progress = tester.try_algorithms();
+	tester.time_limit = old_time_limit;
+	tester.show_reports = old_show_reports;
+
+	return progress;
+}
+
+// Local search. Repeatedly pick the group that gets the most progress
+// done when added to the end of the list of groups to test.
+
+std::list<size_t> get_group_order(double time_limit,
+	const test_generator_groups & groups,
+	const std::vector<test_results> & all_results, backtracker & tester,
+	bool report) {
+
+	std::priority_queue<group_score_pair, std::vector<group_score_pair >,
+		std::greater<group_score_pair > > incoming_groups,
+		outgoing_groups;
+
+	std::list<size_t> output_order;
+
+	// Dump every group into the incoming_groups priority queue.
+	for (size_t i = 0; i < groups.groups.size(); ++i) {
+		incoming_groups.push(group_score_pair(0, i, false));
+	}
+
+	while (!incoming_groups.empty()) {
+		// Visit the incoming queue in order from the furthest progressing
+		// to the least, as a proxy for how far it will progress this
+		// time around.
+
+		std::vector<size_t> candidates;
+
+		while (!incoming_groups.empty()) {
+			candidates.push_back(incoming_groups.top().group_idx);
+			incoming_groups.pop();
+		}
+
+		// Try every candidate group at the beginning and at the end of
+		// the order. The probes are independent of each other, so run
+		// them concurrently, each with a backtracker of its own that
+		// searches on a single thread. That way, the time limit means the
+		// same as if they were run one after another.
+
+		std::vector<double> progress_front(candidates.size()),
+			progress_back(candidates.size());
+
+		bool failed = false;
+		std::string error_message;
+
+		#pragma omp parallel for schedule(dynamic)
+		for (size_t probe = 0; probe < 2 * candidates.size(); ++probe) {
+			size_t cand_idx = probe / 2;
+			bool front = probe % 2 == 0;
+
+			try {
+				backtracker prober = tester;
+				prober.num_threads = 1;
+
+				std::list<size_t> tentative = output_order;
+				if (front) {
+					tentative.push_front(candidates[cand_idx]);
+				} else {
+					tentative.push_back(candidates[cand_idx]);
+				}
+
+				prober.set_tests_and_results(tentative, groups,
+					all_results);
+
+				if (front) {
+					progress_front[cand_idx] = get_progress(time_limit,
+							prober);
+				} else {
+					progress_back[cand_idx] = get_progress(time_limit,
+							prober);
+				}
+			} catch (std::exception & e) {
+				#pragma omp critical
+				{
+					if (!failed) {
+						error_message = e.what();
+					}
+					failed = true;
+				}
+			}
+		}
+
+		if (failed) {
+			throw std::runtime_error("Group order: " + error_message);
+		}
+
+		// Report and rank in the same order as we would have if the
+		// probes were run serially.
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			if (report) {
+				std::cout << candidates[i] << ": progress at"
+					" exit was " << progress_front[i] << " (beginning)\n";
+				std::cout << candidates[i] << ": progress at"
+					" exit was " << progress_back[i] << " (end)\n";
+			}
+
+			bool beginning = progress_front[i] > progress_back[i];
+			double progress = std::max(progress_front[i], progress_back[i]);
+
+			outgoing_groups.push(group_score_pair(progress,
+					candidates[i], beginning));
+		}
+		// Insert the top as the next element of the output order.
+		if (report) {
+			std::cout << "Inserting recordholder " <<
+				outgoing_groups.top().group_idx << " with progress " <<
+				outgoing_groups.top().score << "." << std::endl;
+		}
+
+		if (outgoing_groups.top().beginning) {
+			output_order.push_front(outgoing_groups.top().group_idx);
+		} else {
+			output_order.push_back(outgoing_groups.top().group_idx);
+		}
+		outgoing_groups.pop();
+
+		std::swap(incoming_groups, outgoing_groups);
+	}
+
+	// The probes ran on copies, so set up the tester itself to check the
+	// groups in the order we found.
+	tester.set_tests_and_results(output_order, groups, all_results);
+
+	return output_order;
+}
+
+// Uniformly reduce the number of algorithms until a full pass can be done
+// in the time allotted. This is used to make a more representative sample
+// of the complete algorithms set.
+
+// Uniformly reducing means that e.g. if num_algorithms_per_candidate is
+// 10 and the number of algorithms for 3 candidates is 200, then every
+// 20th algorithm is included.
+
+std::vector<std::vector<algo_t> > reduce_num_algorithms(
+	const std::vector<std::vector<algo_t> > & functions_to_test,
+	size_t num_algorithms_per_candidate) {
+
+	std::vector<std::vector<algo_t> > out;
+
+	for (const std::vector<algo_t> & algorithms_one_cand :
+		functions_to_test) {
+
+		if (algorithms_one_cand.size() <= num_algorithms_per_candidate) {
+			out.push_back(algorithms_one_cand);
+			continue;
+		}
+
+		std::vector<algo_t> out_this_candidate;
+
+		for (double source_index = 0;
+			source_index < algorithms_one_cand.size();
+			source_index += algorithms_one_cand.size()/(double)
+				num_algorithms_per_candidate) {
+
+			out_this_candidate.push_back(algorithms_one_cand[(int)
+					round(source_index)]);
+		}
+
+		out.push_back(out_this_candidate);
+	}
+
+	return out;
+}
+
+// Perform a bisection search to get the largest (most representative)
+// sample of algorithms that can still be searched in the time allotted.
+
+std::vector<std::vector<algo_t> > get_function_sample(double time_limit,
+	backtracker & tester,
+	const std::vector<std::vector<algo_t> > & functions_to_test) {
+
+	double progress = 0;
+	double tolerance = 1e-15;
+
+	// We want a value x for reduce_num_algorithms so that the tester
+	// completes in exactly time_limit. Find said x with a bisection
+	// method (perhaps some other method later).
+
+	double high = 0, low = 1;
+	double f_low = -1000;
+
+	for (const auto & ftt: functions_to_test) {
+		high = std::max(high, (double)ftt.size());
+	}
+
+	for (int iter = 0; iter < 100; ++iter) {
+
+		double mid = round((high + low) * 0.5);
+
+		std::vector<std::vector<algo_t> > reduced_functions_to_test =
+			reduce_num_algorithms(functions_to_test, mid);
+
+		// Found a small enough range to conclude.
+		if (round(high) - round(mid) < 1) {
+			std::cout << "mid is " << mid << std::endl;
+			tester.set_algorithms(functions_to_test);
+			return reduced_functions_to_test;
+		}
+
+		tester.set_algorithms(reduced_functions_to_test);
+
+		progress = get_progress(time_limit, tester);
+
+		std::cout << "iter " << iter << ", progress " << progress << " mid " << mid
+			<< std::endl;
+
+		// We want progress to be 1. Bisection search finds the root, i.e.
+		// where y = 0, so we subtract to adjust.
+		// Furthermore, we want y to be negative for low values and
+		// positive for high ones. (Is that necessary?)
+		double y = 1 - progress;
+
+		if (fabs(y) < tolerance) {
+			// Found the correct size sample.
+			std::cout << "mid is " << mid << std::endl;
+			tester.set_algorithms(functions_to_test);
+			return reduced_functions_to_test;
+		}
+
+		if (sign(y) == sign(f_low)) {
+			low = mid;
+			f_low = y;
+		} else {
+			high = mid;
+		}
+	}
+
+	throw std::runtime_error("Did not find the correct number of algorithms"
+		" to finish search in time");
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+// The backtracking search that the verifier (verifier.cc) uses to find
+// combinations of algorithms that pass every test, and the local searches
+// that pick what order to check the test groups in.
+
+// The verifier does the actual checking by a backtracking recursive
+// algorithm that consists of alternating between assigning algorithms to
+// unassigned scenarios and checking if they pass tests.
+
+// However, that still leaves the question of in what order to investigate
+// the different test groups. We would want to put the most discriminating
+// tests first, so that the backtracking aborts the recursive tests as early
+// as possible (thus avoiding the combinatorial explosion problem).
+
+// Previously, I determined the order by using a topological sort, but that
+// led to bad assignments (where some very discriminating tests were pushed
+// to the back), so instead I now use a local search: try every test group
+// alone and check how many tests pass it after 2 seconds, then pick the one
+// that pass the fewest tests and repeat with the next test group.
+
+///////////////////////////////////////////////////////////////////////////
+
+// Once we know what order to investigate, we can do a recursive
+// enumeration. We set up a vector listing what algorithm to try for
+// what scenario (-1 if we haven't decided yet), and go through each data
+// file corresponding to each test generator group, in order.
+
+// When we enter into a new test generator group, we go through the four
+// scenarios (A, B, A', B') and check if we've assigned algorithms to each.
+// If we haven't, we run a for loop to try every possible algorithm for the
+// unused positions. At the end, all four scenario positions are populated
+// and we can test if this configuration passes the tests according to the
+// data file produced by compositor.
+
+// The search is parallel: the first few scenario assignments (see
+// task_depth) each spawn an OpenMP task per algorithm, and the rest of the
+// subtree is searched recursively within that task. The OpenMP runtime
+// hands tasks to idle threads, so threads that are done with a subtree that
+// got pruned early will pick up other work. Each task has its own search
+// state and merges its iteration counts, failure counts and progress into
+// the backtracker's totals when done.
+
+#include "../composition/groups/test_generator_groups.h"
+#include "../composition/test_results.h"
+#include "../gen_custom_function.h"
+
+#include "tools/time_tools.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class test_and_result {
+	public:
+		test_generator_group test_group;
+		test_results group_results;
+
+		test_and_result(const test_generator_group & group_in,
+			const test_results & results_in) : test_group(group_in),
+			group_results(results_in) {}
+};
+
+// The state of (part of) the recursive search. Each OpenMP task gets its
+// own copy so that it can search its subtree without interfering with the
+// others.
+class search_state {
+	public:
+		std::vector<int> algorithm_used;
+		std::vector<std::vector<int> > algorithm_per_setting;
+		std::vector<size_t> iteration_count;
+		std::vector<size_t> failures_per_test;
+
+		// for showing a progress report without wasting too much time
+		// on time-elapsed calls.
+		size_t global_counter;
+
+		// The progress (see get_progress) at the start of the subtree,
+		// the fraction of the whole search space that the subtree
+		// covers, and how much of that fraction has been handed off
+		// to other tasks.
+		double start_progress, weight, spawned_weight;
+
+		// If we ran out of time, progress_at_exit is how far we got.
+		bool aborted;
+		double progress_at_exit;
+};
+
+class backtracker {
+	private:
+		// returns fraction covered.
+		double get_progress(const search_state & state) const;
+		double get_weight(const search_state & state) const;
+		void print_progress(const search_state & state) const;
+		void print_method(const search_state & state,
+			size_t test_group_idx);
+
+		std::map<copeland_scenario, int> algorithm_used_idx_for_scenario;
+		std::vector<std::vector<int> > algorithm_used_idx_for_test;
+		std::vector<size_t> numcands_per_scenario_idx;
+
+		void init_algorithms_used();
+
+		bool is_out_of_time();
+		void run_task(search_state state, size_t test_group_idx,
+			test_election current_election_setting);
+		void try_algorithms(search_state & state, size_t test_group_idx,
+			test_election current_election_setting);
+
+		// Totals over every finished task.
+		std::vector<size_t> iteration_count;
+		std::vector<test_and_result> tests_and_results;
+
+		std::vector<gen_custom_function> evaluators;
+		size_t min_numcands, max_numcands;
+		size_t num_groups;
+
+		size_t counter_threshold;
+		time_pt last_shown_time, start_time;
+
+		// Shared between the tasks. completed_progress is the sum of
+		// the progress of every finished task, and out_of_time is set
+		// (atomically) by the first task to notice that the time limit
+		// has been exceeded.
+		double completed_progress;
+		int out_of_time;
+		bool failed;
+		std::string error_message;
+
+		size_t greatest_idx_reached;
+		bool show_partially_complying_methods;
+
+	public:
+		// Should be made private once a few things have been improved/
+		// refactored. This is a shared pointer so that copies of the
+		// backtracker (for concurrent group order probes) don't also
+		// copy the possibly very large algorithm lists.
+		std::shared_ptr<const std::vector<std::vector<algo_t> > >
+		prospective_algorithms;
+		bool show_reports;
+
+		// Abort after this time has elapsed, or -1 if no such limit
+		// is desired.
+		double time_limit = 0;
+
+		// Number of threads to search with, or 0 for OpenMP's default.
+		size_t num_threads = 0;
+
+		// Every assignment of an algorithm to a scenario with an index
+		// below task_depth spawns a task for each algorithm; below that,
+		// the search is recursive as usual. Idle threads steal the
+		// spawned tasks.
+		size_t task_depth = 2;
+
+		// for calculating the progress
+		// needs to be improved.
+		std::vector<std::vector<int> > max_num_algorithms;
+
+		// Record which tests fail methods in the given group.
+		// If -1, does no recording.
+		int record_failures_for_group_idx = -1;
+		// Specifies that a method must pass the k first tests before
+		// any failures are recorded.
+		size_t must_pass_first_k = 0;
+		std::vector<size_t> failures_per_test;
+
+		void set_tests_and_results(
+			const std::list<size_t> & order,
+			const test_generator_groups & all_groups,
+			const std::vector<test_results> & all_results);
+
+		void set_test_reporting(int group_idx) {
+			record_failures_for_group_idx = group_idx;
+
+			if (group_idx == -1) {
+				return;
+			}
+
+			failures_per_test = std::vector<size_t>(
+					tests_and_results[group_idx].group_results.num_tests, 0);
+		}
+
+		void set_algorithms(const std::vector<std::vector<algo_t> > & algos_in);
+
+		double try_algorithms();
+
+		// The number of complete methods (i.e. that pass every group's
+		// tests) found by the last search.
+		size_t get_num_passing_methods() const {
+			return iteration_count[num_groups];
+		}
+
+		backtracker(size_t min_numcands_in, size_t max_numcands_in) {
+			min_numcands = min_numcands_in; // remove later
+			max_numcands = max_numcands_in;
+			counter_threshold = 2000;
+			last_shown_time = get_now();
+			num_groups = 0;
+			completed_progress = 0;
+			out_of_time = 0;
+			failed = false;
+			show_reports = true;
+			time_limit = -1;
+
+			for (size_t i = 0; i <= max_numcands; ++i) {
+				evaluators.push_back(gen_custom_function(i));
+			}
+
+			greatest_idx_reached = 0;
+			show_partially_complying_methods = true;
+		}
+};
+
+// How far the search gets within the given time limit. See
+// backtracker::try_algorithms for what the return value means.
+double get_progress(double time_limit, backtracker & tester);
+
+// Find a good order to check the groups in, by local search. When done,
+// the tester is set up to check the groups in that order.
+std::list<size_t> get_group_order(double time_limit,
+	const test_generator_groups & groups,
+	const std::vector<test_results> & all_results, backtracker & tester,
+	bool report);
+
+std::vector<std::vector<algo_t> > reduce_num_algorithms(
+	const std::vector<std::vector<algo_t> > & functions_to_test,
+	size_t num_algorithms_per_candidate);
+
+// Returns the largest uniform sample of the algorithms that the tester
+// can search in the time allotted. The tester's tests and results must
+// have been set.
+std::vector<std::vector<algo_t> > get_function_sample(double time_limit,
+	backtracker & tester,
+	const std::vector<std::vector<algo_t> > & functions_to_test);
@@ -1,7 +1,4 @@
-#include "../composition/groups/test_generator_groups.h"
-#include "../composition/groups/test_generator_group.h"
-
-#include "../composition/test_results.h"
+#include "backtracker.h"
 
 #include "linear_model/constraints/relative_criterion_producer.h"
 #include "linear_model/constraints/relative_criteria/mono-raise.h"
@@ -9,12 +6,9 @@
 
 #include "config/general_rpn.h"
 
-#include "tools/time_tools.h"
-
 #include <iostream>
 #include <iterator>
 #include <memory>
-#include <queue>
 
 #include "../isda.cc"
 
@@ -23,713 +17,8 @@
 // viable election methods (i.e. ones that pass the tests tested by
 // polytope_compositor).
 
-// The program does the actual checking by a backtracking recursive
-// algorithm that consists of alternating between assigning algorithms to
-// unassigned scenarios and checking if they pass tests.
-
-// However, that still leaves the question of in what order to investigate
-// the different test groups. We would want to put the most discriminating
-// tests first, so that the backtracking aborts the recursive tests as early
-// as possible (thus avoiding the combinatorial explosion problem).
-
-// Previously, I determined the order by using a topological sort, but that
-// led to bad assignments (where some very discriminating tests were pushed
-// to the back), so instead I now use a local search: try every test group
-// alone and check how many tests pass it after 2 seconds, then pick the one
-// that pass the fewest tests and repeat with the next test group.
-
-///////////////////////////////////////////////////////////////////////////
-
-// Once we know what order to investigate, we can do a recursive
-// enumeration. We set up a vector listing what algorithm to try for
-// what scenario (-1 if we haven't decided yet), and go through each data
-// file corresponding to each test generator group, in order.
-
-// When we enter into a new test generator group, we go through the four
-// scenarios (A, B, A', B') and check if we've assigned algorithms to each.
-// If we haven't, we run a for loop to try every possible algorithm for the
-// unused positions. At the end, all four scenario positions are populated
-// and we can test if this configuration passes the tests according to the
-// data file produced by compositor.
-
-class test_and_result {
-	public:
-		test_generator_group test_group;
-		test_results group_results;
-
-		test_and_result(const test_generator_group & group_in,
-			const test_results & results_in) : test_group(group_in),
-			group_results(results_in) {}
-};
-
-class backtracker {
-	private:
-		// returns fraction covered.
-		double get_progress() const;
-		void print_progress() const;
-
-		std::map<copeland_scenario, int> algorithm_used_idx_for_scenario;
-		std::vector<std::vector<int> > algorithm_used_idx_for_test;
-		std::vector<int> algorithm_used;
-		std::vector<size_t> numcands_per_scenario_idx;
-
-		void init_algorithms_used();
-
-		void try_algorithms(size_t test_group_idx,
-			test_election current_election_setting);
-
-		std::vector<size_t> iteration_count;
-		std::vector<test_and_result> tests_and_results;
-
-		std::vector<std::vector<int> > algorithm_per_setting;
-		std::vector<gen_custom_function> evaluators;
-		size_t min_numcands, max_numcands;
-		size_t num_groups;
-
-		// for showing a progress report without wasting too much time
-		// on time-elapsed calls.
-		size_t global_counter, counter_threshold;
-		time_pt last_shown_time, start_time;
-
-		double progress_at_exit;
-
-		size_t greatest_idx_reached;
-		bool show_partially_complying_methods;
-
-	public:
-		// Should be made private once a few things have been improved/
-		// refactored.
-		std::vector<std::vector<algo_t> > prospective_algorithms;
-		bool show_reports;
-
-		// Abort after this time has elapsed, or -1 if no such limit
-		// is desired.
-		double time_limit = 0;
-
-		// for calculating the progress
-		// needs to be improved.
-		std::vector<std::vector<int> > max_num_algorithms;
-
-		// Record which tests fail methods in the given group.
-		// If -1, does no recording.
-		int record_failures_for_group_idx = -1;
-		// Specifies that a method must pass the k first tests before
-		// any failures are recorded.
-		size_t must_pass_first_k = 0;
-		std::vector<size_t> failures_per_test;
-
-		void set_tests_and_results(
-			const std::list<size_t> & order,
-			const test_generator_groups & all_groups,
-			const std::vector<test_results> & all_results);
-
-		void set_test_reporting(int group_idx) {
-			record_failures_for_group_idx = group_idx;
-
-			if (group_idx == -1) {
-				return;
-			}
-
-			failures_per_test = std::vector<size_t>(
-					tests_and_results[group_idx].group_results.num_tests, 0);
-		}
-
-		void set_algorithms(const std::vector<std::vector<algo_t> > & algos_in);
-
-		double try_algorithms() {
-			if (prospective_algorithms.empty()) {
-				throw new std::runtime_error("No algorithms to check!");
-			}
-
-			start_time = get_now();
-			progress_at_exit = 0;
-			try_algorithms(0, TYPE_A);
-
-			if (show_reports) {
-				std::cout << "Final iteration counts." << std::endl;
-				for (size_t i = 0; i < iteration_count.size(); ++i) {
-					std::cout << "idx " << i << "\t" << iteration_count[i] << std::endl;
-				}
-			}
-
-			// If progress at exit is not set, we must have gone through
-			// the whole search space before exceeding our time budget, so
-			// set progress accordingly. If we finish just in time,
-			// set progress to 1, but if we finish before time is up,
-			// extrapolate linearly. E.g. finishing in half the allotted
-			// time gives a progress number of 2.
-			if (progress_at_exit == 0) {
-				progress_at_exit = std::max(1.0,
-						time_limit/secs_elapsed(start_time, get_now()));
-			}
-
-			return progress_at_exit;
-		}
-
-		backtracker(size_t min_numcands_in, size_t max_numcands_in) {
-			min_numcands = min_numcands_in; // remove later
-			max_numcands = max_numcands_in;
-			counter_threshold = 2000;
-			global_counter = 0;
-			last_shown_time = get_now();
-			progress_at_exit = 0;
-			show_reports = true;
-			time_limit = -1;
-
-			for (size_t i = 0; i <= max_numcands; ++i) {
-				evaluators.push_back(gen_custom_function(i));
-			}
-
-			greatest_idx_reached = 0;
-			show_partially_complying_methods = true;
-		}
-};
-
-double backtracker::get_progress() const {
-	// This is basically a least significant digit first radix conversion.
-	// While MSD is easier to write, it would also cause overflows.
-	// idx is indexed backwards to avoid problems with going below zero
-	// on an unsigned counter.
-
-	// Fortunately for us, algorithm_used is indexed so that [0] changes
-	// least often, [1] changes a bit more often, and so on, so we can
-	// simply go in reverse order, skipping any -1 values.
-
-	double progress = 0;
-
-	for (size_t r_idx = 1; r_idx <= algorithm_used.size(); ++r_idx) {
-		size_t idx = algorithm_used.size() - r_idx;
-
-		if (algorithm_used[idx] == -1) {
-			continue;
-		}
-
-		progress += algorithm_used[idx];
-		progress /= (double)prospective_algorithms[
-		 numcands_per_scenario_idx[idx]].size();
-	}
-
-	return progress;
-}
-
-void backtracker::print_progress() const {
-
-	double progress = get_progress();
-
-	double seconds_run = secs_elapsed(start_time, last_shown_time);
-	double eta_seconds = (1-progress)/progress * seconds_run;
-
-	std::cerr << "Iteration counts." << std::endl;
-	for (size_t i = 0; i < iteration_count.size(); ++i) {
-		std::cerr << "idx " << i << "\t" << iteration_count[i] << std::endl;
-	}
-
-	std::cerr << "Progress: " << progress << "    ";
-	std::cerr << "ETA: " << format_time(eta_seconds) << ".";
-	std::cerr << "    \r" << std::flush;
-}
-
-// We want to assign an algorithm to each scenario, which then determines
-// what voting method we have constructed out of the algorithms. Because
-// indexing by scenario takes too long time when we're calling the
-// try_algorithms function billions of times, instead the program uses a
-// bit of an in-between move. It assigns each (group_idx, election_setting)
-// pair to an index into an array. What that index is depends on what
-// scenario corresponds to that particular group and that particular
-// election setting. Then the try_algorithms function can simply check if
-// some algorithm has already been set at algorithm_used[
-// algorithm_used_idx_for_test[test_group_idx][current_election_setting]]
-// without having to do a costly map lookup.
-void backtracker::init_algorithms_used() {
-
-	algorithm_used_idx_for_scenario.clear();
-
-	algorithm_used_idx_for_test = std::vector<std::vector<int> >(
-			tests_and_results.size(), std::vector<int>(NUM_REL_ELECTION_TYPES,
-				0));
-
-	max_num_algorithms = std::vector<std::vector<int> >(
-			tests_and_results.size(), std::vector<int>(NUM_REL_ELECTION_TYPES,
-				0));
-
-	// Map scenarios to indices and (test_group, current_election) pairs
-	// to the same indices through their scenarios.
-	size_t num_distinct_scenarios = 0, test_group_idx;
-	int current_election_setting;
-
-	numcands_per_scenario_idx = std::vector<size_t>();
-
-	for (test_group_idx = 0; test_group_idx < tests_and_results.size();
-		++test_group_idx) {
-
-		for (current_election_setting = 0; current_election_setting <
-			NUM_REL_ELECTION_TYPES; ++current_election_setting) {
-
-			copeland_scenario current_scenario = tests_and_results[
-			test_group_idx].test_group.get_scenario(
-					(test_election)current_election_setting);
-
-			if (algorithm_used_idx_for_scenario.find(current_scenario) ==
-				algorithm_used_idx_for_scenario.end()) {
-				algorithm_used_idx_for_scenario[current_scenario] =
-					num_distinct_scenarios;
-
-				numcands_per_scenario_idx.push_back(
-					current_scenario.get_numcands());
-
-				num_distinct_scenarios++;
-			}
-
-			algorithm_used_idx_for_test[test_group_idx]
-			[current_election_setting] =
-				algorithm_used_idx_for_scenario[current_scenario];
-
-			// Set the denominator for the progress indicator.
-			// This could be done once and for all outside of the loop.
-			// TODO: Do that.
-			max_num_algorithms[test_group_idx][(int)current_election_setting] =
-				prospective_algorithms[current_scenario.get_numcands()].size();
-		}
-	}
-
-	algorithm_used = std::vector<int>(num_distinct_scenarios, -1);
-}
-
-void backtracker::try_algorithms(size_t test_group_idx,
-	test_election current_election_setting) {
-
-	bool do_printout = false;
-
-	if (test_group_idx == num_groups) {
-		++iteration_count[test_group_idx];
-
-		if (!show_reports) {
-			return;
-		}
-
-		do_printout = true;
-
-		std::cout << "Reached the end." << std::endl;
-	}
-
-	if (show_reports
-		&& test_group_idx >= std::max((size_t)7, greatest_idx_reached) &&
-		show_partially_complying_methods) {
-
-		std::cout << "Found another best-so-far at idx " << test_group_idx <<
-			std::endl;
-		std::cout << "Printing it to get partial method information." << std::endl;
-
-		do_printout = true;
-		greatest_idx_reached = test_group_idx;
-	}
-
-	if (do_printout) {
-
-		for (const auto & kv : algorithm_used_idx_for_scenario) {
-			size_t numcands = kv.first.get_numcands();
-
-			int algo_idx = algorithm_used[kv.second];
-			algo_t algorithm = prospective_algorithms[numcands][algo_idx];
-			evaluators[numcands].set_algorithm(algorithm);
-			std::cout << "\t" << kv.first.to_string() << ": "
-				<< algorithm << "\t" << evaluators[numcands].to_string()
-				<< "\n";
-		}
-		std::cout << "Summary: ";
-		for (const auto & kv : algorithm_used_idx_for_scenario) {
-			size_t numcands = kv.first.get_numcands();
-
-			int algo_idx = algorithm_used[kv.second];
-			algo_t algorithm = prospective_algorithms[numcands][algo_idx];
-			evaluators[numcands].set_algorithm(algorithm);
-
-			std::cout << evaluators[numcands].to_string() << " ## ";
-		}
-
-		std::cout << std::endl;
-
-		std::cout << "Iteration counts." << std::endl;
-		for (size_t i = 0; i < iteration_count.size(); ++i) {
-			std::cout << "idx " << i << "\t" << iteration_count[i] << std::endl;
-		}
-	}
-
-	if (test_group_idx == num_groups) {
-		return;
-	}
-
-	// First check if we've set an algorithm for the current test group.
-	// If not, go through every possible algorithm.
-
-	int current_scenario_idx = algorithm_used_idx_for_test[test_group_idx]
-		[(int)current_election_setting];
-
-	size_t i, numcands = numcands_per_scenario_idx[current_scenario_idx];
-
-	if (algorithm_used[current_scenario_idx] == -1) {
-		// Go through every possible algorithm. For each, recurse back with
-		// the current position the same so we'll fall through next time.
-
-		for (i = 0; i < prospective_algorithms[numcands].size(); ++i) {
-			algorithm_used[current_scenario_idx] = i;
-			try_algorithms(test_group_idx, current_election_setting);
-		}
-
-		// Since we've looped through to ourselves, there's no need
-		// to do anything but reset the scenario to undecided and return.
-		algorithm_used[current_scenario_idx] = -1;
-		return;
-	}
-
-	// If we got here, the algorithm to use for the current scenario has
-	// already been defined. So set the algorithm_per_setting array to
-	// this particular algorithm, as the testing function need is in that
-	// particular format.
-
-	// Increment the relevant iteration count.
-	if (current_election_setting == TYPE_A) {
-		++iteration_count[test_group_idx];
-	}
-
-	// Note that we need a different algorithm_per_setting array for each
-	// test_group_idx. Otherwise recursions further in might scribble on
-	// an algorithm_per_setting that a recursion further out needs to
-	// preserve.
-
-	algorithm_per_setting[test_group_idx][(int)current_election_setting] =
-		algorithm_used[current_scenario_idx];
-
-	// Show a progress report if the global counter is high enough and enough
-	// time has elapsed. (1s hard-coded.)
-	if (global_counter++ >= counter_threshold) {
-
-		// Time limit check
-		if (time_limit > 0 &&
-			secs_elapsed(start_time, get_now()) >= time_limit) {
-
-			// Record how far we managed to get before forced to exit,
-			// if we haven't already recorded it.
-			if (progress_at_exit == 0) {
-				progress_at_exit = get_progress();
-			}
-			return;
-		}
-
-		global_counter = 0;
-		if (show_reports && secs_elapsed(last_shown_time,get_now()) > 1) {
-
-			last_shown_time = get_now();
-			print_progress();
-		}
-	}
-
-	// If we're at the last election setting, run a test, because we have
-	// algorithms for every selection setting (A, B, A', B').
-	if (current_election_setting == TYPE_B_PRIME) {
-		bool pass;
-
-		// If we've been told to record just which tests fail the result,
-		// do so.
-		if (record_failures_for_group_idx == (int)test_group_idx) {
-			pass = tests_and_results[test_group_idx].group_results.
-				passes_tests(algorithm_per_setting[test_group_idx],
-					failures_per_test, must_pass_first_k,
-					tests_and_results[test_group_idx].test_group.get_no_harm(),
-					tests_and_results[test_group_idx].test_group.get_no_help());
-		} else {
-			pass = tests_and_results[test_group_idx].group_results.
-				passes_tests(algorithm_per_setting[test_group_idx],
-					tests_and_results[test_group_idx].test_group.get_no_harm(),
-					tests_and_results[test_group_idx].test_group.get_no_help());
-		}
-
-		// Abort early if no pass.
-		if (!pass) {
-			return;
-		}
-	}
-
-	// Recurse either to the next group or to the next election setting.
-	if (current_election_setting == TYPE_B_PRIME) {
-		try_algorithms(test_group_idx+1, TYPE_A);
-	} else {
-		try_algorithms(test_group_idx, (test_election)
-			((int)current_election_setting+1));
-	}
-
-	// Make debugging easier by cleaning up after ourselves.
-	algorithm_per_setting[test_group_idx][(int)current_election_setting] = -1;
-}
-
-void backtracker::set_tests_and_results(
-	const std::list<size_t> & order,
-	const test_generator_groups & all_groups,
-	const std::vector<test_results> & all_results) {
-
-	tests_and_results.clear();
-
-	for (size_t idx: order) {
-		tests_and_results.push_back(
-			test_and_result(all_groups.groups[idx], all_results[idx]));
-	}
-
-	algorithm_per_setting =
-		std::vector<std::vector<int> >(tests_and_results.size(),
-			std::vector<int>(NUM_REL_ELECTION_TYPES, -1));
-
-	max_num_algorithms = std::vector<std::vector<int> >(
-			tests_and_results.size(),
-			std::vector<int>(NUM_REL_ELECTION_TYPES, -1));
-
-	iteration_count =
-		std::vector<size_t>(tests_and_results.size()+1, 0);
-
-	// Init_algorithms_used also initializes the size counts that we
-	// need for progress reports. These counts depend on the algorithms
-	// having been set, so we can only call init_algorithms if both
-	// tests_and_results and prospective_algorithms have been set.
-
-	if (!prospective_algorithms.empty()) {
-		init_algorithms_used();
-	}
-
-	num_groups = tests_and_results.size();
-}
-
-void backtracker::set_algorithms(
-	const std::vector<std::vector<algo_t> > & algos_in) {
-
-	prospective_algorithms = algos_in;
-
-	// See above.
-	if (!tests_and_results.empty()) {
-		init_algorithms_used();
-	}
-}
-
-/////////////////////////////////////////////////////////////////
-
-// "Greater" sorts descending by score and ascending by group index,
-// which is how the tiebreaking should work for aesthetic reasons.
-class group_score_pair {
-	public:
-		double score;
-		size_t group_idx;
-		bool beginning;
-
-		bool operator>(const group_score_pair & other) const {
-			if (score != other.score) {
-				return score < other.score;
-			}
-			return group_idx >= other.group_idx;
-		}
-
-		group_score_pair(double score_in, size_t idx_in, bool beginning_in) {
-			group_idx = idx_in;
-			score = score_in;
-			beginning = beginning_in;
-		}
-};
-
-// Local search subroutine for getting how much progress we can attain
-// in a given time.
-
-double get_progress(double time_limit, backtracker & tester) {
-
-	bool old_show_reports = tester.show_reports;
-	double old_time_limit = tester.time_limit;
-
-	tester.show_reports = false;
-	tester.time_limit = time_limit;
-	double progress = tester.try_algorithms();
-	tester.time_limit = old_time_limit;
-	tester.show_reports = old_show_reports;
-
-	return progress;
-}
-
-// Local search. Repeatedly pick the group that gets the most progress
-// done when added to the end of the list of groups to test.
-
-std::list<size_t> get_group_order(double time_limit,
-	const test_generator_groups & groups,
-	const std::vector<test_results> & all_results, backtracker & tester,
-	bool report) {
-
-	std::priority_queue<group_score_pair, std::vector<group_score_pair >,
-		std::greater<group_score_pair > > incoming_groups,
-		outgoing_groups;
-
-	std::list<size_t> output_order;
-
-	// Dump every group into the incoming_groups priority queue.
-	for (size_t i = 0; i < groups.groups.size(); ++i) {
-		incoming_groups.push(group_score_pair(0, i, false));
-	}
-
-	while (!incoming_groups.empty()) {
-		// Visit the incoming queue in order from the furthest progressing
-		// to the least, as a proxy for how far it will progress this
-		// time around.
-
-		while (!incoming_groups.empty()) {
-			std::list<size_t> tentative = output_order;
-
-			tentative.push_front(incoming_groups.top().group_idx);
-
-			tester.set_tests_and_results(tentative, groups, all_results);
-
-			double progress_front = get_progress(time_limit, tester);
-
-			if (report) {
-				std::cout << incoming_groups.top().group_idx << ": progress at"
-					" exit was " << progress_front << " (beginning)\n";
-			}
-
-			tentative.pop_front();
-			tentative.push_back(incoming_groups.top().group_idx);
-			tester.set_tests_and_results(tentative, groups, all_results);
-
-			double progress_back = get_progress(time_limit, tester);
-
-			if (report) {
-				std::cout << incoming_groups.top().group_idx << ": progress at"
-					" exit was " << progress_back << " (end)\n";
-			}
-
-			bool beginning = progress_front > progress_back;
-			double progress = std::max(progress_front, progress_back);
-
-			outgoing_groups.push(group_score_pair(progress,
-					incoming_groups.top().group_idx, beginning));
-			incoming_groups.pop();
-		}
-		// Insert the top as the next element of the output order.
-		if (report) {
-			std::cout << "Inserting recordholder " <<
-				outgoing_groups.top().group_idx << " with progress " <<
-				outgoing_groups.top().score << "." << std::endl;
-		}
-
-		if (outgoing_groups.top().beginning) {
-			output_order.push_front(outgoing_groups.top().group_idx);
-		} else {
-			output_order.push_back(outgoing_groups.top().group_idx);
-		}
-		outgoing_groups.pop();
-
-		std::swap(incoming_groups, outgoing_groups);
-	}
-
-	return output_order;
-}
-
-// Uniformly reduce the number of algorithms until a full pass can be done
-// in the time allotted. This is used to make a more representative sample
-// of the complete algorithms set.
-
-// Uniformly reducing means that e.g. if num_algorithms_per_candidate is
-// 10 and the number of algorithms for 3 candidates is 200, then every
-// 20th algorithm is included.
-
-std::vector<std::vector<algo_t> > reduce_num_algorithms(
-	const std::vector<std::vector<algo_t> > & functions_to_test,
-	size_t num_algorithms_per_candidate) {
-
-	std::vector<std::vector<algo_t> > out;
-
-	for (const std::vector<algo_t> & algorithms_one_cand :
-		functions_to_test) {
-
-		if (algorithms_one_cand.size() <= num_algorithms_per_candidate) {
-			out.push_back(algorithms_one_cand);
-			continue;
-		}
-
-		std::vector<algo_t> out_this_candidate;
-
-		for (double source_index = 0;
-			source_index < algorithms_one_cand.size();
-			source_index += algorithms_one_cand.size()/(double)
-				num_algorithms_per_candidate) {
-
-			out_this_candidate.push_back(algorithms_one_cand[(int)
-					round(source_index)]);
-		}
-
-		out.push_back(out_this_candidate);
-	}
-
-	return out;
-}
-
-// Perform a bisection search to get the largest (most representative)
-// sample of algorithms that can still be searched in the time allotted.
-
-std::vector<std::vector<algo_t> > get_function_sample(double time_limit,
-	backtracker & tester,
-	const std::vector<std::vector<algo_t> > & functions_to_test) {
-
-	double progress = 0;
-	double tolerance = 1e-15;
-
-	// We want a value x for reduce_num_algorithms so that the tester
-	// completes in exactly time_limit. Find said x with a bisection
-	// method (perhaps some other method later).
-
-	double high = 0, low = 1;
-	double f_low = -1000;
-
-	for (const auto & ftt: functions_to_test) {
-		high = std::max(high, (double)ftt.size());
-	}
-
-	for (int iter = 0; iter < 100; ++iter) {
-
-		double mid = round((high + low) * 0.5);
-
-		std::vector<std::vector<algo_t> > reduced_functions_to_test =
-			reduce_num_algorithms(functions_to_test, mid);
-
-		// Found a small enough range to conclude.
-		if (round(high) - round(mid) < 1) {
-			std::cout << "mid is " << mid << std::endl;
-			tester.set_algorithms(functions_to_test);
-			return reduced_functions_to_test;
-		}
-
-		tester.set_algorithms(reduced_functions_to_test);
-
-		progress = get_progress(time_limit, tester);
-
-		std::cout << "iter " << iter << ", progress " << progress << " mid " << mid
-			<< std::endl;
-
-		// We want progress to be 1. Bisection search finds the root, i.e.
-		// where y = 0, so we subtract to adjust.
-		// Furthermore, we want y to be negative for low values and
-		// positive for high ones. (Is that necessary?)
-		double y = 1 - progress;
-
-		if (fabs(y) < tolerance) {
-			// Found the correct size sample.
-			std::cout << "mid is " << mid << std::endl;
-			tester.set_algorithms(functions_to_test);
-			return reduced_functions_to_test;
-		}
-
-		if (sign(y) == sign(f_low)) {
-			low = mid;
-			f_low = y;
-		} else {
-			high = mid;
-		}
-	}
-
-	throw std::runtime_error("Did not find the correct number of algorithms"
-		" to finish search in time");
-}
+// The search itself, and the local searches that decide what order to
+// check the test groups in, are in backtracker.h.
 
 void print_group_order(const std::list<size_t> & group_order) {
 	std::cout << "group_order = [";
@@ -240,6 +240,7 @@ double custom_function::evaluate(std::vector<double> & stack,
 // I tried exceptions, but it's too slow. We return NaN on error.
 double custom_function::evaluate_function(
 	const std::vector<custom_funct_atom> & function,
+	std::vector<double> & funct_stack,
 	const std::vector<double> & input_values, bool reject_large_stack,
 	bool generous_to_asymptotes) const {
 
@@ -291,15 +292,25 @@ custom_function::custom_function(bool generous_in) {
 
 double custom_function::evaluate(const std::vector<double> & input_values,
 	bool reject_large_stack, bool generous_to_asymptotes) const {
+	// The stack is kept between calls so it doesn't have to be
+	// allocated every time, but there's one per thread so that the
+	// function can be evaluated by several threads at once.
+	static thread_local std::vector<double> funct_stack;
+
 	funct_stack.clear();
-	return (evaluate_function(our_function, input_values,
+	return (evaluate_function(our_function, funct_stack, input_values,
 				reject_large_stack, generous_to_asymptotes));
 }
 
 double custom_function::evaluate(const std::vector<double> & input_values,
 	bool reject_large_stack) const {
+	// The stack is kept between calls so it doesn't have to be
+	// allocated every time, but there's one per thread so that the
+	// function can be evaluated by several threads at once.
+	static thread_local std::vector<double> funct_stack;
+
 	funct_stack.clear();
-	return (evaluate_function(our_function, input_values,
+	return (evaluate_function(our_function, funct_stack, input_values,
 				reject_large_stack, is_generous_to_asymptotes));
 }
 
@@ -314,7 +325,7 @@ bool custom_function::update_suitability(const custom_function &
 	std::map<std::vector<double>, unsigned long long> &
 	results_already_seen) const {
 
-	test_results.resize(test_in_vectors.size());
+	std::vector<double> test_results(test_in_vectors.size());
 	size_t i;
 
 	//std::cout << "Cardinal suitability" << std::endl;
@@ -87,8 +87,6 @@ enum custom_funct_atom {
 class custom_function {
 	private:
 		std::vector<custom_funct_atom> our_function;
-		mutable std::vector<double> funct_stack;
-		mutable std::vector<double> test_results;
 
 		const double blancmange_order = 0.67;
 		bool is_generous_to_asymptotes;
@@ -112,6 +110,7 @@ class custom_function {
 			const std::vector<double> & input_values,
 			bool generous_to_asymptotes) const;
 		double evaluate_function(const std::vector<custom_funct_atom> & function,
+			std::vector<double> & funct_stack,
 			const std::vector<double> & input_values,
 			bool reject_large_stack, bool generous_to_asymptotes) const;
 		bool update_suitability(const custom_function & funct_to_test,
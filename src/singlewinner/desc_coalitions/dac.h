@@ -34,12 +34,12 @@
 class dac : public desc_coalition_method {
 
 	protected:
-		std::vector<coalition_data> get_coalitions(
+		std::vector<coalition_mask_data> get_coalitions(
 			const election_t & election,
 			const std::vector<bool> & hopefuls,
 			int numcands) const {
 
-			return get_acquiescing_coalitions(election,
+			return get_acquiescing_coalition_masks(election,
 					hopefuls, numcands);
 		}
 
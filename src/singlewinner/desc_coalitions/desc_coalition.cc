@@ -1,51 +1,57 @@
 #include "desc_coalition.h"
 #include <vector>
 
-void desc_coalition_method::sort_by_candidate(
-	std::vector<coalition_data> & coalitions, int candidate) const {
+// Coalitions of equal support are ordered so that those containing the
+// candidate come first, which breaks ties in the candidate's favor. Rather
+// than sorting the coalitions again for every candidate, we go through
+// each run of equal support twice: first for the coalitions that contain
+// the candidate, then for the ones that don't.
 
-	for (size_t i = 0; i < coalitions.size(); ++i) {
-		coalitions[i].priority_candidate = candidate;
-	}
+bool desc_coalition_method::can_candidate_win(
+	const std::vector<coalition_mask_data> & coalitions,
+	const coalition_mask & starting_candidate_set,
+	size_t candidate) const {
 
-	std::sort(coalitions.begin(), coalitions.end(),
-		std::greater<coalition_data>());
-}
+	coalition_mask coalition_so_far = starting_candidate_set;
 
-bool desc_coalition_method::can_candidate_win(
-	std::vector<coalition_data> & coalitions,
-	const std::set<size_t> & starting_candidate_set,
-	int candidate, int num_candidates) const {
+	size_t run_start, run_end;
 
-	sort_by_candidate(coalitions, candidate);
+	for (run_start = 0; run_start < coalitions.size(); run_start = run_end) {
+		run_end = run_start;
+		while (run_end < coalitions.size() && coalitions[run_end].support ==
+			coalitions[run_start].support) {
+			++run_end;
+		}
 
-	std::set<size_t> coalition_so_far = starting_candidate_set;
+		for (bool containing: {true, false}) {
+			for (size_t i = run_start; i < run_end; ++i) {
+				const coalition_mask & coalition = coalitions[i].coalition;
 
-	for (std::vector<coalition_data>::const_iterator pos = coalitions.begin();
-		pos != coalitions.end(); ++pos) {
+				if (coalition.test(candidate) != containing) {
+					continue;
+				}
 
-		std::set<size_t> test_intersection;
+				coalition_mask test_intersection = coalition_so_far &
+					coalition;
+				size_t intersection_size = test_intersection.count();
 
-		std::set_intersection(coalition_so_far.begin(), coalition_so_far.end(),
-			pos->coalition.begin(), pos->coalition.end(),
-			std::inserter(test_intersection, test_intersection.end()));
+				// If it's empty, skip.
+				if (intersection_size == 0) {
+					continue;
+				}
 
-		// If it's empty, skip.
-		if (test_intersection.size() == 0) {
-			continue;
-		}
+				// If there's only one candidate left, return true if that
+				// candidate is the specified candidate, false otherwise.
+				if (intersection_size == 1) {
+					return (test_intersection.test(candidate));
+				}
 
-		// If there's only one candidate left, return true if that candidate
-		// is the specified candidate, false otherwise.
-		if (test_intersection.size() == 1) {
-			return (test_intersection.find(candidate) !=
-					test_intersection.end());
+				coalition_so_far = test_intersection;
+			}
 		}
-
-		coalition_so_far = test_intersection;
 	}
 
-	return (coalition_so_far.find(candidate) != coalition_so_far.end());
+	return (coalition_so_far.test(candidate));
 }
 
 std::pair<ordering, bool> desc_coalition_method::elect_inner(
@@ -58,16 +64,7 @@ std::pair<ordering, bool> desc_coalition_method::elect_inner(
 
 	// Get the coalitions corresponding to this ballot group.
 
-	std::map<std::set<size_t>, double> coalition_count;
-	std::set<size_t> current_coalition, all_candidates;
-
-	for (int i = 0; i < num_candidates; ++i) {
-		if (hopefuls[i]) {
-			all_candidates.insert(i);
-		}
-	}
-
-	std::vector<coalition_data> coalitions = get_coalitions(papers,
+	std::vector<coalition_mask_data> coalitions = get_coalitions(papers,
 			hopefuls, num_candidates);
 
 	ordering outcome;
@@ -83,29 +80,30 @@ std::pair<ordering, bool> desc_coalition_method::elect_inner(
 	// Unknown_candidates are the candidates we don't know the rank of yet.
 	// Revealed_candidates are the candidates we've revealed during that
 	// turn.
-	std::set<size_t> unknown_candidates = all_candidates,
-					 revealed_candidates;
+	coalition_mask unknown_candidates, revealed_candidates;
 	int rank_score = num_candidates;
+	int cand;
 
-	std::set<size_t>::const_iterator pos;
-
-	while (!unknown_candidates.empty()) {
-		revealed_candidates.clear();
-		for (pos = unknown_candidates.begin(); pos !=
-			unknown_candidates.end(); ++pos) {
+	for (cand = 0; cand < num_candidates; ++cand) {
+		if (hopefuls[cand]) {
+			unknown_candidates.set(cand);
+		}
+	}
 
-			if (can_candidate_win(coalitions, unknown_candidates, *pos,
-					num_candidates)) {
+	while (unknown_candidates.any()) {
+		revealed_candidates.reset();
+		for (cand = 0; cand < num_candidates; ++cand) {
+			if (!unknown_candidates.test(cand)) {
+				continue;
+			}
 
-				outcome.insert(candscore(*pos, rank_score));
-				revealed_candidates.insert(*pos);
+			if (can_candidate_win(coalitions, unknown_candidates, cand)) {
+				outcome.insert(candscore(cand, rank_score));
+				revealed_candidates.set(cand);
 			}
 		}
 
-		for (pos = revealed_candidates.begin();
-			pos != revealed_candidates.end(); ++pos) {
-			unknown_candidates.erase(*pos);
-		}
+		unknown_candidates &= ~revealed_candidates;
 
 		--rank_score;
 
@@ -113,9 +111,10 @@ std::pair<ordering, bool> desc_coalition_method::elect_inner(
 		// non-winners as equal last.
 		if (winner_only) {
 
-			for (pos = unknown_candidates.begin(); pos !=
-				unknown_candidates.end(); ++pos) {
-				outcome.insert(candscore(*pos, rank_score));
+			for (cand = 0; cand < num_candidates; ++cand) {
+				if (unknown_candidates.test(cand)) {
+					outcome.insert(candscore(cand, rank_score));
+				}
 			}
 
 			return (std::pair<ordering, bool>(outcome, winner_only));
@@ -1,9 +1,8 @@
 #pragma once
 
-// A general superstructure for descending coalitions methods. Currently the
-// only such method implemented is descending solid coalitions, but this
-// ABC should make it easy to extend to DAC or HDSC later once the
-// algorithm itself has been coded.
+// A general superstructure for descending coalitions methods: Descending
+// Solid Coalitions and Descending Acquiescing Coalitions so far. HDSC could
+// be added later once the algorithm itself has been coded.
 
 #include "../method.h"
 #include "coalitions/coalitions.h"
@@ -11,15 +10,14 @@
 class desc_coalition_method : public election_method {
 
 	private:
-		void sort_by_candidate(
-			std::vector<coalition_data> & coalitions,
-			int candidate) const;
-		bool can_candidate_win(std::vector<coalition_data> & coalitions,
-			const std::set<size_t> & starting_candidate_set,
-			int candidate, int num_candidates) const;
+		bool can_candidate_win(
+			const std::vector<coalition_mask_data> & coalitions,
+			const coalition_mask & starting_candidate_set,
+			size_t candidate) const;
 
 	protected:
-		virtual std::vector<coalition_data> get_coalitions(
+		// The coalitions must be sorted by descending support.
+		virtual std::vector<coalition_mask_data> get_coalitions(
 			const election_t & election,
 			const std::vector<bool> & hopefuls,
 			int numcands) const = 0;
@@ -32,4 +30,4 @@ class desc_coalition_method : public election_method {
 			bool winner_only) const;
 
 		virtual std::string name() const = 0;
-};
\ No newline at end of file
+};
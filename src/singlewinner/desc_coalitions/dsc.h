@@ -62,12 +62,12 @@
 class dsc : public desc_coalition_method {
 
 	protected:
-		std::vector<coalition_data> get_coalitions(
+		std::vector<coalition_mask_data> get_coalitions(
 			const election_t & election,
 			const std::vector<bool> & hopefuls,
 			int numcands) const {
 
-			return get_solid_coalitions(election,
+			return get_solid_coalition_masks(election,
 					hopefuls, numcands);
 		}
 
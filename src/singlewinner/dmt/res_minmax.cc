@@ -28,11 +28,11 @@ void res_minmax::explore_paths(
 
 	/*size_t root = chain_members[0],
 		   last = *chain_members.rbegin();*/
-	size_t num_subelections = se.hopeful_power_set.size();
+	size_t num_subelections = se.num_subelections();
 
 	for (size_t se_idx = 0; se_idx < num_subelections; ++se_idx) {
 		// If leaf isn't in it, then it's not interesting.
-		if (!se.hopeful_power_set[se_idx][leaf]) {
+		if (!se.contains(se_idx, leaf)) {
 			continue;
 		}
 
@@ -42,7 +42,7 @@ void res_minmax::explore_paths(
 		size_t earliest_chain_idx = 0;
 
 		for (size_t i = 0; i < chain_members.size() && !found_candidate; ++i) {
-			if (se.hopeful_power_set[se_idx][chain_members[i]]) {
+			if (se.contains(se_idx, chain_members[i])) {
 				earliest_chain_idx = i;
 				found_candidate = true;
 			}
@@ -63,8 +63,8 @@ void res_minmax::explore_paths(
 
 			size_t chain_cand = chain_members[chain_cand_idx];
 
-			all_members &= se.hopeful_power_set[se_idx][chain_cand];
-			combined_first_prefs += se.first_pref_scores[se_idx][chain_cand];
+			all_members &= se.contains(se_idx, chain_cand);
+			combined_first_prefs += se.get_first_prefs(se_idx, chain_cand);
 			++seen_candidates;
 
 			if (!all_members) {
@@ -221,11 +221,11 @@ void res_minmax::set_path_strengths(
 			"explore_paths: Chain must contain root!");
 	}
 
-	size_t num_subelections = se.hopeful_power_set.size();
+	size_t num_subelections = se.num_subelections();
 
 	for (size_t se_idx = 0; se_idx < num_subelections; ++se_idx) {
 		// If leaf isn't in it, then it's not interesting.
-		if (!se.hopeful_power_set[se_idx][leaf]) {
+		if (!se.contains(se_idx, leaf)) {
 			continue;
 		}
 
@@ -235,7 +235,7 @@ void res_minmax::set_path_strengths(
 		size_t earliest_chain_idx = 0;
 
 		for (size_t i = 0; i < chain_members.size() && !found_candidate; ++i) {
-			if (se.hopeful_power_set[se_idx][chain_members[i]]) {
+			if (se.contains(se_idx, chain_members[i])) {
 				earliest_chain_idx = i;
 				found_candidate = true;
 			}
@@ -256,8 +256,8 @@ void res_minmax::set_path_strengths(
 
 			size_t chain_cand = chain_members[chain_cand_idx];
 
-			all_members &= se.hopeful_power_set[se_idx][chain_cand];
-			combined_first_prefs += se.first_pref_scores[se_idx][chain_cand];
+			all_members &= se.contains(se_idx, chain_cand);
+			combined_first_prefs += se.get_first_prefs(se_idx, chain_cand);
 			++seen_candidates;
 
 			if (!all_members) {
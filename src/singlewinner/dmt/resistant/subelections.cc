@@ -1,7 +1,87 @@
 #include "subelections.h"
 
-// TODO: Ignore exhausted ballots (as the definition states) instead of
-// fractionally attributing them to every candidate.
+#include <algorithm>
+#include <stdexcept>
+
+// The first preferences are counted as fractional Plurality would:
+// exhausted ballots count for nobody, and if a ballot ranks k candidates
+// of the subelection equal first, each of them gets 1/k of its weight.
+
+disqual_tensor::disqual_tensor(size_t num_levels, size_t num_candidates_in,
+	bool value) {
+
+	num_candidates = num_candidates_in;
+	rows.resize(num_levels * num_candidates, value ? ~(candidate_mask)0 : 0);
+}
+
+// Add the ballot's first preferences to every subelection. top_rank[idx]
+// is the best rank (counting equal-rank groups from the top) of any member
+// of subelection idx on this ballot, which we can get from the best rank
+// of the same subelection minus its lowest-numbered bit.
+
+void subelections::add_ballot(const ballot_group & ballot,
+	const std::vector<size_t> & hopeful_list) {
+
+	const uint8_t NOT_RANKED = UINT8_MAX;
+
+	size_t num_hopefuls = hopeful_list.size(),
+		   num_sets = hopeful_power_set.size();
+
+	std::vector<uint8_t> rank(num_candidates, NOT_RANKED);
+	std::vector<candidate_mask> rank_members;
+
+	double last_score = 0;
+
+	for (const candscore & cs: ballot.contents) {
+		if (!included_candidates[cs.get_candidate_num()]) {
+			continue;
+		}
+
+		if (rank_members.empty() || cs.get_score() != last_score) {
+			rank_members.push_back(0);
+			last_score = cs.get_score();
+		}
+
+		rank[cs.get_candidate_num()] = rank_members.size() - 1;
+		rank_members.back() |= (candidate_mask)1 << cs.get_candidate_num();
+	}
+
+	if (rank_members.empty()) {
+		return;
+	}
+
+	double weight = ballot.get_weight();
+
+	top_rank.resize(num_sets);
+	top_rank[0] = NOT_RANKED;
+
+	for (size_t idx = 1; idx < num_sets; ++idx) {
+		size_t lowest = hopeful_list[num_hopefuls - 1 -
+					   __builtin_ctzll(idx)];
+
+		top_rank[idx] = std::min(top_rank[idx & (idx-1)], rank[lowest]);
+
+		if (top_rank[idx] == NOT_RANKED) {
+			continue;
+		}
+
+		candidate_mask first = hopeful_power_set[idx] &
+			rank_members[top_rank[idx]];
+		double * scores = first_pref_scores.data() + idx * num_candidates;
+
+		// Usually there's only one first preference.
+		if ((first & (first-1)) == 0) {
+			scores[__builtin_ctzll(first)] += weight;
+			continue;
+		}
+
+		double value = weight / (double)__builtin_popcountll(first);
+
+		for (; first != 0; first &= first-1) {
+			scores[__builtin_ctzll(first)] += value;
+		}
+	}
+}
 
 void subelections::count_subelections(
 	const election_t & papers,
@@ -10,62 +90,93 @@ void subelections::count_subelections(
 
 	included_candidates = hopefuls;
 	num_candidates = hopefuls.size();
-	hopeful_power_set =	power_set(hopefuls);
 
-	// Create a vector of first preference scores for every possible
-	// way to eliminate hopeful candidates. The accompanying num_candidates
-	// gives the cardinality of the set, i.e. the number of remaining
-	// hopefuls, so we can calculate the 1/n threshold. We also have a sum
-	// of first preferences to deal with equal rank/exhausted ballots.
+	std::vector<size_t> hopeful_list;
 
-	first_pref_scores.clear();
-	num_remaining_candidates.clear();
-	num_remaining_voters.clear();
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		if (hopefuls[cand]) {
+			hopeful_list.push_back(cand);
+		}
+	}
 
-	for (const std::vector<bool> & candidate_selection: hopeful_power_set) {
+	if (num_candidates > 64 || hopeful_list.size() >= 64) {
+		throw std::invalid_argument("count_subelections: can't handle "
+			"more than 64 candidates");
+	}
 
-		int num_remaining_candidates_here = 0;
+	// Enumerate the subelections in power_set() order, i.e. counting in
+	// binary with the first hopeful as the most significant bit.
 
-		for (size_t i = 0; i < candidate_selection.size(); ++i) {
-			if (candidate_selection[i]) {
-				++num_remaining_candidates_here;
-			}
-		}
+	size_t num_hopefuls = hopeful_list.size(),
+		   num_sets = (size_t)1 << num_hopefuls;
+
+	hopeful_power_set.resize(num_sets);
+	num_remaining_candidates.resize(num_sets);
+	hopeful_power_set[0] = 0;
+	num_remaining_candidates[0] = 0;
+
+	for (size_t idx = 1; idx < num_sets; ++idx) {
+		size_t lowest = hopeful_list[num_hopefuls - 1 -
+					   __builtin_ctzll(idx)];
+
+		hopeful_power_set[idx] = hopeful_power_set[idx & (idx-1)] |
+			(candidate_mask)1 << lowest;
+		num_remaining_candidates[idx] =
+			__builtin_popcountll(hopeful_power_set[idx]);
+	}
+
+	first_pref_scores.assign(num_sets * num_candidates, 0);
+
+	for (const ballot_group & ballot: papers) {
+		add_ballot(ballot, hopeful_list);
+	}
+
+	// Apply the tiebreak and sum up the number of continuing voters.
+	// We sum in the order that Plurality's output ordering would list
+	// the candidates (best first), so that the results are exactly
+	// the same as when each subelection was counted separately.
+
+	num_remaining_voters.resize(num_sets);
+	std::vector<std::pair<double, size_t> > social_order;
+
+	for (size_t idx = 0; idx < num_sets; ++idx) {
+		double * scores = first_pref_scores.data() + idx * num_candidates;
+
+		social_order.clear();
 
-		ordering plur_outcome;
+		for (candidate_mask members = hopeful_power_set[idx];
+			members != 0; members &= members-1) {
 
-		if (num_remaining_candidates_here > 0) {
-			plur_outcome = plurality_method.elect(papers,
-					candidate_selection, num_candidates, NULL, false);
+			size_t cand = __builtin_ctzll(members);
+			social_order.push_back(std::pair<double, size_t>(
+					scores[cand], cand));
 		}
 
-		std::vector<double> first_prefs_this_selection(
-			num_candidates, 0);
+		std::sort(social_order.begin(), social_order.end(),
+			std::greater<std::pair<double, size_t> >());
+
 		double num_remaining_voters_here = 0;
 
-		for (const candscore & cand_and_score: plur_outcome) {
-			assert(cand_and_score.get_candidate_num() < (size_t)num_candidates);
+		for (const std::pair<double, size_t> & cand_and_score:
+			social_order) {
 
-			double score = cand_and_score.get_score();
+			double score = cand_and_score.first;
+			size_t cand = cand_and_score.second;
 
 			if (tiebreak) {
-				score += 1e-6 * score * cand_and_score.get_candidate_num() *
-					num_candidates;
+				score += 1e-6 * score * cand * num_candidates;
 			}
 
-			first_prefs_this_selection[cand_and_score.get_candidate_num()] =
-				score;
+			scores[cand] = score;
 			num_remaining_voters_here += score;
 		}
 
-		first_pref_scores.push_back(first_prefs_this_selection);
-		num_remaining_candidates.push_back(num_remaining_candidates_here);
-		num_remaining_voters.push_back(num_remaining_voters_here);
+		num_remaining_voters[idx] = num_remaining_voters_here;
 	}
 }
 
 // Determine the disqualification relation for each level of set
-// cardinality. disqualifies[i][a][b] gives whether a ~> b when
+// cardinality. disqualifies.get(i, a, b) gives whether a ~> b when
 // considering subelections of i members or fewer.
 
 // TODO? Handle higher levels with hopefuls... e.g. suppose
@@ -77,9 +188,15 @@ disqual_tensor subelections::get_level_disqualifications(
 
 	size_t numcands = hopefuls.size(), num_levels = numcands + 1;
 
-	std::vector<std::vector<std::vector<bool> > > disqualifies(
-		num_levels, std::vector<std::vector<bool> >(numcands,
-			std::vector<bool>(numcands, true)));
+	disqual_tensor disqualifies(num_levels, numcands, true);
+
+	candidate_mask hopeful_mask = 0;
+
+	for (size_t cand = 0; cand < numcands; ++cand) {
+		if (hopefuls[cand]) {
+			hopeful_mask |= (candidate_mask)1 << cand;
+		}
+	}
 
 	// For zero and one-candidate sets, it's impossible to get
 	// two candidates into the set, so the disqualification relation
@@ -88,33 +205,33 @@ disqual_tensor subelections::get_level_disqualifications(
 	// and B. This makes every pair on level zero (even non-hopefuls)
 	// true, and every pair except A~>A true on level one.
 
-	size_t level, cand, against;
+	size_t level, cand;
 	for (level = 1; level < num_levels; ++level) {
 		for (cand = 0; cand < numcands; ++cand) {
 			if (!hopefuls[cand]) {
-				for (against = 0; against < numcands; ++against) {
-					disqualifies[level][cand][against] = false;
-				}
+				disqualifies.row(level, cand) = 0;
 				continue;
 			}
-			disqualifies[level][cand][cand] = false;
+			disqualifies.set(level, cand, cand, false);
 		}
 	}
 
 	// Go through every subelection and candidate pair, and see if the
-	// former disqualifies the latter. If not, set disqualifies
+	// former disqualifies the latter. If not, clear the disqualification
+	// of everybody else in the subelection at once. (Clearing A~>A too
+	// doesn't matter, because it's already false.)
 
-	for (size_t subelection = 0; subelection < first_pref_scores.size();
+	for (size_t subelection = 0; subelection < num_subelections();
 		++subelection) {
 
-		for (cand = 0; cand < numcands; ++cand) {
-			if (!hopeful_power_set[subelection][cand]) {
-				continue;
-			}
+		candidate_mask members = hopeful_power_set[subelection];
+
+		for (candidate_mask left = members; left != 0; left &= left-1) {
+			cand = __builtin_ctzll(left);
 
 			// The candidate's first prefs
 			size_t numcands_here = num_remaining_candidates[subelection];
-			double cand_fpp = first_pref_scores[subelection][cand];
+			double cand_fpp = get_first_prefs(subelection, cand);
 
 			// For A ~> B to still hold, we need
 			// fpA_S > numvoters/numcands_here, i.e.
@@ -123,17 +240,7 @@ disqual_tensor subelections::get_level_disqualifications(
 				continue;
 			}
 
-			for (against = 0; against < numcands; ++against) {
-				if (cand == against) {
-					continue;
-				}
-
-				if (!hopeful_power_set[subelection][against]) {
-					continue;
-				}
-
-				disqualifies[numcands_here][cand][against] = false;
-			}
+			disqualifies.row(numcands_here, cand) &= ~members;
 		}
 	}
 
@@ -153,16 +260,11 @@ disqual_tensor subelections::get_level_disqualifications(
 			continue;
 		}
 
-		for (against = 0; against < numcands; ++against) {
-			if (!hopefuls[against] || cand == against) {
-				continue;
-			}
+		candidate_mask others = hopeful_mask & ~((candidate_mask)1 << cand);
 
-			for (level = 1; level < num_levels; ++level) {
-				if (!disqualifies[level-1][cand][against]) {
-					disqualifies[level][cand][against] = false;
-				}
-			}
+		for (level = 1; level < num_levels; ++level) {
+			disqualifies.row(level, cand) &=
+				disqualifies.row(level-1, cand) | ~others;
 		}
 	}
 
@@ -171,25 +273,23 @@ disqual_tensor subelections::get_level_disqualifications(
 
 void subelections::print_subelection_counts() const {
 
-	size_t num_subelections = hopeful_power_set.size();
-
-	for (size_t i = 0; i < num_subelections; ++i) {
+	for (size_t i = 0; i < num_subelections(); ++i) {
 		std::cout << "Subelection " << i << " contains { ";
 		size_t j;
 
-		for (j = 0; j < hopeful_power_set[i].size(); ++j) {
-			if (hopeful_power_set[i][j]) {
+		for (j = 0; j < num_candidates; ++j) {
+			if (contains(i, j)) {
 				std::cout << j << " ";
 			}
 		}
 		std::cout << "}\n";
 
-		for (j = 0; j < hopeful_power_set[i].size(); ++j) {
-			if (!hopeful_power_set[i][j]) {
+		for (j = 0; j < num_candidates; ++j) {
+			if (!contains(i, j)) {
 				continue;
 			}
 			std::cout << "fp(" << j <<"): " <<
-				first_pref_scores[i][j] << "\n";
+				get_first_prefs(i, j) << "\n";
 		}
 		std::cout << "\n";
 	}
@@ -217,12 +317,12 @@ condmat subelection_tools::get_defeating_matrix(
 				continue;
 			}
 
-			if (beats[level][candidate][challenger]) {
+			if (beats.get(level, candidate, challenger)) {
 				matrix.add(candidate, challenger, 1);
 				matrix.add(challenger, candidate, 0);
 			}
 
-			if (beats[level][challenger][candidate]) {
+			if (beats.get(level, challenger, candidate)) {
 				matrix.add(candidate, challenger, 0);
 				matrix.add(challenger, candidate, 1);
 			}
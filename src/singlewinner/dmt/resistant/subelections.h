@@ -3,19 +3,77 @@
 #include "singlewinner/positional/simple_methods.h"
 #include "pairwise/matrix.h"
 
+#include <stdint.h>
+
 // A subelection, given by a set S, is an election with every candidate not
 // in S eliminated. This class counts the first preferences for every
 // subelection of a given election. The first preference information is used
 // in resistant set-based methods to determine or elect from the resistant set.
 
-// beats[k][x][y] is true iff candidate x disqualifies y on
-// every set of cardinality k and less.
+// Sets of candidates are stored as bitmasks, with bit x set if candidate x
+// is in the set; so there can be at most 64 candidates. (The power set of
+// even half as many would be far too large to enumerate anyway.)
+
+typedef uint64_t candidate_mask;
+
+// beats.get(k, x, y) is true iff candidate x disqualifies y on
+// every set of cardinality k and less. Each (k, x) row is stored as a
+// candidate_mask of the candidates y that x disqualifies.
+
+class disqual_tensor {
+	private:
+		size_t num_candidates;
+		std::vector<candidate_mask> rows;
+
+	public:
+		candidate_mask & row(size_t level, size_t from) {
+			return rows[level * num_candidates + from];
+		}
+
+		candidate_mask row(size_t level, size_t from) const {
+			return rows[level * num_candidates + from];
+		}
+
+		bool get(size_t level, size_t from, size_t to) const {
+			return (row(level, from) >> to) & 1;
+		}
+
+		void set(size_t level, size_t from, size_t to, bool value) {
+			if (value) {
+				row(level, from) |= (candidate_mask)1 << to;
+			} else {
+				row(level, from) &= ~((candidate_mask)1 << to);
+			}
+		}
 
-typedef std::vector<std::vector<std::vector<bool> > > disqual_tensor;
+		size_t get_num_levels() const {
+			if (num_candidates == 0) {
+				return 0;
+			}
+			return rows.size() / num_candidates;
+		}
+
+		size_t get_num_candidates() const {
+			return num_candidates;
+		}
+
+		disqual_tensor() {
+			num_candidates = 0;
+		}
+
+		// Every (level, x, y) entry starts off as value.
+		disqual_tensor(size_t num_levels, size_t num_candidates_in,
+			bool value);
+};
 
 class subelections {
 	private:
-		plurality plurality_method;
+		// Scratch space for count_subelections, so that the memory
+		// can be reused from one count to the next.
+		std::vector<uint8_t> top_rank;
+
+		void add_ballot(const ballot_group & ballot,
+			const std::vector<size_t> & hopeful_list);
 
 	public:
 		// The hopeful power set lists the candidates included in each
@@ -23,10 +81,11 @@ class subelections {
 		// preferences, and the num_remaining_candidates and num_remaining
 		// voters vectors list how many candidates are included in the
 		// subelection and how many continuing (non-exhausted) voters are
-		// involved.
+		// involved. first_pref_scores is flattened: use get_first_prefs
+		// to access it.
 
-		std::vector<std::vector<bool > > hopeful_power_set;
-		std::vector<std::vector<double> > first_pref_scores;
+		std::vector<candidate_mask> hopeful_power_set;
+		std::vector<double> first_pref_scores;
 		std::vector<int> num_remaining_candidates;
 		std::vector<double> num_remaining_voters;
 
@@ -34,16 +93,39 @@ class subelections {
 		std::vector<bool> included_candidates;
 		size_t num_candidates; // including already eliminated (non-hopefuls)
 
+		size_t num_subelections() const {
+			return hopeful_power_set.size();
+		}
+
+		bool contains(size_t subelection, size_t candidate) const {
+			return (hopeful_power_set[subelection] >> candidate) & 1;
+		}
+
+		double get_first_prefs(size_t subelection, size_t candidate) const {
+			return first_pref_scores[subelection * num_candidates +
+					candidate];
+		}
+
 		// Determine the subelection first-preference counts for
 		// the given election. If tiebreak is true, add a small
 		// value to lower-numbered candidates so that true ties
 		// never occur. (Doing so breaks neutrality.)
+
+		// The subelections are in the same order as power_set()
+		// would give, and the counts are the same as fractional
+		// Plurality would give on each, except that a one-candidate
+		// subelection gets its actual first preference count instead
+		// of a score of one. (Both satisfy the 1/n threshold with
+		// equality, so this changes no disqualifications.) But rather
+		// than running Plurality 2^n times, we go through each ballot
+		// once and find its first preference in every subelection,
+		// which takes constant time per subelection.
 		void count_subelections(const election_t & papers,
 			const std::vector<bool> & hopefuls,
 			bool tiebreak);
 
 		// Determine the disqualification relation for each level
-		// of set cardinality. disqualifies[i][a][b] gives whether
+		// of set cardinality. disqualifies.get(i, a, b) gives whether
 		// a ~> b when considering subelections of i members or
 		// fewer (cumulative) or subelections of exactly i members
 		// (not cumulative).
@@ -51,10 +133,6 @@ class subelections {
 			const std::vector<bool> & hopefuls,
 			bool cumulative) const;
 
-		// I'm not sure which is better; IFPP Method X uses
-		// whole, and this uses fractional. Probably fractional.
-		subelections() : plurality_method(PT_FRACTIONAL) {}
-
 		void print_subelection_counts() const;
 };
 
@@ -0,0 +1,94 @@
+// Check that the subelection counts are what fractional Plurality gives
+// when run on each subelection separately.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "singlewinner/dmt/resistant/subelections.h"
+#include "tools/tools.h"
+
+TEST(Subelections, MatchesPluralityOnEachSubelection) {
+	size_t num_candidates = 6;
+	plurality plurality_method(PT_FRACTIONAL);
+
+	rng randomizer(0);
+
+	for (int trial = 0; trial < 5; ++trial) {
+		election_t election = get_random_election(num_candidates, 30, 3,
+				true, true, randomizer);
+
+		std::vector<bool> hopefuls(num_candidates, true);
+		if (trial % 2 == 1) {
+			hopefuls[trial % num_candidates] = false;
+		}
+
+		subelections se;
+		se.count_subelections(election, hopefuls, false);
+
+		std::vector<std::vector<bool> > expected_sets = power_set(hopefuls);
+		ASSERT_EQ(se.num_subelections(), expected_sets.size());
+
+		for (size_t idx = 0; idx < expected_sets.size(); ++idx) {
+			size_t members = 0;
+			double voters = 0;
+
+			for (size_t cand = 0; cand < num_candidates; ++cand) {
+				EXPECT_EQ(se.contains(idx, cand), expected_sets[idx][cand]);
+				members += expected_sets[idx][cand];
+			}
+
+			EXPECT_EQ(se.num_remaining_candidates[idx], (int)members);
+
+			if (members == 0) {
+				EXPECT_EQ(se.num_remaining_voters[idx], 0);
+				continue;
+			}
+
+			// election_method::elect gives a single hopeful a score
+			// of one, so we can't compare against it there.
+			if (members == 1) {
+				continue;
+			}
+
+			ordering outcome = plurality_method.elect(election,
+					expected_sets[idx], num_candidates, NULL, false);
+
+			for (const candscore & cs: outcome) {
+				EXPECT_EQ(se.get_first_prefs(idx, cs.get_candidate_num()),
+					cs.get_score());
+				voters += cs.get_score();
+			}
+
+			EXPECT_EQ(se.num_remaining_voters[idx], voters);
+		}
+	}
+}
+
+TEST(Subelections, DisqualificationsAreCumulative) {
+	size_t num_candidates = 5;
+	std::vector<bool> hopefuls(num_candidates, true);
+
+	rng randomizer(1);
+
+	subelections se;
+	se.count_subelections(get_random_election(num_candidates, 30, 3, true,
+			true, randomizer), hopefuls, true);
+
+	disqual_tensor exact = se.get_level_disqualifications(hopefuls, false),
+				   cumulative = se.get_level_disqualifications(hopefuls, true);
+
+	ASSERT_EQ(cumulative.get_num_levels(), num_candidates + 1);
+
+	for (size_t a = 0; a < num_candidates; ++a) {
+		for (size_t b = 0; b < num_candidates; ++b) {
+			bool all_so_far = true;
+
+			for (size_t level = 0; level <= num_candidates; ++level) {
+				all_so_far &= exact.get(level, a, b);
+				EXPECT_EQ(cumulative.get(level, a, b), all_so_far);
+			}
+		}
+	}
+}
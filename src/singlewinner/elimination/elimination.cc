@@ -1,4 +1,5 @@
 #include "elimination.h"
+#include "incremental.h"
 #include <list>
 
 // Loser-elimination meta-method. This method takes a base method and
@@ -58,11 +59,24 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 		}
 	}
 
+	// Pairwise matrix for bottom-two runoff. It's local so that the
+	// same method object can be used from several threads at once.
+	condmat pairwise(CM_PAIRWISE_OPP);
+
 	if (bottom_two_runoff) {
-		pairwise = condmat(CM_PAIRWISE_OPP);
 		pairwise.count_ballots(papers, (size_t)num_candidates);
 	}
 
+	// If the base method is a positional method whose scores only depend
+	// on the first or last preferences, keep the tallies up to date as
+	// candidates are eliminated instead of recounting every round.
+	const positional * pos_base = dynamic_cast<const positional *>(
+			base.get());
+	incremental_tally tally;
+	bool incremental = pos_base != NULL && tally.init(papers, hopefuls,
+			num_candidates, pos_base->get_kind(),
+			pos_base->get_incremental_type());
+
 	int rank = 0;
 
 	bool debug = false;
@@ -85,8 +99,22 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 		}
 
 		// Get the output for the base method.
-		ordering this_round = base->elect(papers, base_hopefuls,
-				num_candidates, cache, false);
+		ordering this_round;
+
+		if (!incremental) {
+			this_round = base->elect(papers, base_hopefuls,
+					num_candidates, cache, false);
+		} else if (tally.get_num_hopefuls() == 1) {
+			// Do what elect() does with a single hopeful.
+			for (counter = 0; counter < (size_t)num_candidates; ++counter) {
+				if (base_hopefuls[counter]) {
+					this_round.insert(candscore(counter, 1));
+				}
+			}
+		} else {
+			this_round = pos_base->pos_elect(tally.get_positional_matrix(),
+					tally.get_num_hopefuls(), base_hopefuls);
+		}
 
 		// Then eliminate and add candidates. If we're using average
 		// elimination, calculate the average and dump all the
@@ -136,6 +164,9 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 						rank++));
 				base_hopefuls[rpos->get_candidate_num()] =
 					false;
+				if (incremental) {
+					tally.eliminate(rpos->get_candidate_num());
+				}
 				++elim_this_round;
 			}
 
@@ -151,6 +182,10 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 
 					output.first.insert(candscore(rpos->get_candidate_num(),
 							rank));
+					if (incremental && base_hopefuls[
+							rpos->get_candidate_num()]) {
+						tally.eliminate(rpos->get_candidate_num());
+					}
 					base_hopefuls[rpos->get_candidate_num()] = false;
 					++elim_this_round;
 				}
@@ -238,6 +273,9 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 
 			assert(base_hopefuls[loser]);
 			base_hopefuls[loser] = false;
+			if (incremental) {
+				tally.eliminate(loser);
+			}
 		}
 
 		// Add the base output to list of previous outputs (for tiebreak
@@ -257,7 +295,7 @@ std::pair<ordering, bool> loser_elimination::elect_inner(const
 
 loser_elimination::loser_elimination(
 	std::shared_ptr<const election_method> base_method,
-	bool average_loser, bool use_first_diff) : pairwise(CM_PAIRWISE_OPP) {
+	bool average_loser, bool use_first_diff) {
 
 	assert(base_method != NULL);
 	base = base_method;
@@ -271,7 +309,7 @@ loser_elimination::loser_elimination(
 loser_elimination::loser_elimination(
 	std::shared_ptr<const election_method> base_method,
 	bool average_loser, bool use_first_diff,
-	bool btr_in) : pairwise(CM_PAIRWISE_OPP) {
+	bool btr_in) {
 
 	assert(base_method != NULL);
 
@@ -25,9 +25,6 @@ class loser_elimination : public election_method {
 	private:
 		std::shared_ptr<const election_method> base;
 
-		// Pairwise matrix for bottom-two runoff.
-		mutable condmat pairwise;
-
 		// If average_loser_elim is true, then all candidates at
 		// or below mean score is eliminated. If not, only the loser
 		// is eliminated.
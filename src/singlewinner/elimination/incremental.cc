@@ -0,0 +1,297 @@
+#include "incremental.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+
+// Integers above this can't all be represented by a double.
+const double EXACT_LIMIT = 9007199254740992.0; // 2^53
+
+bool incremental_tally::init(const election_t & papers,
+	const std::vector<bool> & hopefuls_in, size_t num_candidates_in,
+	positional_type kind, incremental_tally_type type_in) {
+
+	if (type_in == IT_NONE || hopefuls_in.size() != num_candidates_in) {
+		return false;
+	}
+
+	// Check that the tallies will be exact.
+	double total_weight = 0;
+
+	for (const ballot_group & ballot: papers) {
+		if (ballot.get_weight() != floor(ballot.get_weight())) {
+			return false;
+		}
+		total_weight += fabs(ballot.get_weight());
+
+		if (kind == PT_FRACTIONAL) {
+			bool first = true;
+			double last_score = 0;
+			for (const candscore & cs: ballot.contents) {
+				if (!first && cs.get_score() == last_score) {
+					return false;
+				}
+				last_score = cs.get_score();
+				first = false;
+			}
+		}
+	}
+
+	if (total_weight >= EXACT_LIMIT) {
+		return false;
+	}
+
+	type = type_in;
+	num_candidates = num_candidates_in;
+	hopefuls = hopefuls_in;
+	num_hopefuls = std::count(hopefuls.begin(), hopefuls.end(), true);
+
+	ballots.clear();
+	ballots.add_ballots(papers);
+
+	size_t num_ballots = ballots.num_ballots(), ballot;
+
+	group_begin.assign(num_ballots, 0);
+	group_end.assign(num_ballots, 0);
+	group_hopefuls.assign(num_ballots, 0);
+	buckets.assign(num_candidates, std::vector<size_t>());
+	tally.assign(num_candidates, 0);
+
+	if (type == IT_LAST_PREFERENCES) {
+		unranked_hopefuls.assign(num_ballots, num_hopefuls);
+		unranked_by.assign(num_candidates, std::vector<size_t>());
+		ranked_weight.assign(num_candidates, 0);
+
+		std::vector<bool> ranked(num_candidates);
+
+		for (ballot = 0; ballot < num_ballots; ++ballot) {
+			std::fill(ranked.begin(), ranked.end(), false);
+
+			for (size_t entry = ballots.ballot_begin(ballot);
+				entry < ballots.ballot_end(ballot); ++entry) {
+				size_t cand = ballots.get_candidate(entry);
+				if (cand >= num_candidates) {
+					throw std::out_of_range("incremental_tally: Voter "
+						"ranked a candidate greater than number of "
+						"candidates.");
+				}
+				ranked[cand] = true;
+				ranked_weight[cand] += ballots.get_weight(ballot);
+				if (hopefuls[cand]) {
+					--unranked_hopefuls[ballot];
+				}
+			}
+
+			for (size_t cand = 0; cand < num_candidates; ++cand) {
+				if (!ranked[cand] && hopefuls[cand]) {
+					unranked_by[cand].push_back(ballot);
+				}
+			}
+		}
+	}
+
+	// Start from outside the ballot and find the first group.
+	for (ballot = 0; ballot < num_ballots; ++ballot) {
+		if (type == IT_FIRST_PREFERENCES) {
+			group_begin[ballot] = group_end[ballot] =
+				ballots.ballot_begin(ballot);
+		} else {
+			group_begin[ballot] = group_end[ballot] =
+				ballots.ballot_end(ballot);
+		}
+
+		if (find_next_group(ballot) && type == IT_LAST_PREFERENCES) {
+			add_last_contribution(ballot, 1);
+		}
+	}
+
+	return true;
+}
+
+// Sets the ballot's group to the given entries and puts the ballot in the
+// buckets of the hopefuls in it. For first preferences, also adds the
+// ballot's weight to their tallies.
+
+void incremental_tally::set_group(size_t ballot, size_t begin,
+	size_t end) {
+
+	group_begin[ballot] = begin;
+	group_end[ballot] = end;
+	group_hopefuls[ballot] = 0;
+
+	for (size_t entry = begin; entry < end; ++entry) {
+		size_t cand = ballots.get_candidate(entry);
+
+		if (cand >= num_candidates) {
+			throw std::out_of_range("incremental_tally: Voter ranked a "
+				"candidate greater than number of candidates.");
+		}
+
+		if (!hopefuls[cand]) {
+			continue;
+		}
+
+		++group_hopefuls[ballot];
+		buckets[cand].push_back(ballot);
+
+		if (type == IT_FIRST_PREFERENCES) {
+			tally[cand] += ballots.get_weight(ballot);
+		}
+	}
+}
+
+// Moves the ballot's group past the current one: downwards for first
+// preferences and upwards for last. Returns false if there are no hopefuls
+// left in that direction.
+
+bool incremental_tally::find_next_group(size_t ballot) {
+	size_t begin = ballots.ballot_begin(ballot),
+		   end = ballots.ballot_end(ballot), entry;
+
+	if (type == IT_FIRST_PREFERENCES) {
+		for (entry = group_end[ballot]; entry < end &&
+			!hopefuls[ballots.get_candidate(entry)]; ++entry);
+
+		if (entry == end) {
+			group_begin[ballot] = group_end[ballot] = end;
+			group_hopefuls[ballot] = 0;
+			return false;
+		}
+
+		// Include equal-ranked entries on both sides; those above
+		// are eliminated, but including them is harmless.
+		double score = ballots.get_score(entry);
+		size_t group_start = entry, group_stop = entry;
+		while (group_start > begin &&
+			ballots.get_score(group_start-1) == score) {
+			--group_start;
+		}
+		while (group_stop < end && ballots.get_score(group_stop) == score) {
+			++group_stop;
+		}
+
+		set_group(ballot, group_start, group_stop);
+		return true;
+	}
+
+	for (entry = group_begin[ballot]; entry > begin &&
+		!hopefuls[ballots.get_candidate(entry-1)]; --entry);
+
+	if (entry == begin) {
+		group_begin[ballot] = group_end[ballot] = begin;
+		group_hopefuls[ballot] = 0;
+		return false;
+	}
+
+	double score = ballots.get_score(entry-1);
+	size_t group_start = entry-1, group_stop = entry;
+	while (group_start > begin && ballots.get_score(group_start-1) == score) {
+		--group_start;
+	}
+	while (group_stop < end && ballots.get_score(group_stop) == score) {
+		++group_stop;
+	}
+
+	set_group(ballot, group_start, group_stop);
+	return true;
+}
+
+size_t incremental_tally::get_sole_hopeful(size_t ballot) const {
+	for (size_t entry = group_begin[ballot]; entry < group_end[ballot];
+		++entry) {
+		if (hopefuls[ballots.get_candidate(entry)]) {
+			return ballots.get_candidate(entry);
+		}
+	}
+
+	throw std::logic_error("incremental_tally: Ballot has no hopefuls "
+		"in its group");
+}
+
+// A ballot counts against its last hopeful if it ranks every hopeful and
+// that hopeful is alone at the bottom.
+
+void incremental_tally::add_last_contribution(size_t ballot,
+	double sign) {
+
+	if (unranked_hopefuls[ballot] == 0 && group_hopefuls[ballot] == 1) {
+		tally[get_sole_hopeful(ballot)] += sign *
+			ballots.get_weight(ballot);
+	}
+}
+
+void incremental_tally::eliminate(size_t candidate) {
+	if (candidate >= num_candidates || !hopefuls[candidate]) {
+		throw std::invalid_argument("incremental_tally: Trying to "
+			"eliminate a candidate who isn't hopeful");
+	}
+
+	std::vector<size_t> affected;
+	std::swap(affected, buckets[candidate]);
+
+	if (type == IT_FIRST_PREFERENCES) {
+		hopefuls[candidate] = false;
+		--num_hopefuls;
+
+		for (size_t ballot: affected) {
+			if (--group_hopefuls[ballot] == 0) {
+				find_next_group(ballot);
+			}
+		}
+		return;
+	}
+
+	// Last preferences: take out the contributions of every ballot we
+	// might change before changing anything, then put them back after.
+	for (size_t ballot: affected) {
+		add_last_contribution(ballot, -1);
+	}
+
+	hopefuls[candidate] = false;
+	--num_hopefuls;
+
+	for (size_t ballot: affected) {
+		if (--group_hopefuls[ballot] == 0) {
+			find_next_group(ballot);
+		}
+		add_last_contribution(ballot, 1);
+	}
+
+	// Ballots that didn't rank the candidate may now rank every
+	// hopeful.
+	for (size_t ballot: unranked_by[candidate]) {
+		if (--unranked_hopefuls[ballot] == 0) {
+			add_last_contribution(ballot, 1);
+		}
+	}
+	unranked_by[candidate].clear();
+}
+
+const std::vector<std::vector<double> > &
+incremental_tally::get_positional_matrix() {
+
+	if (type == IT_FIRST_PREFERENCES) {
+		matrix.assign(num_candidates, std::vector<double>(1, 0));
+
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			if (hopefuls[cand]) {
+				matrix[cand][0] = tally[cand];
+			}
+		}
+
+		return matrix;
+	}
+
+	matrix.assign(num_candidates, std::vector<double>(num_candidates, 0));
+
+	// If there's only one hopeful, the first position is also the last,
+	// so add rather than assign.
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		if (hopefuls[cand] && num_hopefuls > 0) {
+			matrix[cand][0] += ranked_weight[cand] - tally[cand];
+			matrix[cand][num_hopefuls-1] += tally[cand];
+		}
+	}
+
+	return matrix;
+}
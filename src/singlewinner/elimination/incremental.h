@@ -0,0 +1,87 @@
+#pragma once
+
+// Incremental tallies for loser elimination. When the base method of a loser
+// elimination method is a positional method like Plurality (IRV) or
+// Antiplurality (Coombs), eliminating a candidate only changes the ballots
+// that had that candidate at the top (or bottom) of their hopefuls. Rather
+// than recount every ballot every round, this keeps, for every candidate, a
+// bucket of the ballots whose current top (or bottom) group of hopefuls
+// includes that candidate. Eliminating a candidate then only walks that
+// candidate's bucket and moves each ballot's pointer to the next group.
+
+// The tallies are turned into a positional matrix that gives the same social
+// ordering as the base method's own when passed to its pos_elect:
+// 	- For first preferences, it's the plurality column, just as the
+// 		aggregator would produce with a zero run of one.
+// 	- For last preferences, a candidate's score is the weight of the
+// 		ballots ranking it minus the weight of the ballots where it's
+// 		ranked strictly last among the hopefuls, with every other hopeful
+// 		ranked. The matrix puts the first in column 0 and the second in
+// 		the last position.
+
+// To keep the outcome exactly the same as recounting (ties and all), the
+// tallies must be exact. Thus init() refuses (returns false) unless every
+// ballot weight is an integer, the total weight fits in a double's mantissa,
+// and, for fractional positional methods, no ballot has equal-ranked
+// candidates. The caller should then recount the usual way.
+
+#include "common/compact_ballots.h"
+#include "singlewinner/positional/types.h"
+
+#include <vector>
+
+class incremental_tally {
+	private:
+		incremental_tally_type type;
+		size_t num_candidates, num_hopefuls;
+		compact_election ballots;
+		std::vector<bool> hopefuls;
+
+		// The entry range of each ballot's current group: the top
+		// group of hopefuls for first preferences, the bottom group
+		// for last preferences. The group is every entry that shares
+		// the score of the first (or last) hopeful, so it may include
+		// eliminated candidates. group_hopefuls counts the hopefuls
+		// in it; if zero, the ballot is exhausted.
+		std::vector<size_t> group_begin, group_end, group_hopefuls;
+
+		// Last preferences only: the number of hopefuls each ballot
+		// doesn't rank, and for each candidate, the ballots that
+		// don't rank it.
+		std::vector<size_t> unranked_hopefuls;
+		std::vector<std::vector<size_t> > unranked_by;
+
+		// buckets[c] holds the ballots whose current group contains c.
+		std::vector<std::vector<size_t> > buckets;
+
+		// For first preferences, tally[c] is the weight of the ballots
+		// with c in the top group. For last preferences, it's the
+		// weight of the complete ballots with c alone at the bottom,
+		// and ranked_weight[c] is the weight of the ballots ranking c.
+		std::vector<double> tally, ranked_weight;
+
+		std::vector<std::vector<double> > matrix;
+
+		void set_group(size_t ballot, size_t begin, size_t end);
+		bool find_next_group(size_t ballot);
+		size_t get_sole_hopeful(size_t ballot) const;
+		void add_last_contribution(size_t ballot, double sign);
+
+	public:
+		// Sets up the tallies. Returns false if the type is IT_NONE or
+		// the tallies wouldn't be exact; see above.
+		bool init(const election_t & papers,
+			const std::vector<bool> & hopefuls_in,
+			size_t num_candidates_in, positional_type kind,
+			incremental_tally_type type_in);
+
+		void eliminate(size_t candidate);
+
+		size_t get_num_hopefuls() const {
+			return num_hopefuls;
+		}
+
+		// The positional matrix to pass to the base method's pos_elect.
+		// The reference is valid until the next call.
+		const std::vector<std::vector<double> > & get_positional_matrix();
+};
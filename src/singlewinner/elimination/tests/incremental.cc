@@ -0,0 +1,88 @@
+// Tests for incremental loser elimination.
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "singlewinner/elimination/elimination.h"
+#include "singlewinner/positional/simple_methods.h"
+
+// Hides the base method's positional nature from loser_elimination so that it
+// recounts every round. This gives us the reference outcomes.
+class opaque_method : public election_method {
+	private:
+		std::shared_ptr<const election_method> inner;
+
+	protected:
+		std::pair<ordering, bool> elect_inner(const election_t & papers,
+			const std::vector<bool> & hopefuls, int num_candidates,
+			cache_map * cache, bool winner_only) const {
+
+			return inner->elect_detailed(papers, hopefuls, num_candidates,
+					cache, winner_only);
+		}
+
+	public:
+		opaque_method(std::shared_ptr<const election_method> inner_in) {
+			inner = inner_in;
+		}
+
+		std::string name() const {
+			return "Opaque-" + inner->name();
+		}
+};
+
+static void check_against_recount(std::shared_ptr<const positional> base,
+	bool average_loser, bool equal_ranks) {
+
+	loser_elimination incremental(base, average_loser, true),
+					  recount(std::make_shared<opaque_method>(base),
+						  average_loser, true);
+
+	rng randomizer(1);
+
+	for (int trial = 0; trial < 200; ++trial) {
+		size_t num_candidates = 2 + randomizer.next_int(7);
+		election_t election = get_random_election(num_candidates,
+				1 + randomizer.next_int(40), equal_ranks ? 3 : 0, true, true,
+				randomizer);
+
+		// Also check that it works with some candidates excluded
+		// from the start.
+		std::vector<bool> hopefuls(num_candidates, true);
+		if (trial % 2 == 1) {
+			hopefuls[randomizer.next_int(num_candidates)] = false;
+		}
+
+		EXPECT_EQ(incremental.elect(election, hopefuls, num_candidates,
+				NULL, false), recount.elect(election, hopefuls,
+				num_candidates, NULL, false)) << base->name();
+	}
+}
+
+TEST(IncrementalElimination, IRVMatchesRecount) {
+	check_against_recount(std::make_shared<plurality>(PT_WHOLE),
+		false, true);
+	check_against_recount(std::make_shared<plurality>(PT_FRACTIONAL),
+		false, false);
+}
+
+TEST(IncrementalElimination, IFPPMatchesRecount) {
+	check_against_recount(std::make_shared<plurality>(PT_WHOLE),
+		true, true);
+}
+
+TEST(IncrementalElimination, CoombsMatchesRecount) {
+	check_against_recount(std::make_shared<antiplurality>(PT_WHOLE),
+		false, true);
+	check_against_recount(std::make_shared<antiplurality>(PT_FRACTIONAL),
+		false, false);
+}
+
+// Fractional equal ranks aren't exact, so these must fall back to recounting;
+// the outcome should still be the same.
+TEST(IncrementalElimination, FallbackMatchesRecount) {
+	check_against_recount(std::make_shared<plurality>(PT_FRACTIONAL),
+		false, true);
+	check_against_recount(std::make_shared<antiplurality>(PT_FRACTIONAL),
+		false, true);
+}
@@ -58,6 +58,7 @@ class disqelim : public election_method {
 			base_ordering = base_ordering_in;
 			has_method = false;
 			base_method = NULL;
+			reset_method_id();
 		}
 
 		void set_base_method(std::shared_ptr<election_method>
@@ -65,6 +66,7 @@ class disqelim : public election_method {
 
 			has_method = true;
 			base_method = base_method_in;
+			reset_method_id();
 		}
 
 		std::string name() const {
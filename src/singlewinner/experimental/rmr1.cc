@@ -59,7 +59,7 @@ int rmr1::get_score_defeated(const disqual_tensor & beats,
 	}
 
 	// Start with the pairwise defeats.
-	std::vector<std::vector<bool> > current_beats = beats[2];
+	disqual_tensor current_beats = beats;
 
 	// And assume we're defeated.
 	bool defeated = true;
@@ -83,11 +83,11 @@ int rmr1::get_score_defeated(const disqual_tensor & beats,
 
 			// Is the disqualification against us no longer active?
 			// Break it.
-			if (!beats[k][challenger][candidate]) {
-				current_beats[challenger][candidate] = false;
+			if (!beats.get(k, challenger, candidate)) {
+				current_beats.set(2, challenger, candidate, false);
 			}
 
-			defeated |= current_beats[challenger][candidate];
+			defeated |= current_beats.get(2, challenger, candidate);
 		}
 
 		if (!defeated) {
@@ -123,10 +123,10 @@ int rmr1::get_score_defeating(const disqual_tensor & beats,
 				continue;
 			}
 
-			defeating |= beats[k][candidate][challenger];
+			defeating |= beats.get(k, candidate, challenger);
 
 			// Nonmonotone HACK, come up with something better later.
-			if (beats[k][challenger][candidate]) {
+			if (beats.get(k, challenger, candidate)) {
 				++defeated_by;
 			}
 		}
@@ -173,8 +173,8 @@ int rmr1::get_score_two_way(const disqual_tensor & beats,
 				continue;
 			}
 
-			defeated |= beats[k][challenger][candidate];
-			defeating_someone |= beats[k][candidate][challenger];
+			defeated |= beats.get(k, challenger, candidate);
+			defeating_someone |= beats.get(k, candidate, challenger);
 		}
 
 		if (!defeated && defeating_someone) {
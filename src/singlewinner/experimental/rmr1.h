@@ -68,7 +68,7 @@
 
 enum rmr_type { RMR_DEFEATED, RMR_DEFEATING, RMR_TWO_WAY, RMR_SCHWARTZ_EXP };
 
-// beats[k][x][y] is true iff candidate x disqualifies y on
+// beats.get(k, x, y) is true iff candidate x disqualifies y on
 // every set of cardinality k and less.
 
 class rmr1 : public election_method {
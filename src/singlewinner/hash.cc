@@ -29,7 +29,7 @@ std::pair<ordering, bool> hash_random_cand::elect_inner(
 
 		ballot_byte_rep[0] = candidate;
 
-		size_t score = hasher.Hash64(
+		size_t score = SpookyHash::Hash64(
 				ballot_byte_rep.data(),
 				sizeof(double) * ballot_byte_rep.size(),
 				0);
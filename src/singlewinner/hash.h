@@ -15,8 +15,6 @@
 class hash_random_cand : public election_method {
 
 	private:
-		mutable SpookyHash hasher;
-
 		std::pair<ordering, bool> elect_inner(
 			const election_t & papers,
 			const std::vector<bool> & hopefuls,
@@ -31,5 +31,5 @@ std::pair<ordering, bool> clamp::elect_inner(
 	}
 
 	return forward_to->elect_detailed(derived_papers,
-			hopefuls, num_candidates, cache, winner_only);
+			hopefuls, num_candidates, NULL, winner_only);
 }
\ No newline at end of file
@@ -34,13 +34,12 @@ std::pair<ordering, bool> slash::elect_inner(const election_t
 	// TODO: Check if there's only one candidate left. If so, just
 	// return the set.
 
-	// Second, get the specific method's ordering, using no cache since we
-	// don't want interference with earlier methods. BLUESKY: Somehow
-	// indicate (in cache) which candidates are used and which aren't, so
-	// the issue disappears.
+	// Second, get the specific method's ordering. The cache keeps results
+	// for different hopefuls apart, so this can't interfere with earlier
+	// methods, and other slash methods with the same set can reuse it.
 
 	std::pair<ordering, bool> spec_result = specific_method->elect_detailed(
-			papers, specified_hopefuls, num_candidates, NULL, winner_only);
+			papers, specified_hopefuls, num_candidates, cache, winner_only);
 
 	// The rest goes as in comma: we complete one of the ballots with the
 	// other. It doesn't matter which way we do it because, by definition,
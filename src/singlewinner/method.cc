@@ -22,6 +22,17 @@ std::pair<ordering, bool> election_method::elect_inner(
 				winner_only));
 }
 
+method_id_t election_method::get_method_id() const {
+	method_id_t id = cached_method_id.load(std::memory_order_relaxed);
+
+	if (id == NO_METHOD_ID) {
+		id = method_id_registry::intern(name());
+		cached_method_id.store(id, std::memory_order_relaxed);
+	}
+
+	return id;
+}
+
 // Cache wrappers.
 
 std::pair<ordering, bool> election_method::elect_detailed(
@@ -43,12 +54,12 @@ std::pair<ordering, bool> election_method::elect_detailed(
 	}
 
 	// If we have a cache, try to look up the answer. We have to do it
-	// this way because has_outcome wastes another name() call or in some
-	// other way becomes too slow. Let's hear it for eager evaluation!
+	// this way because has_outcome wastes another lookup. Let's hear it
+	// for eager evaluation!
 	std::pair<ordering, bool> toRet;
 
 	if (cache != NULL) {
-		toRet = cache->get_outcome(name(), winner_only);
+		toRet = cache->get_outcome(get_method_id(), winner_only);
 
 		// If we got something, then return it...
 		if (!toRet.first.empty()) {
@@ -66,7 +77,7 @@ std::pair<ordering, bool> election_method::elect_detailed(
 	// There were none, so set the cache...
 	if (cache != NULL) {
 		//std::cout << "Setting cache for " << name() << std::endl;
-		cache->set_outcome(name(), toRet);
+		cache->set_outcome(get_method_id(), toRet);
 	}
 
 	// ... and return the value.
@@ -137,24 +148,45 @@ std::pair<ordering, bool> election_method::elect_detailed(
 		return std::pair<ordering, bool>(hopeful, false);
 	}
 
+	// The cache keeps outcomes with excluded candidates separately for
+	// every hopefuls pattern, so there are no collisions between, say,
+	// one IRV round and the next.
+
+	std::pair<ordering, bool> toRet;
+
+	if (cache != NULL) {
+		toRet = cache->get_outcome(get_method_id(), hopefuls,
+				winner_only);
+
+		if (!toRet.first.empty()) {
+			return (toRet);
+		}
+	}
+
 	// Otherwise, go about it the hard way.
 
-	std::pair<ordering, bool> toRet = elect_inner(papers, hopefuls,
-			num_candidates, cache, winner_only);
+	toRet = elect_inner(papers, hopefuls, num_candidates, cache,
+			winner_only);
 
 	// Check that there are no errors.
 	// BLUESKY: make num_* size_t.
 	assert(toRet.first.size() == (size_t)num_hopefuls);
 
-	// Then return! We can't use cache as there could be collisions
-	// between different hopefuls patterns.
-	// Bluesky: build a prefix according to the hopefuls? E.g. IRV
-	// round with A and B excluded, C and D remaining becomes
-	// __##/Plurality... Is it worth it? Find out when we have a tester,
-	// but probably not.
+	if (cache != NULL) {
+		cache->set_outcome(get_method_id(), hopefuls, toRet);
+	}
+
 	return (toRet);
 }
 
+std::pair<ordering, bool> election_method::elect_from_statistics(
+	const election_statistics & /*statistics*/,
+	bool /*winner_only*/) const {
+
+	throw std::logic_error(name() + " can't elect from summary "
+		"statistics");
+}
+
 // Public wrappers.
 ordering election_method::elect(const election_t & papers,
 	int num_candidates, cache_map * cache,
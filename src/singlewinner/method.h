@@ -3,6 +3,9 @@
 #include "common/ballots.h"
 #include "tools/tools.h"
 #include "common/cache.h"
+#include "common/method_id.h"
+#include "statistics.h"
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <list>
@@ -53,10 +56,26 @@
 // proceed as if that was a complete ballot set with only the hopefuls
 // actually mentioned.
 
+// The cache is indexed by the method's interned ID. The ID is determined from
+// name() the first time it's needed and then kept, so a method that changes
+// its name after it has been used (e.g. by a setter) must call
+// reset_method_id().
+
 // (Mostly) abstract base class.
 class election_method {
 
+	private:
+		// This is atomic because the same method may be called from
+		// several threads. Every thread would intern the same name
+		// and so store the same value, so relaxed ordering suffices.
+		mutable std::atomic<method_id_t> cached_method_id;
+
 	protected:
+		void reset_method_id() {
+			cached_method_id.store(NO_METHOD_ID,
+				std::memory_order_relaxed);
+		}
+
 		// Use these when programming inherited classes. The cache
 		// reference has to be read-write as some methods may add
 		// additional information to it - for instance, the comma class
@@ -76,6 +95,23 @@ class election_method {
 			bool winner_only) const = 0;
 
 	public:
+		election_method() : cached_method_id(NO_METHOD_ID) {}
+
+		// Atomics can't be copied, so do it by hand. The copy has
+		// the same name and so the same ID.
+		election_method(const election_method & other) :
+			cached_method_id(other.cached_method_id.load(
+					std::memory_order_relaxed)) {}
+
+		election_method & operator=(const election_method & other) {
+			cached_method_id.store(other.cached_method_id.load(
+					std::memory_order_relaxed), std::memory_order_relaxed);
+			return *this;
+		}
+
+		// The interned ID of name(). See above.
+		method_id_t get_method_id() const;
+
 		// ElectEx? :p
 		// The next two shouldn't be publicly used; instead, they're
 		// used in combination methods that have to know if what they're
@@ -128,6 +164,20 @@ class election_method {
 						NULL, false));
 		}
 
+		// Summable methods only need a fixed-size summary of the
+		// ballots (see statistics.h). Such methods return the summaries
+		// they need here, and can then elect from any statistics object
+		// that has those summaries. Methods that need the ballots
+		// themselves return an empty request, and elect_from_statistics
+		// throws std::logic_error.
+		virtual statistics_request get_required_statistics() const {
+			return statistics_request();
+		}
+
+		virtual std::pair<ordering, bool> elect_from_statistics(
+			const election_statistics & statistics,
+			bool winner_only) const;
+
 		// Here goes stats stuff like "returns rated vote" (score not
 		// just rank), "returns complete ordering or just winners",
 		// etc. Perhaps better would be to have this set by constructor
@@ -1,10 +1,11 @@
-// Kemeny. This method is, unfortunately, NP-hard. We do as best as we can by
-// making use of the GLPK to solve it through integer programming. (We might
-// handle the linear programming relaxation too, later: just solve and then
-// output the X>Y weights into Ranked Pairs.)
+// Kemeny. This method is, unfortunately, NP-hard. This file has the integer
+// programming solvers, and the code that splits the problem into components
+// and picks a solver for each (see kemeny.h). The other solvers are in
+// kemeny_solvers.cc. (We might handle the linear programming relaxation too,
+// later: just solve and then output the X>Y weights into Ranked Pairs.)
 
-// The exact integer program will be given in comments within the pair_elect
-// function itself.
+// The reference solver, solve_kemeny, gives the whole problem to GLPK at
+// once. Its integer program is given in comments within that function.
 
 // YOUNG, H. Peyton; LEVENGLICK, Arthur. A consistent extension of
 // Condorcet’s election principle. SIAM Journal on applied Mathematics,
@@ -18,10 +19,14 @@
 #include "pairwise/matrix.h"
 #include "method.h"
 #include "kemeny.h"
+#include "kemeny_solvers.h"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <vector>
 #include <glpk.h>
+#include <math.h>
 
 std::vector<std::vector<bool> > kemeny::solve_kemeny(
 	const abstract_condmat & input,
@@ -360,11 +365,334 @@ std::vector<std::vector<bool> > kemeny::solve_kemeny(
 	return (adjacency);
 }
 
+// The reference program above has a variable for every ordered pair and n^3
+// rows, and it's rebuilt from nothing every time. The compact program used
+// for components too large for dynamic programming has a variable x[i][j]
+// only for i < j (x[j][i] is then 1 - x[i][j]), and the triangle
+// inequalities become, for every i < j < k,
+//	0 <= x[i][j] + x[j][k] - x[i][k] <= 1,
+// which rules out both i > j > k > i and k > j > i > k. The constraint
+// matrix only depends on the number of candidates, so we build it once per
+// number and keep it around.
+
+// The solver is warm-started with a heuristic order (passed as the
+// incumbent). If the LP relaxation's bound is no better than the incumbent,
+// the incumbent is optimal and we're done; otherwise, it's given to GLPK as
+// a known integer solution so that the branch and cut can prune right away.
+
+class kemeny_ilp_skeleton {
+	public:
+		int num_rows, num_cols;
+		// 1-indexed, as GLPK wants them.
+		std::vector<int> ia, ja;
+		std::vector<double> ar;
+		// column[i][j] for i < j is the column of x[i][j].
+		std::vector<std::vector<int> > column;
+};
+
+static const kemeny_ilp_skeleton & get_ilp_skeleton(size_t numcands) {
+	static std::map<size_t, kemeny_ilp_skeleton> skeletons;
+	const kemeny_ilp_skeleton * skeleton;
+
+	#pragma omp critical(kemeny_ilp_skeleton)
+	{
+		std::map<size_t, kemeny_ilp_skeleton>::iterator pos =
+			skeletons.find(numcands);
+
+		if (pos == skeletons.end()) {
+			kemeny_ilp_skeleton & built = skeletons[numcands];
+			size_t i, j, k;
+
+			built.num_cols = 0;
+			built.column = std::vector<std::vector<int> >(numcands,
+					std::vector<int>(numcands, 0));
+
+			for (i = 0; i < numcands; ++i) {
+				for (j = i+1; j < numcands; ++j) {
+					built.column[i][j] = ++built.num_cols;
+				}
+			}
+
+			built.num_rows = 0;
+			built.ia.push_back(0);
+			built.ja.push_back(0);
+			built.ar.push_back(0);
+
+			for (i = 0; i < numcands; ++i) {
+				for (j = i+1; j < numcands; ++j) {
+					for (k = j+1; k < numcands; ++k) {
+						++built.num_rows;
+
+						built.ia.push_back(built.num_rows);
+						built.ja.push_back(built.column[i][j]);
+						built.ar.push_back(1);
+						built.ia.push_back(built.num_rows);
+						built.ja.push_back(built.column[j][k]);
+						built.ar.push_back(1);
+						built.ia.push_back(built.num_rows);
+						built.ja.push_back(built.column[i][k]);
+						built.ar.push_back(-1);
+					}
+				}
+			}
+
+			pos = skeletons.find(numcands);
+		}
+
+		skeleton = &pos->second;
+	}
+
+	return *skeleton;
+}
+
+class kemeny_warm_start {
+	public:
+		std::vector<double> solution;
+		bool given;
+};
+
+static void give_warm_start(glp_tree * tree, void * info) {
+	kemeny_warm_start * warm_start = (kemeny_warm_start *)info;
+
+	if (glp_ios_reason(tree) == GLP_IHEUR && !warm_start->given) {
+		glp_ios_heur_sol(tree, warm_start->solution.data());
+		warm_start->given = true;
+	}
+}
+
+static std::vector<size_t> solve_kemeny_ilp(
+	const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & incumbent) {
+
+	size_t n = score.size(), i, j;
+	const kemeny_ilp_skeleton & skeleton = get_ilp_skeleton(n);
+
+	glp_prob * ip = glp_create_prob();
+
+	if (!ip) {
+		throw std::runtime_error("Kemeny: GLPK problem creation failed.");
+	}
+
+	glp_set_obj_dir(ip, GLP_MAX);
+	if (skeleton.num_rows > 0) {
+		glp_add_rows(ip, skeleton.num_rows);
+	}
+	glp_add_cols(ip, skeleton.num_cols);
+
+	for (int row = 1; row <= skeleton.num_rows; ++row) {
+		glp_set_row_bnds(ip, row, GLP_DB, 0, 1);
+	}
+
+	// Ranking i above j gives score[i][j] and ranking j above i gives
+	// score[j][i], so the objective is the sum of score[j][i] plus
+	// (score[i][j] - score[j][i]) * x[i][j].
+	double constant = 0;
+
+	for (i = 0; i < n; ++i) {
+		for (j = i+1; j < n; ++j) {
+			glp_set_col_kind(ip, skeleton.column[i][j], GLP_BV);
+			glp_set_obj_coef(ip, skeleton.column[i][j],
+				score[i][j] - score[j][i]);
+			constant += score[j][i];
+		}
+	}
+	glp_set_obj_coef(ip, 0, constant);
+
+	if (skeleton.num_rows > 0) {
+		glp_load_matrix(ip, skeleton.ia.size() - 1, skeleton.ia.data(),
+			skeleton.ja.data(), skeleton.ar.data());
+	}
+
+	glp_smcp params;
+	glp_init_smcp(&params);
+	params.msg_lev = GLP_MSG_OFF;
+	params.presolve = GLP_ON;
+
+	if (glp_simplex(ip, &params) != 0 || glp_get_status(ip) != GLP_OPT) {
+		glp_delete_prob(ip);
+		throw std::runtime_error("Kemeny: Could not solve relaxation!");
+	}
+
+	// If the relaxation can't beat the incumbent, nothing can.
+	double incumbent_score = kemeny_score(score, incumbent);
+
+	if (glp_get_obj_val(ip) <= incumbent_score + 1e-9 *
+		std::max(1.0, fabs(incumbent_score))) {
+
+		glp_delete_prob(ip);
+		return incumbent;
+	}
+
+	bool already_int = true;
+	for (int col = 1; col <= skeleton.num_cols && already_int; ++col) {
+		double value = glp_get_col_prim(ip, col);
+		already_int = (value == round(value));
+	}
+
+	if (!already_int) {
+		// Turn the incumbent into a solution vector.
+		kemeny_warm_start warm_start;
+		warm_start.solution = std::vector<double>(skeleton.num_cols + 1, 0);
+		warm_start.given = false;
+
+		std::vector<size_t> position(n);
+		for (i = 0; i < n; ++i) {
+			position[incumbent[i]] = i;
+		}
+
+		for (i = 0; i < n; ++i) {
+			for (j = i+1; j < n; ++j) {
+				if (position[i] < position[j]) {
+					warm_start.solution[skeleton.column[i][j]] = 1;
+				}
+			}
+		}
+
+		glp_iocp io_param;
+		glp_init_iocp(&io_param);
+		io_param.msg_lev = GLP_MSG_OFF;
+		io_param.cb_func = give_warm_start;
+		io_param.cb_info = &warm_start;
+
+		int solver_error = glp_intopt(ip, &io_param);
+		if (solver_error != 0 || glp_mip_status(ip) != GLP_OPT) {
+			glp_delete_prob(ip);
+			throw std::runtime_error("Kemeny: Could not solve integer program!");
+		}
+	}
+
+	// Each candidate's position is given by how many candidates it beats.
+	std::vector<std::pair<int, size_t> > beaten(n);
+
+	for (i = 0; i < n; ++i) {
+		beaten[i] = std::pair<int, size_t>(0, i);
+	}
+
+	for (i = 0; i < n; ++i) {
+		for (j = i+1; j < n; ++j) {
+			double value;
+			if (already_int) {
+				value = glp_get_col_prim(ip, skeleton.column[i][j]);
+			} else {
+				value = glp_mip_col_val(ip, skeleton.column[i][j]);
+			}
+
+			if (value > 0.5) {
+				--beaten[i].first;
+			} else {
+				--beaten[j].first;
+			}
+		}
+	}
+
+	glp_delete_prob(ip);
+
+	std::sort(beaten.begin(), beaten.end());
+
+	std::vector<size_t> order;
+	for (const auto & beaten_and_cand: beaten) {
+		order.push_back(beaten_and_cand.second);
+	}
+
+	return order;
+}
+
+// Solve a single strongly connected component with the chosen solver. The
+// score matrix is the component's own, so the order is given in terms of
+// its members' indices.
+
+std::vector<size_t> kemeny::solve_component(
+	const std::vector<std::vector<double> > & score) const {
+
+	if (score.size() == 1) {
+		return std::vector<size_t>(1, 0);
+	}
+
+	switch (solver) {
+		case KS_SUBSET_DP:
+			return kemeny_subset_dp(score);
+		case KS_BRANCH_AND_BOUND:
+			return kemeny_branch_and_bound(score,
+					kemeny_heuristic_order(score));
+		case KS_ILP:
+			return solve_kemeny_ilp(score, kemeny_heuristic_order(score));
+		default:
+			if (score.size() <= KEMENY_DP_MAX_CANDIDATES) {
+				return kemeny_subset_dp(score);
+			}
+			return solve_kemeny_ilp(score, kemeny_heuristic_order(score));
+	}
+}
+
+std::vector<size_t> kemeny::get_kemeny_order(
+	const abstract_condmat & input,
+	const std::vector<bool> & hopefuls) const {
+
+	std::vector<size_t> candidates;
+
+	for (size_t cand = 0; cand < input.get_num_candidates(); ++cand) {
+		if (hopefuls[cand]) {
+			candidates.push_back(cand);
+		}
+	}
+
+	std::vector<std::vector<double> > score(candidates.size(),
+		std::vector<double>(candidates.size(), 0));
+
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		for (size_t j = 0; j < candidates.size(); ++j) {
+			if (i != j) {
+				score[i][j] = input.get_magnitude(candidates[i],
+						candidates[j], hopefuls);
+			}
+		}
+	}
+
+	std::vector<size_t> order;
+
+	for (const std::vector<size_t> & component:
+		kemeny_components(score)) {
+
+		std::vector<size_t> component_order = solve_component(
+				kemeny_submatrix(score, component));
+
+		for (size_t local_idx: component_order) {
+			order.push_back(candidates[component[local_idx]]);
+		}
+	}
+
+	return order;
+}
+
+std::string kemeny::pw_name() const {
+	switch (solver) {
+		case KS_SUBSET_DP: return ("Kemeny-DP");
+		case KS_BRANCH_AND_BOUND: return ("Kemeny-BB");
+		case KS_ILP: return ("Kemeny-ILP");
+		case KS_GLPK_REFERENCE: return ("Kemeny-GLPK");
+		default: return ("Kemeny");
+	}
+}
+
 std::pair<ordering, bool> kemeny::pair_elect(const abstract_condmat &
 	input,
 	const std::vector<bool> & hopefuls, cache_map * cache,
 	bool winner_only) const {
 
+	ordering out;
+
+	if (solver != KS_GLPK_REFERENCE) {
+		// Each candidate's score is the number of candidates the order
+		// ranks it above.
+		std::vector<size_t> order = get_kemeny_order(input, hopefuls);
+
+		for (size_t pos = 0; pos < order.size(); ++pos) {
+			out.insert(candscore(order[pos], order.size() - 1 - pos));
+		}
+
+		return (std::pair<ordering, bool>(out, false));
+	}
+
 	// First, get the transitive adjacency matrix for Kemeny.
 	// Disable debug mode so it won't be so verbose.
 	std::vector<std::vector<bool> > adj = solve_kemeny(input, hopefuls, false);
@@ -382,8 +710,6 @@ std::pair<ordering, bool> kemeny::pair_elect(const abstract_condmat &
 	// If I'm going to do a linear relaxation later, I'll have to use a
 	// variant of the DFS for Ranked Pairs.
 
-	ordering out;
-
 	for (size_t counter = 0; counter < adj.size(); ++counter) {
 		if (!hopefuls[counter]) {
 			continue;
@@ -1,10 +1,15 @@
 // Kemeny. This method is, unfortunately, NP-hard. We do as best as we can by
-// making use of the GLPK to solve it through integer programming. (We might
-// handle the linear programming relaxation too, later: just solve and then
-// output the X>Y weights into Ranked Pairs.)
+// splitting the problem into the strongly connected components of the
+// majority graph and then solving each component with one of several
+// solvers (see kemeny_solvers.h). The default is to use dynamic programming
+// for components small enough, and a warm-started integer program for the
+// rest. The original integer program, which solves the whole problem at
+// once with GLPK, is kept as a reference. (We might handle the linear
+// programming relaxation too, later: just solve and then output the X>Y
+// weights into Ranked Pairs.)
 
-// The exact integer program will be given in comments within the pair_elect
-// function itself.
+// The exact integer program is given in comments within the reference
+// solver, solve_kemeny.
 
 // YOUNG, H. Peyton; LEVENGLICK, Arthur. A consistent extension of
 // Condorcet’s election principle. SIAM Journal on applied Mathematics,
@@ -19,24 +24,41 @@
 #include <iostream>
 #include <vector>
 
+enum kemeny_solver_type { KS_AUTO, KS_SUBSET_DP, KS_BRANCH_AND_BOUND,
+	KS_ILP, KS_GLPK_REFERENCE
+};
 
 class kemeny : public pairwise_method {
 	private:
+		kemeny_solver_type solver;
+
+		// The reference solver.
 		std::vector<std::vector<bool> > solve_kemeny(
 			const abstract_condmat & input,
 			const std::vector<bool> & hopefuls,
 			bool debug) const;
 
+		// Solve a single component, given the score matrix for it.
+		std::vector<size_t> solve_component(
+			const std::vector<std::vector<double> > & score) const;
+
+		// Returns the hopefuls in Kemeny order, top first.
+		std::vector<size_t> get_kemeny_order(
+			const abstract_condmat & input,
+			const std::vector<bool> & hopefuls) const;
+
 	public:
 		std::pair<ordering, bool> pair_elect(const abstract_condmat & input,
 			const std::vector<bool> & hopefuls,
 			cache_map * cache, bool winner_only) const;
 
-		std::string pw_name() const {
-			return ("Kemeny");
-		}
+		std::string pw_name() const;
+
+		kemeny(pairwise_type def_type_in,
+			kemeny_solver_type solver_in = KS_AUTO) :
+			pairwise_method(def_type_in) {
 
-		kemeny(pairwise_type def_type_in):pairwise_method(def_type_in) {
+			solver = solver_in;
 			update_name();
 		}
 };
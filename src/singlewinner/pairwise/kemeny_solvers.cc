@@ -0,0 +1,390 @@
+#include "kemeny_solvers.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+double kemeny_score(const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & order) {
+
+	double total = 0;
+
+	for (size_t i = 0; i < order.size(); ++i) {
+		for (size_t j = i+1; j < order.size(); ++j) {
+			total += score[order[i]][order[j]];
+		}
+	}
+
+	return total;
+}
+
+// Why the problem decomposes into components: suppose we have an optimal
+// order that ranks some member of a component below some member of a
+// component that it's beaten by. Stably sort the order by component. That
+// only flips pairs of candidates in different components, and each flip is
+// to a pair that was beaten, so the sorted order must be strictly better.
+// Thus every optimal order is sorted by component.
+
+static bool weakly_beats(const std::vector<std::vector<double> > & score,
+	size_t a, size_t b) {
+
+	return a != b && score[a][b] >= score[b][a];
+}
+
+static void finish_order_dfs(const std::vector<std::vector<double> > & score,
+	size_t cand, std::vector<bool> & visited,
+	std::vector<size_t> & finished) {
+
+	visited[cand] = true;
+
+	for (size_t next = 0; next < score.size(); ++next) {
+		if (!visited[next] && weakly_beats(score, cand, next)) {
+			finish_order_dfs(score, next, visited, finished);
+		}
+	}
+
+	finished.push_back(cand);
+}
+
+static void reverse_dfs(const std::vector<std::vector<double> > & score,
+	size_t cand, std::vector<bool> & visited,
+	std::vector<size_t> & component) {
+
+	visited[cand] = true;
+	component.push_back(cand);
+
+	for (size_t next = 0; next < score.size(); ++next) {
+		if (!visited[next] && weakly_beats(score, next, cand)) {
+			reverse_dfs(score, next, visited, component);
+		}
+	}
+}
+
+// This is Kosaraju's algorithm: the second pass finds the components in
+// topological order, which here means the top component comes first.
+
+std::vector<std::vector<size_t> > kemeny_components(
+	const std::vector<std::vector<double> > & score) {
+
+	size_t n = score.size();
+	std::vector<bool> visited(n, false);
+	std::vector<size_t> finished;
+
+	for (size_t cand = 0; cand < n; ++cand) {
+		if (!visited[cand]) {
+			finish_order_dfs(score, cand, visited, finished);
+		}
+	}
+
+	std::fill(visited.begin(), visited.end(), false);
+	std::vector<std::vector<size_t> > components;
+
+	for (size_t i = n; i > 0; --i) {
+		size_t cand = finished[i-1];
+		if (visited[cand]) {
+			continue;
+		}
+
+		std::vector<size_t> component;
+		reverse_dfs(score, cand, visited, component);
+		std::sort(component.begin(), component.end());
+		components.push_back(component);
+	}
+
+	return components;
+}
+
+std::vector<std::vector<double> > kemeny_submatrix(
+	const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & candidates) {
+
+	std::vector<std::vector<double> > out(candidates.size(),
+		std::vector<double>(candidates.size(), 0));
+
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		for (size_t j = 0; j < candidates.size(); ++j) {
+			if (i != j) {
+				out[i][j] = score[candidates[i]][candidates[j]];
+			}
+		}
+	}
+
+	return out;
+}
+
+// The heuristic sorts by net score and then moves single candidates around
+// while that improves the score. It only needs to give the exact solvers a
+// good starting point.
+
+std::vector<size_t> kemeny_heuristic_order(
+	const std::vector<std::vector<double> > & score) {
+
+	size_t n = score.size(), i, j;
+
+	std::vector<std::pair<double, size_t> > net_scores;
+
+	for (i = 0; i < n; ++i) {
+		double net = 0;
+		for (j = 0; j < n; ++j) {
+			if (i != j) {
+				net += score[i][j] - score[j][i];
+			}
+		}
+		// Negate so that sorting ascending puts the best first and
+		// ties go to the lowest index.
+		net_scores.push_back(std::pair<double, size_t>(-net, i));
+	}
+
+	std::sort(net_scores.begin(), net_scores.end());
+
+	std::vector<size_t> order;
+	for (const auto & net_and_cand: net_scores) {
+		order.push_back(net_and_cand.second);
+	}
+
+	// Now try to move each candidate to where it does best. Moving
+	// candidate c up past e changes the score by score[c][e] - score[e][c],
+	// and conversely for moving down, so we can find the best place for c
+	// in linear time. Every move is a strict improvement, but in case of
+	// floating point trouble, limit the number of passes anyway.
+
+	bool improved = true;
+
+	for (size_t pass = 0; pass < n * n && improved; ++pass) {
+		improved = false;
+
+		for (size_t pos = 0; pos < n; ++pos) {
+			size_t cand = order[pos], best_pos = pos;
+			double delta = 0, best_delta = 0;
+
+			for (i = pos; i > 0; --i) {
+				delta += score[cand][order[i-1]] - score[order[i-1]][cand];
+				if (delta > best_delta) {
+					best_delta = delta;
+					best_pos = i-1;
+				}
+			}
+
+			delta = 0;
+			for (i = pos+1; i < n; ++i) {
+				delta += score[order[i]][cand] - score[cand][order[i]];
+				if (delta > best_delta) {
+					best_delta = delta;
+					best_pos = i;
+				}
+			}
+
+			if (best_pos == pos) {
+				continue;
+			}
+
+			order.erase(order.begin() + pos);
+			order.insert(order.begin() + best_pos, cand);
+			improved = true;
+		}
+	}
+
+	return order;
+}
+
+// The dynamic program works over subsets of the candidates. Let best[S] be
+// the best score we can get from the pairs inside S when S is ranked as a
+// block. If c is ranked last in S, then that score is best[S - c] plus the
+// score of every other member of S over c. We need the latter sum quickly,
+// so we split S into a low and a high half and look up each half's
+// contribution in a table. This makes the whole DP O(n 2^n).
+
+std::vector<size_t> kemeny_subset_dp(
+	const std::vector<std::vector<double> > & score) {
+
+	size_t n = score.size();
+
+	if (n > KEMENY_DP_MAX_CANDIDATES) {
+		throw std::invalid_argument("kemeny_subset_dp: Too many "
+			"candidates");
+	}
+
+	if (n == 0) {
+		return std::vector<size_t>();
+	}
+
+	size_t low_bits = n/2, high_bits = n - low_bits, cand, mask;
+	uint32_t low_mask = (1 << low_bits) - 1;
+
+	// low_sum[c][mask] is the sum of score[x][c] over x in the mask, for
+	// the low half, and similarly for high_sum.
+	std::vector<std::vector<double> > low_sum(n,
+		std::vector<double>(1 << low_bits, 0)),
+		high_sum(n, std::vector<double>(1 << high_bits, 0));
+
+	for (cand = 0; cand < n; ++cand) {
+		for (mask = 1; mask < low_sum[cand].size(); ++mask) {
+			size_t lowest = __builtin_ctz(mask);
+			low_sum[cand][mask] = low_sum[cand][mask & (mask-1)];
+			if (lowest != cand) {
+				low_sum[cand][mask] += score[lowest][cand];
+			}
+		}
+		for (mask = 1; mask < high_sum[cand].size(); ++mask) {
+			size_t lowest = __builtin_ctz(mask) + low_bits;
+			high_sum[cand][mask] = high_sum[cand][mask & (mask-1)];
+			if (lowest != cand) {
+				high_sum[cand][mask] += score[lowest][cand];
+			}
+		}
+	}
+
+	uint32_t full = (uint32_t)((1ULL << n) - 1);
+	std::vector<double> best(full + 1ULL, 0);
+	std::vector<uint8_t> last(full + 1ULL, 0);
+
+	for (uint64_t set = 1; set <= full; ++set) {
+		bool found = false;
+		uint32_t low_part = set & low_mask, high_part = set >> low_bits;
+
+		for (uint32_t remaining = set; remaining != 0;
+			remaining &= remaining - 1) {
+
+			cand = __builtin_ctz(remaining);
+
+			// The tables don't include the diagonal, so we don't
+			// need to remove c from S when looking up.
+			double candidate_score = best[set & ~(1U << cand)] +
+				low_sum[cand][low_part] + high_sum[cand][high_part];
+
+			if (!found || candidate_score > best[set]) {
+				best[set] = candidate_score;
+				last[set] = cand;
+				found = true;
+			}
+		}
+	}
+
+	std::vector<size_t> order(n);
+	uint32_t set = full;
+
+	for (size_t pos = n; pos > 0; --pos) {
+		order[pos-1] = last[set];
+		set &= ~(1U << last[set]);
+	}
+
+	return order;
+}
+
+// The branch and bound builds the order top down. Placing c next gets us
+// score[c][r] for every remaining r. The pairs among the remaining
+// candidates can't give more than the larger of score[a][b] and
+// score[b][a] each, which gives us an upper bound. In addition, no optimal
+// order has a candidate right above one that beats it, since swapping them
+// would be an improvement.
+
+class kemeny_bb_state {
+	public:
+		const std::vector<std::vector<double> > * score;
+		std::vector<std::vector<double> > pair_max;
+		std::vector<size_t> current, best_order;
+		double best_score;
+};
+
+static void branch_and_bound(kemeny_bb_state & state, uint64_t remaining,
+	double score_so_far, double remaining_bound) {
+
+	const std::vector<std::vector<double> > & score = *state.score;
+
+	if (remaining == 0) {
+		if (score_so_far > state.best_score) {
+			state.best_score = score_so_far;
+			state.best_order = state.current;
+		}
+		return;
+	}
+
+	// Get what each remaining candidate would give us if placed next, and
+	// how much it'd reduce the bound. Try the most promising first.
+	std::vector<std::pair<double, size_t> > by_gain;
+	std::vector<double> gain(score.size(), 0), bound_loss(score.size(), 0);
+
+	for (uint64_t cands = remaining; cands != 0; cands &= cands - 1) {
+		size_t cand = __builtin_ctzll(cands);
+
+		for (uint64_t others = remaining; others != 0;
+			others &= others - 1) {
+			size_t other = __builtin_ctzll(others);
+			if (other != cand) {
+				gain[cand] += score[cand][other];
+				bound_loss[cand] += state.pair_max[cand][other];
+			}
+		}
+
+		by_gain.push_back(std::pair<double, size_t>(-gain[cand], cand));
+	}
+
+	std::sort(by_gain.begin(), by_gain.end());
+
+	for (const auto & gain_and_cand: by_gain) {
+		size_t cand = gain_and_cand.second;
+
+		if (!state.current.empty()) {
+			size_t above = *state.current.rbegin();
+			if (score[cand][above] > score[above][cand]) {
+				continue;
+			}
+		}
+
+		double child_score = score_so_far + gain[cand],
+			   child_bound = remaining_bound - bound_loss[cand];
+
+		if (child_score + child_bound <= state.best_score) {
+			continue;
+		}
+
+		state.current.push_back(cand);
+		branch_and_bound(state, remaining & ~(1ULL << cand), child_score,
+			child_bound);
+		state.current.pop_back();
+	}
+}
+
+std::vector<size_t> kemeny_branch_and_bound(
+	const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & incumbent) {
+
+	size_t n = score.size(), i, j;
+
+	if (n > 64) {
+		throw std::invalid_argument("kemeny_branch_and_bound: Too many "
+			"candidates");
+	}
+
+	if (incumbent.size() != n) {
+		throw std::invalid_argument("kemeny_branch_and_bound: Incumbent "
+			"has the wrong number of candidates");
+	}
+
+	kemeny_bb_state state;
+	state.score = &score;
+	state.best_order = incumbent;
+	state.best_score = kemeny_score(score, incumbent);
+	state.pair_max = std::vector<std::vector<double> >(n,
+			std::vector<double>(n, 0));
+
+	double bound = 0;
+
+	for (i = 0; i < n; ++i) {
+		for (j = 0; j < n; ++j) {
+			if (i == j) {
+				continue;
+			}
+			state.pair_max[i][j] = std::max(score[i][j], score[j][i]);
+			if (i < j) {
+				bound += state.pair_max[i][j];
+			}
+		}
+	}
+
+	uint64_t everybody = (n == 64) ? ~0ULL : ((1ULL << n) - 1);
+
+	branch_and_bound(state, everybody, 0, bound);
+
+	return state.best_order;
+}
@@ -0,0 +1,54 @@
+// Combinatorial solvers for the Kemeny ranking problem. Given a matrix where
+// score[a][b] is what we get by ranking a above b, find the order (top first)
+// that maximizes the sum of score[a][b] over every pair with a above b.
+
+// Kemeny is NP-hard, but in practice most of the difficulty is in the
+// cycles. Every Kemeny ranking ranks the members of one strongly connected
+// component of the (weak) majority graph above every member of a component
+// that it beats (see kemeny_components), so we can solve the components
+// separately and then put the solutions together. What's left is solved
+// by dynamic programming over subsets for small components, and otherwise
+// by branch and bound or by an integer program (see kemeny.cc).
+
+// All candidate numbers here are indices into the score matrix, not the
+// original candidate numbers.
+
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+
+// Subset DP uses 2^n doubles and bytes, so this is about as far as it goes.
+const size_t KEMENY_DP_MAX_CANDIDATES = 20;
+
+// The score of ranking the candidates in the given order.
+double kemeny_score(const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & order);
+
+// Returns the strongly connected components of the graph that has an edge
+// from a to b whenever score[a][b] >= score[b][a]. Every pair of
+// candidates is connected one way or the other, so the components form a
+// total order; they're returned in that order, top first.
+std::vector<std::vector<size_t> > kemeny_components(
+	const std::vector<std::vector<double> > & score);
+
+// Restricts the score matrix to the given candidates (in that order).
+std::vector<std::vector<double> > kemeny_submatrix(
+	const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & candidates);
+
+// A good, but not necessarily optimal, order: sort by net score, then
+// move candidates around one at a time as long as that improves things.
+std::vector<size_t> kemeny_heuristic_order(
+	const std::vector<std::vector<double> > & score);
+
+// Exact solvers. The DP handles up to KEMENY_DP_MAX_CANDIDATES and the
+// branch and bound up to 64; both throw std::invalid_argument if asked to
+// handle more. The branch and bound starts from the incumbent, which
+// should be a good order (e.g. from kemeny_heuristic_order).
+std::vector<size_t> kemeny_subset_dp(
+	const std::vector<std::vector<double> > & score);
+
+std::vector<size_t> kemeny_branch_and_bound(
+	const std::vector<std::vector<double> > & score,
+	const std::vector<size_t> & incumbent);
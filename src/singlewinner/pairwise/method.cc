@@ -19,6 +19,7 @@ void pairwise_method::update_name() {
 	if (do_cache_name) {
 		cached_name = determine_name();
 	}
+	reset_method_id();
 }
 
 std::pair<ordering, bool> pairwise_method::pair_elect(
@@ -81,6 +81,20 @@ class pairwise_method : public election_method {
 			int num_candidates, cache_map * cache,
 			bool winner_only) const;
 
+		statistics_request get_required_statistics() const {
+			statistics_request request;
+			request.pairwise_matrix = true;
+			return request;
+		}
+
+		std::pair<ordering, bool> elect_from_statistics(
+			const election_statistics & statistics,
+			bool winner_only) const {
+
+			return pair_elect(statistics.get_condmat(default_type),
+					winner_only);
+		}
+
 		pairwise_type get_type() const {
 			return (default_type);
 		}
@@ -5,6 +5,7 @@
 #include "simple_methods.h"
 
 #include <complex>
+#include <memory>
 
 //////////////////////////////
 
@@ -303,7 +304,34 @@ std::pair<ordering, bool> schulze::pair_elect(
 	const std::vector<bool> & hopefuls, cache_map * cache,
 	bool winner_only) const {
 
-	beatpath bpath(input, CM_PAIRWISE_OPP, hopefuls);
+	// The beatpath matrix is shared with every other Schulze (and
+	// Schulze-based) method using the same kind of input matrix, so try
+	// the cache first.
+	const beatpath * cached_bpath = NULL;
+
+	if (cache != NULL) {
+		cached_bpath = cache->get_beatpath(input.get_type().get(),
+				hopefuls);
+
+		if (cached_bpath == NULL) {
+			cache->set_beatpath(input.get_type().get(), hopefuls,
+				beatpath(input, CM_PAIRWISE_OPP, hopefuls));
+			cached_bpath = cache->get_beatpath(input.get_type().get(),
+					hopefuls);
+		}
+	}
+
+	// If there's no cache, or too many candidates to cache, just make
+	// our own.
+	std::shared_ptr<beatpath> own_bpath;
+
+	if (cached_bpath == NULL) {
+		own_bpath = std::make_shared<beatpath>(input, CM_PAIRWISE_OPP,
+				hopefuls);
+		cached_bpath = own_bpath.get();
+	}
+
+	const beatpath & bpath = *cached_bpath;
 
 	// Count defeats.
 	size_t i, j, numcand = bpath.get_num_candidates();
@@ -0,0 +1,245 @@
+// Tests for the Kemeny solvers.
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "pairwise/matrix.h"
+#include "singlewinner/pairwise/kemeny.h"
+#include "singlewinner/pairwise/kemeny_solvers.h"
+
+// Integer scores with plenty of ties and cycles.
+static std::vector<std::vector<double> > random_scores(
+	size_t num_candidates, rng & randomizer) {
+
+	std::vector<std::vector<double> > score(num_candidates,
+		std::vector<double>(num_candidates, 0));
+
+	for (size_t i = 0; i < num_candidates; ++i) {
+		for (size_t j = 0; j < num_candidates; ++j) {
+			if (i != j) {
+				score[i][j] = randomizer.next_int(6);
+			}
+		}
+	}
+
+	return score;
+}
+
+// Try every order.
+static double brute_force_score(
+	const std::vector<std::vector<double> > & score) {
+
+	std::vector<size_t> order;
+	for (size_t i = 0; i < score.size(); ++i) {
+		order.push_back(i);
+	}
+
+	double record = kemeny_score(score, order);
+	while (std::next_permutation(order.begin(), order.end())) {
+		record = std::max(record, kemeny_score(score, order));
+	}
+
+	return record;
+}
+
+static bool is_permutation_of_all(const std::vector<size_t> & order,
+	size_t n) {
+
+	std::vector<size_t> sorted = order;
+	std::sort(sorted.begin(), sorted.end());
+	for (size_t i = 0; i < sorted.size(); ++i) {
+		if (sorted[i] != i) {
+			return false;
+		}
+	}
+	return sorted.size() == n;
+}
+
+TEST(Kemeny, SolversMatchBruteForce) {
+	rng randomizer(1);
+
+	for (int trial = 0; trial < 300; ++trial) {
+		size_t n = 1 + randomizer.next_int(8);
+		std::vector<std::vector<double> > score = random_scores(n,
+				randomizer);
+		double optimum = brute_force_score(score);
+
+		std::vector<size_t> heuristic = kemeny_heuristic_order(score),
+			dp = kemeny_subset_dp(score),
+			bb = kemeny_branch_and_bound(score, heuristic);
+
+		ASSERT_TRUE(is_permutation_of_all(heuristic, n));
+		ASSERT_TRUE(is_permutation_of_all(dp, n));
+		ASSERT_TRUE(is_permutation_of_all(bb, n));
+
+		EXPECT_LE(kemeny_score(score, heuristic), optimum);
+		EXPECT_EQ(kemeny_score(score, dp), optimum);
+		EXPECT_EQ(kemeny_score(score, bb), optimum);
+	}
+}
+
+TEST(Kemeny, DPMatchesBranchAndBound) {
+	rng randomizer(2);
+
+	for (int trial = 0; trial < 5; ++trial) {
+		std::vector<std::vector<double> > score = random_scores(14,
+				randomizer);
+
+		EXPECT_EQ(kemeny_score(score, kemeny_subset_dp(score)),
+			kemeny_score(score, kemeny_branch_and_bound(score,
+					kemeny_heuristic_order(score))));
+	}
+}
+
+TEST(Kemeny, ComponentsAreInOrder) {
+	// Candidates 0, 3 and 5 form a cycle and beat everybody else; then
+	// comes 1 alone, then the tie between 2 and 4.
+	std::vector<size_t> group = {1, 2, 3, 1, 3, 0};
+	std::vector<std::vector<double> > score(6, std::vector<double>(6, 0));
+
+	for (size_t i = 0; i < 6; ++i) {
+		for (size_t j = 0; j < 6; ++j) {
+			if (group[i] < group[j]) {
+				score[i][j] = 2;
+			}
+		}
+	}
+	score[0][3] = score[3][5] = score[5][0] = 2;
+	score[2][4] = score[4][2] = 1;
+
+	std::vector<std::vector<size_t> > expected = {{0, 3, 5}, {1}, {2, 4}};
+	EXPECT_EQ(kemeny_components(score), expected);
+}
+
+// Turns the method's ordering into a list of indices into candidates, top
+// first.
+static std::vector<size_t> ordering_to_indices(const ordering & out,
+	const std::vector<size_t> & candidates) {
+
+	std::vector<size_t> order;
+	for (const candscore & pos: out) {
+		order.push_back(std::find(candidates.begin(), candidates.end(),
+				pos.get_candidate_num()) - candidates.begin());
+	}
+
+	return order;
+}
+
+// The whole method, with the decomposition and some candidates excluded,
+// must give a Kemeny-optimal strict order of the hopefuls.
+TEST(Kemeny, MethodGivesOptimalOrder) {
+	rng randomizer(3);
+
+	std::vector<kemeny_solver_type> solvers = {KS_AUTO, KS_SUBSET_DP,
+		KS_BRANCH_AND_BOUND
+	};
+
+	for (int trial = 0; trial < 100; ++trial) {
+		size_t num_candidates = 2 + randomizer.next_int(6);
+
+		election_t election = get_random_election(num_candidates, 15,
+				num_candidates - 1, false, false, randomizer);
+
+		std::vector<bool> hopefuls(num_candidates, true);
+		if (trial % 2 == 1) {
+			hopefuls[randomizer.next_int(num_candidates)] = false;
+		}
+
+		condmat matrix(election, num_candidates, CM_WV);
+
+		std::vector<size_t> hopeful_cands;
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			if (hopefuls[cand]) {
+				hopeful_cands.push_back(cand);
+			}
+		}
+
+		std::vector<std::vector<double> > score(hopeful_cands.size(),
+			std::vector<double>(hopeful_cands.size(), 0));
+		for (size_t i = 0; i < hopeful_cands.size(); ++i) {
+			for (size_t j = 0; j < hopeful_cands.size(); ++j) {
+				if (i != j) {
+					score[i][j] = matrix.get_magnitude(hopeful_cands[i],
+							hopeful_cands[j], hopefuls);
+				}
+			}
+		}
+
+		double optimum = brute_force_score(score);
+
+		for (kemeny_solver_type solver: solvers) {
+			kemeny method(CM_WV, solver);
+			ordering out = method.pair_elect(matrix, hopefuls, NULL,
+					false).first;
+
+			ASSERT_EQ(out.size(), hopeful_cands.size());
+
+			// Turn the ordering back into indices into score.
+			std::vector<size_t> order;
+			double last_score = 0;
+			for (ordering::const_iterator pos = out.begin();
+				pos != out.end(); ++pos) {
+
+				if (pos != out.begin()) {
+					EXPECT_LT(pos->get_score(), last_score);
+				}
+				last_score = pos->get_score();
+
+				order.push_back(std::find(hopeful_cands.begin(),
+						hopeful_cands.end(), pos->get_candidate_num()) -
+					hopeful_cands.begin());
+			}
+
+			ASSERT_TRUE(is_permutation_of_all(order, hopeful_cands.size()));
+			EXPECT_EQ(kemeny_score(score, order), optimum)
+					<< method.name();
+		}
+	}
+}
+
+// The compact integer program is only used by default for components too
+// large for the DP, so force it on small elections and check that it finds
+// orders that are as good as the DP's. This needs a working GLPK.
+TEST(Kemeny, ILPMatchesSubsetDP) {
+	rng randomizer(4);
+
+	kemeny ilp(CM_WV, KS_ILP), dp(CM_WV, KS_SUBSET_DP);
+
+	for (int trial = 0; trial < 50; ++trial) {
+		size_t num_candidates = 2 + randomizer.next_int(7);
+
+		election_t election = get_random_election(num_candidates, 15,
+				num_candidates - 1, false, false, randomizer);
+		condmat matrix(election, num_candidates, CM_WV);
+		std::vector<bool> hopefuls(num_candidates, true);
+
+		std::vector<size_t> candidates;
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			candidates.push_back(cand);
+		}
+
+		std::vector<std::vector<double> > score(num_candidates,
+			std::vector<double>(num_candidates, 0));
+		for (size_t i = 0; i < num_candidates; ++i) {
+			for (size_t j = 0; j < num_candidates; ++j) {
+				if (i != j) {
+					score[i][j] = matrix.get_magnitude(i, j, hopefuls);
+				}
+			}
+		}
+
+		std::vector<size_t> ilp_order = ordering_to_indices(
+				ilp.pair_elect(matrix, hopefuls, NULL, false).first,
+				candidates),
+			dp_order = ordering_to_indices(
+				dp.pair_elect(matrix, hopefuls, NULL, false).first,
+				candidates);
+
+		ASSERT_TRUE(is_permutation_of_all(ilp_order, num_candidates));
+		EXPECT_EQ(kemeny_score(score, ilp_order),
+			kemeny_score(score, dp_order));
+	}
+}
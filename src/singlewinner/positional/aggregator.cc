@@ -95,3 +95,79 @@ positional_aggregator::get_positional_matrix(const
 	return (get_positional_matrix(ballots, num_candidates, num_hopefuls,
 				hopefuls, kind, -1));
 }
+
+// Compact election versions. The logic is the same as above, except that we
+// walk entry indices instead of ordering iterators.
+
+void positional_aggregator::aggregate(const compact_election & input,
+	size_t ballot, int num_hopefuls, const std::vector<bool> & hopefuls,
+	std::vector<std::vector<double> > & positional_array,
+	positional_type kind, int zero_run_advice) const {
+
+	size_t end = input.ballot_end(ballot);
+	double weight = input.get_weight(ballot);
+	int cur_idx = 0;
+
+	size_t pos = input.ballot_begin(ballot);
+
+	while (pos != end && !hopefuls[input.get_candidate(pos)]) {
+		++pos;
+	}
+
+	while (pos != end && (cur_idx < zero_run_advice
+			|| zero_run_advice == -1)) {
+
+		double group_score = input.get_score(pos);
+		size_t end_group = pos;
+		int span = 0;
+
+		// Count the hopefuls in this equal-rank group.
+		while (end_group != end &&
+			input.get_score(end_group) == group_score) {
+			if (hopefuls[input.get_candidate(end_group)]) {
+				++span;
+			}
+			++end_group;
+		}
+
+		double value = weight;
+		if (kind == PT_FRACTIONAL) {
+			value /= (double)span;
+		}
+
+		for (; pos != end_group; ++pos) {
+			size_t candidate = input.get_candidate(pos);
+			if (hopefuls[candidate]) {
+				positional_array[candidate][cur_idx] += value;
+			}
+		}
+
+		cur_idx += span;
+
+		while (pos != end && !hopefuls[input.get_candidate(pos)]) {
+			++pos;
+		}
+	}
+}
+
+std::vector<std::vector<double> >
+positional_aggregator::get_positional_matrix(
+	const compact_election & ballots, int num_candidates,
+	int num_hopefuls, const std::vector<bool> & hopefuls,
+	positional_type kind, int zero_run_advice) const {
+
+	int width = zero_run_advice;
+	if (width == -1) {
+		width = num_candidates;
+	}
+
+	std::vector<std::vector<double> > positional_matrix(num_candidates,
+		std::vector<double>(width, 0));
+
+	for (size_t ballot = 0; ballot < ballots.num_ballots(); ++ballot) {
+		aggregate(ballots, ballot, num_hopefuls, hopefuls,
+			positional_matrix, kind, zero_run_advice);
+	}
+
+	return (positional_matrix);
+}
@@ -7,6 +7,7 @@
 #define _VOTE_POS_MATRIX
 
 #include "common/ballots.h"
+#include "common/compact_ballots.h"
 #include "../method.h"
 #include <list>
 #include <vector>
@@ -53,6 +54,18 @@ class positional_aggregator {
 			int num_candidates, int num_hopefuls,
 			const std::vector<bool> & hopefuls,
 			positional_type kind) const;
+
+		// The same for the packed election representation.
+		void aggregate(const compact_election & input, size_t ballot,
+			int num_hopefuls, const std::vector<bool> & hopefuls,
+			std::vector<std::vector<double> > & positional_array,
+			positional_type kind, int zero_run_advice) const;
+		std::vector<std::vector<double> > get_positional_matrix(const
+			compact_election & ballots,
+			int num_candidates, int num_hopefuls,
+			const std::vector<bool> & hopefuls,
+			positional_type kind,
+			int zero_run_advice) const;
 };
 
 #endif
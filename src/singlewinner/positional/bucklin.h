@@ -4,9 +4,6 @@
 #include "positional.h"
 
 class bucklin : public positional {
-	private:
-		mutable sweep sweep_method;
-
 	protected:
 		virtual double pos_weight(size_t position,
 			size_t last_position) const {
@@ -23,6 +20,10 @@ class bucklin : public positional {
 
 			size_t i;
 
+			// This is local so that the method is safe to call from
+			// more than one thread.
+			sweep sweep_method(PT_WHOLE);
+
 			// Get the number of voters so we know what a majority is.
 			size_t numcands = positional_matrix.size();
 			double numvoters = 0;
@@ -39,10 +40,6 @@ class bucklin : public positional {
 						positional_matrix, num_hopefuls, hopefuls);
 
 				if (social_order.begin()->get_score() >= numvoters * 0.5) {
-					// Always set the sweep to 1 after we're done, as an
-					// invariant.
-					sweep_method.set_sweep_point(1);
-
 					return social_order;
 				}
 			}
@@ -51,7 +48,7 @@ class bucklin : public positional {
 				"Bucklin: Didn't get a majority!");
 		}
 
-		bucklin() : positional(PT_WHOLE), sweep_method(PT_WHOLE) {}
+		bucklin() : positional(PT_WHOLE) {}
 
 		std::string pos_name() const {
 			return ("Bucklin");
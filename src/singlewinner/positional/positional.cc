@@ -66,6 +66,18 @@ ordering positional::pos_elect(
 	return (social_order);
 }
 
+std::pair<ordering, bool> positional::elect_from_statistics(
+	const election_statistics & statistics,
+	bool /*winner_only*/) const {
+
+	size_t num_candidates = statistics.get_num_candidates();
+
+	return (std::pair<ordering, bool>(pos_elect(
+					statistics.get_positional_matrix(kind,
+						zero_run_beginning()), num_candidates,
+					std::vector<bool>(num_candidates, true)), false));
+}
+
 ordering positional::elect_to_ordering(const election_t & input,
 	size_t num_candidates, size_t num_hopefuls,
 	const std::vector<bool> & hopefuls) const {
@@ -76,6 +88,16 @@ ordering positional::elect_to_ordering(const election_t & input,
 			num_hopefuls, hopefuls);
 }
 
+ordering positional::elect_to_ordering(const compact_election & input,
+	size_t num_candidates, size_t num_hopefuls,
+	const std::vector<bool> & hopefuls) const {
+
+	return pos_elect(positional_aggregator().get_positional_matrix(input,
+				num_candidates, num_hopefuls, hopefuls,
+				kind, zero_run_beginning()),
+			num_hopefuls, hopefuls);
+}
+
 std::pair<ordering, bool> positional::elect_inner(const
 	election_t & input, const std::vector<bool> & hopefuls,
 	int num_candidates, cache_map * cache, bool winner_only) const {
@@ -96,10 +118,54 @@ std::pair<ordering, bool> positional::elect_inner(const
 			++num_hopefuls;
 		}
 
+	if (cache == NULL) {
+		return (std::pair<ordering, bool>(
+					elect_to_ordering(input, num_candidates, num_hopefuls,
+						hopefuls), false));
+	}
+
+	// Every positional method with the same type and zero run shares
+	// the positional matrix, so look for it in the cache first.
+
+	const std::vector<std::vector<double> > * cached_matrix =
+		cache->get_positional_matrix(kind, zero_run_beginning(), hopefuls);
+
+	if (cached_matrix == NULL) {
+		cache->set_positional_matrix(kind, zero_run_beginning(), hopefuls,
+			positional_aggregator().get_positional_matrix(input,
+				num_candidates, num_hopefuls, hopefuls,
+				kind, zero_run_beginning()));
+
+		cached_matrix = cache->get_positional_matrix(kind,
+				zero_run_beginning(), hopefuls);
+	}
+
+	// If there were too many candidates to cache, just do it directly.
+	if (cached_matrix == NULL) {
+		return (std::pair<ordering, bool>(
+					elect_to_ordering(input, num_candidates, num_hopefuls,
+						hopefuls), false));
+	}
+
+	return (std::pair<ordering, bool>(pos_elect(*cached_matrix,
+					num_hopefuls, hopefuls), false));
+};
+
+std::pair<ordering, bool> positional::elect_inner(const
+	compact_election & input, const std::vector<bool> & hopefuls,
+	int num_candidates, cache_map * cache, bool winner_only) const {
+
+	if (hopefuls.size() != (size_t)num_candidates) {
+		throw std::invalid_argument("positional: The list of hopefuls "
+			"doesn't match the number of candidates!");
+	}
+
+	int num_hopefuls = std::count(hopefuls.begin(), hopefuls.end(), true);
+
 	return (std::pair<ordering, bool>(
 				elect_to_ordering(input, num_candidates, num_hopefuls,
 					hopefuls), false));
-};
+}
 
 double positional::get_pos_score(const ballot_group & input,
 	size_t candidate_number, const std::vector<bool> & hopefuls,
@@ -4,6 +4,7 @@
 #define _VOTE_POSITIONAL
 
 #include "common/ballots.h"
+#include "common/compact_ballots.h"
 #include "../method.h"
 #include <list>
 #include <vector>
@@ -20,6 +21,9 @@ class positional : public election_method {
 		ordering elect_to_ordering(const election_t & input,
 			size_t num_candidates, size_t num_hopefuls,
 			const std::vector<bool> & hopefuls) const;
+		ordering elect_to_ordering(const compact_election & input,
+			size_t num_candidates, size_t num_hopefuls,
+			const std::vector<bool> & hopefuls) const;
 
 		std::string show_type(const positional_type & kind_in) const;
 
@@ -63,16 +67,59 @@ class positional : public election_method {
 			int num_candidates, cache_map * cache,
 			bool winner_only) const;
 
+		// Counts directly from the packed representation. The cache
+		// isn't consulted, since its outcomes are keyed to the
+		// election_t the caller is presumably not constructing.
+		std::pair<ordering, bool> elect_inner(
+			const compact_election & input,
+			const std::vector<bool> & hopefuls,
+			int num_candidates, cache_map * cache,
+			bool winner_only) const;
+
+		using election_method::elect;
+		ordering elect(const compact_election & input,
+			int num_candidates) const {
+			return elect_inner(input, std::vector<bool>(
+						num_candidates, true), num_candidates,
+					NULL, false).first;
+		}
+
+		statistics_request get_required_statistics() const {
+			statistics_request request;
+			request.positional_matrices.insert(positional_matrix_key(
+					kind, zero_run_beginning()));
+			return request;
+		}
+
+		std::pair<ordering, bool> elect_from_statistics(
+			const election_statistics & statistics,
+			bool winner_only) const;
+
 		// Particular interface to all positional methods.
 		virtual ordering pos_elect(
 			const std::vector<std::vector<double> > &
 			positional_matrix, int num_hopefuls,
 			const std::vector<bool> & hopefuls) const;
 
+		// Lets loser elimination update the tallies incrementally
+		// instead of recounting every round. Methods with weights
+		// that are constant except for the last position should
+		// override this to return IT_LAST_PREFERENCES.
+		virtual incremental_tally_type get_incremental_type() const {
+			if (zero_run_beginning() == 1) {
+				return IT_FIRST_PREFERENCES;
+			}
+			return IT_NONE;
+		}
+
 		positional(positional_type kind_in) {
 			kind = kind_in;
 		}
 
+		positional_type get_kind() const {
+			return kind;
+		}
+
 		std::string show_type() const {
 			return show_type(kind);
 		}
@@ -50,6 +50,7 @@ class sweep : public positional {
 
 		void set_sweep_point(double sw_in) {
 			sweep_point = sw_in;
+			reset_method_id();
 		}
 
 };
@@ -102,6 +103,10 @@ class antiplurality : public positional {
 		}
 
 	public:
+		incremental_tally_type get_incremental_type() const {
+			return IT_LAST_PREFERENCES;
+		}
+
 		antiplurality(positional_type kind_in) : positional(kind_in) {}
 };
 
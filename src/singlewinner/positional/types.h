@@ -5,4 +5,13 @@ enum positional_type { PT_FIRST = 0, PT_WHOLE = 0, PT_FRACTIONAL = 1,
 	PT_LAST = 1
 };
 
+// What the scores of a positional method depend on, for incremental loser
+// elimination (see elimination/incremental.h). IT_FIRST_PREFERENCES means
+// only the top hopefuls on each ballot matter (e.g. Plurality), and
+// IT_LAST_PREFERENCES means every position has the same weight except the
+// last (e.g. Antiplurality). IT_NONE means anything else.
+enum incremental_tally_type { IT_NONE = 0, IT_FIRST_PREFERENCES = 1,
+	IT_LAST_PREFERENCES = 2
+};
+
 #endif
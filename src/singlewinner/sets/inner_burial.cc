@@ -33,17 +33,17 @@ std::pair<ordering, bool> inner_burial_set::elect_inner(
 
 			bool passes_threshold = true;
 
-			for (size_t subelection = 0; subelection < se.first_pref_scores.size()
+			for (size_t subelection = 0; subelection < se.num_subelections()
 				&& passes_threshold; ++subelection) {
 
 				// If not both candidates are present in this subelection,
 				// skip.
-				if (!se.hopeful_power_set[subelection][first_cand]
-					|| !se.hopeful_power_set[subelection][sec_cand]) {
+				if (!se.contains(subelection, first_cand)
+					|| !se.contains(subelection, sec_cand)) {
 					continue;
 				}
 
-				if (se.first_pref_scores[subelection][first_cand] <=
+				if (se.get_first_prefs(subelection, first_cand) <=
 					se.num_remaining_voters[subelection]/
 					se.num_remaining_candidates[subelection]) {
 					passes_threshold = false;
@@ -7,8 +7,8 @@ std::pair<ordering, bool> mutual_majority_set::elect_inner(
 	int num_candidates, cache_map * cache,
 	bool winner_only) const {
 
-	std::vector<coalition_data> solid_coalitions =
-		get_solid_coalitions(papers, hopefuls,
+	std::vector<coalition_mask_data> solid_coalitions =
+		get_solid_coalition_masks(papers, hopefuls,
 			num_candidates);
 
 	// Now find the smallest set supported by a majority,
@@ -18,12 +18,12 @@ std::pair<ordering, bool> mutual_majority_set::elect_inner(
 		numvoters += paper.get_weight();
 	}
 
-	coalition_data current_best = *solid_coalitions.begin();
+	coalition_mask_data current_best = *solid_coalitions.begin();
 	bool found = false;
-	for (const coalition_data & cur_coalition: solid_coalitions) {
+	for (const coalition_mask_data & cur_coalition: solid_coalitions) {
 		if (cur_coalition.support > numvoters/2.0) {
-			if (!found || cur_coalition.coalition.size() <
-				current_best.coalition.size()) {
+			if (!found || cur_coalition.coalition.count() <
+				current_best.coalition.count()) {
 				current_best = cur_coalition;
 				found = true;
 			}
@@ -34,18 +34,13 @@ std::pair<ordering, bool> mutual_majority_set::elect_inner(
 	// something is *wrong*.
 	assert(found);
 
-	std::vector<bool> in_set(num_candidates, false);
-	for (int candidate_idx: current_best.coalition) {
-		in_set[candidate_idx] = true;
-	}
-
 	ordering mm_set;
 
 	for (int cand = 0; cand < num_candidates; ++cand) {
 		if (!hopefuls[cand]) {
 			continue;
 		}
-		if (in_set[cand]) {
+		if (current_best.coalition.test(cand)) {
 			mm_set.insert(candscore(cand, 1));
 		} else {
 			mm_set.insert(candscore(cand, 0));
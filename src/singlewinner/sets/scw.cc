@@ -40,7 +40,7 @@ std::pair<ordering, bool> super_condorcet_set::elect_inner(
 				continue;
 			}
 
-			if (!level_disqualifications[numcands][i][j]) {
+			if (!level_disqualifications.get(numcands, i, j)) {
 				is_super_cw = false;
 			} else {
 				++copeland_counts[i];
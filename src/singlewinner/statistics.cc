@@ -0,0 +1,275 @@
+#include "statistics.h"
+
+#include "pairwise/counter.h"
+#include "singlewinner/positional/aggregator.h"
+
+#include <algorithm>
+#include <math.h>
+#include <memory>
+#include <stdexcept>
+#include <stdint.h>
+
+void statistics_request::add(const statistics_request & other) {
+	pairwise_matrix |= other.pairwise_matrix;
+	positional_matrices.insert(other.positional_matrices.begin(),
+		other.positional_matrices.end());
+}
+
+bool statistics_request::includes(const statistics_request & other) const {
+	if (other.pairwise_matrix && !pairwise_matrix) {
+		return false;
+	}
+
+	return std::includes(positional_matrices.begin(),
+			positional_matrices.end(), other.positional_matrices.begin(),
+			other.positional_matrices.end());
+}
+
+election_statistics::election_statistics(
+	const statistics_request & request_in, size_t num_candidates_in) {
+
+	if (num_candidates_in == 0) {
+		throw std::invalid_argument("election_statistics: Must have at "
+			"least one candidate");
+	}
+
+	request = request_in;
+	num_candidates = num_candidates_in;
+	num_voters = 0;
+
+	if (request.pairwise_matrix) {
+		pairwise_counts.resize(num_candidates * num_candidates, 0);
+	}
+
+	// The positional matrices are dimensioned the same way as
+	// positional_aggregator does.
+	for (const positional_matrix_key & key: request.positional_matrices) {
+		size_t width = key.second;
+		if (width == SIZE_MAX) {
+			width = num_candidates;
+		}
+
+		positional_matrices[key] = std::vector<std::vector<double> >(
+				num_candidates, std::vector<double>(width, 0));
+	}
+}
+
+election_statistics::election_statistics(
+	const statistics_request & request_in, const election_t & ballots,
+	size_t num_candidates_in) : election_statistics(request_in,
+			num_candidates_in) {
+
+	add_ballots(ballots);
+}
+
+void election_statistics::add_ballots(const election_t & ballots) {
+	// Only set up the pairwise counter if we need it, as it's
+	// comparatively expensive to construct.
+	std::unique_ptr<pairwise_counter> counter;
+	if (request.pairwise_matrix) {
+		counter = std::unique_ptr<pairwise_counter>(
+				new pairwise_counter(num_candidates));
+	}
+
+	positional_aggregator aggregator;
+	std::vector<bool> hopefuls(num_candidates, true);
+
+	for (const ballot_group & ballot: ballots) {
+		num_voters += ballot.get_weight();
+
+		if (counter) {
+			counter->add_ballot(ballot);
+		}
+
+		for (auto & key_and_matrix: positional_matrices) {
+			aggregator.aggregate(ballot, num_candidates, num_candidates,
+				hopefuls, key_and_matrix.second, key_and_matrix.first.first,
+				key_and_matrix.first.second);
+		}
+	}
+
+	if (!counter) {
+		return;
+	}
+
+	counter->flush();
+
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		for (size_t against = 0; against < num_candidates; ++against) {
+			pairwise_counts[cand * num_candidates + against] +=
+				counter->get_count(cand, against);
+		}
+	}
+}
+
+void election_statistics::remove_ballots(const election_t & ballots) {
+	*this -= election_statistics(request, ballots, num_candidates);
+}
+
+void election_statistics::add_utilities(
+	const std::vector<double> & utilities, size_t num_ballots) {
+
+	if (utilities.size() != num_ballots * num_candidates) {
+		throw std::invalid_argument("election_statistics: Utilities "
+			"don't match the number of ballots and candidates");
+	}
+
+	num_voters += num_ballots;
+
+	size_t voter, cand;
+
+	if (request.pairwise_matrix) {
+		pairwise_counter counter(num_candidates);
+		size_t stride = counter.get_stride(), block_size =
+				pairwise_counter::BLOCK_SIZE;
+
+		// A voter's rank vector is just the voter's negated utilities,
+		// since the counter considers lower ranks better.
+		std::vector<double> rank_block(block_size * stride, -INFINITY),
+			weights(block_size, 1);
+
+		for (size_t first = 0; first < num_ballots; first += block_size) {
+			size_t count = std::min(block_size, num_ballots - first);
+
+			for (voter = 0; voter < count; ++voter) {
+				const double * utility = utilities.data() +
+					(first + voter) * num_candidates;
+
+				for (cand = 0; cand < num_candidates; ++cand) {
+					rank_block[voter * stride + cand] = -utility[cand];
+				}
+			}
+
+			counter.add_rank_block(rank_block.data(), weights.data(),
+				count);
+		}
+
+		counter.flush();
+
+		for (cand = 0; cand < num_candidates; ++cand) {
+			for (size_t against = 0; against < num_candidates; ++against) {
+				pairwise_counts[cand * num_candidates + against] +=
+					counter.get_count(cand, against);
+			}
+		}
+	}
+
+	if (positional_matrices.empty()) {
+		return;
+	}
+
+	std::vector<size_t> order(num_candidates);
+
+	for (voter = 0; voter < num_ballots; ++voter) {
+		const double * utility = utilities.data() + voter * num_candidates;
+
+		// Sort the candidates by utility, best first. There aren't many
+		// of them, so insertion sort is fine.
+		for (cand = 0; cand < num_candidates; ++cand) {
+			size_t pos = cand;
+			for (; pos > 0 && utility[order[pos-1]] < utility[cand];
+				--pos) {
+				order[pos] = order[pos-1];
+			}
+			order[pos] = cand;
+		}
+
+		// Give equally ranked candidates the same position, like
+		// positional_aggregator does.
+		for (size_t start = 0, end = 0; start < num_candidates;
+			start = end) {
+
+			while (end < num_candidates &&
+				utility[order[end]] == utility[order[start]]) {
+				++end;
+			}
+
+			for (auto & key_and_matrix: positional_matrices) {
+				std::vector<std::vector<double> > & matrix =
+					key_and_matrix.second;
+
+				if (start >= matrix[0].size()) {
+					continue;
+				}
+
+				double value = 1;
+				if (key_and_matrix.first.first == PT_FRACTIONAL) {
+					value /= (double)(end - start);
+				}
+
+				for (size_t pos = start; pos < end; ++pos) {
+					matrix[order[pos]][start] += value;
+				}
+			}
+		}
+	}
+}
+
+void election_statistics::check_compatible(
+	const election_statistics & other) const {
+
+	if (num_candidates != other.num_candidates ||
+		!request.includes(other.request) ||
+		!other.request.includes(request)) {
+
+		throw std::invalid_argument("election_statistics: Can't combine "
+			"statistics of different kinds");
+	}
+}
+
+void election_statistics::add_scaled(const election_statistics & other,
+	double factor) {
+
+	check_compatible(other);
+
+	num_voters += factor * other.num_voters;
+
+	for (size_t i = 0; i < pairwise_counts.size(); ++i) {
+		pairwise_counts[i] += factor * other.pairwise_counts[i];
+	}
+
+	for (auto & key_and_matrix: positional_matrices) {
+		const std::vector<std::vector<double> > & other_matrix =
+			other.positional_matrices.find(key_and_matrix.first)->second;
+
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			for (size_t pos = 0; pos < other_matrix[cand].size(); ++pos) {
+				key_and_matrix.second[cand][pos] +=
+					factor * other_matrix[cand][pos];
+			}
+		}
+	}
+}
+
+condmat election_statistics::get_condmat(pairwise_type type) const {
+	if (!request.pairwise_matrix) {
+		throw std::invalid_argument("election_statistics: No pairwise "
+			"matrix was requested");
+	}
+
+	condmat out(num_candidates, num_voters, type);
+
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		for (size_t against = 0; against < num_candidates; ++against) {
+			out.add(cand, against,
+				pairwise_counts[cand * num_candidates + against]);
+		}
+	}
+
+	return out;
+}
+
+const std::vector<std::vector<double> > &
+election_statistics::get_positional_matrix(positional_type kind,
+	size_t zero_run_beginning) const {
+
+	auto pos = positional_matrices.find(positional_matrix_key(kind,
+				zero_run_beginning));
+
+	if (pos == positional_matrices.end()) {
+		throw std::invalid_argument("election_statistics: No such "
+			"positional matrix was requested");
+	}
+
+	return pos->second;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+// Many methods don't need the ballots themselves, just a fixed-size summary
+// of them: pairwise methods need the pairwise matrix and positional methods
+// need the positional matrix. These summaries are summable: the summary of
+// an election is the sum of the summaries of its ballots. So they can be
+// counted for several methods in one pass over the ballots, added together
+// across parts of an election, or patched by adding and removing ballots
+// without recounting the rest.
+
+// A method declares which summaries it needs with
+// election_method::get_required_statistics, and can then elect with
+// election_method::elect_from_statistics given an election_statistics object
+// that has (at least) those summaries. Requests from several methods can be
+// merged, so that one election_statistics object serves them all.
+
+#include "common/ballots.h"
+#include "pairwise/matrix.h"
+#include "singlewinner/positional/types.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+// Positional matrices are identified by equal-rank handling and by the
+// position at which every further weight is zero (see positional.h).
+typedef std::pair<positional_type, size_t> positional_matrix_key;
+
+class statistics_request {
+	public:
+		bool pairwise_matrix;
+		std::set<positional_matrix_key> positional_matrices;
+
+		statistics_request() {
+			pairwise_matrix = false;
+		}
+
+		// An empty request means that the method needs the ballots.
+		bool empty() const {
+			return !pairwise_matrix && positional_matrices.empty();
+		}
+
+		// Includes everything in other, so that the result can be
+		// used for methods that need either.
+		void add(const statistics_request & other);
+		bool includes(const statistics_request & other) const;
+};
+
+class election_statistics {
+	private:
+		statistics_request request;
+		size_t num_candidates;
+		double num_voters;
+
+		// pairwise_counts[a * num_candidates + b] is the number of
+		// voters preferring a to b.
+		std::vector<double> pairwise_counts;
+		std::map<positional_matrix_key,
+			std::vector<std::vector<double> > > positional_matrices;
+
+		void check_compatible(const election_statistics & other) const;
+		void add_scaled(const election_statistics & other, double factor);
+
+	public:
+		// Every summary starts out empty, i.e. no voters.
+		election_statistics(const statistics_request & request_in,
+			size_t num_candidates_in);
+		election_statistics(const statistics_request & request_in,
+			const election_t & ballots, size_t num_candidates_in);
+
+		// Count every requested summary in one pass over the ballots.
+		void add_ballots(const election_t & ballots);
+		void remove_ballots(const election_t & ballots);
+
+		// Count the summaries of num_ballots voters who rank the
+		// candidates by utility, given as utilities[voter *
+		// num_candidates + cand]. This gives the same result as counting
+		// ballots that rate each candidate at its utility, but
+		// without making the ballots.
+		void add_utilities(const std::vector<double> & utilities,
+			size_t num_ballots);
+
+		// Both sides must have the same request and number of
+		// candidates.
+		election_statistics & operator+=(const election_statistics & other) {
+			add_scaled(other, 1);
+			return *this;
+		}
+
+		election_statistics & operator-=(const election_statistics & other) {
+			add_scaled(other, -1);
+			return *this;
+		}
+
+		const statistics_request & get_request() const {
+			return request;
+		}
+
+		size_t get_num_candidates() const {
+			return num_candidates;
+		}
+
+		double get_num_voters() const {
+			return num_voters;
+		}
+
+		// These throw std::invalid_argument if the summary wasn't
+		// requested.
+		condmat get_condmat(pairwise_type type) const;
+		const std::vector<std::vector<double> > & get_positional_matrix(
+			positional_type kind, size_t zero_run_beginning) const;
+};
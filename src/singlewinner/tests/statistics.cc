@@ -0,0 +1,102 @@
+// Tests for electing from summary statistics.
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "singlewinner/elimination/elimination.h"
+#include "singlewinner/pairwise/simple_methods.h"
+#include "singlewinner/positional/simple_methods.h"
+#include "singlewinner/statistics.h"
+
+static std::vector<std::shared_ptr<election_method> > get_summable_methods() {
+	return {
+		std::make_shared<schulze>(CM_WV),
+		std::make_shared<ext_minmax>(CM_MARGINS, false),
+		std::make_shared<copeland>(CM_PAIRWISE_OPP),
+		std::make_shared<borda>(PT_WHOLE),
+		std::make_shared<borda>(PT_FRACTIONAL),
+		std::make_shared<plurality>(PT_FRACTIONAL),
+		std::make_shared<antiplurality>(PT_WHOLE)
+	};
+}
+
+// One statistics object, counted in one pass, should serve every method.
+TEST(Statistics, MatchesElectingFromBallots) {
+	rng randomizer(1);
+	size_t num_candidates = 5;
+
+	statistics_request request;
+	for (auto method: get_summable_methods()) {
+		EXPECT_FALSE(method->get_required_statistics().empty());
+		request.add(method->get_required_statistics());
+	}
+
+	for (int iteration = 0; iteration < 50; ++iteration) {
+		election_t election = get_random_election(num_candidates, 30, 4,
+				true, true, randomizer);
+		election_statistics statistics(request, election, num_candidates);
+
+		for (auto method: get_summable_methods()) {
+			EXPECT_EQ(method->elect_from_statistics(statistics,
+					false).first, method->elect(election, num_candidates));
+		}
+	}
+}
+
+TEST(Statistics, ShardsAddUp) {
+	rng randomizer(2);
+	size_t num_candidates = 4;
+
+	statistics_request request;
+	request.pairwise_matrix = true;
+	request.add(borda(PT_WHOLE).get_required_statistics());
+
+	election_t first = get_random_election(num_candidates, 20, 4, true,
+			true, randomizer);
+	election_t second = get_random_election(num_candidates, 20, 4, true,
+			true, randomizer);
+	election_t both = first;
+	both.insert(both.end(), second.begin(), second.end());
+
+	election_statistics combined(request, first, num_candidates),
+						reference(request, both, num_candidates);
+	combined += election_statistics(request, second, num_candidates);
+
+	condmat combined_matrix = combined.get_condmat(CM_PAIRWISE_OPP),
+			reference_matrix = reference.get_condmat(CM_PAIRWISE_OPP);
+
+	EXPECT_EQ(combined.get_num_voters(), reference.get_num_voters());
+
+	for (size_t cand = 0; cand < num_candidates; ++cand) {
+		for (size_t against = 0; against < num_candidates; ++against) {
+			EXPECT_EQ(combined_matrix.get_magnitude(cand, against),
+				reference_matrix.get_magnitude(cand, against));
+		}
+	}
+
+	EXPECT_EQ(combined.get_positional_matrix(PT_WHOLE, SIZE_MAX),
+		reference.get_positional_matrix(PT_WHOLE, SIZE_MAX));
+
+	// Removing the second shard should give the statistics of the first.
+	combined.remove_ballots(second);
+
+	EXPECT_EQ(combined.get_positional_matrix(PT_WHOLE, SIZE_MAX),
+		election_statistics(request, first, num_candidates).
+		get_positional_matrix(PT_WHOLE, SIZE_MAX));
+
+	EXPECT_THROW(combined.get_positional_matrix(PT_FRACTIONAL, SIZE_MAX),
+		std::invalid_argument);
+	EXPECT_THROW(combined += election_statistics(statistics_request(),
+			num_candidates), std::invalid_argument);
+}
+
+TEST(Statistics, NonSummableMethodsRefuse) {
+	instant_runoff_voting irv(PT_WHOLE, false);
+
+	EXPECT_TRUE(irv.get_required_statistics().empty());
+	EXPECT_THROW(irv.elect_from_statistics(election_statistics(
+				statistics_request(), 3), false), std::logic_error);
+}
@@ -0,0 +1,85 @@
+// Tests for Young's method.
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/tests/random_elections.h"
+#include "singlewinner/young.h"
+
+// The fewest ballots we need to delete to make the candidate a strict CW,
+// by trying every subset of ballots to keep. Unranked candidates count as
+// below every ranked one. If no subset works, every ballot has to go.
+static size_t brute_force_deletions(const election_t & election,
+	size_t num_candidates, size_t candidate) {
+
+	std::vector<std::vector<double> > ratings;
+	for (const ballot_group & ballot: election) {
+		std::vector<double> rating(num_candidates, -1);
+		for (const candscore & pos: ballot.contents) {
+			rating[pos.get_candidate_num()] = pos.get_score();
+		}
+		ratings.push_back(rating);
+	}
+
+	size_t num_ballots = ratings.size(), fewest = num_ballots;
+
+	for (size_t kept = 1; kept < ((size_t)1 << num_ballots); ++kept) {
+		bool is_cw = true;
+
+		for (size_t other = 0; other < num_candidates && is_cw; ++other) {
+			if (other == candidate) {
+				continue;
+			}
+
+			int margin = 0;
+			for (size_t i = 0; i < num_ballots; ++i) {
+				if ((kept & ((size_t)1 << i)) == 0) {
+					continue;
+				}
+				if (ratings[i][candidate] > ratings[i][other]) {
+					++margin;
+				}
+				if (ratings[i][candidate] < ratings[i][other]) {
+					--margin;
+				}
+			}
+			is_cw = margin > 0;
+		}
+
+		if (is_cw) {
+			fewest = std::min(fewest, num_ballots -
+					__builtin_popcountll(kept));
+		}
+	}
+
+	return fewest;
+}
+
+// The integer program's score is the number of ballots that remain, so it
+// should be the number of ballots minus the fewest deletions. This needs a
+// working GLPK.
+TEST(Young, IntegerScoreMatchesBruteForce) {
+	rng randomizer(1);
+
+	for (int trial = 0; trial < 100; ++trial) {
+		size_t num_candidates = 2 + randomizer.next_int(3),
+			num_voters = 1 + randomizer.next_int(9);
+
+		election_t election = get_random_election(num_candidates,
+				num_voters, 3, trial % 2 == 1, false, randomizer);
+		std::vector<bool> hopefuls(num_candidates, true);
+
+		young_model model(election, num_candidates, hopefuls, false,
+			false, false);
+
+		for (size_t cand = 0; cand < num_candidates; ++cand) {
+			double expected = election.size() -
+				brute_force_deletions(election, num_candidates, cand);
+
+			EXPECT_EQ(model.get_young_score(cand).second, expected)
+					<< "trial " << trial << ", candidate " << cand;
+		}
+	}
+}
@@ -15,208 +15,141 @@
 #include "young.h"
 
 
-std::pair<double, double> young::get_young_score(const
-	election_t &
-	papers,
-	size_t candidate, size_t num_candidates, size_t num_ballots,
-	const std::vector<bool> & hopeful, bool relaxed,
-	bool symmetric_completion, bool debug) const {
+young_model::young_model(const election_t & papers,
+	size_t num_candidates_in, const std::vector<bool> & hopefuls_in,
+	bool relaxed_in, bool symmetric_completion, bool debug_in) {
 
-	std::pair<double, double> score(-1, -1);
+	num_candidates = num_candidates_in;
+	num_ballots = papers.size();
+	hopefuls = hopefuls_in;
+	relaxed = relaxed_in;
+	debug = debug_in;
 
-	assert(candidate < num_candidates);
-	if (!hopeful[candidate]) {
-		return (score);
+	// Setting tie_val to 0.5 may make it break Condorcet when there are
+	// many voters. However, having this value > 0 (e.g. 0.01) seems to
+	// improve BR. More investigation is needed.
+	// Setting it to (num_candidates * (num_candidates - 1)) seems to work.
+	tie_val = 0;
+	if (symmetric_completion) {
+		//tie_val = 0.5;
+		tie_val = 1/(double)(num_candidates * (num_candidates-1));
 	}
 
 	// Yup, you guessed it, it's return of GLPK.
 
-	// Create the problem we want to solve. (Maybe move this off-function
-	// later?)
-	glp_prob * ip;
 	ip = glp_create_prob();
 	assert(ip != NULL);
-	glp_set_prob_name(ip, std::string("Young score for " +
-			itos(candidate)).c_str());
+	glp_set_prob_name(ip, "Young score");
 	glp_set_obj_dir(ip, GLP_MAX); // Maximum score.
 
-	// Row = alias variables, e.g. p = sum over i x[i] * e[i][c*][1],
-	// then later, p > 0. There are (num_hopefuls - 1) of these, but we
-	// just fix them to num_candidates-1 and have everybody beat the not-
-	// hopefuls - for simplicity's sake.
+	// Row = alias variables, e.g. p = sum over i x[i] * e[i][c*][a],
+	// then later, p > 0. We have one row for every candidate a, so that
+	// row a means the same thing no matter who c* is; c*'s own row is left
+	// free. Non-hopefuls get rows too, but everybody beats them, for
+	// simplicity's sake.
 
 	// Columns = terms (e[0][c*][1], e[1][c*][1], e[2][c*][1]...).
 	//	We'll need num_ballots of these.
 
-	// c*'s Young score:
-	//      max sum over values x[i] so that
-	//              for all candidates a except for c*,
-	//                      sum over i
-	//                               x[i] * e[i][c*][a]
-	//                        >= 1
-	// for all i, x[i] is integer, 0 >= x[i] >= wt[i], where wt[i] is
-	// the weight of the ith ballot,
-
-	glp_add_rows(ip, num_candidates - 1);
-	glp_add_cols(ip, num_ballots);
-
-	// We also need ia, ja, and ar parameters for the matrix itself.
-	// if ia[x] is 1, ja[x] is 2, and ar[x] is 3, that means that
-	// the first (1.) alias parameter contains the second (2.) optimization
-	// variable, times 3.
-
-	// ia[x] will contain the candidate number since the first row deals
-	// with c*'s victory over the first candidate, the second row deals with
-	// c*'s victory over the second candidate, and so on. So x's maximum
-	// value is (num_candidates - 1) * (num_ballots).
-
-	// ja increases with ballot number, and ar is 1, 0, -1, depending
-	// on whether the voter ranked c* above, equal, or below the other
-	// candidate in question.
-
-	// Since the ballots aren't random access, the easiest way to handle
-	// this is to keep ja fixed and then set ia to the candidate number
-	// (plus one, since glpk starts at 1), and ar to the relevant victory
-	// number.
-
-	int entries = (num_candidates - 1) * (num_ballots);
-	int * ia = new int[entries + 1];
-	int * ja = new int[entries + 1];
-	double * ar = new double[entries + 1];
-	int running_ballot_count = 1, running_count = 1;
-	size_t counter;
-
-	std::vector<double> vs_others(num_candidates);
-
-	std::string name;
+	glp_add_rows(ip, num_candidates);
+	if (num_ballots > 0) {
+		glp_add_cols(ip, num_ballots);
+	}
 
-	double tie_val = 0;
+	ranked = std::vector<std::vector<bool> >(num_ballots,
+			std::vector<bool>(num_candidates, false));
+	rank_score = std::vector<std::vector<double> >(num_ballots,
+			std::vector<double>(num_candidates, 0));
 
-	// Setting tie_val to 0.5 may make it break Condorcet when there are
-	// many voters. However, having this value > 0 (e.g. 0.01) seems to
-	// improve BR. More investigation is needed.
-	// Setting it to (num_candidates * (num_candidates - 1)) seems to work.
-	if (symmetric_completion)
-		//tie_val = 0.5;
-	{
-		tie_val = 1/(double)(num_candidates * (num_candidates-1));
-	}
+	size_t ballot = 0;
+	std::string name;
 
 	for (election_t::const_iterator pos = papers.begin(); pos !=
 		papers.end(); ++pos) {
 		// If not relaxed, we can't handle non-integer ballot sizes.
 		assert(relaxed || pos->get_weight() == round(pos->get_weight()));
 
-		// Determine the data we need for ar. This is sort of a copy
-		// of the code in matrix.cc, but to do it through a Condorcet
-		// matrix would take a whole lot longer.
-
-		ordering::const_iterator ourcand = pos->contents.end(), opos;
-
-		// First find the current candidate.
-		for (opos = pos->contents.begin(); opos != pos->contents.end()
-			&& ourcand == pos->contents.end(); ++opos)
-			if ((size_t)opos->get_candidate_num() == candidate) {
-				ourcand = opos;
-			}
-
-		if (ourcand == pos->contents.end()) {
-			// If the candidate wasn't found, that means the voter
-			// truncated and thus everybody else who is ranked is
-			// above him, all other hopefuls equal, not-hopefuls
-			// below.
-
-			if (debug) {
-				std::cout << "Didn't find that candidate." << std::endl;
-			}
+		for (ordering::const_iterator opos = pos->contents.begin();
+			opos != pos->contents.end(); ++opos) {
 
-			for (counter = 0; counter < hopeful.size(); ++counter)
-				if (hopeful[counter] || counter == candidate) {
-					vs_others[counter] = tie_val;
-				} else	{
-					vs_others[counter] = 1;
-				}
+			size_t cand = opos->get_candidate_num();
+			assert(cand < num_candidates);
 
-			for (opos = pos->contents.begin(); opos !=
-				pos->contents.end(); ++opos) {
-				vs_others[opos->get_candidate_num()] = -1;
+			if (!ranked[ballot][cand]) {
+				ranked[ballot][cand] = true;
+				rank_score[ballot][cand] = opos->get_score();
 			}
-		} else {
-			// If the candidate was found, check for all others
-			// whether c* ranks above them. If c* does, 1; if he
-			// doesn't, either 0 or -1. Truncated and not-hopeful
-			// candidates aren't checked and so get an automatic 1.
+		}
 
-			fill(vs_others.begin(), vs_others.end(), 1);
+		// Set the column constraint for this voter. The x parameter
+		// can't be above the ballot's weight, nor can it be below
+		// zero.
 
-			if (debug) {
-				std::cout << "Found that candidate." << std::endl;
-			}
+		glp_set_col_bnds(ip, ballot + 1, GLP_DB, 0, pos->get_weight());
 
-			for (opos = pos->contents.begin(); opos !=
-				pos->contents.end(); ++opos) {
-				if (!hopeful[opos->get_candidate_num()]) {
-					continue;
-				}
-
-				if (opos->get_score() > ourcand->get_score())
-					vs_others[opos->get_candidate_num()]
-						= -1;
-				if (opos->get_score() == ourcand->get_score())
-					vs_others[opos->get_candidate_num()]
-						= tie_val;
-			}
+		if (debug) {
+			name = "x[" + itos(ballot) + "]";
+			glp_set_col_name(ip, ballot + 1, name.c_str());
 		}
 
-		if (debug) {
-			std::cout << "Our candidate is number " << candidate << std::endl;
-			std::cout << "The versus array is: ";
-			copy(vs_others.begin(), vs_others.end(),
-				std::ostream_iterator<double>(std::cout, " "));
-			std::cout << std::endl;
+		if (!relaxed) {
+			glp_set_col_kind(ip, ballot + 1, GLP_IV);
 		}
 
-		for (counter = 0; counter < vs_others.size(); ++counter) {
-			if (counter == candidate) {
-				continue;
-			}
+		// Finally, set the objective coefficient. They will all be
+		// one, since no voter is more important than another.
+		glp_set_obj_coef(ip, ballot + 1, 1);
 
-			if (counter < candidate) {
-				ia[running_count] = 1 + counter;
-			} else	{
-				ia[running_count] = counter;
-			}
+		++ballot;
+	}
 
-			ja[running_count] = running_ballot_count;
-			ar[running_count] = vs_others[counter];
-			++running_count;
-		}
+	row_indices.resize(num_ballots + 1);
+	row_values.resize(num_ballots + 1);
 
-		// Set the column constraint for this voter. The x parameter
-		// can't be above the ballot's weight, nor can it be below
-		// zero.
+	// Start from an advanced (crash) basis. Later candidates start from
+	// the basis of the one before.
+	glp_adv_basis(ip, 0);
+}
 
-		glp_set_col_bnds(ip, running_ballot_count, GLP_DB, 0,
-			pos->get_weight());
+young_model::~young_model() {
+	glp_delete_prob(ip);
+}
 
-		if (debug) {
-			name = "x[" + itos(running_ballot_count - 1) + "]";
-			glp_set_col_name(ip, running_ballot_count,
-				name.c_str());
-		}
+// This is 1 if the ballot ranks the candidate above the other, -1 if
+// below, and tie_val if they're equal. Truncated and non-hopeful candidates
+// count as ranked below every ranked candidate; if the candidate itself is
+// truncated, it's equal to the other truncated hopefuls.
 
-		if (!relaxed) {
-			glp_set_col_kind(ip, running_ballot_count, GLP_IV);
+double young_model::get_coefficient(size_t ballot, size_t candidate,
+	size_t other) const {
+
+	if (!ranked[ballot][candidate]) {
+		if (ranked[ballot][other]) {
+			return -1;
 		}
+		if (hopefuls[other]) {
+			return tie_val;
+		}
+		return 1;
+	}
 
-		++running_ballot_count;
+	if (!ranked[ballot][other] || !hopefuls[other]) {
+		return 1;
 	}
 
-	assert(running_count <= entries + 1);
-	glp_load_matrix(ip, running_count - 1, ia, ja, ar);
+	if (rank_score[ballot][other] > rank_score[ballot][candidate]) {
+		return -1;
+	}
+	if (rank_score[ballot][other] == rank_score[ballot][candidate]) {
+		return tie_val;
+	}
+	return 1;
+}
 
-	// Now set row constraints. These must all be above zero, i.e. the
-	// candidate must win pairwise against each of them.
+void young_model::set_candidate(size_t candidate) {
+
+	// The row constraints must all be above zero, i.e. the candidate
+	// must win pairwise against each of them.
 
 	// Unfortunately, GLPK only supports >=. This is not a problem in
 	// the integer case since we can just set >= 1, but in the relaxed
@@ -229,34 +162,41 @@ std::pair<double, double> young::get_young_score(const
 	// 1 is as good a value as any. Just remember this when you use ballot
 	// weights < 1.
 
-	for (counter = 0; counter < num_candidates - 1; ++counter) {
-		size_t realcand = counter;
-		if (realcand >= candidate) {
-			++realcand;
-		}
+	std::string name;
 
-		if (debug) {
-			name = "vs_cand_" + itos(realcand);
-			glp_set_row_name(ip, counter + 1, name.c_str());
+	for (size_t other = 0; other < num_candidates; ++other) {
+		if (other == candidate) {
+			glp_set_mat_row(ip, other + 1, 0, NULL, NULL);
+			glp_set_row_bnds(ip, other + 1, GLP_FR, 0, 0);
+			continue;
 		}
 
-		glp_set_row_bnds(ip, counter + 1, GLP_LO, 1, 1);
-	}
+		// GLPK wants 1-indexed arrays, and we leave out zeroes.
+		int len = 0;
 
-	// Finally, set the objective coefficients. They will all be one,
-	// since no voter is more important than another.
+		for (size_t ballot = 0; ballot < num_ballots; ++ballot) {
+			double coefficient = get_coefficient(ballot, candidate,
+					other);
 
-	for (counter = 0; counter < num_ballots; ++counter) {
-		glp_set_obj_coef(ip, counter + 1, 1);
-	}
+			if (coefficient != 0) {
+				++len;
+				row_indices[len] = ballot + 1;
+				row_values[len] = coefficient;
+			}
+		}
+
+		glp_set_mat_row(ip, other + 1, len, row_indices.data(),
+			row_values.data());
+		glp_set_row_bnds(ip, other + 1, GLP_LO, 1, 1);
 
-	// All done. Now let's set a few parameters involving verbosity and
-	// then solve. We first solve the linear programming relaxation since
-	// the presolving done there will greatly speed up the problem. If
-	// relaxed is on or the solution is integer, we're done, otherwise
-	// continue to the integer programming solver. The actual score
-	// is simply the objective.
+		if (debug) {
+			name = "vs_cand_" + itos(other);
+			glp_set_row_name(ip, other + 1, name.c_str());
+		}
+	}
+}
 
+int young_model::solve_relaxation() {
 	glp_smcp params;
 	glp_init_smcp(&params);
 
@@ -265,26 +205,50 @@ std::pair<double, double> young::get_young_score(const
 	} else	{
 		params.msg_lev = GLP_MSG_OFF;
 	}
-	params.presolve = GLP_ON;
 
-	/*glp_write_lp(ip, NULL, "output.txt");
-	assert (1 != 1);*/
+	// No presolving, because that would throw away the basis we're
+	// starting from.
+	params.presolve = GLP_OFF;
 
-	// Solve the relaxation. If it doesn't succeed and it's not an
-	// infeasibility problem (see later) , clean up and return -1
-	// for error.
 	int simplex_return = glp_simplex(ip, &params);
-	bool no_soln = (simplex_return == GLP_ENOPFS);
 
-	if (simplex_return != 0 && simplex_return != GLP_ENOPFS) {
+	// If the previous basis is unusable for this candidate (e.g.
+	// singular), start over from a crash basis.
+	if (simplex_return != 0) {
 		if (debug) {
-			std::cout << "First error, val = " << simplex_return << std::endl;
+			std::cout << "Warm start failed, val = " << simplex_return
+				<< std::endl;
 		}
+		glp_adv_basis(ip, 0);
+		simplex_return = glp_simplex(ip, &params);
+	}
 
-		delete[] ar;
-		delete[] ia;
-		delete[] ja;
-		glp_delete_prob(ip);
+	return simplex_return;
+}
+
+std::pair<double, double> young_model::get_young_score(size_t candidate) {
+
+	std::pair<double, double> score(-1, -1);
+
+	assert(candidate < num_candidates);
+	if (!hopefuls[candidate]) {
+		return (score);
+	}
+
+	set_candidate(candidate);
+
+	// All done. Now let's solve. We first solve the linear programming
+	// relaxation. If relaxed is on or the solution is integer, we're done,
+	// otherwise continue to the integer programming solver. The actual
+	// score is simply the objective.
+
+	// If the relaxation doesn't succeed, return -1 for error.
+	int simplex_return = solve_relaxation();
+
+	if (simplex_return != 0) {
+		if (debug) {
+			std::cout << "First error, val = " << simplex_return << std::endl;
+		}
 		return (score);
 	}
 
@@ -292,72 +256,71 @@ std::pair<double, double> young::get_young_score(const
 	// If not, there's no way to make the candidate the CW. This can happen,
 	// for instance, if he's rated last on every ballot. If there's no way
 	// to make the candidate the CW, his score is 0.
-	if (no_soln || glp_get_status(ip) == GLP_NOFEAS) {
+	if (glp_get_status(ip) == GLP_NOFEAS) {
 		if (debug)
 			std::cout << "No possible way to make this candidate a CW."
 				<< std::endl;
-		score = std::pair<double, double>(0, 0);
-	} else {
-		// So there *is* a potential way to make him the CW.
+		return (std::pair<double, double>(0, 0));
+	}
 
-		// If we want the relaxation or we're all integer, return the
-		// objective straight ahead.
+	// So there *is* a potential way to make him the CW.
 
-		score.first = glp_get_obj_val(ip);
+	// If we want the relaxation or we're all integer, return the
+	// objective straight ahead.
 
-		bool relaxed_okay = true;
+	score.first = glp_get_obj_val(ip);
 
-		for (counter = 0; counter < num_ballots && relaxed_okay;
-			++counter) {
-			double retval = glp_get_col_prim(ip, counter+1);
-			relaxed_okay = (retval == (int)retval);
-		}
+	bool relaxed_okay = true;
 
-		if (relaxed_okay) {
-			score.second = glp_get_obj_val(ip);
-		}
+	for (size_t counter = 0; counter < num_ballots && relaxed_okay;
+		++counter) {
+		double retval = glp_get_col_prim(ip, counter+1);
+		relaxed_okay = (retval == (int)retval);
+	}
 
-		// If the linear solution isn't integer-perfect and we
-		// want an integer solution, provide it.
-		if (!relaxed_okay && !relaxed) {
+	if (relaxed_okay) {
+		score.second = score.first;
+	}
 
-			// Looks like we need to use the IP solver.
+	// If the linear solution isn't integer-perfect and we
+	// want an integer solution, provide it.
+	if (relaxed_okay || relaxed) {
+		return (score);
+	}
 
-			glp_iocp io_param;
-			glp_init_iocp(&io_param);
+	// Looks like we need to use the IP solver. It starts from the
+	// relaxation's optimal basis that we just found.
 
-			if (debug) {
-				io_param.msg_lev = GLP_MSG_ALL;
-			} else	{
-				io_param.msg_lev = GLP_MSG_OFF;
-			}
+	glp_iocp io_param;
+	glp_init_iocp(&io_param);
 
-			// Make use of the advanced cut options, as they
-			// significantly speed up the search.
-			io_param.bt_tech = GLP_BT_BPH;
-			io_param.gmi_cuts = GLP_ON;
-			io_param.mir_cuts = GLP_ON;
-
-			// I could have implemented a "non-exact" version that
-			// finds out the maximum error we can have while still
-			// getting the same ranking, and then have set that as
-			// mip_gap, but my version of GLPK seems to have a bug
-			// where it immediately times out if mip_gap != 0.
-
-			if (glp_intopt(ip, &io_param) != 0) {
-				score.second = -1;
-			} else {
-				score.second = glp_get_obj_val(ip);
-			}
-		}
+	if (debug) {
+		io_param.msg_lev = GLP_MSG_ALL;
+	} else	{
+		io_param.msg_lev = GLP_MSG_OFF;
 	}
 
-	// Clean up and return.
-
-	delete[] ia;
-	delete[] ja;
-	delete[] ar;
-	glp_delete_prob(ip);
+	// Make use of the advanced cut options, as they
+	// significantly speed up the search.
+	io_param.bt_tech = GLP_BT_BPH;
+	io_param.gmi_cuts = GLP_ON;
+	io_param.mir_cuts = GLP_ON;
+
+	// I could have implemented a "non-exact" version that
+	// finds out the maximum error we can have while still
+	// getting the same ranking, and then have set that as
+	// mip_gap, but my version of GLPK seems to have a bug
+	// where it immediately times out if mip_gap != 0.
+
+	if (glp_intopt(ip, &io_param) != 0) {
+		score.second = -1;
+	} else if (glp_mip_status(ip) == GLP_NOFEAS) {
+		// The relaxation could make the candidate the CW, but no integer
+		// solution can.
+		score.second = 0;
+	} else {
+		score.second = glp_mip_obj_val(ip);
+	}
 
 	return (score);
 }
@@ -389,17 +352,15 @@ std::pair<ordering, bool> young::elect_inner(const election_t
 
 	ordering toRet;
 
-	int num_ballots = papers.size(); // O(n)
+	young_model model(papers, num_candidates, hopefuls, is_relaxed,
+		is_sym_comp, false);
 
 	for (int counter = 0; counter < num_candidates; ++counter) {
 		if (!hopefuls[counter]) {
 			continue;
 		}
 
-		std::pair<double, double> score = get_young_score(
-				papers, counter, num_candidates,
-				num_ballots, hopefuls, is_relaxed, is_sym_comp,
-				false);
+		std::pair<double, double> score = model.get_young_score(counter);
 
 		if (is_relaxed) {
 			assert(score.first != -1);
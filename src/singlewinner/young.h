@@ -29,6 +29,13 @@
 // The integer programming version restricts ballot weights to integers. A
 // relaxed, linear programming version does not.
 
+// Every candidate's program has the same variables, bounds and objective;
+// only the constraint coefficients differ. So young_model builds the program
+// once per election and then, for each candidate, only replaces the rows'
+// coefficients. The simplex then starts from the previous candidate's
+// optimal basis, which is usually close, and the integer solver is only run
+// if the relaxation's solution is fractional.
+
 #ifndef _VOTE_YOUNG
 #define _VOTE_YOUNG
 
@@ -42,20 +49,52 @@
 #include <assert.h>
 
 
-class young : public election_method {
+class young_model {
 	private:
-		std::string cached_name;
-		bool is_sym_comp, is_relaxed;
+		glp_prob * ip;
+		size_t num_candidates, num_ballots;
+		std::vector<bool> hopefuls;
+		bool relaxed, debug;
+		double tie_val;
+
+		// ranked[i][c] is true if the ith ballot ranks c, and if so,
+		// rank_score[i][c] is the score it gives c.
+		std::vector<std::vector<bool> > ranked;
+		std::vector<std::vector<double> > rank_score;
+
+		// Scratch space for setting rows.
+		std::vector<int> row_indices;
+		std::vector<double> row_values;
+
+		// e[i][c*][a] as defined above.
+		double get_coefficient(size_t ballot, size_t candidate,
+			size_t other) const;
+
+		void set_candidate(size_t candidate);
+
+		// Returns GLPK's error code.
+		int solve_relaxation();
+
+		young_model(const young_model & other) = delete;
+		young_model & operator=(const young_model & other) = delete;
+
+	public:
+		young_model(const election_t & papers,
+			size_t num_candidates_in,
+			const std::vector<bool> & hopefuls_in, bool relaxed_in,
+			bool symmetric_completion, bool debug_in);
+		~young_model();
 
 		// returns (-1, -1) on error. The first of the pair is the
 		// linear programming score. The second is the integer
 		// programming score, or -1 if running relaxed.
-		std::pair<double, double> get_young_score(
-			const election_t & papers,
-			size_t candidate, size_t num_candidates,
-			size_t num_ballots, const std::vector<bool> & hopefuls,
-			bool relaxed, bool symmetric_completion,
-			bool debug) const;
+		std::pair<double, double> get_young_score(size_t candidate);
+};
+
+class young : public election_method {
+	private:
+		std::string cached_name;
+		bool is_sym_comp, is_relaxed;
 
 		std::string determine_name() const;
 
@@ -1,5 +1,15 @@
 #include "coordinate_gen.h"
 #include <stdexcept>
+#include <algorithm>
+
+void coordinate_gen::get_coordinates(size_t dimension, size_t count,
+	double * out) {
+
+	for (size_t i = 0; i < count; ++i) {
+		std::vector<double> coordinate = get_coordinate(dimension);
+		std::copy(coordinate.begin(), coordinate.end(), out + i * dimension);
+	}
+}
 
 double coordinate_gen::next_double(double min, double max) {
 	if (min > max) {
@@ -34,6 +34,13 @@ class coordinate_gen {
 		// Generates an n-dimensional vector in the hypercube [0..1]^n.
 		virtual std::vector<double> get_coordinate(size_t dimension) = 0;
 
+		// Generates count such vectors one after another into out, which
+		// must have room for count * dimension doubles. This gives the
+		// same coordinates as calling get_coordinate count times, but
+		// lets the generator skip the allocation for each.
+		virtual void get_coordinates(size_t dimension, size_t count,
+			double * out);
+
 		virtual std::vector<uint64_t> get_longs(
 			const std::vector<uint64_t> end) {
 			return get_integers_T(end);
@@ -4,14 +4,14 @@
 #include <stdexcept>
 #include <limits>
 #include <vector>
+#include <algorithm>
 
 // If we need it later, implement a general covariance matrix.
 
-// Our normal variate generation is currently based on inverse sampling.
-// This not measurably slower than rejection sampling and has the benefit
-// that it does not consume extra entropy, thus it can be used for Quasi-Monte
-// Carlo. It may be faster to use the Ziggurat algorithm for ordinary Monte
-// Carlo; I'll implement that later if necessary.
+// Our normal variate generation for QMC is based on inverse sampling,
+// since that doesn't consume extra entropy. For ordinary Monte Carlo,
+// fill_standard uses the ziggurat algorithm instead, which turned out to
+// be noticeably faster once ballot generation was done in blocks.
 
 // The qnorm code is from
 // https://gist.github.com/kmpm/1211922/6b7fcd0155b23c3dc71e6f4969f2c48785371292
@@ -117,6 +117,152 @@ double gaussian_dist::qnorm(double p, double mu, double sigma) const {
 	return mu + sigma * val;
 }
 
+void gaussian_dist::qnorm_block(double * p_inout, size_t count) const {
+	size_t i;
+
+	for (i = 0; i < count; ++i) {
+		if (p_inout[i] < 0 || p_inout[i] > 1) {
+			throw std::invalid_argument(
+				"The probality p must be bigger than 0 and smaller than 1");
+		}
+	}
+
+	// Most of the time (85%), we're in the central region. So first
+	// calculate the central approximation for a chunk without branching,
+	// then go back and fix up the tails one at a time. We need to keep the
+	// original probabilities around to know which are the tails.
+
+	const size_t CHUNK = 64;
+	double p[CHUNK];
+
+	for (size_t start = 0; start < count; start += CHUNK) {
+		size_t len = std::min(CHUNK, count - start);
+		double * out = p_inout + start;
+
+		std::copy(out, out + len, p);
+
+		for (i = 0; i < len; ++i) {
+			double q = p[i] - 0.5, r = .180625 - q * q;
+
+			out[i] = q * ((((((
+										(r * 2509.0809287301226727 + 3430.575583588128105) * r +
+										67265.770927008700853) * r +
+									45921.953931549871457) * r + 13731.693765509461125) * r +
+							1971.5909503065514427) * r + 133.14166789178437745) * r +
+					3.387132872796366608)
+				/ (((((((r * 5226.495278852854561 +
+											28729.085735721942674) * r + 39307.89580009271061) * r +
+									21213.794301586595867) * r + 5394.1960214247511077) * r +
+							687.1870074920579083) * r + 42.313330701600911252) * r + 1);
+		}
+
+		for (i = 0; i < len; ++i) {
+			if (fabs(p[i] - 0.5) > .425) {
+				out[i] = qnorm(p[i], 0, 1);
+			}
+		}
+	}
+}
+
+// The ziggurat method of Marsaglia and Tsang, with 128 layers, in the form
+// given by
+// DOORNIK, Jurgen A. An improved ziggurat method to generate normal random
+// samples. University of Oxford, 2005.
+// which avoids the correlation between the layer and the sample.
+
+const int ZIGGURAT_LAYERS = 128;
+const double ZIGGURAT_R = 3.442619855899,        // Start of the tail
+			 ZIGGURAT_V = 9.91256303526217e-3;   // Area of each layer
+
+class ziggurat_tables {
+	public:
+		double x[ZIGGURAT_LAYERS + 1], ratio[ZIGGURAT_LAYERS];
+
+		ziggurat_tables() {
+			double f = exp(-0.5 * ZIGGURAT_R * ZIGGURAT_R);
+
+			x[0] = ZIGGURAT_V / f;
+			x[1] = ZIGGURAT_R;
+			x[ZIGGURAT_LAYERS] = 0;
+
+			for (int i = 2; i < ZIGGURAT_LAYERS; ++i) {
+				x[i] = sqrt(-2 * log(ZIGGURAT_V / x[i-1] + f));
+				f = exp(-0.5 * x[i] * x[i]);
+			}
+
+			for (int i = 0; i < ZIGGURAT_LAYERS; ++i) {
+				ratio[i] = x[i+1] / x[i];
+			}
+		}
+};
+
+double gaussian_dist::ziggurat(coordinate_gen & coord_source) const {
+	static const ziggurat_tables tables;
+
+	for (;;) {
+		// Use the low seven bits for the layer and the top 53 for
+		// the uniform on [-1, 1).
+		uint64_t bits = coord_source.next_long();
+		int layer = bits & (ZIGGURAT_LAYERS - 1);
+		double u = 2 * ((bits >> 11) * (1.0 / 9007199254740992.0)) - 1;
+
+		// Inside the rectangle: accept straight away.
+		if (fabs(u) < tables.ratio[layer]) {
+			return u * tables.x[layer];
+		}
+
+		// The bottom layer includes the tail, which we sample from
+		// by Marsaglia's method. (1 - next_double() is in (0, 1].)
+		if (layer == 0) {
+			double x, y;
+			do {
+				x = log(1 - coord_source.next_double()) / ZIGGURAT_R;
+				y = log(1 - coord_source.next_double());
+			} while (-2 * y < x * x);
+
+			if (u < 0) {
+				return x - ZIGGURAT_R;
+			}
+			return ZIGGURAT_R - x;
+		}
+
+		// Otherwise we're in the wedge between this layer's rectangle
+		// and the pdf.
+		double x = u * tables.x[layer],
+			   f0 = exp(-0.5 * (tables.x[layer] * tables.x[layer] - x * x)),
+			   f1 = exp(-0.5 * (tables.x[layer+1] * tables.x[layer+1] - x * x));
+
+		if (f1 + coord_source.next_double() * (f0 - f1) < 1.0) {
+			return x;
+		}
+	}
+}
+
+void gaussian_dist::fill_standard(double * out, size_t count,
+	coordinate_gen & coord_source) const {
+
+	if (coord_source.is_independent()) {
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = ziggurat(coord_source);
+		}
+		return;
+	}
+
+	if (count % 2 != 0) {
+		throw std::invalid_argument("fill_standard: QMC needs an even "
+			"number of variates");
+	}
+
+	for (size_t i = 0; i < count; i += 2) {
+		coord_source.start_query();
+		out[i] = coord_source.next_double();
+		out[i+1] = coord_source.next_double();
+		coord_source.end_query();
+	}
+
+	qnorm_block(out, count);
+}
+
 std::pair<double, double> gaussian_dist::get_2D(
 	double sigma_in, coordinate_gen & coord_source) const {
 
@@ -8,8 +8,22 @@
 class gaussian_dist {
 	private:
 		double qnorm(double p, double mu, double sigma) const;
+		double ziggurat(coordinate_gen & coord_source) const;
 
 	public:
+		// Turns count probabilities into standard normal variates, in
+		// place. Gives the same results as qnorm, but does the common
+		// case for the whole block at once so the compiler can
+		// vectorize it.
+		void qnorm_block(double * p_inout, size_t count) const;
+
+		// Fills out with count standard normal variates. Independent
+		// sources (RNGs) use the ziggurat method. Sources that aren't
+		// (QMC) use inverse sampling, two variates per query like
+		// get_2D, and so count must be even.
+		void fill_standard(double * out, size_t count,
+			coordinate_gen & coord_source) const;
+
 		std::pair<double, double> get_2D(double sigma_in,
 			coordinate_gen & coord_source) const;
 		std::pair<double, double> get_2D(double xmean, double ymean,
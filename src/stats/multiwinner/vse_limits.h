@@ -49,6 +49,25 @@ class VSE_limits {
 			++times_updated;
 		}
 
+		// Combine with limits gathered (e.g. by another thread) over
+		// other outcomes.
+		void merge(const VSE_limits & other) {
+			if (other.seen_worst && (!seen_worst ||
+					is_worse(other.worst, worst))) {
+				worst = other.worst;
+				seen_worst = true;
+			}
+
+			if (other.seen_best && (!seen_best ||
+					is_better(other.best, best))) {
+				best = other.best;
+				seen_best = true;
+			}
+
+			random += other.random;
+			times_updated += other.times_updated;
+		}
+
 		VSE_limits(optimality_direction opt_dir_in) {
 			clear();
 			opt_dir = opt_dir_in;
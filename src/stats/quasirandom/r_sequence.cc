@@ -21,7 +21,7 @@ void r_sequence::set_alpha_roots(size_t dimension) {
 	}
 }
 
-std::vector<double> r_sequence::next() {
+void r_sequence::next(double * out) {
 	if (query_pos != current_state.size() && query_pos != R_SEQ_NOT_INITED) {
 		throw std::logic_error(
 			"Tried to create new sequence without consuming all coordinate points!");
@@ -32,11 +32,27 @@ std::vector<double> r_sequence::next() {
 
 		// Add 0.5 as recommended in the article.
 		current_point[i] = fmod(current_state[i] + 0.5, 1);
+		out[i] = current_point[i];
 	}
+}
 
+std::vector<double> r_sequence::next() {
+	next(current_point.data());
 	return current_point;
 }
 
+void r_sequence::get_coordinates(size_t dimension, size_t count,
+	double * out) {
+
+	if (dimension != current_state.size()) {
+		throw std::invalid_argument("get_coordinates: Dimension mismatch");
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		next(out + i * dimension);
+	}
+}
+
 void r_sequence::start_query() {
 	if (query_pos != current_state.size() && query_pos != R_SEQ_NOT_INITED) {
 		throw std::logic_error(
@@ -67,6 +67,10 @@ class r_sequence : public coordinate_gen {
 
 		std::vector<double> next();
 
+		// Like next(), but writes the new point to out instead of
+		// returning a copy.
+		void next(double * out);
+
 		std::vector<double> get_coordinate(size_t dimension) {
 			if (dimension != current_state.size()) {
 				throw std::invalid_argument("get_coordinate: Dimension mismatch");
@@ -74,4 +78,6 @@ class r_sequence : public coordinate_gen {
 
 			return next();
 		}
+
+		void get_coordinates(size_t dimension, size_t count, double * out);
 };
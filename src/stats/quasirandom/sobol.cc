@@ -0,0 +1,247 @@
+#include "sobol.h"
+#include "random/philox.h"
+
+#include <stdexcept>
+#include <cmath>
+
+// Degree s, polynomial coefficients a and initial direction numbers m for
+// every dimension after the first.
+
+struct sobol_polynomial {
+	int degree;
+	uint32_t coefficients;
+	uint32_t initial[7];
+};
+
+static const sobol_polynomial sobol_polynomials[SOBOL_MAX_DIMENSION-1] = {
+	{1, 0, {1}},
+	{2, 1, {1, 3}},
+	{3, 1, {1, 3, 1}},
+	{3, 2, {1, 1, 1}},
+	{4, 1, {1, 1, 3, 3}},
+	{4, 4, {1, 3, 5, 13}},
+	{5, 2, {1, 1, 5, 5, 17}},
+	{5, 4, {1, 1, 5, 5, 5}},
+	{5, 7, {1, 1, 7, 11, 19}},
+	{5, 11, {1, 1, 5, 1, 1}},
+	{5, 13, {1, 1, 1, 3, 11}},
+	{5, 14, {1, 3, 5, 5, 31}},
+	{6, 1, {1, 3, 3, 9, 7, 49}},
+	{6, 13, {1, 1, 1, 15, 21, 21}},
+	{6, 16, {1, 3, 1, 13, 27, 49}},
+	{6, 19, {1, 1, 1, 15, 7, 5}},
+	{6, 22, {1, 3, 1, 15, 13, 25}},
+	{6, 25, {1, 1, 5, 5, 19, 61}},
+	{7, 1, {1, 3, 7, 11, 23, 15, 103}},
+	{7, 4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+static uint32_t reverse_bits(uint32_t x) {
+	x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+	x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+	x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+	return (x >> 16) | (x << 16);
+}
+
+// Burley's improved Laine-Karras hash. Every bit of the output only depends
+// on the same or lower bits of the input, so applied to the bit-reversed
+// coordinate, every bit only depends on the more significant ones. That's
+// exactly what Owen scrambling requires.
+static uint32_t laine_karras_permutation(uint32_t x, uint32_t seed) {
+	x += seed;
+	x ^= x * 0x6c50b47c;
+	x ^= x * 0xb82f1e52;
+	x ^= x * 0xc7afe638;
+	x ^= x * 0x8d22f6e6;
+	return x;
+}
+
+static uint32_t nested_uniform_scramble(uint32_t x, uint32_t seed) {
+	return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+}
+
+void sobol_sequence::set_direction_numbers() {
+	direction = std::vector<uint32_t>(dimension * 32, 0);
+
+	size_t bit;
+
+	// The first dimension is just the van der Corput sequence.
+	for (bit = 0; bit < 32; ++bit) {
+		direction[bit] = 1U << (31 - bit);
+	}
+
+	for (size_t dim = 1; dim < dimension; ++dim) {
+		const sobol_polynomial & poly = sobol_polynomials[dim-1];
+		uint32_t * v = direction.data() + dim * 32;
+		size_t s = poly.degree;
+
+		for (bit = 0; bit < s; ++bit) {
+			v[bit] = poly.initial[bit] << (31 - bit);
+		}
+
+		for (bit = s; bit < 32; ++bit) {
+			v[bit] = v[bit-s] ^ (v[bit-s] >> s);
+
+			for (size_t k = 1; k < s; ++k) {
+				if ((poly.coefficients >> (s - 1 - k)) & 1) {
+					v[bit] ^= v[bit-k];
+				}
+			}
+		}
+	}
+}
+
+sobol_sequence::sobol_sequence(size_t dimension_in) {
+	if (dimension_in == 0 || dimension_in > SOBOL_MAX_DIMENSION) {
+		throw std::invalid_argument("sobol_sequence: Unsupported "
+			"dimension");
+	}
+
+	dimension = dimension_in;
+	scrambled = false;
+	scramble_seed = 0;
+
+	set_direction_numbers();
+	state = std::vector<uint32_t>(dimension, 0);
+	current_point = std::vector<double>(dimension, 0);
+	index = 0;
+}
+
+sobol_sequence::sobol_sequence(size_t dimension_in,
+	uint64_t scramble_seed_in) : sobol_sequence(dimension_in) {
+
+	// Let Philox both handle RNG_ENTROPY and turn the seed into one
+	// scramble per dimension.
+	philox_rng seed_source(scramble_seed_in);
+
+	scrambled = true;
+	scramble_seed = seed_source.get_initial_seed();
+
+	for (size_t dim = 0; dim < dimension; ++dim) {
+		scramble_seeds.push_back(seed_source.next_int());
+	}
+}
+
+void sobol_sequence::skip_to(uint64_t index_in) {
+	if (query_pos != dimension && query_pos != SOBOL_NOT_INITED) {
+		throw std::logic_error(
+			"Tried to skip without consuming all coordinate points!");
+	}
+
+	// The point with Gray code index g is the XOR of the direction
+	// numbers for the set bits of g.
+	uint64_t gray = index_in ^ (index_in >> 1);
+
+	for (size_t dim = 0; dim < dimension; ++dim) {
+		state[dim] = 0;
+		for (size_t bit = 0; bit < 32 && (gray >> bit) != 0; ++bit) {
+			if ((gray >> bit) & 1) {
+				state[dim] ^= direction[dim * 32 + bit];
+			}
+		}
+	}
+
+	index = index_in;
+	query_pos = SOBOL_NOT_INITED;
+}
+
+void sobol_sequence::set_point(double * out) const {
+	const double scale = 1.0 / 4294967296.0;
+
+	for (size_t dim = 0; dim < dimension; ++dim) {
+		uint32_t x = state[dim];
+		if (scrambled) {
+			x = nested_uniform_scramble(x, scramble_seeds[dim]);
+		}
+		out[dim] = (x + 0.5) * scale;
+	}
+}
+
+// Going from index i to i+1 in Gray code order flips the bit given by the
+// number of trailing zeroes of i+1.
+
+void sobol_sequence::advance() {
+	++index;
+
+	if (index >> 32 != 0) {
+		throw std::runtime_error("sobol_sequence: Exhausted the 2^32 "
+			"points we have direction numbers for");
+	}
+
+	uint32_t * v = direction.data() + __builtin_ctzll(index);
+
+	for (size_t dim = 0; dim < dimension; ++dim) {
+		state[dim] ^= v[dim * 32];
+	}
+}
+
+std::vector<double> sobol_sequence::next() {
+	if (query_pos != dimension && query_pos != SOBOL_NOT_INITED) {
+		throw std::logic_error(
+			"Tried to create new sequence without consuming all coordinate points!");
+	}
+
+	set_point(current_point.data());
+	advance();
+
+	return current_point;
+}
+
+void sobol_sequence::get_coordinates(size_t dimension_in, size_t count,
+	double * out) {
+
+	if (dimension_in != dimension) {
+		throw std::invalid_argument("get_coordinates: Dimension mismatch");
+	}
+	if (query_pos != dimension && query_pos != SOBOL_NOT_INITED) {
+		throw std::logic_error(
+			"Tried to create new sequence without consuming all coordinate points!");
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		set_point(out + i * dimension);
+		advance();
+	}
+}
+
+void sobol_sequence::start_query() {
+	next();
+	query_pos = 0;
+}
+
+void sobol_sequence::end_query() {
+	if (query_pos != dimension) {
+		throw std::logic_error(
+			"Ended query without having used all coordinate points!");
+	}
+}
+
+double sobol_sequence::next_double() {
+	if (query_pos == SOBOL_NOT_INITED) {
+		throw std::logic_error("next_double without start_query");
+	}
+	if (query_pos == dimension) {
+		throw std::logic_error("double supply exhausted");
+	}
+	return current_point[query_pos++];
+}
+
+// These have the same roundoff problems as r_sequence's. The doubles are
+// never exactly 0 or 1, so at least they don't overflow.
+
+uint64_t sobol_sequence::next_long() {
+	return next_double() * (double)UINT64_MAX;
+}
+
+uint64_t sobol_sequence::next_long(uint64_t modulus) {
+	return next_double() * modulus;
+}
+
+uint32_t sobol_sequence::next_int() {
+	return next_double() * UINT32_MAX;
+}
+
+uint32_t sobol_sequence::next_int(uint32_t modulus) {
+	return next_double() * modulus;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+// Sobol sequence, optionally with Owen scrambling.
+
+// The direction numbers are those of
+// JOE, Stephen; KUO, Frances Y. Constructing Sobol sequences with better
+// two-dimensional projections. SIAM Journal on Scientific Computing, 2008,
+// 30.5: 2635-2654.
+// (new-joe-kuo-6.21201), for up to SOBOL_MAX_DIMENSION dimensions.
+
+// Points are generated in Gray code order, so each new point only takes one
+// XOR per dimension. The first 2^m points of each projection are then
+// perfectly stratified, which is why we don't skip the first point like
+// r_sequence does; instead every coordinate is put in the middle of its
+// 2^-32 wide cell so that nothing is exactly 0.
+
+// The scrambled version uses the hash-based nested uniform scramble of
+// BURLEY, Brent. Practical hash-based Owen scrambling. Journal of Computer
+// Graphics Techniques, 2020, 9.4: 1-20.
+// It keeps the stratification, but every scramble seed gives an independent
+// randomization whose points are each uniformly distributed. Thus running
+// the same integration with a few different seeds gives an unbiased error
+// estimate, and e.g. every Yee pixel can get its own scramble.
+
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+#include "../coordinate_gen.h"
+
+const size_t SOBOL_MAX_DIMENSION = 21;
+const size_t SOBOL_NOT_INITED = (size_t) -1;
+
+class sobol_sequence : public coordinate_gen {
+	private:
+		// direction[dim * 32 + bit]
+		std::vector<uint32_t> direction;
+		std::vector<uint32_t> scramble_seeds;
+		std::vector<uint32_t> state;
+		std::vector<double> current_point;
+
+		size_t dimension;
+		uint64_t index;
+		uint64_t scramble_seed;
+		bool scrambled;
+
+		size_t query_pos = SOBOL_NOT_INITED;
+
+		void set_direction_numbers();
+		void set_point(double * out) const;
+		void advance();
+
+	public:
+		// Unscrambled.
+		sobol_sequence(size_t dimension_in);
+		// Owen-scrambled with the given seed. As with rng, a seed of
+		// RNG_ENTROPY (0) draws the seed from the entropy source.
+		sobol_sequence(size_t dimension_in, uint64_t scramble_seed_in);
+
+		bool is_independent() const {
+			return false;
+		}
+
+		bool is_scrambled() const {
+			return scrambled;
+		}
+
+		// The scramble seed, so that one scrambled sequence can be
+		// used to seed others.
+		uint64_t get_initial_seed() const {
+			return scramble_seed;
+		}
+
+		size_t get_dimension() const {
+			return dimension;
+		}
+
+		// Index of the next point to be generated.
+		uint64_t get_index() const {
+			return index;
+		}
+
+		// Random access: the next point generated will be the one with
+		// the given index.
+		void skip_to(uint64_t index_in);
+
+		void start_query();
+		void end_query();
+
+		using coordinate_gen::next_long;
+		using coordinate_gen::next_int;
+		using coordinate_gen::next_double;
+
+		double next_double();
+
+		uint64_t next_long();
+		uint64_t next_long(uint64_t modulus);
+
+		uint32_t next_int();
+		uint32_t next_int(uint32_t modulus);
+
+		std::vector<double> next();
+
+		std::vector<double> get_coordinate(size_t dimension_in) {
+			if (dimension_in != dimension) {
+				throw std::invalid_argument("get_coordinate: Dimension mismatch");
+			}
+
+			return next();
+		}
+
+		void get_coordinates(size_t dimension_in, size_t count,
+			double * out);
+};
@@ -0,0 +1,85 @@
+// Tests for the batched normal variate and coordinate generation.
+
+#include <gtest/gtest.h>
+
+#include "random/random.h"
+#include "stats/distributions/gaussian.h"
+#include "stats/quasirandom/r_sequence.h"
+
+#include <math.h>
+#include <vector>
+
+// The block inverse normal must give the same variates as get_2D, so that
+// QMC runs come out the same whichever path is used.
+TEST(Gaussian, BlockQNormMatchesScalar) {
+	gaussian_dist gdist;
+	r_sequence scalar_source(2), block_source(2);
+
+	size_t num_pairs = 1000;
+	std::vector<double> block(num_pairs * 2);
+
+	gdist.fill_standard(block.data(), block.size(), block_source);
+
+	for (size_t i = 0; i < num_pairs; ++i) {
+		std::pair<double, double> scalar = gdist.get_2D(1, scalar_source);
+
+		EXPECT_NEAR(scalar.first, block[2*i], 1e-12);
+		EXPECT_NEAR(scalar.second, block[2*i+1], 1e-12);
+	}
+}
+
+TEST(Gaussian, ZigguratMoments) {
+	gaussian_dist gdist;
+	rng randomizer(1);
+
+	size_t num_samples = 400000, below_minus_one = 0, i;
+	std::vector<double> samples(num_samples);
+
+	gdist.fill_standard(samples.data(), num_samples, randomizer);
+
+	double mean = 0, variance = 0, fourth = 0;
+
+	for (i = 0; i < num_samples; ++i) {
+		mean += samples[i];
+		if (samples[i] < -1) {
+			++below_minus_one;
+		}
+	}
+	mean /= num_samples;
+
+	for (i = 0; i < num_samples; ++i) {
+		double dev = samples[i] - mean;
+		variance += dev * dev;
+		fourth += dev * dev * dev * dev;
+	}
+	variance /= num_samples;
+	fourth /= num_samples;
+
+	EXPECT_NEAR(mean, 0, 0.01);
+	EXPECT_NEAR(variance, 1, 0.01);
+	// The fourth moment checks that the tails are about right.
+	EXPECT_NEAR(fourth, 3, 0.06);
+	// Phi(-1) = 0.158655...
+	EXPECT_NEAR(below_minus_one/(double)num_samples, 0.158655, 0.003);
+}
+
+TEST(CoordinateGen, BlockMatchesSingle) {
+	r_sequence single_source(3), block_source(3);
+	rng single_rng(7), block_rng(7);
+
+	size_t count = 50;
+	std::vector<double> block(count * 3), rng_block(count * 3);
+
+	block_source.get_coordinates(3, count, block.data());
+	block_rng.get_coordinates(3, count, rng_block.data());
+
+	for (size_t i = 0; i < count; ++i) {
+		std::vector<double> qmc = single_source.get_coordinate(3),
+							rnd = single_rng.get_coordinate(3);
+
+		for (size_t dim = 0; dim < 3; ++dim) {
+			EXPECT_EQ(qmc[dim], block[i * 3 + dim]);
+			EXPECT_EQ(rnd[dim], rng_block[i * 3 + dim]);
+		}
+	}
+}
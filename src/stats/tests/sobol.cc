@@ -0,0 +1,85 @@
+// Tests for the (scrambled) Sobol sequence.
+
+#include <gtest/gtest.h>
+
+#include "stats/quasirandom/sobol.h"
+
+#include <vector>
+
+TEST(Sobol, FirstPoints) {
+	sobol_sequence sobol(2);
+
+	double expected[4][2] = {{0, 0}, {0.5, 0.5}, {0.75, 0.25},
+		{0.25, 0.75}
+	};
+
+	for (int i = 0; i < 4; ++i) {
+		std::vector<double> point = sobol.next();
+		EXPECT_NEAR(point[0], expected[i][0], 1e-9);
+		EXPECT_NEAR(point[1], expected[i][1], 1e-9);
+	}
+}
+
+// Every one-dimensional projection of the first 2^m points should have
+// exactly one point in each interval of width 2^-m, and the first two
+// dimensions together should be a (0, m, 2)-net. Scrambling must keep both.
+static void check_stratification(sobol_sequence & sobol) {
+	size_t log_points = 8, num_points = 1 << log_points,
+		   dimension = sobol.get_dimension(), i, dim;
+
+	std::vector<double> points(num_points * dimension);
+	sobol.get_coordinates(dimension, num_points, points.data());
+
+	for (dim = 0; dim < dimension; ++dim) {
+		std::vector<int> count(num_points, 0);
+		for (i = 0; i < num_points; ++i) {
+			++count[(size_t)(points[i * dimension + dim] * num_points)];
+		}
+		for (i = 0; i < num_points; ++i) {
+			EXPECT_EQ(count[i], 1) << "dimension " << dim;
+		}
+	}
+
+	for (size_t x_bits = 0; x_bits <= log_points; ++x_bits) {
+		size_t x_cells = 1 << x_bits, y_cells = num_points / x_cells;
+		std::vector<int> count(num_points, 0);
+
+		for (i = 0; i < num_points; ++i) {
+			size_t x = points[i * dimension] * x_cells,
+				   y = points[i * dimension + 1] * y_cells;
+			++count[x * y_cells + y];
+		}
+		for (i = 0; i < num_points; ++i) {
+			EXPECT_EQ(count[i], 1) << "x cells: " << x_cells;
+		}
+	}
+}
+
+TEST(Sobol, Stratified) {
+	sobol_sequence plain(SOBOL_MAX_DIMENSION),
+				   scrambled(SOBOL_MAX_DIMENSION, 17);
+
+	check_stratification(plain);
+	check_stratification(scrambled);
+}
+
+TEST(Sobol, SkipToMatchesStepping) {
+	sobol_sequence stepped(5, 3), skipped(5, 3);
+
+	std::vector<double> point;
+	for (int i = 0; i < 37; ++i) {
+		point = stepped.next();
+	}
+
+	skipped.skip_to(36);
+	EXPECT_EQ(skipped.next(), point);
+}
+
+TEST(Sobol, ScramblesAreIndependent) {
+	sobol_sequence first(3, 1), same(3, 1), other(3, 2);
+
+	std::vector<double> first_point = first.next();
+
+	EXPECT_EQ(first_point, same.next());
+	EXPECT_NE(first_point, other.next());
+}
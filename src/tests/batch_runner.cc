@@ -0,0 +1,105 @@
+#include "batch_runner.h"
+
+batch_test_runner::batch_test_runner(
+	std::shared_ptr<pure_ballot_generator> ballot_gen_in,
+	int numvoters_in, int numcands_in_min, int numcands_in_max,
+	std::shared_ptr<coordinate_gen> randomizer_in,
+	const std::vector<std::shared_ptr<election_method> > & methods_in,
+	int attempts_per_election_in) {
+
+	if (numvoters_in < 0 || numcands_in_min < 0
+		|| numcands_in_max < numcands_in_min) {
+
+		throw std::out_of_range("batch_test_runner: input parameter "
+			"negative or out of range");
+	}
+
+	numvoters = numvoters_in;
+	numcands_min = numcands_in_min;
+	numcands_max = numcands_in_max;
+	ballot_gen = ballot_gen_in;
+	entropy_source = randomizer_in;
+	num_elections = 0;
+
+	// The runners are only used to try strategies on elections we give
+	// them, so their own election parameters don't matter.
+	for (const std::shared_ptr<election_method> & method: methods_in) {
+		runners.push_back(std::make_shared<test_runner>(ballot_gen_in,
+				numvoters_in, numcands_in_min, numcands_in_max,
+				randomizer_in, method, attempts_per_election_in));
+	}
+
+	queued_results.resize(runners.size());
+}
+
+void batch_test_runner::add_test(
+	const std::shared_ptr<criterion_test> & in) {
+
+	for (std::shared_ptr<test_runner> & runner: runners) {
+		runner->add_test(in);
+	}
+}
+
+void batch_test_runner::set_name(std::string new_name) {
+	for (std::shared_ptr<test_runner> & runner: runners) {
+		runner->set_name(new_name);
+	}
+}
+
+void batch_test_runner::test_new_election() {
+	size_t numcands = numcands_min;
+	if (numcands_max > numcands_min) {
+		numcands = entropy_source->next_int(numcands_min, numcands_max+1);
+	}
+
+	election_t ballots = ballot_gen->generate_ballots(numvoters,
+			numcands, *entropy_source);
+	++num_elections;
+
+	honest_cache.clear();
+
+	// One test cache per honest winner.
+	std::map<size_t, test_cache> cache_by_winner;
+
+	for (size_t i = 0; i < runners.size(); ++i) {
+		if (!queued_results[i].empty()) {
+			continue;
+		}
+
+		ordering honest_outcome = runners[i]->get_method()->elect(
+				ballots, numcands, &honest_cache, true);
+
+		// If it's a tie, test_election returns without using the
+		// cache, so it doesn't matter which one we give it.
+		size_t winner = honest_outcome.begin()->get_candidate_num();
+
+		queued_results[i].push_back(runners[i]->test_election(ballots,
+				honest_outcome, numcands, cache_by_winner[winner], true));
+	}
+}
+
+test_result batch_test_runner::get_next_result(size_t method_index) {
+	std::lock_guard<std::mutex> guard(lock);
+
+	if (queued_results[method_index].empty()) {
+		test_new_election();
+	}
+
+	test_result result = queued_results[method_index].front();
+	queued_results[method_index].pop_front();
+
+	return result;
+}
+
+double batch_test_arm::do_simulation() {
+	switch (batch->get_next_result(method_index)) {
+		case TEST_DISPROVEN:
+		case TEST_TIE:
+			return 1;
+		case TEST_NO_DISPROOFS:
+			return 0;
+		default:
+			throw std::invalid_argument(
+				"batch_test_arm::simulate - unknown return code");
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+// A test runner for many methods at once. When a bandit search compares
+// thousands of methods, running a separate test_runner for each means that
+// every pull generates its own election, counts its own honest outcome from
+// scratch, and regroups the ballots by challenger. The batch runner instead
+// generates one election and tests it for every method that needs a new
+// result, so that:
+//	- ballot generation happens once per election, not once per method,
+//	- the honest outcomes share a cache_map, so e.g. the pairwise matrix
+//		and the Smith set are only determined once,
+//	- methods with the same honest winner share the test cache, i.e. the
+//		ballots grouped by challenger and the statistics used for delta
+//		evaluation (see delta.h).
+
+// Each method's results go into a queue, and the batch_test_arm for that
+// method (a Bernoulli simulator, as with test_runner) takes its results from
+// the queue. A new election is only generated when the queue of the arm
+// being pulled is empty, and then only the methods with empty queues are
+// tested, so no result is thrown away except for at most one per method at
+// the end.
+
+// The arms can be pulled from several threads, but they share the batch,
+// and a single mutex guards all of it. So the pulls are serialized: when
+// the bandit pulls arms in parallel, only one thread at a time takes a
+// result from the batch or tests a new election, and the others wait.
+
+#include "runner.h"
+
+#include <deque>
+#include <mutex>
+
+class batch_test_runner {
+	private:
+		int numvoters;
+		size_t numcands_min, numcands_max;
+		std::shared_ptr<pure_ballot_generator> ballot_gen;
+		std::shared_ptr<coordinate_gen> entropy_source;
+
+		std::vector<std::shared_ptr<test_runner> > runners;
+		std::vector<std::deque<test_result> > queued_results;
+
+		cache_map honest_cache;
+		size_t num_elections;
+		mutable std::mutex lock;
+
+		void test_new_election();
+
+	public:
+		batch_test_runner(
+			std::shared_ptr<pure_ballot_generator> ballot_gen_in,
+			int numvoters_in, int numcands_in_min, int numcands_in_max,
+			std::shared_ptr<coordinate_gen> randomizer_in,
+			const std::vector<std::shared_ptr<election_method> > &
+			methods_in, int attempts_per_election_in);
+
+		// Adds the test for every method.
+		void add_test(const std::shared_ptr<criterion_test> & in);
+		void set_name(std::string new_name);
+
+		size_t get_num_methods() const {
+			return runners.size();
+		}
+
+		std::string name(size_t method_index) const {
+			return runners[method_index]->name();
+		}
+
+		// Number of elections generated so far.
+		size_t get_num_elections() const {
+			std::lock_guard<std::mutex> guard(lock);
+			return num_elections;
+		}
+
+		// Returns the outcome of testing the next election for the given
+		// method.
+		test_result get_next_result(size_t method_index);
+};
+
+class batch_test_arm : public bernoulli_simulator {
+	private:
+		std::shared_ptr<batch_test_runner> batch;
+		size_t method_index;
+
+	protected:
+		// As in test_runner, ties count as failures.
+		double do_simulation();
+
+	public:
+		std::string name() const {
+			return batch->name(method_index);
+		}
+
+		bool higher_is_better() const {
+			return false;
+		}
+
+		batch_test_arm(std::shared_ptr<batch_test_runner> batch_in,
+			size_t method_index_in,
+			std::shared_ptr<coordinate_gen> randomizer_in) :
+			bernoulli_simulator(randomizer_in) {
+
+			batch = batch_in;
+			method_index = method_index_in;
+		}
+};
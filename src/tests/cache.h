@@ -14,6 +14,7 @@
 // ugly. But this is the best solution I could come up with.
 
 #include "strategy/ballots_by_support.h"
+#include "singlewinner/statistics.h"
 
 // XXX: This doesn't yet contain a hash that will identify the election it's
 // valid for. It must thus never be used across elections. Implementing a
@@ -22,4 +23,8 @@
 class test_cache {
 	public:
 		std::vector<ballots_by_support> grouped_by_challenger;
+
+		// The summary statistics of the ballots that don't support
+		// each challenger, for summable methods; see delta.h.
+		std::vector<election_statistics> others_statistics;
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "delta.h"
+
+void delta_evaluator::prepare_cache(test_cache & cache,
+	size_t numcands) const {
+
+	if (!is_summable()) {
+		return;
+	}
+
+	statistics_request request = required_statistics;
+
+	// If the cache is shared with other methods, it may already have
+	// statistics that serve this method too. If it has statistics that
+	// don't, count those and ours together so that every method sharing
+	// the cache is served.
+	if (!cache.others_statistics.empty()) {
+		const statistics_request & cached_request =
+			cache.others_statistics[0].get_request();
+
+		if (cached_request.includes(required_statistics)) {
+			return;
+		}
+
+		request.add(cached_request);
+		cache.others_statistics.clear();
+	}
+
+	for (size_t challenger = 0; challenger < numcands; ++challenger) {
+		cache.others_statistics.push_back(election_statistics(request,
+				cache.grouped_by_challenger[challenger].others, numcands));
+	}
+}
+
+ordering delta_evaluator::elect_after(const disproof & partial_disproof,
+	const test_cache & cache, size_t numcands) const {
+
+	if (!partial_disproof.after_is_delta) {
+		return method->elect(partial_disproof.after_election,
+				numcands, true);
+	}
+
+	size_t challenger = partial_disproof.data.find(
+			"chosen_challenger")->second;
+
+	if (is_summable() && !cache.others_statistics.empty()) {
+		election_statistics after = cache.others_statistics[challenger];
+		after.add_ballots(partial_disproof.strategic_ballots);
+
+		return method->elect_from_statistics(after, true).first;
+	}
+
+	// Not summable, so we have to construct the after election.
+	election_t after_election =
+		cache.grouped_by_challenger[challenger].others;
+	after_election.insert(after_election.end(),
+		partial_disproof.strategic_ballots.begin(),
+		partial_disproof.strategic_ballots.end());
+
+	return method->elect(after_election, numcands, true);
+}
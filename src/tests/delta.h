@@ -0,0 +1,51 @@
+#pragma once
+
+// Most strategies only change the ballots of the voters who prefer some
+// challenger to the winner, so the after election is the honest election
+// with those ballots replaced by strategic ones. Counting the after
+// election from scratch for every attempt is where nearly all of the time
+// of a strategy test goes.
+
+// But summable methods (see singlewinner/statistics.h) only need summary
+// statistics of the ballots, and the statistics of an election are the sum
+// of those of its ballots. So we can count the ballots that don't change
+// once per challenger, keep the result in the test cache, and get the
+// statistics of each after election by adding the strategic ballots. The
+// method then elects directly from the statistics.
+
+// Methods that aren't summable, or disproofs that aren't given as deltas,
+// are handled by constructing the after election and electing from it.
+
+#include "cache.h"
+#include "disproof.h"
+
+#include "singlewinner/method.h"
+
+#include <memory>
+
+class delta_evaluator {
+	private:
+		std::shared_ptr<const election_method> method;
+		statistics_request required_statistics;
+
+	public:
+		bool is_summable() const {
+			return !required_statistics.empty();
+		}
+
+		// Count the statistics of the unchanged ballots for every
+		// challenger, if the method is summable and the cache doesn't
+		// already have them. The ballots must already be grouped by
+		// challenger.
+		void prepare_cache(test_cache & cache, size_t numcands) const;
+
+		// Determine the outcome of the after election, with
+		// winner_only set.
+		ordering elect_after(const disproof & partial_disproof,
+			const test_cache & cache, size_t numcands) const;
+
+		delta_evaluator(std::shared_ptr<const election_method> method_in) {
+			method = method_in;
+			required_statistics = method->get_required_statistics();
+		}
+};
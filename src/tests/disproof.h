@@ -22,6 +22,13 @@
 // capability to store information needed for any particular disproof
 // type.
 
+// Strategies where only the voters who prefer the chosen challenger to the
+// winner change their ballots may give the after election as a delta: they
+// set after_is_delta and put the ballots that replace the supporters' ballots
+// in strategic_ballots, leaving after_election empty. This lets summable
+// methods count the after election without constructing it; use
+// criterion_test::expand_after_election to fill it in when needed.
+
 class disproof {
 	public:
 		election_t before_election, after_election;
@@ -29,6 +36,21 @@ class disproof {
 		std::map<std::string, size_t> data;
 		std::string disprover_name;
 
+		election_t strategic_ballots;
+		bool after_is_delta;
+
+		disproof() {
+			after_is_delta = false;
+		}
+
+		// Prepare for a new delta, clearing out the previous after
+		// election.
+		void set_delta() {
+			after_election.clear();
+			strategic_ballots.clear();
+			after_is_delta = true;
+		}
+
 		std::string name() const {
 			return disprover_name;
 		}
@@ -4,6 +4,17 @@ size_t test_runner::get_num_failed_criteria(
 	const election_t & in_ballots, ordering honest_outcome,
 	size_t numcands, bool only_one, bool verbose) {
 
+	test_cache election_data;
+
+	return get_num_failed_criteria(in_ballots, honest_outcome, numcands,
+			election_data, only_one, verbose);
+}
+
+size_t test_runner::get_num_failed_criteria(
+	const election_t & in_ballots, ordering honest_outcome,
+	size_t numcands, test_cache & election_data, bool only_one,
+	bool verbose) {
+
 	// Ties are a problem. We could consider the test to be disproven
 	// if any non-winner can become a winner (for e.g. monotonicity,
 	// strategy); but for now, just don't handle ties.
@@ -23,8 +34,6 @@ size_t test_runner::get_num_failed_criteria(
 				honest_outcome, true) << std::endl;
 	}
 
-	test_cache election_data;
-
 	// Create the disproof (evidence) that we'll be building on.
 	disproof failure_instance;
 	failure_instance.before_outcome = honest_outcome;
@@ -116,14 +125,16 @@ size_t test_runner::get_num_failed_criteria(
 
 			// Determine the winner again! A tie counts if our man
 			// is at top rank, because he wasn't, before.
-			failure_instance.after_outcome = method->elect(
-					failure_instance.after_election,
-					numcands, true);
+			after_evaluator.prepare_cache(election_data, numcands);
+			failure_instance.after_outcome = after_evaluator.elect_after(
+					failure_instance, election_data, numcands);
 
 			// Check if we found a failure (in which case failure_instance
 			// is now a valid disproof of strategy immunity).
 			if (tester->is_disproof_valid(failure_instance)) {
 				if (verbose) {
+					tester->expand_after_election(failure_instance,
+						election_data);
 					tester->print_disproof(failure_instance);
 				}
 
@@ -164,12 +175,22 @@ test_result test_runner::attempt_finding_failure(bool only_one) {
 	ordering honest_outcome = method->elect(ballots, numcands, true);
 	++total_generation_attempts;
 
+	test_cache election_data;
+
+	return test_election(ballots, honest_outcome, numcands, election_data,
+			only_one);
+}
+
+test_result test_runner::test_election(const election_t & in_ballots,
+	const ordering & honest_outcome, size_t numcands,
+	test_cache & election_data, bool only_one) {
+
 	if (ordering_tools::has_multiple_winners(honest_outcome)) {
 		return TEST_TIE;
 	}
 
-	if (get_num_failed_criteria(ballots,
-			honest_outcome, numcands, only_one, false) > 0) {
+	if (get_num_failed_criteria(in_ballots, honest_outcome, numcands,
+			election_data, only_one, false) > 0) {
 
 		return TEST_DISPROVEN;
 	}
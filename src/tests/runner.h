@@ -10,6 +10,7 @@
 #include "singlewinner/method.h"
 #include "random/random.h"
 
+#include "delta.h"
 #include "test.h"
 
 #include <memory>
@@ -23,6 +24,7 @@ class test_runner : public bernoulli_simulator {
 		size_t numcands_min, numcands_max;
 		int total_generation_attempts;
 		std::shared_ptr<const election_method> method;
+		delta_evaluator after_evaluator;
 		election_t ballots;
 		std::shared_ptr<pure_ballot_generator> ballot_gen;
 		size_t disproof_attempts_per_election;
@@ -57,6 +59,23 @@ class test_runner : public bernoulli_simulator {
 			ordering honest_outcome, size_t numcands,
 			bool only_one, bool verbose);
 
+		// The same, but using (and populating) the given test cache.
+		// Since the cache only depends on the election and the honest
+		// winner, it can be shared between methods that elect the same
+		// winner.
+		size_t get_num_failed_criteria(
+			const election_t & in_ballots,
+			ordering honest_outcome, size_t numcands,
+			test_cache & election_data, bool only_one, bool verbose);
+
+		// Try to find a failure for an election whose honest outcome
+		// has already been determined. This lets the caller generate
+		// one election and test it for several methods at once; see
+		// batch_runner.h.
+		test_result test_election(const election_t & in_ballots,
+			const ordering & honest_outcome, size_t numcands,
+			test_cache & election_data, bool only_one);
+
 		// This gives a map indexed by test name, so that the ith
 		// boolean value is true if we could find a failure of that
 		// test for the ith election, false otherwise.
@@ -95,7 +114,8 @@ class test_runner : public bernoulli_simulator {
 			int numvoters_in, int numcands_in_min, int numcands_in_max,
 			std::shared_ptr<coordinate_gen> randomizer_in,
 			std::shared_ptr<const election_method> method_in,
-			int attempts_per_election_in) : bernoulli_simulator(randomizer_in) {
+			int attempts_per_election_in) : bernoulli_simulator(randomizer_in),
+			after_evaluator(method_in) {
 
 			total_generation_attempts = 0;
 			last_run_tried_all_tests = false;
@@ -166,6 +186,10 @@ class test_runner : public bernoulli_simulator {
 				method->name() + ")";
 		}
 
+		std::shared_ptr<const election_method> get_method() const {
+			return method;
+		}
+
 		int get_total_generation_attempts() const {
 			return total_generation_attempts;
 		}
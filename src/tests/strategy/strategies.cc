@@ -28,13 +28,13 @@ void per_ballot_strat::add_strategic_election_inner(
 		&cache.grouped_by_challenger[chosen_challenger];
 
 	partial_disproof.data["chosen_challenger"] = chosen_challenger;
-	partial_disproof.after_election = grouped_ballots->others;
+	partial_disproof.set_delta();
 
 	for (ballot_group ballot:
 		grouped_ballots->supporting_challenger) {
 
-		partial_disproof.after_election.push_back(modify_ballots(ballot,
-				winner, grouped_ballots->challenger));
+		partial_disproof.strategic_ballots.push_back(modify_ballots(
+				ballot, winner, grouped_ballots->challenger));
 	}
 }
 
@@ -85,7 +85,7 @@ void two_sided_reverse::add_strategic_election_inner(
 		&cache.grouped_by_challenger[chosen_challenger];
 
 	partial_disproof.data["chosen_challenger"] = chosen_challenger;
-	partial_disproof.after_election = grouped_ballots->others;
+	partial_disproof.set_delta();
 
 	// Create a ballot with weight equal to the number of voters preferring
 	// the challenger to the winner, with ordering equal to the reverse
@@ -104,7 +104,7 @@ void two_sided_reverse::add_strategic_election_inner(
 	strategic_ballot.replace_score(grouped_ballots->challenger,
 		strategic_ballot.get_max_score()+1);
 
-	partial_disproof.after_election.push_back(strategic_ballot);
+	partial_disproof.strategic_ballots.push_back(strategic_ballot);
 }
 
 // This produces one ballot per coalition; the members of the coalition
@@ -144,7 +144,7 @@ void coalitional_strategy::add_strategic_election_inner(
 		&cache.grouped_by_challenger[chosen_challenger];
 
 	partial_disproof.data["chosen_challenger"] = chosen_challenger;
-	partial_disproof.after_election = grouped_ballots->others;
+	partial_disproof.set_delta();
 
 	double unassigned_weight = grouped_ballots->challenger_support;
 	double max_support_per_coalition =
@@ -175,6 +175,6 @@ void coalitional_strategy::add_strategic_election_inner(
 				strategic_ballot.get_weight(), unassigned_weight));
 		unassigned_weight -= strategic_ballot.get_weight();
 
-		partial_disproof.after_election.push_back(strategic_ballot);
+		partial_disproof.strategic_ballots.push_back(strategic_ballot);
 	}
 }
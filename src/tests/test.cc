@@ -37,6 +37,25 @@ void criterion_test::prepare_cache(test_cache & election_data,
 	}
 }
 
+void criterion_test::expand_after_election(disproof & partial_disproof,
+	const test_cache & cache) const {
+
+	if (!partial_disproof.after_is_delta) {
+		return;
+	}
+
+	size_t chosen_challenger = partial_disproof.data.find(
+			"chosen_challenger")->second;
+
+	partial_disproof.after_election =
+		cache.grouped_by_challenger[chosen_challenger].others;
+	partial_disproof.after_election.insert(
+		partial_disproof.after_election.end(),
+		partial_disproof.strategic_ballots.begin(),
+		partial_disproof.strategic_ballots.end());
+	partial_disproof.after_is_delta = false;
+}
+
 // Since we're dealing with strategies of the type "if a bunch of people who
 // all prefer A to W change their ballots, then A shouldn't win", then we can
 // do the same check for each, namely that the winner did actually change.
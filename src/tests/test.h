@@ -62,6 +62,11 @@ class criterion_test {
 				ballot_generator, randomizer);
 		}
 
+		// If the disproof gives the after election as a delta,
+		// construct the after election proper.
+		void expand_after_election(disproof & partial_disproof,
+			const test_cache & cache) const;
+
 		virtual std::string name() const = 0;
 
 		// "Monotonicity", "Strategy", etc.
@@ -0,0 +1,96 @@
+// Check that testing several methods on shared elections gives the same
+// results as testing each method on its own.
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "generator/impartial.h"
+#include "random/random.h"
+
+#include "singlewinner/elimination/elimination.h"
+#include "singlewinner/pairwise/simple_methods.h"
+#include "singlewinner/positional/simple_methods.h"
+
+#include "tests/batch_runner.h"
+#include "tests/provider.h"
+
+// Only use the strategies that don't draw random numbers, so that the
+// elections generated only depend on how many have been generated.
+static std::shared_ptr<batch_test_runner> get_batch(
+	const std::vector<std::shared_ptr<election_method> > & methods) {
+
+	auto batch = std::make_shared<batch_test_runner>(
+			std::make_shared<impartial>(true, false), 29, 4, 4,
+			std::make_shared<rng>(1), methods, 64);
+
+	test_provider tests;
+
+	for (std::string test_name: {"Burial immunity",
+				"Compromising immunity", "Two-sided immunity",
+				"Two-sided reverse immunity"
+			}) {
+		batch->add_test(tests.get_test_by_name(test_name));
+	}
+
+	return batch;
+}
+
+TEST(BatchRunner, MatchesSeparateRuns) {
+	std::vector<std::shared_ptr<election_method> > methods = {
+		std::make_shared<schulze>(CM_WV),
+		std::make_shared<ext_minmax>(CM_WV, false),
+		std::make_shared<borda>(PT_WHOLE),
+		std::make_shared<instant_runoff_voting>(PT_WHOLE, false)
+	};
+
+	std::shared_ptr<batch_test_runner> batch = get_batch(methods);
+	std::vector<std::vector<test_result> > batch_results(methods.size());
+
+	size_t num_rounds = 40;
+
+	for (size_t round = 0; round < num_rounds; ++round) {
+		for (size_t i = 0; i < methods.size(); ++i) {
+			batch_results[i].push_back(batch->get_next_result(i));
+		}
+	}
+
+	// Every method needed a new result at the same time, so they
+	// should all have been tested on the same elections.
+	EXPECT_EQ(batch->get_num_elections(), num_rounds);
+
+	for (size_t i = 0; i < methods.size(); ++i) {
+		std::shared_ptr<batch_test_runner> single = get_batch({methods[i]});
+
+		for (size_t round = 0; round < num_rounds; ++round) {
+			EXPECT_EQ(single->get_next_result(0), batch_results[i][round]);
+		}
+	}
+}
+
+// A method that is pulled more often than the others should only cause new
+// elections to be generated for itself, and the results stored for the
+// others should be used up before any more elections are generated for them.
+TEST(BatchRunner, OnlyGeneratesWhenNeeded) {
+	std::shared_ptr<batch_test_runner> batch = get_batch({
+		std::make_shared<schulze>(CM_WV),
+		std::make_shared<borda>(PT_WHOLE)
+	});
+
+	batch_test_arm first(batch, 0, std::make_shared<rng>(2)),
+				   second(batch, 1, std::make_shared<rng>(2));
+
+	for (int i = 0; i < 5; ++i) {
+		first.simulate(true);
+	}
+
+	EXPECT_EQ(batch->get_num_elections(), 5);
+	EXPECT_EQ(first.get_simulation_count(), 5);
+
+	second.simulate(true);
+	EXPECT_EQ(batch->get_num_elections(), 5);
+
+	second.simulate(true);
+	EXPECT_EQ(batch->get_num_elections(), 6);
+}
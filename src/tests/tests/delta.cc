@@ -0,0 +1,83 @@
+// Check that electing from the delta of a strategic election gives the same
+// outcome as constructing the strategic election and electing from that.
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "generator/impartial.h"
+#include "random/random.h"
+
+#include "singlewinner/elimination/elimination.h"
+#include "singlewinner/pairwise/simple_methods.h"
+#include "singlewinner/positional/simple_methods.h"
+
+#include "tests/delta.h"
+#include "tests/provider.h"
+
+static void check_deltas(std::shared_ptr<const election_method> method,
+	bool summable) {
+
+	size_t numcands = 5;
+	auto randomizer = std::make_shared<rng>(1);
+	impartial ballot_gen(true, false);
+	test_provider tests;
+
+	delta_evaluator evaluator(method);
+	EXPECT_EQ(evaluator.is_summable(), summable);
+
+	for (int iteration = 0; iteration < 20; ++iteration) {
+		disproof failure_instance;
+		failure_instance.before_election = ballot_gen.generate_ballots(37,
+				numcands, *randomizer);
+		failure_instance.before_outcome = method->elect(
+				failure_instance.before_election, numcands, true);
+
+		if (ordering_tools::has_multiple_winners(
+				failure_instance.before_outcome)) {
+			continue;
+		}
+
+		test_cache cache;
+
+		for (auto test: tests.get_tests_by_category("Strategy")) {
+			// Tests with too many instances to go through are
+			// randomized; try a few of them.
+			int64_t num_tries = test->get_num_tries(numcands);
+			bool random = num_tries < 0;
+
+			if (random) {
+				num_tries = 4;
+			}
+
+			for (int64_t i = 0; i < num_tries; ++i) {
+				test->add_strategic_election(failure_instance,
+					random ? -1 : i, cache, numcands,
+					&ballot_gen, randomizer);
+				evaluator.prepare_cache(cache, numcands);
+
+				ordering delta_outcome = evaluator.elect_after(
+						failure_instance, cache, numcands);
+
+				test->expand_after_election(failure_instance, cache);
+				EXPECT_EQ(delta_outcome, method->elect(
+						failure_instance.after_election, numcands, true));
+			}
+		}
+	}
+}
+
+TEST(StrategyDelta, PairwiseMatchesRecount) {
+	check_deltas(std::make_shared<schulze>(CM_WV), true);
+}
+
+TEST(StrategyDelta, PositionalMatchesRecount) {
+	check_deltas(std::make_shared<borda>(PT_WHOLE), true);
+	check_deltas(std::make_shared<plurality>(PT_FRACTIONAL), true);
+}
+
+TEST(StrategyDelta, NonSummableMatchesRecount) {
+	check_deltas(std::make_shared<instant_runoff_voting>(PT_WHOLE, false),
+		false);
+}
@@ -0,0 +1,128 @@
+#include "revolving_door.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+uint64_t revolving_door::num_combinations(size_t n, size_t k) {
+	if (k > n) {
+		return 0;
+	}
+
+	k = std::min(k, n-k);
+
+	// After step i, out is (n-k+i) choose i, which is an integer.
+	uint64_t out = 1;
+
+	for (size_t i = 1; i <= k; ++i) {
+		uint64_t factor = n - k + i;
+		if (out > UINT64_MAX / factor) {
+			throw std::overflow_error("revolving_door: Too many "
+				"combinations");
+		}
+		out = out * factor / i;
+	}
+
+	return out;
+}
+
+// Kreher and Stinson number everything from one, so x here is their x-1
+// and so on.
+
+std::vector<size_t> revolving_door::unrank(uint64_t rank, size_t n,
+	size_t k) {
+
+	if (rank >= num_combinations(n, k)) {
+		throw std::out_of_range("revolving_door: rank is too large");
+	}
+
+	std::vector<size_t> combination(k);
+	size_t x = n;
+
+	for (size_t i = k; i > 0; --i) {
+		while (num_combinations(x, i) > rank) {
+			--x;
+		}
+		combination[i-1] = x;
+		rank = num_combinations(x+1, i) - rank - 1;
+	}
+
+	return combination;
+}
+
+uint64_t revolving_door::rank(const std::vector<size_t> & combination) {
+	size_t k = combination.size();
+
+	// The alternating sum is never negative once we're done, but
+	// may be in between, so let unsigned arithmetic wrap around.
+	uint64_t rank = -(uint64_t)(k % 2);
+	bool add = true;
+
+	for (size_t i = k; i > 0; --i) {
+		uint64_t term = num_combinations(combination[i-1]+1, i);
+		if (add) {
+			rank += term;
+		} else {
+			rank -= term;
+		}
+		add = !add;
+	}
+
+	return rank;
+}
+
+void revolving_door::next(std::vector<size_t> & combination, size_t n,
+	size_t & removed, size_t & added) {
+
+	size_t k = combination.size(), j = 0;
+
+	// Find the first element that isn't in its lowest possible position.
+	while (j < k && combination[j] == j) {
+		++j;
+	}
+
+	if ((k + j) % 2 == 0) {
+		// Move the element(s) below j up by one.
+		if (j == 0) {
+			removed = combination[0]--;
+			added = combination[0];
+			return;
+		}
+
+		combination[j-1] = j;
+		if (j == 1) {
+			removed = 0;
+			added = 1;
+		} else {
+			combination[j-2] = j-1;
+			removed = j-2;
+			added = j;
+		}
+		return;
+	}
+
+	size_t next_element = n;
+	if (j+1 < k) {
+		next_element = combination[j+1];
+	}
+
+	if (next_element != combination[j]+1) {
+		if (j == 0) {
+			removed = combination[0];
+		} else {
+			removed = j-1;
+			combination[j-1] = combination[j];
+		}
+		added = ++combination[j];
+		return;
+	}
+
+	if (j+1 >= k) {
+		throw std::out_of_range("revolving_door: already at the last "
+			"combination");
+	}
+
+	removed = combination[j+1];
+	combination[j+1] = combination[j];
+	combination[j] = j;
+	added = j;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// This class enumerates k-subsets of {0...n-1} in revolving door order,
+// where every subset differs from the one before by swapping a single
+// element for another. That makes it possible to update functions of the
+// subset incrementally instead of calculating them from scratch.
+
+// It can also go directly to the rth subset in the order (unranking), so
+// the enumeration can be split into independent pieces, e.g. for
+// parallel processing.
+
+// The subsets are stored as sorted vectors. The algorithms are from
+// Kreher and Stinson, "Combinatorial Algorithms: Generation, Enumeration,
+// and Search", section 2.3.3.
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+class revolving_door {
+	public:
+		// n choose k. Throws std::overflow_error if it (or an intermediate
+		// value) doesn't fit in 64 bits.
+		static uint64_t num_combinations(size_t n, size_t k);
+
+		static std::vector<size_t> unrank(uint64_t rank, size_t n,
+			size_t k);
+		static uint64_t rank(const std::vector<size_t> & combination);
+
+		// Turns the combination into the next one in the order, and
+		// returns the element that was removed and the one that was
+		// added. This must not be called on the last combination, i.e.
+		// the one with rank num_combinations(n, k) - 1.
+		static void next(std::vector<size_t> & combination, size_t n,
+			size_t & removed, size_t & added);
+};